@@ -10,18 +10,16 @@
 #define LOG_TAG "COVER"
 #include "AlbumCover.h"
 #include "SimpleLog.h"
+#include "RequestPolicy.h"
 #define WIN32_LEAN_AND_MEAN
 #define NOGDI
 #define NOUSER
 #include <Windows.h>
-#include <WinINet.h>
 #include <fstream>
 #include <filesystem>
 #include <map>
 #include <list>
 
-#pragma comment(lib, "WinINet.lib")
-
 namespace fs = std::filesystem;
 
 namespace Netease {
@@ -71,54 +69,22 @@ bool AlbumCover::IsCached(long long songId) {
 }
 
 bool AlbumCover::DownloadFile(const std::string& url, const std::string& localPath) {
-    HINTERNET hInternet = InternetOpenA(
-        "NeteaseHookSDK/1.0",
-        INTERNET_OPEN_TYPE_PRECONFIG,
-        NULL, NULL, 0
-    );
-    if (!hInternet) {
-        LOG_ERROR("InternetOpenA 失败: 错误码 " << GetLastError());
-        return false;
-    }
-    
-    // 设置 10 秒超时以防止 UI 冻结
-    DWORD timeout = 10000; // 10 seconds
-    InternetSetOptionA(hInternet, INTERNET_OPTION_CONNECT_TIMEOUT, &timeout, sizeof(timeout));
-    InternetSetOptionA(hInternet, INTERNET_OPTION_RECEIVE_TIMEOUT, &timeout, sizeof(timeout));
+    // v0.1.4: 走共享 HTTP 层（Utils/HttpClient），与 API 共用请求策略（对冲 / 重试 / 熔断）
+    Http::Options options;
+    options.userAgent = "NeteaseHookSDK/1.0";
+    options.timeoutMs = 10000; // 10 秒超时以防止 UI 冻结
+    options.maxBodyBytes = 50 * 1024 * 1024; // 限制最大50MB防止OOM
 
-    HINTERNET hUrl = InternetOpenUrlA(
-        hInternet,
-        url.c_str(),
-        NULL, 0,
-        INTERNET_FLAG_RELOAD | INTERNET_FLAG_NO_CACHE_WRITE,
-        0
-    );
-    if (!hUrl) {
-        LOG_ERROR("InternetOpenUrlA 失败: URL=" << url << " 错误码=" << GetLastError());
-        InternetCloseHandle(hInternet);
+    auto response = Http::RequestPolicy::Default().Get(url, options);
+    if (!response) {
         return false;
     }
-
-    // 读取数据 (限制最大50MB防止OOM)
-    const size_t MAX_DOWNLOAD_SIZE = 50 * 1024 * 1024; // 50MB
-    std::vector<char> buffer;
-    buffer.reserve(1024 * 1024); // 预分配 1MB
-    char readBuffer[8192];
-    DWORD bytesRead;
-    
-    while (InternetReadFile(hUrl, readBuffer, sizeof(readBuffer), &bytesRead) && bytesRead > 0) {
-        if (buffer.size() + bytesRead > MAX_DOWNLOAD_SIZE) {
-            LOG_WARN("下载文件超过50MB限制: " << url);
-            InternetCloseHandle(hUrl);
-            InternetCloseHandle(hInternet);
-            return false;
-        }
-        buffer.insert(buffer.end(), readBuffer, readBuffer + bytesRead);
+    if (response->status >= 400) {
+        LOG_WARN("下载失败: URL=" << url << " HTTP " << response->status);
+        return false;
     }
 
-    InternetCloseHandle(hUrl);
-    InternetCloseHandle(hInternet);
-
+    const std::string& buffer = response->body;
     if (buffer.empty()) {
         LOG_WARN("下载了0字节: URL=" << url);
         return false;
@@ -182,6 +148,24 @@ Texture2D AlbumCover::LoadFromUrl(const std::string& url, long long songId) {
     return LoadFromCache(songId);
 }
 
+bool AlbumCover::Prefetch(const std::string& url, long long songId) {
+    if (url.empty() || songId <= 0) return false;
+    if (IsCached(songId)) return true;
+    
+    // 先写临时文件再原子替换：主线程同时加载同一首歌时不会读到半个文件
+    std::string cachePath = GetCachePath(songId);
+    std::string partPath = cachePath + ".part";
+    if (!DownloadFile(url, partPath)) {
+        fs::remove(partPath);
+        return false;
+    }
+    if (!MoveFileExA(partPath.c_str(), cachePath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        fs::remove(partPath);
+        return IsCached(songId);
+    }
+    return true;
+}
+
 int AlbumCover::CleanOldCache(int keepCount) {
     std::string cacheDir = GetCacheDir();
     if (!fs::exists(cacheDir)) return 0;
@@ -41,6 +41,15 @@ public:
      */
     static Texture2D LoadFromCache(long long songId);
     
+    /**
+     * 预热磁盘缓存 (v0.1.4)
+     * 
+     * 仅下载到磁盘缓存，不创建 Texture，可在后台线程调用（供播放队列预取使用）
+     * 
+     * @return 已缓存或下载成功返回 true
+     */
+    static bool Prefetch(const std::string& url, long long songId);
+    
     /**
      * 检查缓存是否存在
      */
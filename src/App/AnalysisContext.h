@@ -0,0 +1,69 @@
+#ifndef ANALYSIS_CONTEXT_H
+#define ANALYSIS_CONTEXT_H
+
+#include <vector>
+#include <span>
+#include <cstddef>
+#include "FftHelper.h"
+
+namespace Netease {
+    // ============================================================
+    // AnalysisContext - 每帧复用的频谱分析上下文 (v0.1.4)
+    // ============================================================
+    // 持有采样 / 幅值 / 频带缓冲区与 FFT 工作区，构造时一次性分配。
+    // 每帧流程：
+    //   AudioCapture::Instance().ReadLatest(context.Samples());
+    //   Visualizer::Instance().Update(context.Process(), deltaTime);
+    // 稳态下整条 采集 → FFT → 频带 路径不做任何堆分配。
+    class AnalysisContext {
+    public:
+        // fftSize 必须为 2 的幂；sampleRate 决定频带映射表的频率刻度
+        explicit AnalysisContext(size_t fftSize = 1024, int bandCount = 32, int sampleRate = 48000)
+            : AnalysisContext(fftSize, bandCount, MakeLayout(sampleRate))
+        {
+        }
+
+        // v0.1.4: 指定完整的频带布局（如降采样后的采样率与最高频率）
+        AnalysisContext(size_t fftSize, int bandCount, const Spectrum::BandLayout& layout)
+            : m_Samples(fftSize, 0.0f),
+              m_Magnitudes(fftSize / 2, 0.0f),
+              m_Bands(bandCount > 0 ? bandCount : 1, 0.0f),
+              m_BandMap(fftSize, (int)m_Bands.size(), layout)
+        {
+            m_Workspace.Prepare(fftSize);
+        }
+
+        size_t FftSize() const { return m_Samples.size(); }
+        size_t BandCount() const { return m_Bands.size(); }
+
+        // 采样输入缓冲区（长度 FftSize()），由调用方填充
+        std::span<float> Samples() { return m_Samples; }
+
+        std::span<const float> Magnitudes() const { return m_Magnitudes; }
+        std::span<const float> Bands() const { return m_Bands; }
+
+        // 对 Samples() 中的数据做一帧分析，返回频带（指向内部缓冲区，下一帧前有效）
+        std::span<const float> Process() {
+            FftHelper::Analyze(m_Samples, m_Magnitudes, m_Workspace);
+            FftHelper::CalculateBands(m_Magnitudes, m_Bands, m_BandMap);
+            return m_Bands;
+        }
+
+        const Spectrum::BandMap& BandMap() const { return m_BandMap; }
+
+    private:
+        static Spectrum::BandLayout MakeLayout(int sampleRate) {
+            Spectrum::BandLayout layout;
+            layout.sampleRate = sampleRate;
+            return layout;
+        }
+
+        FftWorkspace m_Workspace;
+        std::vector<float> m_Samples;
+        std::vector<float> m_Magnitudes;
+        std::vector<float> m_Bands;
+        Spectrum::BandMap m_BandMap;          // v0.1.4: 构造时一次性建表
+    };
+}
+
+#endif // ANALYSIS_CONTEXT_H
@@ -0,0 +1,152 @@
+/**
+ * AnalysisThread.cpp - 独立频谱分析线程实现
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ */
+
+#include "AnalysisThread.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace Netease {
+
+namespace {
+
+SpectrumFrame EmptyFrame(int bandCount) {
+    SpectrumFrame frame;
+    frame.bands.assign(bandCount > 0 ? bandCount : 1, 0.0f);
+    return frame;
+}
+
+constexpr size_t DECIMATE_CHUNK = 1024;
+
+AnalysisConfig Sanitize(AnalysisConfig config) {
+    config.decimation = (std::max)(config.decimation, 1);
+    // 步长对齐到降采样倍数，降采样流中的步长为整数
+    const size_t factor = (size_t)config.decimation;
+    config.hopSize = (std::max)(config.hopSize / factor, (size_t)1) * factor;
+    config.maxCatchUpHops = (std::max)(config.maxCatchUpHops, (size_t)1);
+    config.sampleRate = (std::max)(config.sampleRate, 1);
+    return config;
+}
+
+Spectrum::BandLayout MakeLayout(const AnalysisConfig& config) {
+    Spectrum::BandLayout layout;
+    layout.sampleRate = config.sampleRate / config.decimation;
+    layout.maxHz = config.maxHz;
+    return layout;
+}
+
+} // namespace
+
+AnalysisThread::AnalysisThread(const SpscRing<float>& ring, const AnalysisConfig& config)
+    : m_Ring(ring),
+      m_Config(Sanitize(config)),
+      m_Context(m_Config.fftSize, m_Config.bandCount, MakeLayout(m_Config)),
+      m_Frames(EmptyFrame(m_Config.bandCount)),
+      m_NextEnd(m_Config.hopSize / (size_t)m_Config.decimation),
+      m_Decimator(m_Config.decimation),
+      m_Decimated(m_Config.decimation > 1 ? ring.Capacity() / (size_t)m_Config.decimation + m_Config.fftSize : 1)
+{
+    if (m_Config.decimation > 1) {
+        m_Input.assign(DECIMATE_CHUNK, 0.0f);
+        m_Output.assign(m_Decimator.MaxOutput(DECIMATE_CHUNK), 0.0f);
+    }
+}
+
+AnalysisThread::~AnalysisThread() {
+    Stop();
+}
+
+bool AnalysisThread::Start() {
+    if (m_Running.exchange(true)) return true;
+    m_Thread = std::thread(&AnalysisThread::Run, this);
+    return true;
+}
+
+void AnalysisThread::Stop() {
+    if (!m_Running.exchange(false)) return;
+    if (m_Thread.joinable()) m_Thread.join();
+}
+
+void AnalysisThread::Run() {
+    // 轮询间隔取半个步长；系统计时精度较粗（Windows 默认约 15.6ms）时，
+    // 醒来后由 Pump 一次补齐所有已到达的窗口，分析速率仍由样本位置决定
+    const auto interval = std::chrono::microseconds(
+        (int64_t)(m_Config.hopSize * 1000000 / 2 / (size_t)m_Config.sampleRate));
+    while (m_Running.load(std::memory_order_relaxed)) {
+        if (Pump() == 0) std::this_thread::sleep_for(interval);
+    }
+}
+
+void AnalysisThread::Decimate() {
+    const uint64_t written = m_Ring.Written();
+    const size_t factor = (size_t)m_Config.decimation;
+
+    // 落后超过半圈时丢弃旧输入（按倍数对齐，保持输出相位），滤波器状态随之清空
+    const uint64_t keep = m_Ring.Capacity() / 2;
+    if (written - m_Consumed > keep) {
+        uint64_t skip = (written - m_Consumed - keep) / factor * factor;
+        m_Consumed += skip;
+        m_InputBase += skip;
+        m_Decimator.Reset();
+    }
+
+    while (m_Consumed < written) {
+        size_t take = (size_t)(std::min)((uint64_t)m_Input.size(), written - m_Consumed);
+        // 读取期间被覆盖：留给下一次 Pump 按落后处理
+        if (!m_Ring.ReadEndingAt(m_Consumed + take, m_Input.data(), take)) break;
+        size_t produced = m_Decimator.Process(m_Input.data(), take, m_Output.data());
+        m_Decimated.Write(m_Output.data(), produced);
+        m_Consumed += take;
+    }
+}
+
+size_t AnalysisThread::Pump() {
+    const size_t factor = (size_t)m_Config.decimation;
+    if (factor > 1) Decimate();
+
+    const SpscRing<float>& source = factor > 1 ? m_Decimated : m_Ring;
+    const size_t hop = m_Config.hopSize / factor;
+    const uint64_t written = source.Written();
+    if (written < m_NextEnd) return 0;
+
+    // 落后太多时只补算最新的几个窗口（旧帧来不及显示，也就不必计算）
+    uint64_t pending = (written - m_NextEnd) / hop + 1;
+    if (pending > m_Config.maxCatchUpHops) {
+        uint64_t skip = pending - m_Config.maxCatchUpHops;
+        m_NextEnd += skip * hop;
+        m_Skipped.fetch_add(skip, std::memory_order_relaxed);
+    }
+
+    size_t published = 0;
+    std::span<float> samples = m_Context.Samples();
+    for (; m_NextEnd <= written; m_NextEnd += hop) {
+        if (!source.ReadEndingAt(m_NextEnd, samples.data(), samples.size())) {
+            // 窗口已被生产者覆盖
+            m_Skipped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        double sumSquares = 0;
+        for (float sample : samples) sumSquares += (double)sample * sample;
+
+        std::span<const float> bands = m_Context.Process();
+        SpectrumFrame& frame = m_Frames.Back();
+        std::copy(bands.begin(), bands.end(), frame.bands.begin());
+        float sum = 0;
+        for (float band : bands) sum += band;
+        frame.energy = sum / (float)bands.size();
+        frame.rms = (float)std::sqrt(sumSquares / (double)samples.size());
+        frame.endSample = m_InputBase + m_NextEnd * factor;
+        uint64_t sequence = m_Published.load(std::memory_order_relaxed) + 1;
+        frame.sequence = sequence;
+        m_Frames.Publish();
+        m_Published.store(sequence, std::memory_order_relaxed);
+        published++;
+    }
+    return published;
+}
+
+} // namespace Netease
@@ -0,0 +1,98 @@
+#ifndef ANALYSIS_THREAD_H
+#define ANALYSIS_THREAD_H
+
+#include <vector>
+#include <span>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include "SpscRing.h"
+#include "TripleBuffer.h"
+#include "AnalysisContext.h"
+#include "Decimator.h"
+
+namespace Netease {
+    // 一帧频谱分析结果
+    struct SpectrumFrame {
+        std::vector<float> bands;
+        float energy = 0.0f;           // 频带平均值
+        float rms = 0.0f;              // 本帧窗口内样本的均方根
+        uint64_t sequence = 0;         // 从 1 开始递增
+        uint64_t endSample = 0;        // 窗口结束位置（采集流中的绝对样本序号）
+    };
+
+    struct AnalysisConfig {
+        size_t fftSize = 1024;         // 窗口长度，必须为 2 的幂
+        size_t hopSize = 512;          // 相邻窗口间隔（512 @ 48kHz ≈ 93.75 帧/秒，50% 重叠）
+        int bandCount = 32;
+        int sampleRate = 48000;        // 频带映射表的频率刻度与轮询间隔
+        size_t maxCatchUpHops = 4;     // 一次最多补算几个窗口，落后更多时跳过旧窗口
+
+        // v0.1.4: 分析前降采样（1 = 关闭，2 / 4 = 抗混叠滤波后每 2 / 4 个样本取一个）
+        // fftSize 为降采样后的窗口长度，hopSize 仍按采集样本计（帧率不变）；
+        // 例如 ×4 + FFT 1024 的低频分辨率是全速率 FFT 4096 的水平，运算量约为全速率 FFT 1024
+        int decimation = 1;
+        float maxHz = 16000.0f;        // 最后一个频带的上沿（超过降采样后的 Nyquist 时截断）
+    };
+
+    // ============================================================
+    // AnalysisThread - 独立的频谱分析线程 (v0.1.4)
+    // ============================================================
+    // 按固定步长（采集流的样本位置，而非渲染帧率）消费环形缓冲区，
+    // 重叠加窗分析后经三缓冲发布；渲染线程只读取最新帧，
+    // 帧耗时与 FFT 尺寸无关，分析速率恒为 sampleRate / hopSize。
+    // 开启降采样时先把新到达的采集样本流式送入 Decimator，写入内部的降采样流，再按步长分析。
+    class AnalysisThread {
+    public:
+        explicit AnalysisThread(const SpscRing<float>& ring, const AnalysisConfig& config = AnalysisConfig());
+        ~AnalysisThread();
+
+        AnalysisThread(const AnalysisThread&) = delete;
+        AnalysisThread& operator=(const AnalysisThread&) = delete;
+
+        bool Start();
+        void Stop();
+        bool IsRunning() const { return m_Running.load(); }
+
+        // 处理所有已到达的窗口并发布，返回本次发布的帧数
+        // 由分析线程循环调用；未 Start() 时可直接调用（测试 / 离线分析）
+        size_t Pump();
+
+        // ---------------- 渲染线程 ----------------
+
+        // 最新一帧（无新帧时返回上一帧）；只能由同一个读者线程调用
+        const SpectrumFrame& Latest() {
+            m_Frames.Update();
+            return m_Frames.Front();
+        }
+
+        const AnalysisConfig& Config() const { return m_Config; }
+        uint64_t FramesPublished() const { return m_Published.load(std::memory_order_relaxed); }
+        uint64_t HopsSkipped() const { return m_Skipped.load(std::memory_order_relaxed); }
+
+    private:
+        void Run();
+        void Decimate();
+
+        const SpscRing<float>& m_Ring;
+        AnalysisConfig m_Config;
+        AnalysisContext m_Context;
+        TripleBuffer<SpectrumFrame> m_Frames;
+        uint64_t m_NextEnd = 0;        // 下一个窗口的结束位置（被分析流中的位置）
+
+        // v0.1.4: 降采样（decimation > 1 时使用，只由分析线程访问）
+        Decimator m_Decimator;
+        SpscRing<float> m_Decimated;   // 降采样后的流
+        std::vector<float> m_Input;    // 每次从采集流读取的一块
+        std::vector<float> m_Output;
+        uint64_t m_Consumed = 0;       // 已送入降采样器的采集流位置
+        uint64_t m_InputBase = 0;      // 降采样流位置 0 对应的采集流位置（丢弃过旧输入后前移）
+
+        std::thread m_Thread;
+        std::atomic<bool> m_Running{false};
+        std::atomic<uint64_t> m_Published{0};
+        std::atomic<uint64_t> m_Skipped{0};
+    };
+}
+
+#endif // ANALYSIS_THREAD_H
@@ -5,11 +5,33 @@
 #include "AudioCapture.h"
 #include <iostream>
 #include <algorithm>
+#include <chrono>
 
 namespace Netease {
 
+    namespace {
+        // miniaudio 设备格式 → 接入编码；u8 等不支持的格式返回 false
+        bool ToSampleFormat(ma_format format, SampleFormat& out) {
+            switch (format) {
+                case ma_format_s16: out = SampleFormat::S16; return true;
+                case ma_format_s24: out = SampleFormat::S24; return true;
+                case ma_format_s32: out = SampleFormat::S32; return true;
+                case ma_format_f32: out = SampleFormat::F32; return true;
+                default: return false;
+            }
+        }
+
+        const char* FormatName(SampleFormat format) {
+            switch (format) {
+                case SampleFormat::S16: return "s16";
+                case SampleFormat::S24: return "s24";
+                case SampleFormat::S32: return "s32";
+                default: return "f32";
+            }
+        }
+    }
+
     AudioCapture::AudioCapture() {
-        // deque 不需要 reserve
     }
 
     AudioCapture::~AudioCapture() {
@@ -20,39 +42,33 @@ namespace Netease {
         auto* pCapture = (AudioCapture*)pDevice->pUserData;
         if (!pCapture || !pInput) return;
 
-        pCapture->OnDataInternal((const float*)pInput, frameCount);
+        pCapture->OnDataInternal(pInput, frameCount);
     }
 
 
 
-    void AudioCapture::OnDataInternal(const float* pInput, unsigned int frameCount) {
+    void AudioCapture::OnDataInternal(const void* pInput, unsigned int frameCount) {
         if (!pInput) return;
 
-        int channels = 2;
+        auto begin = std::chrono::steady_clock::now();
 
-        std::lock_guard<std::mutex> lock(m_BufferMutex);
-        
-        // 我们只取单声道混合数据
-        for (unsigned int i = 0; i < frameCount; i++) {
-            float sample = 0;
-            for (int c = 0; c < channels; c++) {
-                sample += pInput[i * channels + c];
-            }
-            sample /= channels;
-
-            m_Buffer.push_back(sample);
-            while (m_Buffer.size() > BUFFER_SIZE) {
-                m_Buffer.pop_front();  // O(1) 删除
-            }
+        // 按设备实际编码与声道数解码、下混，分块在栈上中转后整块写入环形缓冲区
+        WriteMono(m_Ring, pInput, m_InputFormat, m_InputChannels, frameCount);
+        if (m_ChannelCapture.load(std::memory_order_relaxed)) {
+            WriteStereo(m_LeftRing, m_RightRing, pInput, m_InputFormat, m_InputChannels, frameCount);
         }
+
+        auto elapsed = std::chrono::steady_clock::now() - begin;
+        m_CallbackLatency.Record((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
     }
 
     bool AudioCapture::Start() {
         if (m_IsRunning) return true;
 
+        // v0.1.4: 回环走 capture 配置；格式与声道数留空，使用设备原生值，省去 miniaudio 的转换
         ma_device_config config = ma_device_config_init(ma_device_type_loopback);
-        config.playback.format = ma_format_f32;
-        config.playback.channels = 2;
+        config.capture.format = ma_format_unknown;
+        config.capture.channels = 0;
         config.sampleRate = 48000;
         config.dataCallback = DataCallback;
         config.pUserData = this;
@@ -65,6 +81,27 @@ namespace Netease {
             return false;
         }
 
+        // 原生格式不在接入内核支持范围内（如 u8）时，让 miniaudio 转成 f32
+        if (!ToSampleFormat(m_pDevice->capture.format, m_InputFormat)) {
+            ma_device_uninit(m_pDevice);
+            config.capture.format = ma_format_f32;
+            if (ma_device_init(NULL, &config, m_pDevice) != MA_SUCCESS) {
+                LOG_ERROR("初始化音频回放捕获失败 (f32).");
+                free(m_pDevice);
+                m_pDevice = nullptr;
+                return false;
+            }
+            m_InputFormat = SampleFormat::F32;
+        }
+        m_InputChannels = (int)m_pDevice->capture.channels;
+        if (m_InputChannels < 1 || m_InputChannels > Ingest::MAX_CHANNELS) {
+            LOG_ERROR("不支持的回环声道数: " << m_InputChannels);
+            ma_device_uninit(m_pDevice);
+            free(m_pDevice);
+            m_pDevice = nullptr;
+            return false;
+        }
+
         if (ma_device_start(m_pDevice) != MA_SUCCESS) {
             LOG_ERROR("开始音频回放捕获失败.");
             ma_device_uninit(m_pDevice);
@@ -74,13 +111,61 @@ namespace Netease {
         }
 
         m_IsRunning = true;
-        LOG_INFO("音频回放捕获开始 (WASAPI).");
+        LOG_INFO("音频回放捕获开始 (WASAPI, " << FormatName(m_InputFormat) << ", "
+                 << m_InputChannels << " 声道).");
         return true;
     }
 
+    bool AudioCapture::Start(std::unique_ptr<SampleSource> source, bool realTime) {
+        if (m_IsRunning || !source) return false;
+
+        SourceFormat format = source->Format();
+        if (format.channels <= 0 || format.channels > Ingest::MAX_CHANNELS || format.sampleRate <= 0) {
+            LOG_ERROR("采样来源格式无效: " << source->Name());
+            return false;
+        }
+
+        m_Source = std::move(source);
+        m_InputFormat = SampleFormat::F32;
+        m_InputChannels = format.channels;
+        m_IsRunning = true;
+        m_Feeder = std::thread(&AudioCapture::FeedLoop, this, realTime);
+        LOG_INFO("音频采集开始 (" << m_Source->Name() << ", " << format.sampleRate << "Hz, "
+                 << format.channels << " 声道).");
+        return true;
+    }
+
+    void AudioCapture::FeedLoop(bool realTime) {
+        const SourceFormat format = m_Source->Format();
+        std::vector<float> block(FEED_FRAMES * format.channels);
+        auto next = std::chrono::steady_clock::now();
+        uint64_t fed = 0;
+
+        while (m_IsRunning) {
+            size_t frames = m_Source->Read(block.data(), FEED_FRAMES);
+            if (frames == 0) {
+                LOG_INFO("采样来源结束 (" << m_Source->Name() << "), 共 " << fed << " 帧.");
+                break;
+            }
+            OnDataInternal(block.data(), (unsigned int)frames);
+            fed += frames;
+
+            if (realTime) {
+                // 按绝对时间推进，睡眠误差不会累积
+                next += std::chrono::microseconds((int64_t)frames * 1000000 / format.sampleRate);
+                std::this_thread::sleep_until(next);
+            }
+        }
+    }
+
     void AudioCapture::Stop() {
         if (!m_IsRunning) return;
 
+        if (m_Feeder.joinable()) {
+            m_IsRunning = false;
+            m_Feeder.join();
+            m_Source.reset();
+        }
         if (m_pDevice) {
             ma_device_stop(m_pDevice);
             ma_device_uninit(m_pDevice);
@@ -88,24 +173,19 @@ namespace Netease {
             m_pDevice = nullptr;
         }
         m_IsRunning = false;
+
+        auto latency = m_CallbackLatency.Read();
+        if (latency.total > 0) {
+            LOG_INFO("音频回调耗时: " << latency.total << " 次, 平均 " << latency.MeanNs() / 1000.0
+                     << "us, p99 <= " << latency.PercentileNs(0.99) / 1000.0
+                     << "us, 最大 " << latency.maxNs / 1000.0 << "us");
+        }
     }
 
     std::vector<float> AudioCapture::GetSamples(size_t count) {
-        std::vector<float> samples;
-        std::lock_guard<std::mutex> lock(m_BufferMutex);
-        
-        size_t available = m_Buffer.size();
-        size_t toCopy = (std::min)(count, available);
-        
-        if (toCopy > 0) {
-            samples.assign(m_Buffer.end() - toCopy, m_Buffer.end());
-        }
-        
-        // 如果不足，填充零
-        if (samples.size() < count) {
-            samples.insert(samples.begin(), count - samples.size(), 0.0f);
-        }
-        
+        // 不足时开头填充零
+        std::vector<float> samples(count);
+        ReadLatest(samples);
         return samples;
     }
 
@@ -2,9 +2,12 @@
 #define AUDIO_CAPTURE_H
 
 #include <vector>
-#include <deque>
-#include <mutex>
+#include <span>
 #include <atomic>
+#include <memory>
+#include <thread>
+#include "SpscRing.h"
+#include "SampleSource.h"
 
 // 前向声明 miniaudio 生成实现
 extern "C" {
@@ -19,25 +22,61 @@ namespace Netease {
             return instance;
         }
 
+        // WASAPI 回环采集
         bool Start();
+
+        // v0.1.4: 从文件 / 合成信号等来源采集，写入同一个环形缓冲区
+        // realTime = true 时按采样率节拍送入（与回环一致），否则尽快送完
+        bool Start(std::unique_ptr<SampleSource> source, bool realTime = true);
+
         void Stop();
 
         // 获取最新的音频采样数据 (为了性能，返回原始 float 数据)
         std::vector<float> GetSamples(size_t count);
 
+        // v0.1.4: 零拷贝版本，把最新的 out.size() 个样本写入调用方缓冲区（不足时开头补 0）
+        // 返回实际来自采集数据的样本数
+        size_t ReadLatest(std::span<float> out) const { return m_Ring.ReadLatest(out.data(), out.size()); }
+
+        // v0.1.4: 单声道采集流（供 AnalysisThread 按固定步长消费）
+        const SpscRing<float>& Ring() const { return m_Ring; }
+
+        // v0.1.4: 分声道采集（立体声频谱分析），默认关闭以省去一次分声道写入
+        // 开启后第 0 / 1 声道分别写入 ChannelRing(0) / ChannelRing(1)；单声道来源两侧相同
+        void SetChannelCapture(bool enabled) { m_ChannelCapture.store(enabled, std::memory_order_relaxed); }
+        bool IsChannelCapture() const { return m_ChannelCapture.load(std::memory_order_relaxed); }
+        const SpscRing<float>& ChannelRing(int channel) const { return channel == 0 ? m_LeftRing : m_RightRing; }
+
+        // v0.1.4: 当前输入的实际编码与声道数（设备协商结果或来源格式）
+        SampleFormat InputFormat() const { return m_InputFormat; }
+        int InputChannels() const { return m_InputChannels; }
+
+        // v0.1.4: 音频回调耗时分布（纳秒）
+        LatencyHistogram::Snapshot GetCallbackLatency() const { return m_CallbackLatency.Read(); }
+
     private:
         AudioCapture();
         ~AudioCapture();
 
         static void DataCallback(ma_device* pDevice, void* pOutput, const void* pInput, unsigned int frameCount);
-        void OnDataInternal(const float* pInput, unsigned int frameCount);
+        void OnDataInternal(const void* pInput, unsigned int frameCount);
+        void FeedLoop(bool realTime);
+
+        // v0.1.4: 回调线程整块写入、UI 线程读取快照，两侧都不加锁
+        static constexpr size_t RING_CAPACITY = 16384;
+        static constexpr size_t FEED_FRAMES = 480;    // 非设备来源每次送入 10ms @ 48kHz
 
         ma_device* m_pDevice = nullptr;
-        std::deque<float> m_Buffer;  // 使用 deque 以获得 O(1) 的头部删除性能
-        std::mutex m_BufferMutex;
+        std::unique_ptr<SampleSource> m_Source;       // v0.1.4: 非设备来源及其送入线程
+        std::thread m_Feeder;
+        SpscRing<float> m_Ring{RING_CAPACITY};
+        SpscRing<float> m_LeftRing{RING_CAPACITY};
+        SpscRing<float> m_RightRing{RING_CAPACITY};
+        std::atomic<bool> m_ChannelCapture{false};
+        SampleFormat m_InputFormat = SampleFormat::F32;  // 启动前写入，回调线程只读
+        int m_InputChannels = 2;
+        LatencyHistogram m_CallbackLatency;
         std::atomic<bool> m_IsRunning{false};
-        
-        static constexpr size_t BUFFER_SIZE = 4096;
     };
 }
 
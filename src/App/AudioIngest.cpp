@@ -0,0 +1,545 @@
+/**
+ * AudioIngest.cpp - 采集数据接入内核实现
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ */
+
+#include "AudioIngest.h"
+#include "CpuFeatures.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace Netease {
+
+size_t BytesPerSample(SampleFormat format) {
+    switch (format) {
+        case SampleFormat::S16: return 2;
+        case SampleFormat::S24: return 3;
+        default: return 4;
+    }
+}
+
+namespace Ingest {
+
+namespace {
+
+constexpr float S16_SCALE = 1.0f / 32768.0f;
+constexpr float S24_SCALE = 1.0f / 8388608.0f;
+constexpr float S32_SCALE = 1.0f / 2147483648.0f;
+
+// ============================================================================
+// 标量内核
+// ============================================================================
+
+void DecodeS16Scalar(const uint8_t* in, float* out, size_t count) {
+    for (size_t i = 0; i < count; i++, in += 2) {
+        out[i] = (float)(int16_t)(in[0] | (in[1] << 8)) * S16_SCALE;
+    }
+}
+
+void DecodeS24Scalar(const uint8_t* in, float* out, size_t count) {
+    for (size_t i = 0; i < count; i++, in += 3) {
+        int32_t v = (int32_t)(((uint32_t)in[0] << 8) | ((uint32_t)in[1] << 16) | ((uint32_t)in[2] << 24)) >> 8;
+        out[i] = (float)v * S24_SCALE;
+    }
+}
+
+void DecodeS32Scalar(const uint8_t* in, float* out, size_t count) {
+    for (size_t i = 0; i < count; i++, in += 4) {
+        uint32_t u = (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+        out[i] = (float)(int32_t)u * S32_SCALE;
+    }
+}
+
+void DownmixRange(const float* in, int channels, size_t begin, size_t end, float* mono) {
+    const float scale = 1.0f / (float)channels;
+    for (size_t i = begin; i < end; i++) {
+        const float* frame = in + i * channels;
+        float sum = 0;
+        for (int c = 0; c < channels; c++) sum += frame[c];
+        mono[i] = sum * scale;
+    }
+}
+
+void DeinterleaveRange(const float* in, int channels, size_t begin, size_t end, float* const* planes) {
+    for (size_t i = begin; i < end; i++) {
+        const float* frame = in + i * channels;
+        for (int c = 0; c < channels; c++) planes[c][i] = frame[c];
+    }
+}
+
+template <int CHANNELS>
+void DownmixScalar(const float* in, size_t frames, float* mono) {
+    DownmixRange(in, CHANNELS, 0, frames, mono);
+}
+
+template <int CHANNELS>
+void DeinterleaveScalar(const float* in, size_t frames, float* const* planes) {
+    DeinterleaveRange(in, CHANNELS, 0, frames, planes);
+}
+
+#if defined(NETEASE_ARCH_X86)
+
+// ============================================================================
+// SSE2 内核 (4 路)
+// ============================================================================
+
+NETEASE_TARGET_SSE2 void DecodeS16SSE2(const uint8_t* in, float* out, size_t count) {
+    const __m128 scale = _mm_set1_ps(S16_SCALE);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + i * 2));
+        // 放到 32 位高半部分再算术右移，完成符号扩展
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(_mm_setzero_si128(), v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(_mm_setzero_si128(), v), 16);
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    DecodeS16Scalar(in + i * 2, out + i, count - i);
+}
+
+NETEASE_TARGET_SSE2 void DecodeS32SSE2(const uint8_t* in, float* out, size_t count) {
+    const __m128 scale = _mm_set1_ps(S32_SCALE);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(in + i * 4));
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+    }
+    DecodeS32Scalar(in + i * 4, out + i, count - i);
+}
+
+NETEASE_TARGET_SSE2 void Downmix2SSE2(const float* in, size_t frames, float* mono) {
+    const __m128 half = _mm_set1_ps(0.5f);
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        __m128 a = _mm_loadu_ps(in + i * 2);
+        __m128 b = _mm_loadu_ps(in + i * 2 + 4);
+        __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(mono + i, _mm_mul_ps(_mm_add_ps(left, right), half));
+    }
+    DownmixRange(in, 2, i, frames, mono);
+}
+
+/**
+ * 6 / 8 声道：每帧先把高位声道加到前 4 个声道上，
+ * 4 帧转置后逐行相加即得到 4 个帧和
+ */
+template <int CHANNELS>
+NETEASE_TARGET_SSE2 inline __m128 FrameQuadSSE2(const float* frame) {
+    __m128 lo = _mm_loadu_ps(frame);
+    __m128 hi = CHANNELS == 8 ? _mm_loadu_ps(frame + 4)
+                              : _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(frame + 4));
+    return _mm_add_ps(lo, hi);
+}
+
+template <int CHANNELS>
+NETEASE_TARGET_SSE2 void DownmixWideSSE2(const float* in, size_t frames, float* mono) {
+    const __m128 scale = _mm_set1_ps(1.0f / CHANNELS);
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        const float* p = in + i * CHANNELS;
+        __m128 s0 = FrameQuadSSE2<CHANNELS>(p);
+        __m128 s1 = FrameQuadSSE2<CHANNELS>(p + CHANNELS);
+        __m128 s2 = FrameQuadSSE2<CHANNELS>(p + CHANNELS * 2);
+        __m128 s3 = FrameQuadSSE2<CHANNELS>(p + CHANNELS * 3);
+        _MM_TRANSPOSE4_PS(s0, s1, s2, s3);
+        __m128 sum = _mm_add_ps(_mm_add_ps(s0, s1), _mm_add_ps(s2, s3));
+        _mm_storeu_ps(mono + i, _mm_mul_ps(sum, scale));
+    }
+    DownmixRange(in, CHANNELS, i, frames, mono);
+}
+
+NETEASE_TARGET_SSE2 void Deinterleave2SSE2(const float* in, size_t frames, float* const* planes) {
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        __m128 a = _mm_loadu_ps(in + i * 2);
+        __m128 b = _mm_loadu_ps(in + i * 2 + 4);
+        _mm_storeu_ps(planes[0] + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(planes[1] + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+    DeinterleaveRange(in, 2, i, frames, planes);
+}
+
+// 4 帧 × 4 声道转置：行 = 帧，列 = 声道
+template <int CHANNELS>
+NETEASE_TARGET_SSE2 void DeinterleaveWideSSE2(const float* in, size_t frames, float* const* planes) {
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        const float* p = in + i * CHANNELS;
+        __m128 a0 = _mm_loadu_ps(p);
+        __m128 a1 = _mm_loadu_ps(p + CHANNELS);
+        __m128 a2 = _mm_loadu_ps(p + CHANNELS * 2);
+        __m128 a3 = _mm_loadu_ps(p + CHANNELS * 3);
+        _MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+        _mm_storeu_ps(planes[0] + i, a0);
+        _mm_storeu_ps(planes[1] + i, a1);
+        _mm_storeu_ps(planes[2] + i, a2);
+        _mm_storeu_ps(planes[3] + i, a3);
+
+        if (CHANNELS == 8) {
+            __m128 b0 = _mm_loadu_ps(p + 4);
+            __m128 b1 = _mm_loadu_ps(p + 4 + CHANNELS);
+            __m128 b2 = _mm_loadu_ps(p + 4 + CHANNELS * 2);
+            __m128 b3 = _mm_loadu_ps(p + 4 + CHANNELS * 3);
+            _MM_TRANSPOSE4_PS(b0, b1, b2, b3);
+            _mm_storeu_ps(planes[4] + i, b0);
+            _mm_storeu_ps(planes[5] + i, b1);
+            _mm_storeu_ps(planes[6] + i, b2);
+            _mm_storeu_ps(planes[7] + i, b3);
+        } else {
+            // 6 声道：每帧只剩 2 个，转置后取前两行
+            __m128 b0 = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(p + 4));
+            __m128 b1 = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(p + 4 + CHANNELS));
+            __m128 b2 = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(p + 4 + CHANNELS * 2));
+            __m128 b3 = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)(p + 4 + CHANNELS * 3));
+            _MM_TRANSPOSE4_PS(b0, b1, b2, b3);
+            _mm_storeu_ps(planes[4] + i, b0);
+            _mm_storeu_ps(planes[5] + i, b1);
+        }
+    }
+    DeinterleaveRange(in, CHANNELS, i, frames, planes);
+}
+
+// ============================================================================
+// AVX2 内核 (8 路)
+// ============================================================================
+
+NETEASE_TARGET_AVX2 void DecodeS16AVX2(const uint8_t* in, float* out, size_t count) {
+    const __m256 scale = _mm256_set1_ps(S16_SCALE);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(in + i * 2)));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    _mm256_zeroupper();
+    DecodeS16Scalar(in + i * 2, out + i, count - i);
+}
+
+NETEASE_TARGET_AVX2 void DecodeS24AVX2(const uint8_t* in, float* out, size_t count) {
+    const __m256 scale = _mm256_set1_ps(S24_SCALE);
+    // 每 3 字节放到 32 位的高 3 字节，再算术右移 8 位
+    const __m256i shuffle = _mm256_setr_epi8(
+        -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+        -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+    size_t i = 0;
+    // 第二次 16 字节加载从 12 字节处开始，会多读 4 字节：最后几个样本留给标量
+    for (; i + 8 <= count && (i + 8) * 3 + 4 <= count * 3; i += 8) {
+        const uint8_t* p = in + i * 3;
+        __m256i bytes = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)p)),
+            _mm_loadu_si128((const __m128i*)(p + 12)), 1);
+        __m256i v = _mm256_srai_epi32(_mm256_shuffle_epi8(bytes, shuffle), 8);
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    _mm256_zeroupper();
+    DecodeS24Scalar(in + i * 3, out + i, count - i);
+}
+
+NETEASE_TARGET_AVX2 void DecodeS32AVX2(const uint8_t* in, float* out, size_t count) {
+    const __m256 scale = _mm256_set1_ps(S32_SCALE);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(in + i * 4));
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    _mm256_zeroupper();
+    DecodeS32Scalar(in + i * 4, out + i, count - i);
+}
+
+// 水平加法在 128 位通道内进行，结果按 64 位块 [0 2 1 3] 排列：换回帧顺序
+NETEASE_TARGET_AVX2 inline __m256 FixLaneOrder(__m256 v) {
+    return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(v), _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+NETEASE_TARGET_AVX2 void Downmix2AVX2(const float* in, size_t frames, float* mono) {
+    const __m256 half = _mm256_set1_ps(0.5f);
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        __m256 a = _mm256_loadu_ps(in + i * 2);
+        __m256 b = _mm256_loadu_ps(in + i * 2 + 8);
+        _mm256_storeu_ps(mono + i, _mm256_mul_ps(FixLaneOrder(_mm256_hadd_ps(a, b)), half));
+    }
+    _mm256_zeroupper();
+    DownmixRange(in, 2, i, frames, mono);
+}
+
+template <int CHANNELS>
+NETEASE_TARGET_AVX2 inline __m256 LoadFrameAVX2(const float* frame, __m256i mask) {
+    return CHANNELS == 8 ? _mm256_loadu_ps(frame) : _mm256_maskload_ps(frame, mask);
+}
+
+/**
+ * 8 帧一组的三级水平加法树：
+ *   hadd(f0, f1) → 每帧两两求和；再 hadd 一次 → 每个通道内 4 个声道和；
+ *   两个 128 位通道分别是低 4 / 高 4 声道，交叉相加即为 8 个帧和
+ * 6 声道用掩码加载（高 2 个元素为 0，不访问越界内存）
+ */
+template <int CHANNELS>
+NETEASE_TARGET_AVX2 void DownmixWideAVX2(const float* in, size_t frames, float* mono) {
+    const __m256 scale = _mm256_set1_ps(1.0f / CHANNELS);
+    const __m256i mask = _mm256_setr_epi32(-1, -1, -1, -1, -1, -1, 0, 0);
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        const float* p = in + i * CHANNELS;
+        __m256 h01 = _mm256_hadd_ps(LoadFrameAVX2<CHANNELS>(p, mask), LoadFrameAVX2<CHANNELS>(p + CHANNELS, mask));
+        __m256 h23 = _mm256_hadd_ps(LoadFrameAVX2<CHANNELS>(p + CHANNELS * 2, mask),
+                                    LoadFrameAVX2<CHANNELS>(p + CHANNELS * 3, mask));
+        __m256 h45 = _mm256_hadd_ps(LoadFrameAVX2<CHANNELS>(p + CHANNELS * 4, mask),
+                                    LoadFrameAVX2<CHANNELS>(p + CHANNELS * 5, mask));
+        __m256 h67 = _mm256_hadd_ps(LoadFrameAVX2<CHANNELS>(p + CHANNELS * 6, mask),
+                                    LoadFrameAVX2<CHANNELS>(p + CHANNELS * 7, mask));
+        __m256 g0 = _mm256_hadd_ps(h01, h23);
+        __m256 g1 = _mm256_hadd_ps(h45, h67);
+        __m256 low = _mm256_permute2f128_ps(g0, g1, 0x20);
+        __m256 high = _mm256_permute2f128_ps(g0, g1, 0x31);
+        _mm256_storeu_ps(mono + i, _mm256_mul_ps(_mm256_add_ps(low, high), scale));
+    }
+    _mm256_zeroupper();
+    DownmixRange(in, CHANNELS, i, frames, mono);
+}
+
+NETEASE_TARGET_AVX2 void Deinterleave2AVX2(const float* in, size_t frames, float* const* planes) {
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8) {
+        __m256 a = _mm256_loadu_ps(in + i * 2);
+        __m256 b = _mm256_loadu_ps(in + i * 2 + 8);
+        _mm256_storeu_ps(planes[0] + i, FixLaneOrder(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))));
+        _mm256_storeu_ps(planes[1] + i, FixLaneOrder(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))));
+    }
+    _mm256_zeroupper();
+    DeinterleaveRange(in, 2, i, frames, planes);
+}
+
+#endif // NETEASE_ARCH_X86
+
+#if defined(NETEASE_ARCH_NEON)
+
+// ============================================================================
+// NEON 内核 (4 路)
+// ============================================================================
+
+void DecodeS16NEON(const uint8_t* in, float* out, size_t count) {
+    const float32x4_t scale = vdupq_n_f32(S16_SCALE);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t v = vld1q_s16((const int16_t*)(in + i * 2));
+        vst1q_f32(out + i, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+        vst1q_f32(out + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+    }
+    DecodeS16Scalar(in + i * 2, out + i, count - i);
+}
+
+void DecodeS32NEON(const uint8_t* in, float* out, size_t count) {
+    const float32x4_t scale = vdupq_n_f32(S32_SCALE);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(out + i, vmulq_f32(vcvtq_f32_s32(vld1q_s32((const int32_t*)(in + i * 4))), scale));
+    }
+    DecodeS32Scalar(in + i * 4, out + i, count - i);
+}
+
+void Downmix2NEON(const float* in, size_t frames, float* mono) {
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        float32x4x2_t lr = vld2q_f32(in + i * 2);
+        vst1q_f32(mono + i, vmulq_f32(vaddq_f32(lr.val[0], lr.val[1]), half));
+    }
+    DownmixRange(in, 2, i, frames, mono);
+}
+
+void Deinterleave2NEON(const float* in, size_t frames, float* const* planes) {
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4) {
+        float32x4x2_t lr = vld2q_f32(in + i * 2);
+        vst1q_f32(planes[0] + i, lr.val[0]);
+        vst1q_f32(planes[1] + i, lr.val[1]);
+    }
+    DeinterleaveRange(in, 2, i, frames, planes);
+}
+
+#endif // NETEASE_ARCH_NEON
+
+// ============================================================================
+// 运行时分派
+// ============================================================================
+
+using DecodeFn = void (*)(const uint8_t*, float*, size_t);
+using DownmixFn = void (*)(const float*, size_t, float*);
+using DeinterleaveFn = void (*)(const float*, size_t, float* const*);
+
+struct KernelTable {
+    DecodeFn decodeS16;
+    DecodeFn decodeS24;
+    DecodeFn decodeS32;
+    DownmixFn downmix2;
+    DownmixFn downmix6;
+    DownmixFn downmix8;
+    DeinterleaveFn deinterleave2;
+    DeinterleaveFn deinterleave6;
+    DeinterleaveFn deinterleave8;
+};
+
+KernelTable TableFor(Kernel kernel) {
+    switch (kernel) {
+#if defined(NETEASE_ARCH_X86)
+        case Kernel::AVX2:
+            return { &DecodeS16AVX2, &DecodeS24AVX2, &DecodeS32AVX2,
+                     &Downmix2AVX2, &DownmixWideAVX2<6>, &DownmixWideAVX2<8>,
+                     &Deinterleave2AVX2, &DeinterleaveWideSSE2<6>, &DeinterleaveWideSSE2<8> };
+        case Kernel::SSE2:
+            return { &DecodeS16SSE2, &DecodeS24Scalar, &DecodeS32SSE2,
+                     &Downmix2SSE2, &DownmixWideSSE2<6>, &DownmixWideSSE2<8>,
+                     &Deinterleave2SSE2, &DeinterleaveWideSSE2<6>, &DeinterleaveWideSSE2<8> };
+#endif
+#if defined(NETEASE_ARCH_NEON)
+        case Kernel::NEON:
+            return { &DecodeS16NEON, &DecodeS24Scalar, &DecodeS32NEON,
+                     &Downmix2NEON, &DownmixScalar<6>, &DownmixScalar<8>,
+                     &Deinterleave2NEON, &DeinterleaveScalar<6>, &DeinterleaveScalar<8> };
+#endif
+        default:
+            return { &DecodeS16Scalar, &DecodeS24Scalar, &DecodeS32Scalar,
+                     &DownmixScalar<2>, &DownmixScalar<6>, &DownmixScalar<8>,
+                     &DeinterleaveScalar<2>, &DeinterleaveScalar<6>, &DeinterleaveScalar<8> };
+    }
+}
+
+bool IsSupported(Kernel kernel) {
+    const auto& cpu = Cpu::Get();
+    switch (kernel) {
+        case Kernel::Scalar: return true;
+#if defined(NETEASE_ARCH_X86)
+        case Kernel::SSE2: return cpu.sse2;
+        case Kernel::AVX2: return cpu.avx2;
+#endif
+#if defined(NETEASE_ARCH_NEON)
+        case Kernel::NEON: return cpu.neon;
+#endif
+        default: return false;
+    }
+}
+
+Kernel BestKernel() {
+    if (IsSupported(Kernel::AVX2)) return Kernel::AVX2;
+    if (IsSupported(Kernel::SSE2)) return Kernel::SSE2;
+    if (IsSupported(Kernel::NEON)) return Kernel::NEON;
+    return Kernel::Scalar;
+}
+
+std::atomic<Kernel> g_Kernel{ BestKernel() };
+
+} // namespace
+
+bool SetKernel(Kernel kernel) {
+    if (kernel == Kernel::Auto) kernel = BestKernel();
+    if (!IsSupported(kernel)) return false;
+    g_Kernel.store(kernel);
+    return true;
+}
+
+Kernel GetKernel() {
+    return g_Kernel.load();
+}
+
+void Decode(const void* input, SampleFormat format, size_t count, float* out) {
+    const uint8_t* bytes = (const uint8_t*)input;
+    const KernelTable table = TableFor(g_Kernel.load());
+    switch (format) {
+        case SampleFormat::S16: table.decodeS16(bytes, out, count); break;
+        case SampleFormat::S24: table.decodeS24(bytes, out, count); break;
+        case SampleFormat::S32: table.decodeS32(bytes, out, count); break;
+        case SampleFormat::F32: std::memcpy(out, input, count * sizeof(float)); break;
+    }
+}
+
+void Downmix(const float* interleaved, int channels, size_t frames, float* mono) {
+    const KernelTable table = TableFor(g_Kernel.load());
+    switch (channels) {
+        case 1: std::memcpy(mono, interleaved, frames * sizeof(float)); break;
+        case 2: table.downmix2(interleaved, frames, mono); break;
+        case 6: table.downmix6(interleaved, frames, mono); break;
+        case 8: table.downmix8(interleaved, frames, mono); break;
+        default: DownmixRange(interleaved, channels, 0, frames, mono); break;
+    }
+}
+
+void Deinterleave(const float* interleaved, int channels, size_t frames, float* const* planes) {
+    const KernelTable table = TableFor(g_Kernel.load());
+    switch (channels) {
+        case 1: std::memcpy(planes[0], interleaved, frames * sizeof(float)); break;
+        case 2: table.deinterleave2(interleaved, frames, planes); break;
+        case 6: table.deinterleave6(interleaved, frames, planes); break;
+        case 8: table.deinterleave8(interleaved, frames, planes); break;
+        default: DeinterleaveRange(interleaved, channels, 0, frames, planes); break;
+    }
+}
+
+} // namespace Ingest
+
+// ============================================================================
+// 写入环形缓冲区
+// ============================================================================
+
+namespace {
+
+// 栈上中转区：解码后的交错样本最多 STAGING 个（8KB），每块帧数 = STAGING / 声道数
+constexpr size_t STAGING = 2048;
+constexpr size_t MAX_CHUNK = 256;
+
+} // namespace
+
+void WriteMono(SpscRing<float>& ring, const void* input, SampleFormat format, int channels, size_t frames) {
+    if (channels < 1 || channels > Ingest::MAX_CHANNELS) return;
+
+    // 单声道 float：无需中转
+    if (format == SampleFormat::F32 && channels == 1) {
+        ring.Write((const float*)input, frames);
+        return;
+    }
+
+    const size_t frameBytes = BytesPerSample(format) * channels;
+    const size_t chunk = (std::min)(MAX_CHUNK, STAGING / channels);
+    float decoded[STAGING];
+    float mono[MAX_CHUNK];
+    const uint8_t* bytes = (const uint8_t*)input;
+    for (size_t offset = 0; offset < frames; offset += chunk) {
+        size_t count = (std::min)(chunk, frames - offset);
+        const float* interleaved = (const float*)(bytes + offset * frameBytes);
+        if (format != SampleFormat::F32) {
+            Ingest::Decode(bytes + offset * frameBytes, format, count * channels, decoded);
+            interleaved = decoded;
+        }
+        Ingest::Downmix(interleaved, channels, count, mono);
+        ring.Write(mono, count);
+    }
+}
+
+void WriteStereo(SpscRing<float>& left, SpscRing<float>& right,
+                 const void* input, SampleFormat format, int channels, size_t frames) {
+    if (channels < 1 || channels > Ingest::MAX_CHANNELS) return;
+
+    const size_t frameBytes = BytesPerSample(format) * channels;
+    const size_t chunk = (std::min)(MAX_CHUNK, STAGING / channels);
+    float decoded[STAGING];
+    float planeData[STAGING];
+    float* planes[Ingest::MAX_CHANNELS];
+    for (int c = 0; c < channels; c++) planes[c] = planeData + c * chunk;
+
+    const uint8_t* bytes = (const uint8_t*)input;
+    for (size_t offset = 0; offset < frames; offset += chunk) {
+        size_t count = (std::min)(chunk, frames - offset);
+        const float* interleaved = (const float*)(bytes + offset * frameBytes);
+        if (format != SampleFormat::F32) {
+            Ingest::Decode(bytes + offset * frameBytes, format, count * channels, decoded);
+            interleaved = decoded;
+        }
+        Ingest::Deinterleave(interleaved, channels, count, planes);
+        left.Write(planes[0], count);
+        right.Write(planes[channels > 1 ? 1 : 0], count);
+    }
+}
+
+} // namespace Netease
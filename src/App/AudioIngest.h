@@ -0,0 +1,93 @@
+#ifndef AUDIO_INGEST_H
+#define AUDIO_INGEST_H
+
+/**
+ * AudioIngest.h - 采集数据接入：解码 / 下混 / 分声道 (v0.1.4)
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ *
+ * 设备回调与离线来源交来的是交错多声道、任意编码的样本：
+ * - 解码内核：s16 / s24 / s32 → float
+ * - 下混与分声道内核：1 / 2 / 6 / 8 声道有专用 SIMD 路径，其他声道数走通用标量
+ * - SSE2 (4 路) / AVX2 (8 路) / NEON (4 路)，运行时根据 CPUID 选择
+ * 写入环形缓冲区时按块在栈上中转，不分配。
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include "SpscRing.h"
+
+namespace Netease {
+    // 采样格式（文件与设备的原始编码，小端）
+    enum class SampleFormat {
+        S16,      // 16 位有符号整数
+        S24,      // 24 位有符号整数（3 字节紧凑存放）
+        S32,      // 32 位有符号整数
+        F32       // 32 位浮点
+    };
+
+    size_t BytesPerSample(SampleFormat format);
+
+    namespace Ingest {
+        /**
+         * 内核类型
+         */
+        enum class Kernel {
+            Auto,     // 自动选择当前 CPU 支持的最快内核
+            Scalar,
+            SSE2,     // 4 路（s24 解码无 pshufb，走标量）
+            AVX2,     // 8 路（6/8 声道分声道复用 SSE2）
+            NEON      // 4 路（只有 2 声道与 s16/s32 解码有专用路径）
+        };
+
+        /**
+         * 强制使用指定内核（用于测试与基准）
+         *
+         * @return CPU 不支持该内核时返回 false，且不做修改
+         */
+        bool SetKernel(Kernel kernel);
+
+        /**
+         * 当前生效的内核
+         */
+        Kernel GetKernel();
+
+        // 单次接入支持的最大声道数
+        constexpr int MAX_CHANNELS = 32;
+
+        /**
+         * 解码 count 个样本为 [-1, 1) 的 float（F32 为直接复制）
+         */
+        void Decode(const void* input, SampleFormat format, size_t count, float* out);
+
+        /**
+         * 交错 → 单声道（各声道平均）
+         */
+        void Downmix(const float* interleaved, int channels, size_t frames, float* mono);
+
+        /**
+         * 交错 → 分声道平面：planes[c] 长度 frames，c < channels
+         */
+        void Deinterleave(const float* interleaved, int channels, size_t frames, float* const* planes);
+    }
+
+    /**
+     * 任意编码的交错样本 → 单声道，分块写入环形缓冲区
+     * 采集回调与离线输入共用同一条写入路径；只用栈上缓冲区，不分配。
+     * channels 超出 [1, Ingest::MAX_CHANNELS] 时忽略本块。
+     */
+    void WriteMono(SpscRing<float>& ring, const void* input, SampleFormat format, int channels, size_t frames);
+
+    inline void WriteMono(SpscRing<float>& ring, const float* interleaved, size_t frames, int channels) {
+        WriteMono(ring, interleaved, SampleFormat::F32, channels, frames);
+    }
+
+    /**
+     * 分声道写入（立体声频谱分析）：第 0 / 1 声道分别写入 left / right
+     * 单声道输入时两侧相同；多声道时取前左 / 前右
+     */
+    void WriteStereo(SpscRing<float>& left, SpscRing<float>& right,
+                     const void* input, SampleFormat format, int channels, size_t frames);
+}
+
+#endif // AUDIO_INGEST_H
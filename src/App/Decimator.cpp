@@ -0,0 +1,111 @@
+/**
+ * Decimator.cpp - 流式多相降采样器实现
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ */
+
+#include "Decimator.h"
+#include "SpectrumKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace Netease {
+
+namespace {
+
+constexpr double KAISER_BETA = 8.0;    // 阻带约 -80dB
+
+// 第一类零阶修正贝塞尔函数（级数展开）
+double BesselI0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+/**
+ * Kaiser 窗 sinc 低通，cutoff 为截止频率（周期 / 输入样本），直流增益归一化为 1
+ */
+std::vector<float> DesignLowPass(size_t taps, double cutoff) {
+    std::vector<double> h(taps);
+    const double center = (double)(taps - 1) / 2.0;
+    const double norm = BesselI0(KAISER_BETA);
+    double sum = 0;
+    for (size_t i = 0; i < taps; i++) {
+        double t = (double)i - center;
+        double sinc = t == 0 ? 2.0 * cutoff : std::sin(2.0 * M_PI * cutoff * t) / (M_PI * t);
+        double r = t / center;
+        double window = BesselI0(KAISER_BETA * std::sqrt((std::max)(0.0, 1.0 - r * r))) / norm;
+        h[i] = sinc * window;
+        sum += h[i];
+    }
+
+    std::vector<float> out(taps);
+    for (size_t i = 0; i < taps; i++) out[i] = (float)(h[i] / sum);
+    return out;
+}
+
+} // namespace
+
+Decimator::Decimator(int factor, size_t tapsPerPhase)
+    : m_Factor((std::max)(factor, 1))
+{
+    if (m_Factor > 1) {
+        // 抽头数补齐到 BandMap::PAD 的倍数，内积没有标量尾部
+        const size_t pad = Spectrum::BandMap::PAD;
+        const size_t taps = ((std::max)(tapsPerPhase, (size_t)2) * (size_t)m_Factor + pad - 1) / pad * pad;
+        m_Taps = DesignLowPass(taps, 0.9 * 0.5 / m_Factor);
+        m_Buffer.assign(taps - 1 + CHUNK, 0.0f);
+    }
+    Reset();
+}
+
+void Decimator::Reset() {
+    if (m_Taps.empty()) return;
+    std::fill(m_Buffer.begin(), m_Buffer.end(), 0.0f);
+    m_Next = m_Taps.size() - 1 + (size_t)m_Factor - 1;
+}
+
+size_t Decimator::Process(const float* in, size_t count, float* out) {
+    if (m_Factor <= 1) {
+        std::memcpy(out, in, count * sizeof(float));
+        return count;
+    }
+
+    const size_t taps = m_Taps.size();
+    const size_t history = taps - 1;
+    const uint32_t first = 0;
+    const uint32_t offsets[2] = { 0, (uint32_t)taps };
+    size_t produced = 0;
+
+    while (count > 0) {
+        size_t take = (std::min)(CHUNK, count);
+        std::memcpy(m_Buffer.data() + history, in, take * sizeof(float));
+        const size_t end = history + take;
+
+        // 系数对称，窗口按 旧 → 新 顺序直接与系数相乘；
+        // 内积即单个频带的加权求和，复用 BandSums 的 SIMD 内核
+        for (; m_Next < end; m_Next += (size_t)m_Factor) {
+            const float* x = m_Buffer.data() + m_Next - history;
+            Spectrum::BandSums(x, &first, offsets, m_Taps.data(), 1, out + produced);
+            produced++;
+        }
+
+        // 保留最后 N-1 个样本作为下一块的历史
+        std::memmove(m_Buffer.data(), m_Buffer.data() + take, history * sizeof(float));
+        m_Next -= take;
+        in += take;
+        count -= take;
+    }
+    return produced;
+}
+
+} // namespace Netease
@@ -0,0 +1,52 @@
+#ifndef DECIMATOR_H
+#define DECIMATOR_H
+
+#include <vector>
+#include <cstddef>
+
+namespace Netease {
+    // ============================================================
+    // Decimator - 流式多相降采样器 (v0.1.4)
+    // ============================================================
+    // 抗混叠低通 (Kaiser 窗 sinc，线性相位) + 每 factor 个输入保留一个输出。
+    // 多相实现：滤波器只在输出速率上求值，每个输出一次 N 点内积
+    // （等价于 factor 个子滤波器各自的输出之和），每个输入样本摊到 N / factor 次乘加；
+    // 内积走 Spectrum::BandSums 的 SIMD 内核。
+    //
+    // 截止频率取输出 Nyquist 的 0.9 倍（默认 24 抽头 / 相位，约 -80dB 阻带）：
+    // 通带平坦到约 0.7 × 输出 Nyquist，阻带从约 1.1 × 输出 Nyquist 开始，
+    // 残余混叠只会折叠到 0.9 × 输出 Nyquist 以上。
+    //
+    // 状态跨调用保持，输入可以任意分块；只在构造时分配。
+    class Decimator {
+    public:
+        static constexpr size_t TAPS_PER_PHASE = 24;
+
+        // factor <= 1 时直通
+        explicit Decimator(int factor = 2, size_t tapsPerPhase = TAPS_PER_PHASE);
+
+        int Factor() const { return m_Factor; }
+        size_t TapCount() const { return m_Taps.size(); }
+
+        // 群延迟（输入样本数）
+        double Delay() const { return m_Taps.empty() ? 0.0 : (double)(m_Taps.size() - 1) / 2.0; }
+
+        // 处理 count 个输入样本，输出写入 out（容量至少 MaxOutput(count)），返回输出个数
+        size_t Process(const float* in, size_t count, float* out);
+
+        size_t MaxOutput(size_t count) const { return count / (size_t)m_Factor + 1; }
+
+        // 清空历史（输入流不连续时调用）
+        void Reset();
+
+    private:
+        static constexpr size_t CHUNK = 256;
+
+        int m_Factor = 1;
+        std::vector<float> m_Taps;
+        std::vector<float> m_Buffer;   // [历史 N-1 | 本块输入 CHUNK]
+        size_t m_Next = 0;             // 下一个输出对应的最新输入在 m_Buffer 中的下标
+    };
+}
+
+#endif // DECIMATOR_H
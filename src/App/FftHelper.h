@@ -4,89 +4,297 @@
 #include <vector>
 #include <complex>
 #include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <algorithm>
+#include "SpectrumKernels.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
 namespace Netease {
+    // ============================================================
+    // FftPlan - 固定尺寸的 FFT 计划 (v0.1.4)
+    // ============================================================
+    // 每种尺寸创建一次：位反转表、旋转因子表、Hann 窗表全部预计算，
+    // 之后每帧只在调用方提供的缓冲区上原地迭代（基 4 + 必要时一级基 2），
+    // 不做任何堆分配，也不调用 cos/sin。
+    // 双精度，作为 RealFftPlan 的内层变换；分析路径使用单精度的 Spectrum::RealFftPlanF。
+    class FftPlan {
+    public:
+        FftPlan() = default;
+
+        // size 必须为 2 的幂 (>= 2)，否则计划无效 (Size() == 0)
+        explicit FftPlan(size_t size) {
+            if (size < 2 || (size & (size - 1)) != 0) return;
+            m_Size = size;
+
+            int bits = 0;
+            while (((size_t)1 << bits) < size) bits++;
+            m_Bits = bits;
+            m_BitReverse.resize(size);
+            for (size_t i = 0; i < size; i++) {
+                uint32_t r = 0;
+                for (int b = 0; b < bits; b++) {
+                    r |= (uint32_t)((i >> b) & 1) << (bits - 1 - b);
+                }
+                m_BitReverse[i] = r;
+            }
+
+            // W_N^k = e^(-2πik/N)，k < N/2；子变换长度 m 的因子为 W_N^(k·N/m)
+            m_Twiddles.resize(size / 2);
+            for (size_t k = 0; k < size / 2; k++) {
+                double ang = -2.0 * M_PI * (double)k / (double)size;
+                m_Twiddles[k] = std::complex<double>(cos(ang), sin(ang));
+            }
+
+            m_Window.resize(size);
+            for (size_t i = 0; i < size; i++) {
+                m_Window[i] = 0.5 * (1.0 - cos(2.0 * M_PI * i / (size - 1)));
+            }
+        }
+
+        size_t Size() const { return m_Size; }
+        bool Valid() const { return m_Size != 0; }
+        const std::vector<double>& Window() const { return m_Window; }
+
+        // 原地正向 FFT，data 长度为 Size()
+        void Forward(std::complex<double>* data) const {
+            const size_t n = m_Size;
+            if (n == 0) return;
+
+            for (size_t i = 0; i < n; i++) {
+                size_t j = m_BitReverse[i];
+                if (i < j) std::swap(data[i], data[j]);
+            }
+
+            // log2(N) 为奇数时先做一级基 2（长度 2 的蝶形不需要旋转因子）
+            size_t half = 1;
+            if (m_Bits & 1) {
+                for (size_t k = 0; k < n; k += 2) {
+                    std::complex<double> a = data[k];
+                    std::complex<double> b = data[k + 1];
+                    data[k] = a + b;
+                    data[k + 1] = a - b;
+                }
+                half = 2;
+            }
+
+            // 基 4：一次完成长度 2h 与 4h 两级基 2 蝶形
+            for (; half < n; half *= 4) {
+                const size_t block = half * 4;
+                const size_t stride1 = n / (half * 2);  // W_2h^j
+                const size_t stride2 = n / block;       // W_4h^j
+                for (size_t k = 0; k < n; k += block) {
+                    for (size_t j = 0; j < half; j++) {
+                        std::complex<double>* x = data + k + j;
+                        const std::complex<double> w1 = m_Twiddles[j * stride1];
+                        const std::complex<double> w2 = m_Twiddles[j * stride2];
+
+                        std::complex<double> t1 = w1 * x[half];
+                        std::complex<double> t3 = w1 * x[3 * half];
+                        std::complex<double> y0 = x[0] + t1;
+                        std::complex<double> y1 = x[0] - t1;
+                        std::complex<double> y2 = (x[2 * half] + t3) * w2;
+                        std::complex<double> y3 = (x[2 * half] - t3) * w2;
+                        // W_4h^(j+h) = -i · W_4h^j
+                        std::complex<double> y3r(y3.imag(), -y3.real());
+
+                        x[0] = y0 + y2;
+                        x[2 * half] = y0 - y2;
+                        x[half] = y1 + y3r;
+                        x[3 * half] = y1 - y3r;
+                    }
+                }
+            }
+        }
+
+        // 加窗 + FFT + 幅值 (|X[k]| / N，只取前 N/2 个)
+        // work 长度为 Size()，magnitudes 长度为 Size() / 2，均由调用方持有
+        void Analyze(const float* samples, std::complex<double>* work, float* magnitudes) const {
+            const size_t n = m_Size;
+            if (n == 0) return;
+            for (size_t i = 0; i < n; i++) {
+                work[i] = std::complex<double>(samples[i] * m_Window[i], 0.0);
+            }
+            Forward(work);
+            for (size_t i = 0; i < n / 2; i++) {
+                magnitudes[i] = (float)std::sqrt(std::norm(work[i])) / (float)n;
+            }
+        }
+
+    private:
+        size_t m_Size = 0;
+        int m_Bits = 0;
+        std::vector<uint32_t> m_BitReverse;
+        std::vector<std::complex<double>> m_Twiddles;
+        std::vector<double> m_Window;
+    };
+
+    // ============================================================
+    // RealFftPlan - 实数输入 FFT (v0.1.4)
+    // ============================================================
+    // 音频采样是实数，频谱满足 X[N-k] = conj(X[k])：
+    // 把 N 个实数打包成 N/2 个复数 z[t] = x[2t] + i·x[2t+1]，
+    // 做一次 N/2 点复数 FFT，再用一轮后处理拆出前 N/2+1 个频点。
+    // 运算量与工作区都只有同尺寸复数 FFT 的一半。
+    // 双精度参考实现：单精度 Spectrum::RealFftPlanF 的精度以它为基准校验。
+    class RealFftPlan {
+    public:
+        RealFftPlan() = default;
+
+        // size 必须为 2 的幂 (>= 4)，否则计划无效 (Size() == 0)
+        explicit RealFftPlan(size_t size) {
+            if (size < 4 || (size & (size - 1)) != 0) return;
+            m_Size = size;
+            m_Half = FftPlan(size / 2);
+
+            // 后处理因子 W_N^k = e^(-2πik/N)，k < N/2
+            m_Twiddles.resize(size / 2);
+            for (size_t k = 0; k < size / 2; k++) {
+                double ang = -2.0 * M_PI * (double)k / (double)size;
+                m_Twiddles[k] = std::complex<double>(cos(ang), sin(ang));
+            }
+
+            m_Window.resize(size);
+            for (size_t i = 0; i < size; i++) {
+                m_Window[i] = 0.5 * (1.0 - cos(2.0 * M_PI * i / (size - 1)));
+            }
+        }
+
+        size_t Size() const { return m_Size; }
+        bool Valid() const { return m_Size != 0; }
+        const std::vector<double>& Window() const { return m_Window; }
+
+        // 实数 FFT：input 长度 Size()，work 长度 Size() / 2，
+        // spectrum 输出前 Size() / 2 + 1 个频点（含 Nyquist）
+        void Forward(const double* input, std::complex<double>* work, std::complex<double>* spectrum) const {
+            const size_t half = m_Size / 2;
+            if (half == 0) return;
+            for (size_t t = 0; t < half; t++) {
+                work[t] = std::complex<double>(input[2 * t], input[2 * t + 1]);
+            }
+            m_Half.Forward(work);
+
+            spectrum[0] = std::complex<double>(work[0].real() + work[0].imag(), 0.0);
+            spectrum[half] = std::complex<double>(work[0].real() - work[0].imag(), 0.0);
+            for (size_t k = 1; k < half; k++) {
+                spectrum[k] = Combine(work, k);
+            }
+        }
+
+        // 加窗 + 实数 FFT + 幅值 (|X[k]| / N，k < N/2)，与 FftPlan::Analyze 输出一致
+        // work 长度为 Size() / 2，magnitudes 长度为 Size() / 2，均由调用方持有
+        void Analyze(const float* samples, std::complex<double>* work, float* magnitudes) const {
+            const size_t half = m_Size / 2;
+            if (half == 0) return;
+            for (size_t t = 0; t < half; t++) {
+                work[t] = std::complex<double>(samples[2 * t] * m_Window[2 * t],
+                                               samples[2 * t + 1] * m_Window[2 * t + 1]);
+            }
+            m_Half.Forward(work);
+
+            const float scale = 1.0f / (float)m_Size;
+            magnitudes[0] = (float)std::abs(work[0].real() + work[0].imag()) * scale;
+            for (size_t k = 1; k < half; k++) {
+                magnitudes[k] = (float)std::sqrt(std::norm(Combine(work, k))) * scale;
+            }
+        }
+
+    private:
+        // X[k] = E[k] + W_N^k·O[k]，其中
+        // E[k] = (Z[k] + conj(Z[N/2-k])) / 2，O[k] = -i·(Z[k] - conj(Z[N/2-k])) / 2
+        std::complex<double> Combine(const std::complex<double>* z, size_t k) const {
+            const std::complex<double> a = z[k];
+            const std::complex<double> b = std::conj(z[m_Size / 2 - k]);
+            const std::complex<double> even = (a + b) * 0.5;
+            const std::complex<double> diff = (a - b) * 0.5;
+            const std::complex<double> odd(diff.imag(), -diff.real());
+            return even + m_Twiddles[k] * odd;
+        }
+
+        size_t m_Size = 0;
+        FftPlan m_Half;
+        std::vector<std::complex<double>> m_Twiddles;
+        std::vector<double> m_Window;
+    };
+
+    // ============================================================
+    // FftWorkspace - 可复用的分析工作区 (v0.1.4)
+    // ============================================================
+    // 计划 + 工作缓冲区；尺寸不变时 Prepare 不做任何分配
+    struct FftWorkspace {
+        Spectrum::RealFftPlanF plan;
+        std::vector<float> workRe;
+        std::vector<float> workIm;
+
+        void Prepare(size_t size) {
+            if (plan.Size() == size) return;
+            plan = Spectrum::RealFftPlanF(size);
+            workRe.assign(size / 2, 0.0f);
+            workIm.assign(size / 2, 0.0f);
+        }
+    };
+
     class FftHelper {
     public:
-        // 执行快速傅里叶变换 (Radix-2 Cooley-Tukey)
-        // input 大小必须为 2 的幂
+        // Hann 窗 + 实数 FFT + 幅值 (|X[k]| / N，k < N/2)
+        // 经 Spectrum::RealFftPlanF（单精度，N/2 点复数 FFT + SIMD 蝶形）计算；input 大小必须为 2 的幂
         static std::vector<float> Analyze(const std::vector<float>& samples) {
             size_t n = samples.size();
             if (n == 0 || (n & (n - 1)) != 0) return {};
 
-            std::vector<std::complex<double>> data(n);
-            // 应用 Hann 窗并转为复数
-            for (size_t i = 0; i < n; i++) {
-                double window = 0.5 * (1.0 - cos(2.0 * M_PI * i / (n - 1)));
-                data[i] = std::complex<double>(samples[i] * window, 0.0);
-            }
+            // v0.1.4: 每个线程缓存一个工作区，尺寸不变时不再重建
+            thread_local FftWorkspace workspace;
+            std::vector<float> magnitudes(n / 2);
+            Analyze(samples, magnitudes, workspace);
+            return magnitudes;
+        }
 
-            ComputeFFT(data);
+        // v0.1.4: 零拷贝版本，结果写入调用方的 magnitudes (长度 >= N/2)
+        // samples 长度必须为 2 的幂；否则返回 false 且不写入
+        static bool Analyze(std::span<const float> samples, std::span<float> magnitudes, FftWorkspace& workspace) {
+            size_t n = samples.size();
+            if (n == 0 || (n & (n - 1)) != 0 || magnitudes.size() < n / 2) return false;
 
-            // 计算幅值 (只取前一半)
-            size_t binCount = n / 2;
-            std::vector<float> magnitudes(binCount);
-            for (size_t i = 0; i < binCount; i++) {
-                magnitudes[i] = (float)std::abs(data[i]) / (float)n;
+            if (n < 4) {
+                // N <= 2 时 Hann 窗全为 0
+                std::fill(magnitudes.begin(), magnitudes.begin() + n / 2, 0.0f);
+                return true;
             }
 
-            return magnitudes;
+            workspace.Prepare(n);
+            workspace.plan.Analyze(samples.data(), workspace.workRe.data(), workspace.workIm.data(), magnitudes.data());
+            return true;
         }
 
         // 将频率桶映射到有限数量的频带 (Bands)
         static std::vector<float> CalculateBands(const std::vector<float>& magnitudes, int bandCount) {
-            if (magnitudes.empty() || bandCount <= 0) return std::vector<float>(bandCount > 0 ? bandCount : 1, 0.0f);
-            
-            std::vector<float> bands(bandCount, 0.0f);
-            int binsPerBand = (int)magnitudes.size() / bandCount;
-            if (binsPerBand <= 0) binsPerBand = 1; // 防止除零
-            
-            for (int i = 0; i < bandCount; i++) {
-                float sum = 0;
-                int start = i * binsPerBand;
-                int actualBins = 0;
-                for (int j = 0; j < binsPerBand && (start + j) < (int)magnitudes.size(); j++) {
-                    sum += magnitudes[start + j];
-                    actualBins++;
-                }
-                bands[i] = (actualBins > 0) ? (sum / actualBins) : 0.0f;
-                
-                // 增强型 Log 增益补偿，低频和高频都给予额外权重
-                float boost = 1.0f + log10f((float)i + 1.0f) * 4.0f;
-                if (i < 3) boost *= 2.5f; // 重低音增强
-                if (i > bandCount - 5) boost *= 3.0f; // 高音爆点增强
-                
-                bands[i] *= boost;
-            }
-            
+            std::vector<float> bands(bandCount > 0 ? bandCount : 1, 0.0f);
+            if (bandCount > 0) CalculateBands(magnitudes, bands);
             return bands;
         }
 
-    private:
-        static void ComputeFFT(std::vector<std::complex<double>>& a) {
-            size_t n = a.size();
-            if (n <= 1) return;
-
-            std::vector<std::complex<double>> a0(n / 2), a1(n / 2);
-            for (size_t i = 0; i * 2 < n; i++) {
-                a0[i] = a[i * 2];
-                a1[i] = a[i * 2 + 1];
+        // v0.1.4: 零拷贝版本，频带数 = bands.size()
+        // 按 48kHz 对数间距映射；映射表每个线程缓存一份，尺寸不变时不再重建
+        static void CalculateBands(std::span<const float> magnitudes, std::span<float> bands) {
+            thread_local Spectrum::BandMap map;
+            if (magnitudes.size() >= 2 && (map.FftSize() != magnitudes.size() * 2 || map.BandCount() != bands.size())) {
+                map = Spectrum::BandMap(magnitudes.size() * 2, (int)bands.size());
             }
+            CalculateBands(magnitudes, bands, map);
+        }
 
-            ComputeFFT(a0);
-            ComputeFFT(a1);
-
-            double ang = 2 * M_PI / n;
-            std::complex<double> w(1), wn(cos(ang), sin(ang));
-            for (size_t i = 0; i * 2 < n; i++) {
-                a[i] = a0[i] + w * a1[i];
-                a[i + n / 2] = a0[i] - w * a1[i];
-                w *= wn;
+        // v0.1.4: 使用预先构建的映射表（三角滤波器组，一次稀疏加权求和）
+        // magnitudes 不足 FftSize()/2 或频带数不符时输出清零
+        static void CalculateBands(std::span<const float> magnitudes, std::span<float> bands, const Spectrum::BandMap& map) {
+            if (!map.Valid() || magnitudes.size() < map.FftSize() / 2 || bands.size() != map.BandCount()) {
+                std::fill(bands.begin(), bands.end(), 0.0f);
+                return;
             }
+            map.Apply(magnitudes.data(), bands.data());
         }
     };
 }
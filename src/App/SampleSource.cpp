@@ -0,0 +1,258 @@
+/**
+ * SampleSource.cpp - 采样来源实现（合成信号 / WAV / 原始 PCM）
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ */
+
+#include "SampleSource.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace Netease {
+
+// ============================================================================
+// SyntheticSource
+// ============================================================================
+
+namespace {
+
+// Am - F - C - G，每个和弦：低音 + 三个和弦音 (Hz)
+const double CHORDS[4][4] = {
+    { 55.00, 220.00, 261.63, 329.63 },
+    { 43.65, 174.61, 220.00, 261.63 },
+    { 65.41, 261.63, 329.63, 392.00 },
+    { 49.00, 196.00, 246.94, 293.66 },
+};
+const float PARTIAL_GAINS[4] = { 0.30f, 0.12f, 0.10f, 0.08f };
+
+constexpr double KICK_HZ = 50.0;
+constexpr double KICK_DECAY_SECONDS = 0.08;
+
+} // namespace
+
+SyntheticSource::SyntheticSource(const SyntheticConfig& config) : m_Config(config) {
+    m_Config.sampleRate = (std::max)(m_Config.sampleRate, 1);
+    m_Config.channels = (std::max)(m_Config.channels, 1);
+    m_Total = m_Config.seconds > 0 ? (uint64_t)(m_Config.seconds * m_Config.sampleRate) : 0;
+    m_ChordLength = (uint64_t)m_Config.sampleRate * 2;
+    m_BeatLength = (uint64_t)m_Config.sampleRate / 2;    // 120 BPM
+    m_Noise = m_Config.seed ? m_Config.seed : 1;
+
+    for (int p = 0; p < PARTIALS; p++) {
+        m_Re[p] = 1.0;
+        m_Im[p] = 0.0;
+    }
+    double kickAngle = 2.0 * M_PI * KICK_HZ / m_Config.sampleRate;
+    m_KickStepRe = cos(kickAngle);
+    m_KickStepIm = sin(kickAngle);
+    m_KickDecay = exp(-1.0 / (KICK_DECAY_SECONDS * m_Config.sampleRate));
+    SetChord(0);
+}
+
+void SyntheticSource::SetChord(int index) {
+    for (int p = 0; p < PARTIALS; p++) {
+        double angle = 2.0 * M_PI * CHORDS[index % 4][p] / m_Config.sampleRate;
+        m_StepRe[p] = cos(angle);
+        m_StepIm[p] = sin(angle);
+    }
+}
+
+size_t SyntheticSource::Read(float* out, size_t frames) {
+    if (m_Total != 0) frames = (size_t)(std::min)((uint64_t)frames, m_Total - m_Position);
+    const int channels = m_Config.channels;
+
+    for (size_t i = 0; i < frames; i++, m_Position++) {
+        if (m_Position % m_ChordLength == 0) SetChord((int)(m_Position / m_ChordLength));
+        if (m_Position % m_BeatLength == 0) {
+            m_KickEnv = 1.0;
+            m_KickRe = 1.0;
+            m_KickIm = 0.0;
+        }
+
+        float sample = 0;
+        for (int p = 0; p < PARTIALS; p++) {
+            double re = m_Re[p] * m_StepRe[p] - m_Im[p] * m_StepIm[p];
+            m_Im[p] = m_Re[p] * m_StepIm[p] + m_Im[p] * m_StepRe[p];
+            m_Re[p] = re;
+            sample += PARTIAL_GAINS[p] * (float)m_Im[p];
+        }
+        double kickRe = m_KickRe * m_KickStepRe - m_KickIm * m_KickStepIm;
+        m_KickIm = m_KickRe * m_KickStepIm + m_KickIm * m_KickStepRe;
+        m_KickRe = kickRe;
+        m_KickEnv *= m_KickDecay;
+        sample += 0.4f * (float)(m_KickEnv * m_KickIm);
+
+        // xorshift32 白噪声，左右声道反相以区分声道
+        m_Noise ^= m_Noise << 13;
+        m_Noise ^= m_Noise >> 17;
+        m_Noise ^= m_Noise << 5;
+        float noise = ((float)(m_Noise >> 8) / 8388608.0f - 1.0f) * 0.02f;
+
+        float* frame = out + i * channels;
+        for (int c = 0; c < channels; c++) {
+            frame[c] = (c & 1) ? sample - noise : sample + noise;
+        }
+    }
+
+    // 递推误差会让振幅缓慢漂移：每块重新归一化一次
+    for (int p = 0; p < PARTIALS; p++) {
+        double norm = 1.0 / std::sqrt(m_Re[p] * m_Re[p] + m_Im[p] * m_Im[p]);
+        m_Re[p] *= norm;
+        m_Im[p] *= norm;
+    }
+    return frames;
+}
+
+// ============================================================================
+// FileSource
+// ============================================================================
+
+namespace {
+
+uint16_t ReadU16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+uint32_t ReadU32(const uint8_t* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+constexpr uint16_t WAVE_FORMAT_PCM = 0x0001;
+constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+constexpr uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+constexpr uint32_t MAX_FMT_CHUNK = 64 * 1024;    // fmt 块实际最多约 40 字节；超出视为损坏，不按其分配
+
+void SetError(std::string* error, const std::string& message) {
+    if (error) *error = message;
+}
+
+} // namespace
+
+std::unique_ptr<FileSource> FileSource::OpenWav(const std::string& path, std::string* error) {
+    std::unique_ptr<FileSource> source(new FileSource());
+    source->m_File.open(path, std::ios::binary);
+    if (!source->m_File) {
+        SetError(error, "无法打开文件: " + path);
+        return nullptr;
+    }
+
+    uint8_t header[12];
+    if (!source->m_File.read((char*)header, sizeof(header)) ||
+        std::memcmp(header, "RIFF", 4) != 0 || std::memcmp(header + 8, "WAVE", 4) != 0) {
+        SetError(error, "不是 RIFF/WAVE 文件: " + path);
+        return nullptr;
+    }
+
+    // 逐块扫描：需要 fmt 与 data，其余块跳过（块长度按 2 字节对齐）
+    bool haveFormat = false;
+    uint16_t blockAlign = 0;
+    for (;;) {
+        uint8_t chunk[8];
+        if (!source->m_File.read((char*)chunk, sizeof(chunk))) {
+            SetError(error, "缺少 data 块: " + path);
+            return nullptr;
+        }
+        uint32_t size = ReadU32(chunk + 4);
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0) {
+            if (size < 16 || size > MAX_FMT_CHUNK) {
+                SetError(error, "fmt 块损坏: " + path);
+                return nullptr;
+            }
+            std::vector<uint8_t> fmt(size);
+            if (!source->m_File.read((char*)fmt.data(), size)) {
+                SetError(error, "fmt 块损坏: " + path);
+                return nullptr;
+            }
+            uint16_t tag = ReadU16(&fmt[0]);
+            uint16_t bits = ReadU16(&fmt[14]);
+            if (tag == WAVE_FORMAT_EXTENSIBLE && size >= 26) tag = ReadU16(&fmt[24]);   // SubFormat GUID 前 2 字节
+            source->m_Format.channels = ReadU16(&fmt[2]);
+            source->m_Format.sampleRate = (int)ReadU32(&fmt[4]);
+            blockAlign = ReadU16(&fmt[12]);
+
+            if (tag == WAVE_FORMAT_PCM && bits == 16) source->m_Format.format = SampleFormat::S16;
+            else if (tag == WAVE_FORMAT_PCM && bits == 24) source->m_Format.format = SampleFormat::S24;
+            else if (tag == WAVE_FORMAT_PCM && bits == 32) source->m_Format.format = SampleFormat::S32;
+            else if (tag == WAVE_FORMAT_IEEE_FLOAT && bits == 32) source->m_Format.format = SampleFormat::F32;
+            else {
+                SetError(error, "不支持的 WAV 编码 (format " + std::to_string(tag) + ", " + std::to_string(bits) +
+                                " bit): " + path);
+                return nullptr;
+            }
+            if (size & 1) source->m_File.seekg(1, std::ios::cur);
+            haveFormat = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (!haveFormat) {
+                SetError(error, "data 块位于 fmt 块之前: " + path);
+                return nullptr;
+            }
+            const size_t frameBytes = BytesPerSample(source->m_Format.format) * source->m_Format.channels;
+            if (source->m_Format.channels <= 0 || source->m_Format.sampleRate <= 0 || blockAlign != frameBytes) {
+                SetError(error, "fmt 块参数无效: " + path);
+                return nullptr;
+            }
+            source->m_DataOffset = (uint64_t)source->m_File.tellg();
+            source->m_TotalFrames = size / frameBytes;
+            break;
+        } else {
+            source->m_File.seekg(size + (size & 1), std::ios::cur);
+        }
+    }
+
+    source->m_IsWav = true;
+    source->m_Remaining = source->m_TotalFrames;
+    return source;
+}
+
+std::unique_ptr<FileSource> FileSource::OpenRaw(const std::string& path, const RawFormat& format, std::string* error) {
+    if (format.channels <= 0 || format.sampleRate <= 0) {
+        SetError(error, "原始 PCM 格式参数无效");
+        return nullptr;
+    }
+
+    std::unique_ptr<FileSource> source(new FileSource());
+    source->m_File.open(path, std::ios::binary | std::ios::ate);
+    if (!source->m_File) {
+        SetError(error, "无法打开文件: " + path);
+        return nullptr;
+    }
+    uint64_t size = (uint64_t)source->m_File.tellg();
+    source->m_File.seekg(0);
+
+    source->m_Format = format;
+    source->m_TotalFrames = size / (BytesPerSample(format.format) * format.channels);
+    source->m_Remaining = source->m_TotalFrames;
+    return source;
+}
+
+bool FileSource::Rewind() {
+    m_File.clear();
+    m_File.seekg((std::streamoff)m_DataOffset);
+    m_Remaining = m_TotalFrames;
+    return (bool)m_File;
+}
+
+size_t FileSource::Read(float* out, size_t frames) {
+    if (m_Remaining == 0 && !(m_Loop && m_TotalFrames > 0 && Rewind())) return 0;
+
+    const size_t channels = (size_t)m_Format.channels;
+    const size_t frameBytes = BytesPerSample(m_Format.format) * channels;
+    frames = (size_t)(std::min)((uint64_t)frames, m_Remaining);
+    if (m_Raw.size() < frames * frameBytes) m_Raw.resize(frames * frameBytes);
+
+    m_File.read((char*)m_Raw.data(), (std::streamsize)(frames * frameBytes));
+    size_t got = (size_t)m_File.gcount() / frameBytes;
+    Ingest::Decode(m_Raw.data(), m_Format.format, got * channels, out);
+
+    if (got < frames) {
+        // 文件比头部声明的短：按实际长度结束
+        m_TotalFrames -= m_Remaining - got;
+        m_Remaining = 0;
+    } else {
+        m_Remaining -= got;
+    }
+    return got;
+}
+
+} // namespace Netease
@@ -0,0 +1,116 @@
+#ifndef SAMPLE_SOURCE_H
+#define SAMPLE_SOURCE_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <fstream>
+#include <cstddef>
+#include <cstdint>
+#include "AudioIngest.h"
+
+namespace Netease {
+    struct SourceFormat {
+        int sampleRate = 48000;
+        int channels = 2;
+    };
+
+    // ============================================================
+    // SampleSource - 可插拔的采样来源 (v0.1.4)
+    // ============================================================
+    // 拉取式接口：调用方按块读取交错的 float 样本 ([-1, 1])。
+    // 文件与合成信号通过 AudioCapture::Start(source) 送入与 WASAPI 回环相同的环形缓冲区，
+    // 也可以由离线基准 (NeteaseAudioBench) 直接驱动，不依赖音频设备。
+    class SampleSource {
+    public:
+        virtual ~SampleSource() = default;
+
+        virtual const char* Name() const = 0;
+        virtual SourceFormat Format() const = 0;
+
+        // 读取最多 frames 帧到 out（长度 frames × channels），返回实际帧数；0 表示结束
+        virtual size_t Read(float* out, size_t frames) = 0;
+    };
+
+    // ============================================================
+    // SyntheticSource - 合成信号发生器
+    // ============================================================
+    // 类似音乐的确定性信号：和弦（每 2 秒换一次）+ 每拍一次的底鼓 + 少量噪声。
+    // 振荡器用复数旋转递推，每个样本不调用 sin/cos。
+    struct SyntheticConfig {
+        int sampleRate = 48000;
+        int channels = 2;
+        double seconds = 0;            // 总时长，0 表示无限
+        uint32_t seed = 1;
+    };
+
+    class SyntheticSource : public SampleSource {
+    public:
+        explicit SyntheticSource(const SyntheticConfig& config = SyntheticConfig());
+
+        const char* Name() const override { return "synthetic"; }
+        SourceFormat Format() const override { return { m_Config.sampleRate, m_Config.channels }; }
+        size_t Read(float* out, size_t frames) override;
+
+    private:
+        static constexpr int PARTIALS = 4;
+
+        void SetChord(int index);
+
+        SyntheticConfig m_Config;
+        uint64_t m_Position = 0;
+        uint64_t m_Total = 0;          // 0 = 无限
+        uint64_t m_ChordLength = 0;
+        uint64_t m_BeatLength = 0;
+        double m_Re[PARTIALS] = {};    // 振荡器状态 e^(iφ)
+        double m_Im[PARTIALS] = {};
+        double m_StepRe[PARTIALS] = {};
+        double m_StepIm[PARTIALS] = {};
+        double m_KickRe = 1, m_KickIm = 0, m_KickStepRe = 1, m_KickStepIm = 0;
+        double m_KickEnv = 0, m_KickDecay = 0;
+        uint32_t m_Noise = 1;
+    };
+
+    // ============================================================
+    // FileSource - WAV / 原始 PCM 文件
+    // ============================================================
+    // WAV 支持 PCM 16/24/32 位与 IEEE float 32 位（含 WAVE_FORMAT_EXTENSIBLE）；
+    // 原始 PCM 由调用方给出格式。打开失败返回 nullptr 并写入 error。
+    struct RawFormat {
+        int sampleRate = 48000;
+        int channels = 2;
+        SampleFormat format = SampleFormat::F32;
+    };
+
+    class FileSource : public SampleSource {
+    public:
+        static std::unique_ptr<FileSource> OpenWav(const std::string& path, std::string* error = nullptr);
+        static std::unique_ptr<FileSource> OpenRaw(const std::string& path, const RawFormat& format,
+                                                   std::string* error = nullptr);
+
+        const char* Name() const override { return m_IsWav ? "wav" : "raw"; }
+        SourceFormat Format() const override { return { m_Format.sampleRate, m_Format.channels }; }
+        size_t Read(float* out, size_t frames) override;
+
+        SampleFormat Encoding() const { return m_Format.format; }
+        uint64_t TotalFrames() const { return m_TotalFrames; }
+
+        // 读到结尾后从头循环（用于把短文件推成长时间的基准输入）
+        void SetLoop(bool loop) { m_Loop = loop; }
+
+    private:
+        FileSource() = default;
+        bool Rewind();
+
+        std::ifstream m_File;
+        RawFormat m_Format;
+        bool m_IsWav = false;
+        bool m_Loop = false;
+        uint64_t m_DataOffset = 0;     // 数据块在文件中的起始位置
+        uint64_t m_TotalFrames = 0;
+        uint64_t m_Remaining = 0;      // 本轮剩余帧数
+        std::vector<uint8_t> m_Raw;    // 编码数据的读取缓冲区（按最大请求长度增长一次）
+    };
+}
+
+#endif // SAMPLE_SOURCE_H
@@ -0,0 +1,581 @@
+/**
+ * SpectrumKernels.cpp - 单精度频谱内核实现
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ */
+
+#include "SpectrumKernels.h"
+#include "CpuFeatures.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace Netease::Spectrum {
+
+namespace {
+
+// ============================================================================
+// 标量内核
+// ============================================================================
+
+void ButterflyScalar(float* re, float* im, size_t n, size_t half, const float* twRe, const float* twIm) {
+    for (size_t k = 0; k < n; k += 2 * half) {
+        float* aRe = re + k;
+        float* aIm = im + k;
+        float* bRe = aRe + half;
+        float* bIm = aIm + half;
+        for (size_t j = 0; j < half; j++) {
+            float tRe = bRe[j] * twRe[j] - bIm[j] * twIm[j];
+            float tIm = bRe[j] * twIm[j] + bIm[j] * twRe[j];
+            bRe[j] = aRe[j] - tRe;
+            bIm[j] = aIm[j] - tIm;
+            aRe[j] += tRe;
+            aIm[j] += tIm;
+        }
+    }
+}
+
+/**
+ * 2X[k] = (Z[k] + conj(Z[M-k])) - i·W_N^k·(Z[k] - conj(Z[M-k]))，展开为实部/虚部：
+ *   sumRe = re[k] + re[M-k]    difRe = re[k] - re[M-k]
+ *   sumIm = im[k] - im[M-k]    difIm = im[k] + im[M-k]
+ *   2Re = sumRe + wr·difIm + wi·difRe
+ *   2Im = sumIm - wr·difRe + wi·difIm
+ * 因子 1/2 合并进 scale
+ */
+void RealMagnitudesRange(const float* re, const float* im, size_t half, const float* twRe, const float* twIm,
+                         float scale, float* out, size_t begin, size_t end) {
+    const float halfScale = scale * 0.5f;
+    for (size_t k = begin; k < end; k++) {
+        size_t m = half - k;
+        float sumRe = re[k] + re[m];
+        float difRe = re[k] - re[m];
+        float sumIm = im[k] - im[m];
+        float difIm = im[k] + im[m];
+        float xRe = sumRe + twRe[k] * difIm + twIm[k] * difRe;
+        float xIm = sumIm - twRe[k] * difRe + twIm[k] * difIm;
+        out[k] = std::sqrt(xRe * xRe + xIm * xIm) * halfScale;
+    }
+}
+
+void RealMagnitudesScalar(const float* re, const float* im, size_t half, const float* twRe, const float* twIm,
+                          float scale, float* out) {
+    RealMagnitudesRange(re, im, half, twRe, twIm, scale, out, 1, half);
+}
+
+float BandSumRange(const float* values, const float* weights, size_t begin, size_t end) {
+    float sum = 0;
+    for (size_t j = begin; j < end; j++) sum += values[j] * weights[j];
+    return sum;
+}
+
+void BandSumsScalar(const float* values, const uint32_t* first, const uint32_t* offsets, const float* weights,
+                    size_t bandCount, float* out) {
+    for (size_t b = 0; b < bandCount; b++) {
+        out[b] = BandSumRange(values + first[b], weights + offsets[b], 0, offsets[b + 1] - offsets[b]);
+    }
+}
+
+#if defined(NETEASE_ARCH_X86)
+
+// ============================================================================
+// SSE2 内核 (4 路)
+// ============================================================================
+
+NETEASE_TARGET_SSE2 void ButterflySSE2(float* re, float* im, size_t n, size_t half,
+                                       const float* twRe, const float* twIm) {
+    if (half < 4) {
+        ButterflyScalar(re, im, n, half, twRe, twIm);
+        return;
+    }
+    for (size_t k = 0; k < n; k += 2 * half) {
+        float* aRe = re + k;
+        float* aIm = im + k;
+        float* bRe = aRe + half;
+        float* bIm = aIm + half;
+        for (size_t j = 0; j < half; j += 4) {
+            __m128 wr = _mm_loadu_ps(twRe + j);
+            __m128 wi = _mm_loadu_ps(twIm + j);
+            __m128 br = _mm_loadu_ps(bRe + j);
+            __m128 bi = _mm_loadu_ps(bIm + j);
+            __m128 tRe = _mm_sub_ps(_mm_mul_ps(br, wr), _mm_mul_ps(bi, wi));
+            __m128 tIm = _mm_add_ps(_mm_mul_ps(br, wi), _mm_mul_ps(bi, wr));
+            __m128 ar = _mm_loadu_ps(aRe + j);
+            __m128 ai = _mm_loadu_ps(aIm + j);
+            _mm_storeu_ps(bRe + j, _mm_sub_ps(ar, tRe));
+            _mm_storeu_ps(bIm + j, _mm_sub_ps(ai, tIm));
+            _mm_storeu_ps(aRe + j, _mm_add_ps(ar, tRe));
+            _mm_storeu_ps(aIm + j, _mm_add_ps(ai, tIm));
+        }
+    }
+}
+
+NETEASE_TARGET_SSE2 void RealMagnitudesSSE2(const float* re, const float* im, size_t half,
+                                            const float* twRe, const float* twIm, float scale, float* out) {
+    const __m128 halfScale = _mm_set1_ps(scale * 0.5f);
+    size_t k = 1;
+    // 镜像下标 M-k 递减：从 M-k-3 起连续加载再反转通道
+    for (; k + 4 <= half; k += 4) {
+        size_t m = half - k - 3;
+        __m128 r0 = _mm_loadu_ps(re + k);
+        __m128 i0 = _mm_loadu_ps(im + k);
+        __m128 r1 = _mm_loadu_ps(re + m);
+        __m128 i1 = _mm_loadu_ps(im + m);
+        r1 = _mm_shuffle_ps(r1, r1, _MM_SHUFFLE(0, 1, 2, 3));
+        i1 = _mm_shuffle_ps(i1, i1, _MM_SHUFFLE(0, 1, 2, 3));
+        __m128 wr = _mm_loadu_ps(twRe + k);
+        __m128 wi = _mm_loadu_ps(twIm + k);
+
+        __m128 sumRe = _mm_add_ps(r0, r1);
+        __m128 difRe = _mm_sub_ps(r0, r1);
+        __m128 sumIm = _mm_sub_ps(i0, i1);
+        __m128 difIm = _mm_add_ps(i0, i1);
+        __m128 xRe = _mm_add_ps(sumRe, _mm_add_ps(_mm_mul_ps(wr, difIm), _mm_mul_ps(wi, difRe)));
+        __m128 xIm = _mm_add_ps(_mm_sub_ps(sumIm, _mm_mul_ps(wr, difRe)), _mm_mul_ps(wi, difIm));
+        __m128 mag = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(xRe, xRe), _mm_mul_ps(xIm, xIm)));
+        _mm_storeu_ps(out + k, _mm_mul_ps(mag, halfScale));
+    }
+    RealMagnitudesRange(re, im, half, twRe, twIm, scale, out, k, half);
+}
+
+NETEASE_TARGET_SSE2 void BandSumsSSE2(const float* values, const uint32_t* first, const uint32_t* offsets,
+                                      const float* weights, size_t bandCount, float* out) {
+    for (size_t b = 0; b < bandCount; b++) {
+        const float* v = values + first[b];
+        const float* w = weights + offsets[b];
+        const size_t count = offsets[b + 1] - offsets[b];
+        __m128 acc = _mm_setzero_ps();
+        size_t j = 0;
+        for (; j + 4 <= count; j += 4) {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(v + j), _mm_loadu_ps(w + j)));
+        }
+        // 水平求和：[0+2, 1+3] → 0+1+2+3
+        acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+        acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(1, 1, 1, 1)));
+        out[b] = _mm_cvtss_f32(acc) + BandSumRange(v, w, j, count);
+    }
+}
+
+// ============================================================================
+// AVX2 内核 (8 路 + FMA)
+// ============================================================================
+
+NETEASE_TARGET_AVX2 void ButterflyAVX2(float* re, float* im, size_t n, size_t half,
+                                       const float* twRe, const float* twIm) {
+    if (half < 8) {
+        ButterflySSE2(re, im, n, half, twRe, twIm);
+        return;
+    }
+    for (size_t k = 0; k < n; k += 2 * half) {
+        float* aRe = re + k;
+        float* aIm = im + k;
+        float* bRe = aRe + half;
+        float* bIm = aIm + half;
+        for (size_t j = 0; j < half; j += 8) {
+            __m256 wr = _mm256_loadu_ps(twRe + j);
+            __m256 wi = _mm256_loadu_ps(twIm + j);
+            __m256 br = _mm256_loadu_ps(bRe + j);
+            __m256 bi = _mm256_loadu_ps(bIm + j);
+            __m256 tRe = _mm256_fmsub_ps(br, wr, _mm256_mul_ps(bi, wi));
+            __m256 tIm = _mm256_fmadd_ps(br, wi, _mm256_mul_ps(bi, wr));
+            __m256 ar = _mm256_loadu_ps(aRe + j);
+            __m256 ai = _mm256_loadu_ps(aIm + j);
+            _mm256_storeu_ps(bRe + j, _mm256_sub_ps(ar, tRe));
+            _mm256_storeu_ps(bIm + j, _mm256_sub_ps(ai, tIm));
+            _mm256_storeu_ps(aRe + j, _mm256_add_ps(ar, tRe));
+            _mm256_storeu_ps(aIm + j, _mm256_add_ps(ai, tIm));
+        }
+    }
+    // 显式清理 YMM 高位，避免后续 legacy SSE 代码的状态切换惩罚
+    _mm256_zeroupper();
+}
+
+NETEASE_TARGET_AVX2 void RealMagnitudesAVX2(const float* re, const float* im, size_t half,
+                                            const float* twRe, const float* twIm, float scale, float* out) {
+    const __m256 halfScale = _mm256_set1_ps(scale * 0.5f);
+    const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    size_t k = 1;
+    for (; k + 8 <= half; k += 8) {
+        size_t m = half - k - 7;
+        __m256 r0 = _mm256_loadu_ps(re + k);
+        __m256 i0 = _mm256_loadu_ps(im + k);
+        __m256 r1 = _mm256_permutevar8x32_ps(_mm256_loadu_ps(re + m), reverse);
+        __m256 i1 = _mm256_permutevar8x32_ps(_mm256_loadu_ps(im + m), reverse);
+        __m256 wr = _mm256_loadu_ps(twRe + k);
+        __m256 wi = _mm256_loadu_ps(twIm + k);
+
+        __m256 sumRe = _mm256_add_ps(r0, r1);
+        __m256 difRe = _mm256_sub_ps(r0, r1);
+        __m256 sumIm = _mm256_sub_ps(i0, i1);
+        __m256 difIm = _mm256_add_ps(i0, i1);
+        __m256 xRe = _mm256_fmadd_ps(wi, difRe, _mm256_fmadd_ps(wr, difIm, sumRe));
+        __m256 xIm = _mm256_fmadd_ps(wi, difIm, _mm256_fnmadd_ps(wr, difRe, sumIm));
+        __m256 mag = _mm256_sqrt_ps(_mm256_fmadd_ps(xRe, xRe, _mm256_mul_ps(xIm, xIm)));
+        _mm256_storeu_ps(out + k, _mm256_mul_ps(mag, halfScale));
+    }
+    _mm256_zeroupper();
+    RealMagnitudesRange(re, im, half, twRe, twIm, scale, out, k, half);
+}
+
+NETEASE_TARGET_AVX2 void BandSumsAVX2(const float* values, const uint32_t* first, const uint32_t* offsets,
+                                      const float* weights, size_t bandCount, float* out) {
+    for (size_t b = 0; b < bandCount; b++) {
+        const float* v = values + first[b];
+        const float* w = weights + offsets[b];
+        const size_t count = offsets[b + 1] - offsets[b];
+        __m256 acc = _mm256_setzero_ps();
+        size_t j = 0;
+        for (; j + 8 <= count; j += 8) {
+            acc = _mm256_fmadd_ps(_mm256_loadu_ps(v + j), _mm256_loadu_ps(w + j), acc);
+        }
+        __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+        out[b] = _mm_cvtss_f32(sum) + BandSumRange(v, w, j, count);
+    }
+    _mm256_zeroupper();
+}
+
+#endif // NETEASE_ARCH_X86
+
+#if defined(NETEASE_ARCH_NEON)
+
+// ============================================================================
+// NEON 内核 (4 路)
+// ============================================================================
+
+void ButterflyNEON(float* re, float* im, size_t n, size_t half, const float* twRe, const float* twIm) {
+    if (half < 4) {
+        ButterflyScalar(re, im, n, half, twRe, twIm);
+        return;
+    }
+    for (size_t k = 0; k < n; k += 2 * half) {
+        float* aRe = re + k;
+        float* aIm = im + k;
+        float* bRe = aRe + half;
+        float* bIm = aIm + half;
+        for (size_t j = 0; j < half; j += 4) {
+            float32x4_t wr = vld1q_f32(twRe + j);
+            float32x4_t wi = vld1q_f32(twIm + j);
+            float32x4_t br = vld1q_f32(bRe + j);
+            float32x4_t bi = vld1q_f32(bIm + j);
+            float32x4_t tRe = vmlsq_f32(vmulq_f32(br, wr), bi, wi);
+            float32x4_t tIm = vmlaq_f32(vmulq_f32(br, wi), bi, wr);
+            float32x4_t ar = vld1q_f32(aRe + j);
+            float32x4_t ai = vld1q_f32(aIm + j);
+            vst1q_f32(bRe + j, vsubq_f32(ar, tRe));
+            vst1q_f32(bIm + j, vsubq_f32(ai, tIm));
+            vst1q_f32(aRe + j, vaddq_f32(ar, tRe));
+            vst1q_f32(aIm + j, vaddq_f32(ai, tIm));
+        }
+    }
+}
+
+inline float32x4_t ReverseNEON(float32x4_t v) {
+    float32x4_t swapped = vrev64q_f32(v);   // [1 0 3 2]
+    return vextq_f32(swapped, swapped, 2);  // [3 2 1 0]
+}
+
+void RealMagnitudesNEON(const float* re, const float* im, size_t half, const float* twRe, const float* twIm,
+                        float scale, float* out) {
+    const float32x4_t halfScale = vdupq_n_f32(scale * 0.5f);
+    size_t k = 1;
+    for (; k + 4 <= half; k += 4) {
+        size_t m = half - k - 3;
+        float32x4_t r0 = vld1q_f32(re + k);
+        float32x4_t i0 = vld1q_f32(im + k);
+        float32x4_t r1 = ReverseNEON(vld1q_f32(re + m));
+        float32x4_t i1 = ReverseNEON(vld1q_f32(im + m));
+        float32x4_t wr = vld1q_f32(twRe + k);
+        float32x4_t wi = vld1q_f32(twIm + k);
+
+        float32x4_t sumRe = vaddq_f32(r0, r1);
+        float32x4_t difRe = vsubq_f32(r0, r1);
+        float32x4_t sumIm = vsubq_f32(i0, i1);
+        float32x4_t difIm = vaddq_f32(i0, i1);
+        float32x4_t xRe = vmlaq_f32(vmlaq_f32(sumRe, wr, difIm), wi, difRe);
+        float32x4_t xIm = vmlaq_f32(vmlsq_f32(sumIm, wr, difRe), wi, difIm);
+        float32x4_t mag = vsqrtq_f32(vmlaq_f32(vmulq_f32(xRe, xRe), xIm, xIm));
+        vst1q_f32(out + k, vmulq_f32(mag, halfScale));
+    }
+    RealMagnitudesRange(re, im, half, twRe, twIm, scale, out, k, half);
+}
+
+void BandSumsNEON(const float* values, const uint32_t* first, const uint32_t* offsets, const float* weights,
+                  size_t bandCount, float* out) {
+    for (size_t b = 0; b < bandCount; b++) {
+        const float* v = values + first[b];
+        const float* w = weights + offsets[b];
+        const size_t count = offsets[b + 1] - offsets[b];
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        size_t j = 0;
+        for (; j + 4 <= count; j += 4) {
+            acc = vmlaq_f32(acc, vld1q_f32(v + j), vld1q_f32(w + j));
+        }
+        out[b] = vaddvq_f32(acc) + BandSumRange(v, w, j, count);
+    }
+}
+
+#endif // NETEASE_ARCH_NEON
+
+// ============================================================================
+// 运行时分派
+// ============================================================================
+
+using ButterflyFn = void (*)(float*, float*, size_t, size_t, const float*, const float*);
+using MagnitudesFn = void (*)(const float*, const float*, size_t, const float*, const float*, float, float*);
+using BandSumsFn = void (*)(const float*, const uint32_t*, const uint32_t*, const float*, size_t, float*);
+
+struct KernelTable {
+    ButterflyFn butterfly;
+    MagnitudesFn realMagnitudes;
+    BandSumsFn bandSums;
+};
+
+KernelTable TableFor(Kernel kernel) {
+    switch (kernel) {
+#if defined(NETEASE_ARCH_X86)
+        case Kernel::AVX2: return { &ButterflyAVX2, &RealMagnitudesAVX2, &BandSumsAVX2 };
+        case Kernel::SSE2: return { &ButterflySSE2, &RealMagnitudesSSE2, &BandSumsSSE2 };
+#endif
+#if defined(NETEASE_ARCH_NEON)
+        case Kernel::NEON: return { &ButterflyNEON, &RealMagnitudesNEON, &BandSumsNEON };
+#endif
+        default:           return { &ButterflyScalar, &RealMagnitudesScalar, &BandSumsScalar };
+    }
+}
+
+bool IsSupported(Kernel kernel) {
+    const auto& cpu = Cpu::Get();
+    switch (kernel) {
+        case Kernel::Scalar: return true;
+#if defined(NETEASE_ARCH_X86)
+        case Kernel::SSE2: return cpu.sse2;
+        case Kernel::AVX2: return cpu.avx2 && cpu.fma;
+#endif
+#if defined(NETEASE_ARCH_NEON)
+        case Kernel::NEON: return cpu.neon;
+#endif
+        default: return false;
+    }
+}
+
+Kernel BestKernel() {
+    if (IsSupported(Kernel::AVX2)) return Kernel::AVX2;
+    if (IsSupported(Kernel::SSE2)) return Kernel::SSE2;
+    if (IsSupported(Kernel::NEON)) return Kernel::NEON;
+    return Kernel::Scalar;
+}
+
+std::atomic<Kernel> g_Kernel{ BestKernel() };
+
+} // namespace
+
+bool SetKernel(Kernel kernel) {
+    if (kernel == Kernel::Auto) kernel = BestKernel();
+    if (!IsSupported(kernel)) return false;
+    g_Kernel.store(kernel);
+    return true;
+}
+
+Kernel GetKernel() {
+    return g_Kernel.load();
+}
+
+void ButterflyStage(float* re, float* im, size_t n, size_t half, const float* twRe, const float* twIm) {
+    TableFor(g_Kernel.load()).butterfly(re, im, n, half, twRe, twIm);
+}
+
+void RealMagnitudes(const float* re, const float* im, size_t half,
+                    const float* twRe, const float* twIm, float scale, float* out) {
+    TableFor(g_Kernel.load()).realMagnitudes(re, im, half, twRe, twIm, scale, out);
+}
+
+void BandSums(const float* values, const uint32_t* first, const uint32_t* offsets, const float* weights,
+              size_t bandCount, float* out) {
+    TableFor(g_Kernel.load()).bandSums(values, first, offsets, weights, bandCount, out);
+}
+
+// ============================================================================
+// RealFftPlanF
+// ============================================================================
+
+RealFftPlanF::RealFftPlanF(size_t size) {
+    if (size < 4 || (size & (size - 1)) != 0) return;
+    m_Size = size;
+    const size_t half = size / 2;
+
+    int bits = 0;
+    while (((size_t)1 << bits) < half) bits++;
+    m_BitReverse.resize(half);
+    for (size_t i = 0; i < half; i++) {
+        uint32_t r = 0;
+        for (int b = 0; b < bits; b++) {
+            r |= (uint32_t)((i >> b) & 1) << (bits - 1 - b);
+        }
+        m_BitReverse[i] = r;
+    }
+
+    // 每级旋转因子连续存放：[h, 2h) 为 W_2h^j，j < h（双精度计算后再截断）
+    m_StageRe.assign((std::max)(half, (size_t)1), 0.0f);
+    m_StageIm.assign((std::max)(half, (size_t)1), 0.0f);
+    for (size_t h = 1; h < half; h *= 2) {
+        for (size_t j = 0; j < h; j++) {
+            double ang = -M_PI * (double)j / (double)h;
+            m_StageRe[h + j] = (float)cos(ang);
+            m_StageIm[h + j] = (float)sin(ang);
+        }
+    }
+
+    m_PostRe.resize(half);
+    m_PostIm.resize(half);
+    for (size_t k = 0; k < half; k++) {
+        double ang = -2.0 * M_PI * (double)k / (double)size;
+        m_PostRe[k] = (float)cos(ang);
+        m_PostIm[k] = (float)sin(ang);
+    }
+
+    m_Window.resize(size);
+    for (size_t i = 0; i < size; i++) {
+        m_Window[i] = (float)(0.5 * (1.0 - cos(2.0 * M_PI * i / (size - 1))));
+    }
+}
+
+void RealFftPlanF::Analyze(const float* samples, float* workRe, float* workIm, float* magnitudes) const {
+    const size_t half = m_Size / 2;
+    if (half == 0) return;
+
+    // 1. 加窗并打包 z[t] = x[2t] + i·x[2t+1]，直接写到位反转位置
+    const uint32_t* rev = m_BitReverse.data();
+    const float* window = m_Window.data();
+    for (size_t t = 0; t < half; t++) {
+        workRe[rev[t]] = samples[2 * t] * window[2 * t];
+        workIm[rev[t]] = samples[2 * t + 1] * window[2 * t + 1];
+    }
+
+    // 2. 前两级（W = 1, -i）合并为一次标量基 4
+    size_t stage = 1;
+    if (half >= 4) {
+        for (size_t k = 0; k < half; k += 4) {
+            float* r = workRe + k;
+            float* i = workIm + k;
+            float r0 = r[0] + r[1], i0 = i[0] + i[1];
+            float r1 = r[0] - r[1], i1 = i[0] - i[1];
+            float r2 = r[2] + r[3], i2 = i[2] + i[3];
+            float r3 = r[2] - r[3], i3 = i[2] - i[3];
+            r[0] = r0 + r2; i[0] = i0 + i2;
+            r[2] = r0 - r2; i[2] = i0 - i2;
+            // (-i)·(r3 + i·i3) = i3 - i·r3
+            r[1] = r1 + i3; i[1] = i1 - r3;
+            r[3] = r1 - i3; i[3] = i1 + r3;
+        }
+        stage = 4;
+    }
+
+    // 3. 其余各级走 SIMD 蝶形
+    const KernelTable table = TableFor(g_Kernel.load());
+    for (; stage < half; stage *= 2) {
+        table.butterfly(workRe, workIm, half, stage, m_StageRe.data() + stage, m_StageIm.data() + stage);
+    }
+
+    // 4. 后处理 + 幅值
+    const float scale = 1.0f / (float)m_Size;
+    magnitudes[0] = std::fabs(workRe[0] + workIm[0]) * scale;
+    table.realMagnitudes(workRe, workIm, half, m_PostRe.data(), m_PostIm.data(), scale, magnitudes);
+}
+
+// ============================================================================
+// BandMap
+// ============================================================================
+
+namespace {
+
+double ToScale(double hz, BandScale scale) {
+    return scale == BandScale::Mel ? 2595.0 * log10(1.0 + hz / 700.0) : log(hz);
+}
+
+double FromScale(double value, BandScale scale) {
+    return scale == BandScale::Mel ? 700.0 * (pow(10.0, value / 2595.0) - 1.0) : exp(value);
+}
+
+} // namespace
+
+BandMap::BandMap(size_t fftSize, int bandCount, const BandLayout& layout) : m_Layout(layout) {
+    if (fftSize < 4 || bandCount < 1 || layout.sampleRate <= 0) return;
+    m_FftSize = fftSize;
+    const size_t bins = fftSize / 2;
+    const double binHz = (double)layout.sampleRate / (double)fftSize;
+
+    // 频率范围：上沿不超过最后一个频率桶，对数刻度的下沿必须为正
+    double hi = (std::min)((double)layout.maxHz, (double)(bins - 1) * binHz);
+    double lo = (std::max)((double)layout.minHz, layout.scale == BandScale::Log ? 1.0 : 0.0);
+    if (lo >= hi) lo = hi * 0.5;
+
+    const double scaleLo = ToScale(lo, layout.scale);
+    const double scaleHi = ToScale(hi, layout.scale);
+    const double step = (scaleHi - scaleLo) / (double)(bandCount + 1);
+    m_Edges.resize(bandCount + 2);
+    for (int i = 0; i < bandCount + 2; i++) {
+        m_Edges[i] = (float)FromScale(scaleLo + step * i, layout.scale);
+    }
+
+    m_First.resize(bandCount);
+    m_Offsets.assign(1, 0);
+    m_Gains.resize(bandCount);
+    std::vector<float> dense(bins);
+    for (int b = 0; b < bandCount; b++) {
+        const double sl = scaleLo + step * b;
+        const double sc = sl + step;
+        const double su = sc + step;
+        const double center = FromScale(sc, layout.scale);
+
+        // 三角形在所选刻度上线性升降，在各频率桶中心取样
+        std::fill(dense.begin(), dense.end(), 0.0f);
+        size_t kBegin = (size_t)(std::max)(1.0, std::ceil(FromScale(sl, layout.scale) / binHz));
+        size_t kEnd = (std::min)(bins, (size_t)std::floor(FromScale(su, layout.scale) / binHz) + 1);
+        double total = 0;
+        for (size_t k = kBegin; k < kEnd; k++) {
+            double s = ToScale((double)k * binHz, layout.scale);
+            double w = s <= sc ? (s - sl) / step : (su - s) / step;
+            if (w > 0) {
+                dense[k] = (float)w;
+                total += w;
+            }
+        }
+
+        // 三角形窄于约两个频率桶时取样不足：改为中心频率处的线性插值
+        if (total < 1.0) {
+            std::fill(dense.begin(), dense.end(), 0.0f);
+            double position = (std::max)(1.0, center / binHz);
+            size_t k0 = (std::min)((size_t)position, bins - 1);
+            double frac = k0 + 1 < bins ? position - (double)k0 : 0.0;
+            dense[k0] = (float)(1.0 - frac);
+            if (frac > 0) dense[k0 + 1] = (float)frac;
+            total = 1.0;
+        }
+
+        // 归一化为加权平均，再烘焙倾斜补偿与整体增益
+        double gain = layout.gain * pow(10.0, layout.slopeDbPerOctave * log2(center / 1000.0) / 20.0);
+        m_Gains[b] = (float)gain;
+
+        size_t begin = 0;
+        while (begin < bins && dense[begin] == 0.0f) begin++;
+        size_t end = bins;
+        while (end > begin && dense[end - 1] == 0.0f) end--;
+
+        // 补齐到 PAD 的倍数（放不下时向前借零权重桶）
+        size_t count = (std::min)((end - begin + PAD - 1) / PAD * PAD, bins);
+        begin = (std::min)(begin, bins - count);
+        m_First[b] = (uint32_t)begin;
+        for (size_t k = begin; k < begin + count; k++) {
+            m_Weights.push_back((float)(dense[k] / total * gain));
+        }
+        m_Offsets.push_back((uint32_t)m_Weights.size());
+    }
+}
+
+} // namespace Netease::Spectrum
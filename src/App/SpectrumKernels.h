@@ -0,0 +1,181 @@
+#ifndef SPECTRUM_KERNELS_H
+#define SPECTRUM_KERNELS_H
+
+/**
+ * SpectrumKernels.h - 单精度频谱内核 (v0.1.4)
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ *
+ * 可视化只需要 float 精度，频谱路径改用单精度 + 实部/虚部分离存储：
+ * - 蝶形级与"实数 FFT 后处理 + 幅值"两类内核
+ * - 频带映射：稀疏加权求和内核 + 预计算的对数/Mel 三角滤波器组
+ * - SSE2 (4 路) / AVX2+FMA (8 路) / NEON (4 路)，无 SIMD 时回退到标量
+ * - 运行时根据 CPUID 选择内核（与 JSON 内核共用 CpuFeatures.h）
+ */
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace Netease::Spectrum {
+
+    /**
+     * 内核类型
+     */
+    enum class Kernel {
+        Auto,     // 自动选择当前 CPU 支持的最快内核
+        Scalar,
+        SSE2,     // 4 路
+        AVX2,     // 8 路 + FMA
+        NEON      // 4 路 (ARM64)
+    };
+
+    /**
+     * 强制使用指定内核（用于测试与基准）
+     *
+     * @return CPU 不支持该内核时返回 false，且不做修改
+     */
+    bool SetKernel(Kernel kernel);
+
+    /**
+     * 当前生效的内核
+     */
+    Kernel GetKernel();
+
+    /**
+     * 一级基 2 蝶形（DIT，原地，实部/虚部分离）
+     *
+     * 对每个长度 2·half 的块、每个 j < half：
+     *   t = W[j]·x[k+j+half]; x[k+j] += t; x[k+j+half] = x[k+j] - t
+     *
+     * @param twRe / twIm 本级旋转因子 W_2half^j，长度 half
+     */
+    void ButterflyStage(float* re, float* im, size_t n, size_t half, const float* twRe, const float* twIm);
+
+    /**
+     * 实数 FFT 后处理 + 幅值：由 N/2 点复数 FFT 结果 Z 求 |X[k]|·scale，k ∈ [1, half)
+     *
+     * @param half N/2（Z 的长度）
+     * @param twRe / twIm W_N^k，长度 half
+     * @param out 写入 out[1 .. half-1]；out[0] 由调用方计算
+     */
+    void RealMagnitudes(const float* re, const float* im, size_t half,
+                        const float* twRe, const float* twIm, float scale, float* out);
+
+    /**
+     * 稀疏加权求和：out[b] = Σ values[first[b] + j]·weights[offsets[b] + j]，j < offsets[b+1] - offsets[b]
+     *
+     * 每个频带的权重是一段连续区间，长度补齐到 BandMap::PAD 的倍数时没有标量尾部
+     *
+     * @param offsets 长度 bandCount + 1
+     */
+    void BandSums(const float* values, const uint32_t* first, const uint32_t* offsets, const float* weights,
+                  size_t bandCount, float* out);
+
+    /**
+     * 单精度实数输入 FFT 计划
+     *
+     * 与 RealFftPlan 相同的打包方式（N 个实数 → N/2 个复数），区别在于：
+     * - 加窗时直接写入位反转位置，省去单独的置换遍历
+     * - 前两级（无旋转因子）合并为一次标量基 4，其余各级走 SIMD 蝶形内核
+     * - 每级旋转因子连续存放，便于整段向量加载
+     */
+    class RealFftPlanF {
+    public:
+        RealFftPlanF() = default;
+
+        // size 必须为 2 的幂 (>= 4)，否则计划无效 (Size() == 0)
+        explicit RealFftPlanF(size_t size);
+
+        size_t Size() const { return m_Size; }
+        bool Valid() const { return m_Size != 0; }
+
+        /**
+         * 加窗 + 实数 FFT + 幅值 (|X[k]| / N，k < N/2)
+         *
+         * @param workRe / workIm 工作区，长度均为 Size() / 2，由调用方持有
+         * @param magnitudes 输出，长度 Size() / 2
+         */
+        void Analyze(const float* samples, float* workRe, float* workIm, float* magnitudes) const;
+
+    private:
+        size_t m_Size = 0;
+        std::vector<uint32_t> m_BitReverse;   // N/2 点位反转
+        std::vector<float> m_StageRe;         // 第 half 级旋转因子位于 [half, 2·half)
+        std::vector<float> m_StageIm;
+        std::vector<float> m_PostRe;          // 后处理因子 W_N^k
+        std::vector<float> m_PostIm;
+        std::vector<float> m_Window;
+    };
+
+    /**
+     * 频带间距
+     */
+    enum class BandScale {
+        Log,      // 对数频率（每个频带相同的倍频程宽度）
+        Mel       // Mel 刻度（低频近似线性，高频近似对数）
+    };
+
+    struct BandLayout {
+        int sampleRate = 48000;
+        float minHz = 30.0f;               // 第一个频带的下沿
+        float maxHz = 16000.0f;            // 最后一个频带的上沿（超过 Nyquist 时截断）
+        BandScale scale = BandScale::Log;
+        float slopeDbPerOctave = 3.0f;     // 以 1kHz 为基准的倾斜补偿（音乐频谱大致按 1/f 衰减）
+        float gain = 1.0f;                 // 整体增益
+    };
+
+    /**
+     * 频带映射表
+     *
+     * 为 (FFT 尺寸, 采样率, 频带数) 一次性构建三角滤波器组：
+     * - 频带中心在所选刻度上等距，相邻三角形的边沿互为对方的中心
+     * - 比一个频率桶还窄的低频频带改用中心频率处的线性插值（分数桶权重）
+     * - 每个频带的权重归一化后乘以倾斜补偿与整体增益，全部烘焙进权重
+     * 每帧只剩一次 BandSums，不再有任何超越函数。
+     */
+    class BandMap {
+    public:
+        static constexpr size_t PAD = 8;   // 每段权重补齐到 8 的倍数（AVX2 一次处理 8 个）
+
+        BandMap() = default;
+
+        // fftSize >= 4，bandCount >= 1，否则映射无效 (BandCount() == 0)
+        BandMap(size_t fftSize, int bandCount, const BandLayout& layout = BandLayout());
+
+        size_t FftSize() const { return m_FftSize; }
+        size_t BandCount() const { return m_First.size(); }
+        bool Valid() const { return !m_First.empty(); }
+        const BandLayout& Layout() const { return m_Layout; }
+
+        float CenterHz(size_t band) const { return m_Edges[band + 1]; }
+        float LowerHz(size_t band) const { return m_Edges[band]; }
+        float UpperHz(size_t band) const { return m_Edges[band + 2]; }
+
+        // 全 1 幅值输入时该频带的输出（倾斜补偿 × 整体增益）
+        float Gain(size_t band) const { return m_Gains[band]; }
+
+        // 权重表总长度（含补齐）
+        size_t WeightCount() const { return m_Weights.size(); }
+
+        /**
+         * @param magnitudes 长度 >= FftSize() / 2
+         * @param bands 长度 BandCount()
+         */
+        void Apply(const float* magnitudes, float* bands) const {
+            BandSums(magnitudes, m_First.data(), m_Offsets.data(), m_Weights.data(), m_First.size(), bands);
+        }
+
+    private:
+        size_t m_FftSize = 0;
+        BandLayout m_Layout;
+        std::vector<float> m_Edges;        // BandCount() + 2 个刻度等距点（Hz）
+        std::vector<float> m_Gains;
+        std::vector<uint32_t> m_First;     // 每个频带的起始频率桶
+        std::vector<uint32_t> m_Offsets;   // 每个频带在 m_Weights 中的起始位置，末尾为总长度
+        std::vector<float> m_Weights;
+    };
+
+} // namespace Netease::Spectrum
+
+#endif // SPECTRUM_KERNELS_H
@@ -0,0 +1,194 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <algorithm>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace Netease {
+    // ============================================================
+    // SpscRing - 单生产者 / 单消费者环形缓冲区 (v0.1.4)
+    // ============================================================
+    // 音频回调（生产者）整块写入，永不阻塞、永不等待：
+    // 写满后直接覆盖最旧的数据，写前声明覆盖范围、写后 release 发布写指针。
+    // UI 线程（消费者）按需读取"最新 N 个样本"的快照：
+    // 复制完成后再检查写指针，若复制期间被覆盖则重读（极少发生，
+    // 容量远大于快照长度时基本不会重试）。
+    //
+    // 容量为 2 的幂，下标用按位与回绕；生产者的两个计数器独占一条缓存行，
+    // 避免与消费者侧数据伪共享。
+    template <typename T>
+    class SpscRing {
+        static_assert(std::is_trivially_copyable<T>::value, "SpscRing 只支持可平凡复制的类型");
+
+    public:
+        static constexpr size_t CACHE_LINE = 64;
+
+        // capacity 向上取整到 2 的幂
+        explicit SpscRing(size_t capacity) {
+            size_t size = 1;
+            while (size < capacity) size <<= 1;
+            m_Data.assign(size, T());
+            m_Mask = size - 1;
+        }
+
+        size_t Capacity() const { return m_Mask + 1; }
+
+        // 累计写入的样本数（单调递增，不回绕）
+        uint64_t Written() const { return m_Write.load(std::memory_order_acquire); }
+
+        // ---------------- 生产者 ----------------
+
+        // 整块写入（超过容量时只保留最后 Capacity() 个）
+        void Write(const T* data, size_t count) {
+            const size_t capacity = Capacity();
+            uint64_t write = m_Write.load(std::memory_order_relaxed);
+            if (count > capacity) {
+                write += count - capacity;
+                data += count - capacity;
+                count = capacity;
+            }
+
+            // 先声明将要覆盖的范围，再写数据（读者据此判断快照是否被正在进行的写入破坏）
+            m_Reserve.store(write + count, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            size_t offset = (size_t)(write & m_Mask);
+            size_t first = (std::min)(count, capacity - offset);
+            std::memcpy(m_Data.data() + offset, data, first * sizeof(T));
+            std::memcpy(m_Data.data(), data + first, (count - first) * sizeof(T));
+            m_Write.store(write + count, std::memory_order_release);
+        }
+
+        // ---------------- 消费者 ----------------
+
+        // 读取最新的 count 个样本到 out（旧 → 新）
+        // 可用数据不足时在开头补 0；返回实际来自缓冲区的样本数
+        size_t ReadLatest(T* out, size_t count) const {
+            for (;;) {
+                uint64_t write = m_Write.load(std::memory_order_acquire);
+                size_t available = 0;
+                if (CopyEndingAt(write, out, count, available)) return available;
+                m_Retries.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        // v0.1.4: 读取以绝对位置 end 结尾的 count 个样本（end <= Written()），用于按固定步长消费
+        // 流开始之前的部分补 0；数据已被覆盖（读者落后超过一圈）时返回 false
+        bool ReadEndingAt(uint64_t end, T* out, size_t count) const {
+            if (end > m_Write.load(std::memory_order_acquire)) return false;
+            size_t available = 0;
+            return CopyEndingAt(end, out, count, available);
+        }
+
+        // 因复制期间被覆盖而重读的次数（诊断用）
+        uint64_t Retries() const { return m_Retries.load(std::memory_order_relaxed); }
+
+    private:
+        // 复制 [end - count, end)；复制完成后确认生产者没有绕回覆盖这段数据
+        bool CopyEndingAt(uint64_t end, T* out, size_t count, size_t& available) const {
+            const size_t capacity = Capacity();
+            available = (size_t)(std::min)(end, (uint64_t)(std::min)(count, capacity));
+            size_t missing = count - available;
+            std::fill(out, out + missing, T());
+
+            uint64_t start = end - available;
+            size_t offset = (size_t)(start & m_Mask);
+            size_t first = (std::min)(available, capacity - offset);
+            std::memcpy(out + missing, m_Data.data() + offset, first * sizeof(T));
+            std::memcpy(out + missing + first, m_Data.data(), (available - first) * sizeof(T));
+
+            // 复制期间生产者声明覆盖到哪里：只要没有绕回到 start 就是完整快照
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t reserved = m_Reserve.load(std::memory_order_relaxed);
+            return reserved - start <= capacity;
+        }
+
+        alignas(CACHE_LINE) std::atomic<uint64_t> m_Write{0};
+        std::atomic<uint64_t> m_Reserve{0};                       // 生产者独占，与 m_Write 同一缓存行
+        alignas(CACHE_LINE) mutable std::atomic<uint64_t> m_Retries{0};
+        size_t m_Mask = 0;
+        std::vector<T> m_Data;
+    };
+
+    // ============================================================
+    // LatencyHistogram - 实时线程耗时直方图 (v0.1.4)
+    // ============================================================
+    // 按 2 的幂分桶（纳秒）：第 i 桶为 [2^(i-1), 2^i)，第 0 桶为 0。
+    // 只有一个线程调用 Record（音频回调），全部是 relaxed 原子操作，
+    // 不加锁、不分配；其他线程随时可以读取近似快照。
+    class LatencyHistogram {
+    public:
+        static constexpr int BUCKETS = 32;   // 最后一桶收纳 >= 2^30ns (~1s)
+
+        struct Snapshot {
+            uint64_t counts[BUCKETS] = {};
+            uint64_t total = 0;
+            uint64_t sumNs = 0;
+            uint64_t maxNs = 0;
+
+            double MeanNs() const { return total ? (double)sumNs / (double)total : 0.0; }
+
+            // 百分位（返回所在桶的上界，保守估计）
+            uint64_t PercentileNs(double percentile) const {
+                if (total == 0) return 0;
+                uint64_t rank = (uint64_t)(percentile * (double)(total - 1)) + 1;
+                uint64_t seen = 0;
+                for (int i = 0; i < BUCKETS; i++) {
+                    seen += counts[i];
+                    if (seen >= rank) return (std::min)(BucketUpperNs(i), maxNs);
+                }
+                return maxNs;
+            }
+        };
+
+        static int BucketOf(uint64_t ns) {
+            int bucket = 0;
+            while (ns != 0 && bucket < BUCKETS - 1) {
+                ns >>= 1;
+                bucket++;
+            }
+            return bucket;
+        }
+
+        static uint64_t BucketUpperNs(int bucket) {
+            return bucket == 0 ? 0 : ((uint64_t)1 << bucket) - 1;
+        }
+
+        void Record(uint64_t ns) {
+            m_Counts[BucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+            m_SumNs.fetch_add(ns, std::memory_order_relaxed);
+            // 单一写入者：读-改-写无需 CAS
+            if (ns > m_MaxNs.load(std::memory_order_relaxed)) m_MaxNs.store(ns, std::memory_order_relaxed);
+        }
+
+        Snapshot Read() const {
+            Snapshot snapshot;
+            for (int i = 0; i < BUCKETS; i++) {
+                snapshot.counts[i] = m_Counts[i].load(std::memory_order_relaxed);
+                snapshot.total += snapshot.counts[i];
+            }
+            snapshot.sumNs = m_SumNs.load(std::memory_order_relaxed);
+            snapshot.maxNs = m_MaxNs.load(std::memory_order_relaxed);
+            return snapshot;
+        }
+
+        // 与 Record 并发调用时可能丢失少量样本，仅用于统计窗口切换
+        void Reset() {
+            for (auto& count : m_Counts) count.store(0, std::memory_order_relaxed);
+            m_SumNs.store(0, std::memory_order_relaxed);
+            m_MaxNs.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<uint64_t> m_Counts[BUCKETS] = {};
+        std::atomic<uint64_t> m_SumNs{0};
+        std::atomic<uint64_t> m_MaxNs{0};
+    };
+}
+
+#endif // SPSC_RING_H
@@ -0,0 +1,56 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace Netease {
+    // ============================================================
+    // TripleBuffer - 无锁三缓冲 (v0.1.4)
+    // ============================================================
+    // 一个写者、一个读者，各自独占一个缓冲区，第三个用于交换：
+    // - 写者在 Back() 上填好一帧后 Publish()，与中间缓冲区交换
+    // - 读者调用 Update()，有新帧时把中间缓冲区换到 Front()
+    // 双方都只做一次原子交换，永不等待；读者总是拿到最新的完整帧，
+    // 来不及读取的旧帧被直接覆盖。
+    template <typename T>
+    class TripleBuffer {
+    public:
+        TripleBuffer() = default;
+
+        // 三个缓冲区用同一个值初始化（预分配容器容量，之后不再分配）
+        explicit TripleBuffer(const T& initial) : m_Buffers{ initial, initial, initial } {}
+
+        // ---------------- 写者 ----------------
+
+        T& Back() { return m_Buffers[m_Back]; }
+
+        void Publish() {
+            uint8_t previous = m_Middle.exchange((uint8_t)(m_Back | FRESH), std::memory_order_acq_rel);
+            m_Back = previous & INDEX_MASK;
+        }
+
+        // ---------------- 读者 ----------------
+
+        // 有新帧时切换 Front() 并返回 true
+        bool Update() {
+            if ((m_Middle.load(std::memory_order_relaxed) & FRESH) == 0) return false;
+            uint8_t previous = m_Middle.exchange(m_Front, std::memory_order_acq_rel);
+            m_Front = previous & INDEX_MASK;
+            return true;
+        }
+
+        const T& Front() const { return m_Buffers[m_Front]; }
+
+    private:
+        static constexpr uint8_t INDEX_MASK = 0x3;
+        static constexpr uint8_t FRESH = 0x4;       // 中间缓冲区含有读者尚未取走的帧
+
+        T m_Buffers[3];
+        alignas(64) std::atomic<uint8_t> m_Middle{1};
+        alignas(64) uint8_t m_Back = 0;             // 写者独占
+        alignas(64) uint8_t m_Front = 2;            // 读者独占
+    };
+}
+
+#endif // TRIPLE_BUFFER_H
@@ -2,6 +2,7 @@
 #define VISUALIZER_H
 
 #include <vector>
+#include <span>
 #include <cmath>
 #include "raylib.h"
 #include "raymath.h"
@@ -22,7 +23,7 @@ namespace Netease {
             return instance;
         }
 
-        void Update(const std::vector<float>& magnitudes, float deltaTime) {
+        void Update(std::span<const float> magnitudes, float deltaTime) {
             // 安全检查：空数据
             if (magnitudes.empty()) return;
             
@@ -54,7 +55,7 @@ namespace Netease {
             }
 
             // 3. 高能触发粒子
-            if (currentEnergy > 5.0f && m_Particles.size() < 120) {
+            if (currentEnergy > 5.0f && m_Particles.size() < MAX_PARTICLES) {
                 EmitParticle();
             }
         }
@@ -82,7 +83,8 @@ namespace Netease {
             };
 
             for (int layer = 0; layer < 3; layer++) {
-                std::vector<Vector2> points;
+                std::vector<Vector2>& points = m_Points;  // v0.1.4: 复用，避免每帧分配
+                points.clear();
                 float alphaScale = 0.5f - layer * 0.12f;
                 
                 // 动态计算绘制区域
@@ -127,7 +129,11 @@ namespace Netease {
         }
 
     private:
-        Visualizer() {}
+        Visualizer() {
+            m_Particles.reserve(MAX_PARTICLES);  // v0.1.4: 粒子数有上限，预留后不再扩容
+        }
+
+        static constexpr size_t MAX_PARTICLES = 120;
 
         void EmitParticle() {
             if (m_LastWidth <= 0 || m_LastHeight <= 0) return;
@@ -144,6 +150,7 @@ namespace Netease {
 
         std::vector<float> m_Bands;
         std::vector<Particle> m_Particles;
+        std::vector<Vector2> m_Points;
         float m_EnergyPulse = 0.0f;
         int m_LastWidth = 0;
         int m_LastHeight = 0;
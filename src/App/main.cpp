@@ -14,6 +14,7 @@
 #include "NeteaseAPI.h"
 #include "AlbumCover.h"
 #include "AudioCapture.h"
+#include "AnalysisThread.h"
 #include "Visualizer.h"
 #include "MemoryMonitor.h"  // 内存监控（Windows API 已隔离）
 #include <vector>
@@ -21,9 +22,11 @@
 #include <optional>
 #include <iostream>
 #include <chrono>
+#include <cmath>
 #include <set>
 #include <iomanip>
 #include <sstream>
+#include <cstdlib>
 
 #if defined(_MSC_VER)
 #pragma execution_character_set("utf-8")
@@ -122,8 +125,11 @@ struct LyricLine {
  */
 struct LyricSystem {
     std::vector<LyricLine> lines;   // 所有歌词行（按时间排序）
+    std::vector<int64_t> timesMs;   // 与 lines 一一对应的时间戳（毫秒），供游标查找 (v0.1.4)
+    Netease::LineCursor cursor;     // v0.1.4: 增量游标（跳转检测）
     int currentIndex = -1;          // 当前激活的歌词索引 (-1表示未开始)
     float scrollOffset = 0.0f;      // 平滑滚动偏移量（像素，用于动画插值）
+    bool snapScroll = false;        // 检测到跳转：下一帧直接滚动到位，不做插值
     
     /**
      * 清空歌词系统状态
@@ -131,8 +137,11 @@ struct LyricSystem {
      */
     void Clear() {
         lines.clear();
+        timesMs.clear();
+        cursor.Reset();
         currentIndex = -1;
         scrollOffset = 0.0f;
+        snapScroll = false;
     }
     
     /**
@@ -140,24 +149,16 @@ struct LyricSystem {
      * 
      * @param currentTime 当前播放时间 (秒)
      * 
-     * 算法: 从前一个索引开始向后扫描，找到最后一个
-     *       timestamp <= currentTime 的行作为当前行
+     * v0.1.4: 由 Netease::LineCursor 从上一次的位置增量前进；
+     *         时间回退或大幅前进（拖动进度条）时二分查找，并让滚动直接跳到目标行
      */
     void UpdateIndex(double currentTime) {
-        if (lines.empty()) {
-            currentIndex = -1;
-            return;
+        // 歌词整体替换（切歌时 LyricSystem 被重新赋值）后自动重新绑定
+        cursor.Bind(timesMs);
+        currentIndex = cursor.Update((int64_t)std::llround(currentTime * 1000.0));
+        if (cursor.LastUpdateWasSeek()) {
+            snapScroll = true;
         }
-        
-        int newIndex = -1;
-        for (int i = 0; i < (int)lines.size(); i++) {
-            if (lines[i].timestamp <= currentTime) {
-                newIndex = i;
-            } else {
-                break;
-            }
-        }
-        currentIndex = newIndex;
     }
 };
 
@@ -190,6 +191,10 @@ struct SongCache {
 // v0.1.3: 新的 FontManager 类
 static Netease::FontManager g_FontMgr;
 
+// v0.1.4: 频谱分析在独立线程上按固定步长运行（1024 点窗口，512 样本步长），渲染线程只读取最新帧
+// 配置取决于命令行（--audio-decimate），解析参数后再创建
+static std::unique_ptr<Netease::AnalysisThread> g_Analysis;
+
 /**
  * === 唱片旋转动画系统 ===
  * 
@@ -343,114 +348,25 @@ static Shader g_AuroraShader;
 static Shader g_MaskShader;
 
 
-// 解析 LRC 格式字符串并存入 map (time -> text)
-static std::map<double, std::string> ParseLrcToMap(const std::string& lrc, double* outOffset = nullptr) {
-    std::map<double, std::string> result;
-    if (lrc.empty()) return result;
-    
-    std::stringstream ss(lrc);
-    std::string line;
-    while (std::getline(ss, line)) {
-        if (line.empty()) continue;
-        
-        // 1. 处理 [offset:X] 标签
-        if (outOffset && line.find("[offset:") != std::string::npos) {
-            size_t start = line.find(':') + 1;
-            size_t end = line.find(']');
-            if (end != std::string::npos) {
-                try {
-                    *outOffset = std::stod(line.substr(start, end - start)) / 1000.0;
-                } catch (...) {}
-            }
-            continue;
-        }
-
-        // 2. 查找所有时间标签 [mm:ss.xx]
-        std::vector<double> timestamps;
-        size_t lastBracketEnd = 0;
-        size_t pos = 0;
-        
-        while (true) {
-            size_t bracketStart = line.find('[', pos);
-            size_t bracketEnd = line.find(']', pos);
-            if (bracketStart == std::string::npos || bracketEnd == std::string::npos || bracketEnd < bracketStart) break;
-            
-            std::string tag = line.substr(bracketStart + 1, bracketEnd - bracketStart - 1);
-            
-            // 精确解析 mm:ss.xx (手动处理小数点后的位数)
-            int m = 0, s = 0;
-            size_t colon = tag.find(':');
-            size_t dot = tag.find_first_of(".:"); // 可能是 . 也可能是 :
-            if (dot == colon) dot = tag.find_last_of(".:"); // 找到最后一个分隔符
-            
-            if (colon != std::string::npos) {
-                m = std::atoi(tag.substr(0, colon).c_str());
-                if (dot != std::string::npos && dot > colon) {
-                    s = std::atoi(tag.substr(colon + 1, dot - colon - 1).c_str());
-                    std::string fracStr = tag.substr(dot + 1);
-                    if (!fracStr.empty()) {
-                        double frac = std::atof(("0." + fracStr).c_str());
-                        timestamps.push_back(m * 60.0 + s + frac);
-                    } else {
-                        timestamps.push_back(m * 60.0 + s);
-                    }
-                } else {
-                    s = std::atoi(tag.substr(colon + 1).c_str());
-                    timestamps.push_back(m * 60.0 + (double)s);
-                }
-            }
-            
-            lastBracketEnd = bracketEnd;
-            pos = bracketEnd + 1;
-            // 贪婪跳过所有标签继续查找
-            size_t nextBracket = line.find('[', pos);
-            if (nextBracket == std::string::npos) break;
-            
-            // 如果中间只有空格，继续处理下一个标签
-            std::string between = line.substr(pos, nextBracket - pos);
-            bool onlySpace = true;
-            for(char c : between) { if(!isspace((unsigned char)c)) { onlySpace = false; break; } }
-            if (!onlySpace) break;
-            pos = nextBracket;
-        }
-        
-        if (timestamps.empty()) continue;
-        
-        // 提取文本内容
-        std::string text = line.substr(lastBracketEnd + 1);
-        text.erase(0, text.find_first_not_of(" \t\r\n"));
-        size_t last = text.find_last_not_of(" \t\r\n");
-        if (last != std::string::npos) text.erase(last + 1);
-        
-        if (!text.empty()) {
-            for (double ts : timestamps) {
-                result[ts] = text;
-            }
-        }
-    }
-    return result;
-}
-
-// 解析并合并原版和翻译歌词
-static LyricSystem ParseLyrics(const std::string& lrc, const std::string& tlrc) {
+// 解析并合并原版、翻译和罗马音歌词
+// v0.1.4: 使用 SDK 共享解析器 (API::ParseTimeline)，取代本地 map 解析
+static LyricSystem ParseLyrics(const Netease::LyricData& lyric) {
     LyricSystem system;
-    double offset = 0;
-    auto lrcMap = ParseLrcToMap(lrc, &offset);
-    auto tlrcMap = ParseLrcToMap(tlrc);
+    Netease::LrcTimeline timeline = Netease::API::ParseTimeline(lyric, 300);
     
-    // 应用全局偏移
-    for (auto const& [time, text] : lrcMap) {
+    system.lines.reserve(timeline.Size());
+    system.timesMs.reserve(timeline.Size());
+    for (size_t i = 0; i < timeline.Size(); ++i) {
+        std::string_view text = timeline.Text(i);
+        if (text.empty()) continue;     // 空行（间奏）不显示
+        
         LyricLine line;
-        line.timestamp = time + offset;
+        line.timestamp = timeline.timesMs[i] / 1000.0;
         line.text = text;
-        
-        // 尝试匹配翻译 (容差 0.2s)
-        auto it = tlrcMap.lower_bound(time - 0.2);
-        if (it != tlrcMap.end() && fabs(it->first - time) < 0.3) {
-            line.translation = it->second;
-        }
-        
-        system.lines.push_back(line);
+        // 无翻译时显示罗马音
+        line.translation = timeline.translation[i] >= 0 ? timeline.Translation(i) : timeline.Romaji(i);
+        system.lines.push_back(std::move(line));
+        system.timesMs.push_back(timeline.timesMs[i]);
     }
     
     return system;
@@ -501,6 +417,9 @@ int main(int argc, char* argv[]) {
     bool verboseMode = false;
     bool helpRequested = false;
     std::string logFilePath;
+    std::string audioFilePath;      // v0.1.4: 用 WAV 文件代替回环采集
+    bool syntheticAudio = false;    // v0.1.4: 用合成信号代替回环采集
+    int audioDecimation = 1;        // v0.1.4: 频谱分析前降采样倍数
     
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
@@ -513,6 +432,12 @@ int main(int argc, char* argv[]) {
         } else if (arg.find("--log=") == 0) {
             logFilePath = arg.substr(6);
             verboseMode = true; // 日志文件模式隐含开启日志
+        } else if (arg.find("--audio-file=") == 0) {
+            audioFilePath = arg.substr(13);
+        } else if (arg == "--audio-synthetic") {
+            syntheticAudio = true;
+        } else if (arg.find("--audio-decimate=") == 0) {
+            audioDecimation = std::atoi(arg.substr(17).c_str());
         }
     }
     
@@ -524,6 +449,10 @@ int main(int argc, char* argv[]) {
         std::cout << "  --verbose, -v      Enable verbose logging\n";
         std::cout << "  --silent, -s       Force silent mode (default)\n";
         std::cout << "  --log=<file>       Redirect logs to file\n";
+        std::cout << "  --audio-file=<wav> Visualize a WAV file (looped) instead of system audio\n";
+        std::cout << "  --audio-synthetic  Visualize a synthetic test signal instead of system audio\n";
+        std::cout << "  --audio-decimate=<2|4>\n";
+        std::cout << "                     Decimate before the FFT: finer bass bands, top band capped below 8 kHz\n";
         std::cout << "  --help, -h         Show this help message\n";
         std::cout << "\nKeyboard Shortcuts:\n";
         std::cout << "  Ctrl+I             Install Hook\n";
@@ -686,11 +615,44 @@ int main(int argc, char* argv[]) {
     
     // 注册回调 (必须在 Connect 之前或之后均可，只要 Driver 存在)
     driver.SetTrackChangedCallback(OnTrackChanged);
-    
+
+    // v0.1.4: 预取播放队列中接下来的歌曲（元数据/歌词写入 SDK 缓存，封面写入磁盘缓存）
+    // 切歌时 GetSongDetail / GetLyric / LoadFromUrl 均直接命中缓存
+    driver.SetPrefetchCoverCallback([](long long songId, const std::string& coverUrl) {
+        Netease::AlbumCover::Prefetch(coverUrl, songId);
+    });
+    driver.SetPrefetchDepth(3);
+
+    // v0.1.4: 后台条件刷新过期歌词缓存（每次启动最多 100 首，304 不传输正文）
+    Netease::API::RefreshStaleLyricsAsync(100);
+
     bool connected = driver.Connect(9222);
 
     // v0.1.2: 初始化音频采集 (WASAPI Loopback)
-    Netease::AudioCapture::Instance().Start();
+    // v0.1.4: 也可以指定文件 / 合成信号来源，走同一个环形缓冲区
+    if (!audioFilePath.empty()) {
+        std::string error;
+        auto file = Netease::FileSource::OpenWav(audioFilePath, &error);
+        if (file) {
+            file->SetLoop(true);
+            Netease::AudioCapture::Instance().Start(std::move(file));
+        } else {
+            LOG_ERROR("打开音频文件失败: " << error);
+        }
+    } else if (syntheticAudio) {
+        Netease::AudioCapture::Instance().Start(std::make_unique<Netease::SyntheticSource>());
+    } else {
+        Netease::AudioCapture::Instance().Start();
+    }
+    // v0.1.4: 降采样时 FFT 尺寸不变，窗口覆盖的时长随倍数增加，低频分辨率随之提高；
+    // 最高频带限制在降采样后的平坦通带内
+    Netease::AnalysisConfig analysisConfig;
+    if (audioDecimation == 2 || audioDecimation == 4) {
+        analysisConfig.decimation = audioDecimation;
+        analysisConfig.maxHz = 0.35f * (float)analysisConfig.sampleRate / (float)audioDecimation;
+    }
+    g_Analysis = std::make_unique<Netease::AnalysisThread>(Netease::AudioCapture::Instance().Ring(), analysisConfig);
+    g_Analysis->Start();
     
     std::string installPath = NeteaseDriver::GetInstallPath();
     bool hookInstalled = false;
@@ -826,10 +788,8 @@ int main(int argc, char* argv[]) {
         g_Tonearm.Update(state.isPlaying == 1, deltaTime);
         
         // --- v0.1.2: 更新频谱分析 ---
-        auto samples = Netease::AudioCapture::Instance().GetSamples(1024);
-        auto magnitudes = Netease::FftHelper::Analyze(samples);
-        auto bands = Netease::FftHelper::CalculateBands(magnitudes, 32);
-        Netease::Visualizer::Instance().Update(bands, deltaTime);
+        // v0.1.4: 只取分析线程发布的最新帧，渲染耗时与 FFT 尺寸无关
+        Netease::Visualizer::Instance().Update(g_Analysis->Latest().bands, deltaTime);
 
         // --- 更新入场动画 (Ease-Out Snappier) ---
         if (entranceOffset > 0.1f) {
@@ -941,10 +901,7 @@ int main(int argc, char* argv[]) {
                 auto t3 = std::chrono::high_resolution_clock::now();
                 g_SongCache.lyric = Netease::API::GetLyric(numericId);
                 if (g_SongCache.lyric) {
-                    g_SongCache.lyrics = ParseLyrics(
-                        g_SongCache.lyric->lrc, 
-                        g_SongCache.lyric->tlyric + "\n" + g_SongCache.lyric->romalrc
-                    );
+                    g_SongCache.lyrics = ParseLyrics(*g_SongCache.lyric);
                 } else {
                     g_SongCache.lyrics.Clear();
                 }
@@ -1172,7 +1129,12 @@ int main(int argc, char* argv[]) {
             if (g_SongCache.lyrics.currentIndex >= 0) {
                 targetScroll = g_SongCache.lyrics.currentIndex * (float)lineHeight;
             }
-            g_SongCache.lyrics.scrollOffset += (targetScroll - g_SongCache.lyrics.scrollOffset) * 0.1f;
+            if (g_SongCache.lyrics.snapScroll) {
+                g_SongCache.lyrics.scrollOffset = targetScroll;
+                g_SongCache.lyrics.snapScroll = false;
+            } else {
+                g_SongCache.lyrics.scrollOffset += (targetScroll - g_SongCache.lyrics.scrollOffset) * 0.1f;
+            }
             
             if (g_SongCache.isLoading) {
                 DrawUICentered("Loading lyrics...", lyricCenterX, lyricZoneY, 15, ColorAlpha(THEME_PRIMARY, 0.6f));
@@ -1286,6 +1248,7 @@ int main(int argc, char* argv[]) {
     }
     
     // === Cleanup: 正确释放所有资源 (VRAM Leak Prevention) ===
+    g_Analysis->Stop();
     Netease::AudioCapture::Instance().Stop();
     Netease::AlbumCover::ClearTextureCache();
     
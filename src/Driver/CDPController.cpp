@@ -121,6 +121,51 @@ static const char* POLL_PAYLOAD = R"(
 })();
 )";
 
+// v0.1.4: 读取播放队列中当前歌曲之后的歌曲 ID
+// 数据来源按顺序尝试：
+// 1. window.__NCM_QUEUE__（外部注入 / 测试替身，数组元素为 ID 或 {id}）
+// 2. localStorage 中形如播放列表的数组（键名包含 play/queue/list）
+// 当前歌曲由进度监听中的 songId 定位；找不到时从队首开始
+static const char* QUEUE_PAYLOAD = R"(
+(function(limit) {
+    function idOf(item) {
+        if (item == null) return '';
+        if (typeof item !== 'object') return String(item);
+        var v = item.id || item.songId || item.trackId ||
+                (item.track && item.track.id) || (item.data && item.data.id) || '';
+        return String(v);
+    }
+    function toIds(list) {
+        var ids = [];
+        for (var i = 0; i < list.length; i++) {
+            var id = idOf(list[i]);
+            if (/^[0-9]+$/.test(id)) ids.push(id);
+        }
+        return ids;
+    }
+
+    var ids = [];
+    try {
+        if (Array.isArray(window.__NCM_QUEUE__)) {
+            ids = toIds(window.__NCM_QUEUE__);
+        }
+        if (!ids.length && window.localStorage) {
+            for (var k = 0; k < localStorage.length && !ids.length; k++) {
+                var key = localStorage.key(k);
+                if (!/play|queue|list/i.test(key)) continue;
+                var value;
+                try { value = JSON.parse(localStorage.getItem(key)); } catch (e) { continue; }
+                if (value && !Array.isArray(value)) value = value.list || value.queue || value.tracks;
+                if (Array.isArray(value) && value.length > 1) ids = toIds(value);
+            }
+        }
+    } catch (e) {}
+
+    var current = String((window.__NCM_PROGRESS__ || {}).songId || '').split('_')[0];
+    var start = ids.indexOf(current) + 1;
+    return { queue: ids.slice(start, start + limit) };
+})(%LIMIT%);
+)";
 
 // ============================================================
 // 构造/析构
@@ -381,3 +426,38 @@ bool CDPController::PollProgress(double& outTime, double& outDuration, std::stri
     
     return outTime > 0;
 }
+
+// ============================================================
+// 播放队列 (v0.1.4)
+// ============================================================
+
+bool CDPController::GetUpcomingQueue(size_t maxCount, std::vector<std::string>& outSongIds) {
+    outSongIds.clear();
+    
+    std::string payload = QUEUE_PAYLOAD;
+    size_t placeholder = payload.find("%LIMIT%");
+    payload.replace(placeholder, 7, std::to_string(maxCount));
+    
+    std::string result = Evaluate(payload);
+    if (result.empty()) {
+        return false;
+    }
+    
+    // 解析 "queue":["1","2",...]
+    size_t queuePos = result.find("\"queue\"");
+    if (queuePos == std::string::npos) {
+        return false;
+    }
+    size_t arrayStart = result.find('[', queuePos);
+    size_t arrayEnd = result.find(']', arrayStart);
+    if (arrayStart == std::string::npos || arrayEnd == std::string::npos) {
+        return false;
+    }
+    
+    std::string array = result.substr(arrayStart, arrayEnd - arrayStart);
+    std::regex idRegex("\"([0-9]+)\"");
+    for (std::sregex_iterator it(array.begin(), array.end(), idRegex), end; it != end; ++it) {
+        outSongIds.push_back((*it)[1].str());
+    }
+    return true;
+}
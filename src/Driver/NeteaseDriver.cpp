@@ -9,6 +9,8 @@
 #include "CDPController.h"
 #include "SimpleLog.h"
 #include "LogRedirect.h"
+#include "Prefetcher.h"
+#include "NeteaseAPI.h"
 #include <iostream>
 #include <cstring>
 #include <atomic>
@@ -29,11 +31,17 @@ NeteaseDriver::NeteaseDriver()
     , m_LastTime(0)
     , m_LastDuration(0)
     , m_LastUpdateTimestamp(0) 
+    , m_PrefetchDepth(0)
+    , m_LastQueuePoll(0)
 {
+    Netease::Prefetcher::Options options;
+    options.depth = 0;      // 由 SetPrefetchDepth 启用
+    m_Prefetcher = std::make_unique<Netease::Prefetcher>(options);
 }
 
 NeteaseDriver::~NeteaseDriver() {
     Disconnect();
+    m_Prefetcher.reset();
 }
 
 NeteaseDriver& NeteaseDriver::Instance() {
@@ -155,7 +163,10 @@ void NeteaseDriver::Disconnect() {
         m_MonitorThread.join();
     }
 
-    // 2. 断开连接并清理
+    // 2. 停止预取线程（队列只由监控线程更新，重新连接后再次启动）
+    m_Prefetcher->Stop();
+
+    // 3. 断开连接并清理
     std::lock_guard<std::mutex> lock(m_Mutex);
     if (m_CDP) {
         m_CDP->Disconnect();
@@ -516,6 +527,53 @@ void NeteaseDriver::SetTrackChangedCallback(TrackChangedCallback callback) {
     m_Callback = callback;
 }
 
+// ============================================================
+// 播放队列预取 (v0.1.4)
+// ============================================================
+
+// 队列轮询间隔：切歌时立即读取，其余时间低频刷新（捕获用户手动调整队列）
+static const unsigned long long QUEUE_POLL_INTERVAL_MS = 5000;
+
+void NeteaseDriver::SetPrefetchDepth(int depth) {
+    if (depth < 0) depth = 0;
+    m_PrefetchDepth = depth;
+    m_LastQueuePoll = 0;    // 下一轮监控立即读取队列
+    m_Prefetcher->SetDepth((size_t)depth);
+}
+
+void NeteaseDriver::SetPrefetchCoverCallback(CoverWarmCallback callback) {
+    m_Prefetcher->SetCoverWarmer(std::move(callback));
+}
+
+void NeteaseDriver::RefreshPrefetchQueue(const std::string& currentSongId) {
+    int depth = m_PrefetchDepth.load();
+    if (depth <= 0) return;
+    
+    // 失败也计入轮询时间：读取失败时按正常间隔重试，不在每轮监控中重复执行 Runtime.evaluate
+    m_LastQueuePoll = GetTickCount64();
+    
+    std::vector<std::string> rawIds;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (!m_CDP || !m_CDP->IsConnected()) return;
+        if (!m_CDP->GetUpcomingQueue((size_t)depth, rawIds)) return;
+    }
+    
+    long long current = 0;
+    try { current = std::stoll(currentSongId); } catch (...) {}
+    
+    std::vector<long long> upcoming;
+    for (const auto& rawId : rawIds) {
+        try {
+            long long songId = std::stoll(rawId);
+            if (songId != current) upcoming.push_back(songId);
+        } catch (...) {}
+    }
+    
+    // 预取线程自行调度，这里不持有 m_Mutex
+    m_Prefetcher->UpdateQueue(upcoming);
+}
+
 void NeteaseDriver::MonitorLoop() {
     std::string currentSongId = "";
     
@@ -555,6 +613,7 @@ void NeteaseDriver::MonitorLoop() {
 
         std::string songId;
         double t, d;
+        bool trackChanged = false;
         
         {
             std::lock_guard<std::mutex> lock(m_Mutex);
@@ -568,6 +627,7 @@ void NeteaseDriver::MonitorLoop() {
                     // 检查歌曲变更
                     if (!songId.empty() && songId != currentSongId) {
                         currentSongId = songId;
+                        trackChanged = true;
                         if (m_Callback) {
                             m_Callback(songId);
                         }
@@ -575,6 +635,11 @@ void NeteaseDriver::MonitorLoop() {
                 }
             }
         }
+        
+        // v0.1.4: 切歌或到达轮询间隔时刷新预取队列
+        if (trackChanged || GetTickCount64() - m_LastQueuePoll >= QUEUE_POLL_INTERVAL_MS) {
+            RefreshPrefetchQueue(currentSongId);
+        }
     }
 }
 
@@ -589,6 +654,7 @@ extern "C" {
 
     void NETEASE_API Netease_Disconnect() {
         NeteaseDriver::Instance().Disconnect();
+        Netease::API::Shutdown();   // v0.1.4: 缓存刷新、淘汰与对冲请求线程
     }
 
     bool NETEASE_API Netease_GetState(IPC::NeteaseState* outState) {
@@ -637,6 +703,75 @@ extern "C" {
         }
     }
 
+    // v0.1.4: 播放队列预取
+    void NETEASE_API Netease_SetPrefetchDepth(int depth) {
+        NeteaseDriver::Instance().SetPrefetchDepth(depth);
+    }
+
+    typedef void (*Netease_CoverWarmCallback)(long long songId, const char* coverUrl);
+    static Netease_CoverWarmCallback g_CCoverCallback = nullptr;
+
+    void NETEASE_API Netease_SetPrefetchCoverCallback(Netease_CoverWarmCallback callback) {
+        g_CCoverCallback = callback;
+        if (callback) {
+            NeteaseDriver::Instance().SetPrefetchCoverCallback([](long long songId, const std::string& coverUrl) {
+                if (g_CCoverCallback) {
+                    g_CCoverCallback(songId, coverUrl.c_str());
+                }
+            });
+        } else {
+            NeteaseDriver::Instance().SetPrefetchCoverCallback(nullptr);
+        }
+    }
+
+    // v0.1.4: 歌词时间轴（句柄为不透明指针，由 Netease_LrcFree 释放）
+    typedef struct Netease_LrcTimeline Netease_LrcTimeline;
+
+    Netease_LrcTimeline* NETEASE_API Netease_LrcParse(const char* lrc, const char* tlyric, const char* romalrc, int toleranceMs) {
+        auto* timeline = new Netease::LrcTimeline(Netease::API::ParseTimeline(
+            lrc ? lrc : "", tlyric ? tlyric : "", romalrc ? romalrc : "", toleranceMs));
+        return reinterpret_cast<Netease_LrcTimeline*>(timeline);
+    }
+
+    void NETEASE_API Netease_LrcFree(Netease_LrcTimeline* handle) {
+        delete reinterpret_cast<Netease::LrcTimeline*>(handle);
+    }
+
+    int NETEASE_API Netease_LrcCount(const Netease_LrcTimeline* handle) {
+        if (!handle) return 0;
+        return (int)reinterpret_cast<const Netease::LrcTimeline*>(handle)->Size();
+    }
+
+    long long NETEASE_API Netease_LrcTimeMs(const Netease_LrcTimeline* handle, int index) {
+        auto* timeline = reinterpret_cast<const Netease::LrcTimeline*>(handle);
+        if (!timeline || index < 0 || index >= (int)timeline->Size()) return -1;
+        return timeline->timesMs[index];
+    }
+
+    // 返回的字符串由句柄持有，Netease_LrcFree 之后失效；无翻译 / 罗马音时返回 NULL
+    const char* NETEASE_API Netease_LrcText(const Netease_LrcTimeline* handle, int index) {
+        auto* timeline = reinterpret_cast<const Netease::LrcTimeline*>(handle);
+        if (!timeline || index < 0 || index >= (int)timeline->Size()) return nullptr;
+        return timeline->SpanCStr(timeline->text[index]);
+    }
+
+    const char* NETEASE_API Netease_LrcTranslation(const Netease_LrcTimeline* handle, int index) {
+        auto* timeline = reinterpret_cast<const Netease::LrcTimeline*>(handle);
+        if (!timeline || index < 0 || index >= (int)timeline->Size()) return nullptr;
+        return timeline->SpanCStr(timeline->translation[index]);
+    }
+
+    const char* NETEASE_API Netease_LrcRomaji(const Netease_LrcTimeline* handle, int index) {
+        auto* timeline = reinterpret_cast<const Netease::LrcTimeline*>(handle);
+        if (!timeline || index < 0 || index >= (int)timeline->Size()) return nullptr;
+        return timeline->SpanCStr(timeline->romaji[index]);
+    }
+
+    int NETEASE_API Netease_LrcFind(const Netease_LrcTimeline* handle, long long timeMs) {
+        if (!handle) return -1;
+        return reinterpret_cast<const Netease::LrcTimeline*>(handle)->FindLine(timeMs);
+    }
+
     int NETEASE_API Netease_GetInstallPath(char* buffer, int maxLen) {
         std::string path = NeteaseDriver::GetInstallPath();
         if (buffer && maxLen > 0) {
@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <vector>
 #include <functional>
 
 /**
@@ -61,6 +62,14 @@ public:
      */
     bool PollProgress(double& outTime, double& outDuration, std::string& outSongId);
     
+    /**
+     * 读取播放队列中当前歌曲之后的歌曲 (v0.1.4)
+     * @param maxCount 最多返回几首
+     * @param outSongIds 输出：按播放顺序排列的歌曲 ID
+     * @return 页面执行成功（队列可能为空）
+     */
+    bool GetUpcomingQueue(size_t maxCount, std::vector<std::string>& outSongIds);
+    
     /**
      * 检查是否已连接
      */
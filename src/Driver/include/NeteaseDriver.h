@@ -3,11 +3,13 @@
 #include <mutex>
 #include <thread>
 #include <atomic>
+#include <memory>
 #include <functional>
 #include "SharedData.hpp"
 
 // 前向声明
 class CDPController;
+namespace Netease { class Prefetcher; }
 
 // 调用约定宏 (Calling Convention)
 // 确保跨编译器/跨架构兼容性，特别是 x86 环境
@@ -51,6 +53,7 @@ public:
     // 回调函数类型定义
     using TrackChangedCallback = std::function<void(const std::string&)>;
     using LogCallback = std::function<void(const std::string& level, const std::string& msg)>;
+    using CoverWarmCallback = std::function<void(long long songId, const std::string& coverUrl)>;
 
     /**
      * 构造函数
@@ -99,6 +102,26 @@ public:
      */
     void SetLogCallback(LogCallback callback);
 
+    // =======================================================
+    // 播放队列预取 API (v0.1.4)
+    // =======================================================
+
+    /**
+     * 设置预取深度
+     * 
+     * 启用后监控线程定期读取播放队列，在后台（低优先级）提前获取
+     * 接下来 depth 首歌曲的元数据与歌词并写入缓存；队列变化时取消过期任务
+     * 
+     * @param depth 预取接下来几首，0 = 关闭（默认关闭）
+     */
+    void SetPrefetchDepth(int depth);
+
+    /**
+     * 设置封面预热回调
+     * 在预取线程中调用，由调用方下载 / 缓存封面（SDK 不处理图片）
+     */
+    void SetPrefetchCoverCallback(CoverWarmCallback callback);
+
     // =======================================================
     // 日志控制 API (v0.1.2)
     // =======================================================
@@ -144,6 +167,11 @@ private:
      */
     void MonitorLoop();
 
+    /**
+     * 读取播放队列并更新预取任务（监控线程调用）
+     */
+    void RefreshPrefetchQueue(const std::string& currentSongId);
+
     // 内部日志辅助函数
     void Log(const std::string& level, const std::string& msg) const;
 
@@ -165,6 +193,11 @@ private:
     unsigned long long m_LastUpdateTimestamp; // 上次状态变化的时间戳 (GetTickCount64)
     std::string m_LastSongId;
 
+    // v0.1.4: 播放队列预取（Disconnect 时停止后台线程，析构时释放）
+    std::unique_ptr<Netease::Prefetcher> m_Prefetcher;
+    std::atomic<int> m_PrefetchDepth;
+    std::atomic<unsigned long long> m_LastQueuePoll;   // 上次读取队列的时间戳 (GetTickCount64)
+
 public:
     // =======================================================
     // 自动部署 API (Installer)
@@ -0,0 +1,81 @@
+#pragma once
+/**
+ * CpuFeatures.h - CPU 指令集运行时探测 (v0.1.4)
+ *
+ * SDK (JSON 内核) 与 App (频谱内核) 共用的轻量级探测：
+ * - 首次调用时执行 CPUID，结果缓存为静态常量
+ * - AVX2 额外校验 OS 是否保存 YMM 状态 (XGETBV)
+ * - 非 x86 平台只报告 NEON
+ *
+ * 使用示例:
+ *   if (Netease::Cpu::Get().avx2) { ... }
+ */
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define NETEASE_ARCH_X86 1
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #endif
+    #include <immintrin.h>
+#elif defined(_M_ARM64) || defined(__aarch64__) || defined(__ARM_NEON)
+    #define NETEASE_ARCH_NEON 1
+    #include <arm_neon.h>
+#endif
+
+// GCC/Clang 需要逐函数开启指令集；MSVC 可直接使用内建函数
+#if defined(__GNUC__) || defined(__clang__)
+    #define NETEASE_TARGET_SSE2 __attribute__((target("sse2")))
+    #define NETEASE_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+    #define NETEASE_TARGET_SSE2
+    #define NETEASE_TARGET_AVX2
+#endif
+
+namespace Netease::Cpu {
+
+    struct Features {
+        bool sse2 = false;
+        bool avx2 = false;
+        bool fma = false;
+        bool neon = false;
+    };
+
+    inline Features Detect() {
+        Features f;
+#if defined(NETEASE_ARCH_X86)
+    #if defined(_MSC_VER)
+        int info[4] = {0};
+        __cpuid(info, 0);
+        int maxLeaf = info[0];
+
+        __cpuid(info, 1);
+        f.sse2 = ((info[3] >> 26) & 1) != 0;
+        bool osxsave = ((info[2] >> 27) & 1) != 0;
+        bool avx = ((info[2] >> 28) & 1) != 0;
+        bool fma = ((info[2] >> 12) & 1) != 0;
+
+        // 操作系统必须同时保存 XMM/YMM 寄存器
+        bool ymmEnabled = osxsave && avx && ((_xgetbv(0) & 0x6) == 0x6);
+        if (maxLeaf >= 7) {
+            __cpuidex(info, 7, 0);
+            f.avx2 = ymmEnabled && (((info[1] >> 5) & 1) != 0);
+        }
+        f.fma = ymmEnabled && fma;
+    #else
+        __builtin_cpu_init();
+        f.sse2 = __builtin_cpu_supports("sse2") != 0;
+        f.avx2 = __builtin_cpu_supports("avx2") != 0;
+        f.fma = __builtin_cpu_supports("fma") != 0;
+    #endif
+#elif defined(NETEASE_ARCH_NEON)
+        f.neon = true;
+#endif
+        return f;
+    }
+
+    inline const Features& Get() {
+        static const Features features = Detect();
+        return features;
+    }
+
+} // namespace Netease::Cpu
@@ -0,0 +1,887 @@
+/**
+ * AudioBench.cpp - 音频分析流水线离线基准
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ *
+ * 不依赖音频设备与窗口：把采样来源（合成信号 / WAV / 原始 PCM）
+ * 以最快速度推过 采集 → 下混 → 环形缓冲区 → FFT → 频带 → 三缓冲发布 → 读取，
+ * 报告吞吐量（分析帧/秒、实时倍数）、各阶段耗时与堆分配次数。
+ *
+ * --micro 改为运行各组件的微基准（单元测试只校验正确性，耗时对比放在这里）。
+ *
+ * 用法：
+ *   NeteaseAudioBench [选项]
+ *
+ *   --synthetic          合成信号（默认）
+ *   --wav <file>         WAV 文件（循环读取直到 --seconds）
+ *   --raw <file>         原始 PCM 文件，格式由下面三项给出
+ *   --rate <hz>          原始 PCM 采样率（默认 48000）
+ *   --channels <n>       原始 PCM 声道数（默认 2）
+ *   --format <fmt>       原始 PCM 编码：s16 / s24 / s32 / f32（默认 f32）
+ *   --seconds <s>        推入的音频时长（默认 3600，即 1 小时）
+ *   --fft <n>            FFT 尺寸（默认 1024）
+ *   --hop <n>            分析步长，按采集样本计（默认为窗口时长的一半）
+ *   --bands <n>          频带数（默认 32）
+ *   --decimate <n>       分析前降采样倍数（默认 1 = 关闭；FFT 尺寸按降采样后计）
+ *   --max-hz <hz>        最后一个频带的上沿（默认 16000，超过降采样后的 Nyquist 时截断）
+ *   --block <n>          每次读取的帧数（默认 480，即 10ms @ 48kHz）
+ *
+ *   --micro              运行组件微基准（不跑流水线）
+ *   --only <name>        只运行指定微基准（可重复，隐含 --micro）
+ *   --list               列出所有微基准
+ *   --scale <x>          微基准迭代次数倍率（默认 1；冒烟测试可用 0.05）
+ *
+ * 退出码：0 = 成功，1 = 来源打开失败，2 = 参数错误
+ */
+
+#include "SampleSource.h"
+#include "AnalysisThread.h"
+#include "FftHelper.h"
+#include "SpectrumKernels.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <complex>
+#include <random>
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <deque>
+#include <mutex>
+#include <new>
+
+// ============================================================================
+// 堆分配计数（替换全局 operator new）
+// ============================================================================
+
+namespace {
+std::atomic<uint64_t> g_Allocations{0};
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t size) {
+    g_Allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * 单个阶段的累计耗时与分配次数
+ */
+struct Stage {
+    const char* name;
+    double seconds = 0;
+    uint64_t allocations = 0;
+    uint64_t calls = 0;
+
+    template <typename Fn>
+    auto Run(Fn&& fn) {
+        uint64_t allocBefore = g_Allocations.load(std::memory_order_relaxed);
+        auto begin = Clock::now();
+        auto result = fn();
+        seconds += std::chrono::duration<double>(Clock::now() - begin).count();
+        allocations += g_Allocations.load(std::memory_order_relaxed) - allocBefore;
+        calls++;
+        return result;
+    }
+};
+
+// ============================================================================
+// 组件微基准 (--micro)
+// ============================================================================
+
+struct MicroOptions {
+    double scale = 1.0;
+};
+
+int Iterations(const MicroOptions& options, int base) {
+    int n = (int)(base * options.scale);
+    return n > 0 ? n : 1;
+}
+
+/**
+ * 计时：返回 fn 执行 iterations 次的平均耗时（微秒）
+ */
+template <typename Fn>
+double TimeUs(int iterations, Fn&& fn) {
+    auto begin = Clock::now();
+    for (int i = 0; i < iterations; i++) fn(i);
+    return std::chrono::duration<double, std::micro>(Clock::now() - begin).count() / iterations;
+}
+
+/**
+ * 模拟音乐：几个正弦分量 + 少量白噪声，幅度在 [-1, 1] 内
+ */
+std::vector<float> MakeSignal(size_t n, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> noise(-0.05f, 0.05f);
+    std::vector<float> samples(n);
+    for (size_t i = 0; i < n; i++) {
+        double t = (double)i / 48000.0;
+        samples[i] = (float)(0.5 * sin(2 * M_PI * 55.0 * t) + 0.25 * sin(2 * M_PI * 440.0 * t) +
+                             0.1 * sin(2 * M_PI * 3520.0 * t)) + noise(rng);
+    }
+    return samples;
+}
+
+/**
+ * 计时期间强制使用指定内核，析构时恢复自动选择
+ */
+class ScopedKernel {
+public:
+    explicit ScopedKernel(Netease::Spectrum::Kernel kernel) : m_Ok(Netease::Spectrum::SetKernel(kernel)) {}
+    ~ScopedKernel() { Netease::Spectrum::SetKernel(Netease::Spectrum::Kernel::Auto); }
+    bool Ok() const { return m_Ok; }
+
+private:
+    bool m_Ok;
+};
+
+const char* KernelName(Netease::Spectrum::Kernel kernel) {
+    switch (kernel) {
+        case Netease::Spectrum::Kernel::Scalar: return "Scalar";
+        case Netease::Spectrum::Kernel::SSE2: return "SSE2";
+        case Netease::Spectrum::Kernel::AVX2: return "AVX2";
+        case Netease::Spectrum::Kernel::NEON: return "NEON";
+        default: return "Auto";
+    }
+}
+
+const Netease::Spectrum::Kernel ALL_KERNELS[] = {
+    Netease::Spectrum::Kernel::Scalar,
+    Netease::Spectrum::Kernel::SSE2,
+    Netease::Spectrum::Kernel::AVX2,
+    Netease::Spectrum::Kernel::NEON,
+};
+
+// ----------------------------------------------------------------------------
+// fft: 预计算计划的迭代 FFT vs v0.1.3 递归实现
+// ----------------------------------------------------------------------------
+
+// v0.1.3 的递归实现（每层分配两个子数组），基线
+void LegacyComputeFFT(std::vector<std::complex<double>>& a) {
+    size_t n = a.size();
+    if (n <= 1) return;
+
+    std::vector<std::complex<double>> a0(n / 2), a1(n / 2);
+    for (size_t i = 0; i * 2 < n; i++) {
+        a0[i] = a[i * 2];
+        a1[i] = a[i * 2 + 1];
+    }
+
+    LegacyComputeFFT(a0);
+    LegacyComputeFFT(a1);
+
+    double ang = 2 * M_PI / n;
+    std::complex<double> w(1), wn(cos(ang), sin(ang));
+    for (size_t i = 0; i * 2 < n; i++) {
+        a[i] = a0[i] + w * a1[i];
+        a[i + n / 2] = a0[i] - w * a1[i];
+        w *= wn;
+    }
+}
+
+std::vector<float> LegacyAnalyze(const std::vector<float>& samples) {
+    size_t n = samples.size();
+    std::vector<std::complex<double>> data(n);
+    for (size_t i = 0; i < n; i++) {
+        double window = 0.5 * (1.0 - cos(2.0 * M_PI * i / (n - 1)));
+        data[i] = std::complex<double>(samples[i] * window, 0.0);
+    }
+
+    LegacyComputeFFT(data);
+
+    std::vector<float> magnitudes(n / 2);
+    for (size_t i = 0; i < n / 2; i++) {
+        magnitudes[i] = (float)std::abs(data[i]) / (float)n;
+    }
+    return magnitudes;
+}
+
+void MicroFft(const MicroOptions& options) {
+    for (size_t n : { 1024u, 2048u, 4096u }) {
+        auto samples = MakeSignal(n, 7);
+        Netease::FftPlan plan(n);
+        std::vector<std::complex<double>> work(n);
+        std::vector<float> magnitudes(n / 2);
+
+        const int iterations = Iterations(options, (int)(2000 * 1024 / n));
+        double sink = 0;
+        double legacyUs = TimeUs(iterations, [&](int) { sink += LegacyAnalyze(samples)[1]; });
+        double planUs = TimeUs(iterations, [&](int) {
+            plan.Analyze(samples.data(), work.data(), magnitudes.data());
+            sink += magnitudes[1];
+        });
+        std::cout << "  " << std::setw(5) << n << " points: recursive " << legacyUs << " us, plan " << planUs
+                  << " us, speedup " << legacyUs / planUs << "x (" << sink << ")" << std::endl;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// realfft: 实数输入 FFT（N/2 点复数 FFT + 拆分）vs N 点复数 FFT
+// ----------------------------------------------------------------------------
+
+void MicroRealFft(const MicroOptions& options) {
+    // NeteaseMonitor 每帧分析 1024 点；2048 / 4096 为更高分辨率的候选尺寸
+    for (size_t n : { 1024u, 2048u, 4096u }) {
+        auto samples = MakeSignal(n, 9);
+        Netease::FftPlan complexPlan(n);
+        Netease::RealFftPlan realPlan(n);
+        std::vector<std::complex<double>> complexWork(n);
+        std::vector<std::complex<double>> realWork(n / 2);
+        std::vector<float> magnitudes(n / 2);
+
+        const int iterations = Iterations(options, (int)(4000 * 1024 / n));
+        double sink = 0;
+        double complexUs = TimeUs(iterations, [&](int) {
+            complexPlan.Analyze(samples.data(), complexWork.data(), magnitudes.data());
+            sink += magnitudes[1];
+        });
+        double realUs = TimeUs(iterations, [&](int) {
+            realPlan.Analyze(samples.data(), realWork.data(), magnitudes.data());
+            sink += magnitudes[1];
+        });
+        std::cout << "  " << std::setw(5) << n << " points: complex " << complexUs << " us, real " << realUs
+                  << " us, speedup " << complexUs / realUs << "x, workspace " << n * sizeof(std::complex<double>)
+                  << " -> " << n / 2 * sizeof(std::complex<double>) << " bytes (" << sink << ")" << std::endl;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// spectrum: 单精度 SoA 实数 FFT（各 SIMD 内核）vs 双精度 RealFftPlan
+// ----------------------------------------------------------------------------
+
+void MicroSpectrum(const MicroOptions& options) {
+    for (size_t n : { 1024u, 2048u, 4096u }) {
+        auto samples = MakeSignal(n, 11);
+        const int iterations = Iterations(options, (int)(8000 * 1024 / n));
+        float sink = 0;
+
+        Netease::RealFftPlan reference(n);
+        std::vector<std::complex<double>> work(n / 2);
+        std::vector<float> magnitudes(n / 2);
+        double doubleUs = TimeUs(iterations, [&](int) {
+            reference.Analyze(samples.data(), work.data(), magnitudes.data());
+            sink += magnitudes[1];
+        });
+        std::cout << "  " << std::setw(5) << n << " points: double " << doubleUs << " us";
+
+        Netease::Spectrum::RealFftPlanF plan(n);
+        std::vector<float> workRe(n / 2), workIm(n / 2);
+        for (auto kernel : ALL_KERNELS) {
+            ScopedKernel scoped(kernel);
+            if (!scoped.Ok()) continue;
+            double us = TimeUs(iterations, [&](int) {
+                plan.Analyze(samples.data(), workRe.data(), workIm.data(), magnitudes.data());
+                sink += magnitudes[1];
+            });
+            std::cout << ", " << KernelName(kernel) << " " << us << " us (" << doubleUs / us << "x)";
+        }
+        std::cout << " (" << sink << ")" << std::endl;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// ring: 采集回调延迟，SpscRing vs v0.1.3 deque + mutex
+// ----------------------------------------------------------------------------
+
+/**
+ * v0.1.3 的采集缓冲区：回调内加锁，逐样本 push_back + pop_front
+ */
+struct LegacyCaptureBuffer {
+    std::deque<float> buffer;
+    std::mutex mutex;
+
+    void OnData(const float* input, unsigned int frameCount) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (unsigned int i = 0; i < frameCount; i++) {
+            float sample = (input[i * 2] + input[i * 2 + 1]) / 2;
+            buffer.push_back(sample);
+            while (buffer.size() > 4096) buffer.pop_front();
+        }
+    }
+
+    std::vector<float> GetSamples(size_t count) {
+        std::vector<float> samples;
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t toCopy = (std::min)(count, buffer.size());
+        samples.assign(buffer.end() - toCopy, buffer.end());
+        samples.insert(samples.begin(), count - samples.size(), 0.0f);
+        return samples;
+    }
+};
+
+/**
+ * 与 AudioCapture::OnDataInternal 相同的写入方式：栈上分块混合 + 整块写入
+ */
+void RingOnData(Netease::SpscRing<float>& ring, const float* input, unsigned int frameCount) {
+    float mono[256];
+    for (unsigned int offset = 0; offset < frameCount; offset += 256) {
+        unsigned int frames = (std::min)(256u, frameCount - offset);
+        const float* frame = input + (size_t)offset * 2;
+        for (unsigned int i = 0; i < frames; i++) mono[i] = (frame[i * 2] + frame[i * 2 + 1]) / 2;
+        ring.Write(mono, frames);
+    }
+}
+
+void MicroRing(const MicroOptions& options) {
+    // WASAPI 每 10ms 一个回调：48kHz 立体声 480 帧；UI 线程同时不停读取 1024 个样本
+    const unsigned int frames = 480;
+    const int callbacks = Iterations(options, 20000);
+    std::vector<float> input(frames * 2);
+    for (size_t i = 0; i < input.size(); i++) input[i] = (float)sin(0.01 * i);
+
+    auto run = [&](auto&& onData, auto&& readLatest) {
+        Netease::LatencyHistogram histogram;
+        std::atomic<bool> stop{false};
+        std::thread reader([&] {
+            float sink = 0;
+            while (!stop.load(std::memory_order_relaxed)) sink += readLatest();
+            (void)sink;
+        });
+        for (int i = 0; i < callbacks; i++) {
+            auto begin = Clock::now();
+            onData(input.data(), frames);
+            auto elapsed = Clock::now() - begin;
+            histogram.Record((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+        stop = true;
+        reader.join();
+        return histogram.Read();
+    };
+
+    LegacyCaptureBuffer legacy;
+    auto legacyStats = run([&](const float* data, unsigned int count) { legacy.OnData(data, count); },
+                           [&] { return legacy.GetSamples(1024).back(); });
+
+    Netease::SpscRing<float> ring(16384);
+    std::vector<float> snapshot(1024);
+    auto ringStats = run([&](const float* data, unsigned int count) { RingOnData(ring, data, count); },
+                         [&] {
+                             ring.ReadLatest(snapshot.data(), snapshot.size());
+                             return snapshot.back();
+                         });
+
+    auto print = [](const char* name, const Netease::LatencyHistogram::Snapshot& stats) {
+        std::cout << "  " << std::setw(13) << name << ": mean " << stats.MeanNs() / 1000.0 << " us, p50 <= "
+                  << stats.PercentileNs(0.5) / 1000.0 << " us, p99 <= " << stats.PercentileNs(0.99) / 1000.0
+                  << " us, max " << stats.maxNs / 1000.0 << " us" << std::endl;
+    };
+    print("deque + mutex", legacyStats);
+    print("SpscRing", ringStats);
+    std::cout << "  speedup (mean) " << legacyStats.MeanNs() / ringStats.MeanNs() << "x, reader retries "
+              << ring.Retries() << std::endl;
+}
+
+// ----------------------------------------------------------------------------
+// context: 每帧 采集 -> 频带，分析上下文（零分配）vs 按值返回接口
+// ----------------------------------------------------------------------------
+
+void MicroContext(const MicroOptions& options) {
+    auto samples = MakeSignal(1024, 46);
+    Netease::SpscRing<float> ring(16384);
+    ring.Write(samples.data(), samples.size());
+    Netease::AnalysisContext context(1024, 32);
+
+    const int iterations = Iterations(options, 20000);
+    float sink = 0;
+    Stage vector{ "vector" }, zeroCopy{ "context" };
+    vector.Run([&] {
+        return TimeUs(iterations, [&](int) {
+            std::vector<float> frame(1024);
+            ring.ReadLatest(frame.data(), frame.size());
+            auto magnitudes = Netease::FftHelper::Analyze(frame);
+            sink += Netease::FftHelper::CalculateBands(magnitudes, 32)[3];
+        });
+    });
+    zeroCopy.Run([&] {
+        return TimeUs(iterations, [&](int) {
+            ring.ReadLatest(context.Samples().data(), context.FftSize());
+            sink += context.Process()[3];
+        });
+    });
+
+    // 差异主要来自分配器，受运行环境影响大
+    for (const Stage* stage : { &vector, &zeroCopy }) {
+        std::cout << "  " << std::setw(7) << stage->name << ": " << stage->seconds * 1e6 / iterations
+                  << " us/frame, " << (double)stage->allocations / iterations << " allocations/frame" << std::endl;
+    }
+    std::cout << "  (" << sink << ")" << std::endl;
+}
+
+// ----------------------------------------------------------------------------
+// thread: 渲染线程每帧频谱开销，帧内分析 vs 读取分析线程结果
+// ----------------------------------------------------------------------------
+
+void MicroThread(const MicroOptions& options) {
+    for (size_t fftSize : { (size_t)1024, (size_t)4096 }) {
+        Netease::AnalysisConfig config;
+        config.fftSize = fftSize;
+        config.hopSize = fftSize / 2;
+
+        auto signal = MakeSignal(fftSize * 4, 51);
+        Netease::SpscRing<float> ring(16384);
+        ring.Write(signal.data(), signal.size());
+        Netease::AnalysisThread analysis(ring, config);
+        analysis.Pump();
+
+        Netease::AnalysisContext context(fftSize, 32);
+        const int iterations = Iterations(options, 5000);
+        float sink = 0;
+
+        // 旧路径：渲染线程每帧自己读取并分析
+        double inlineUs = TimeUs(iterations, [&](int) {
+            ring.ReadLatest(context.Samples().data(), context.FftSize());
+            sink += context.Process()[3];
+        });
+        // 新路径：渲染线程只取最新帧
+        double latestUs = TimeUs(iterations, [&](int) { sink += analysis.Latest().bands[3]; });
+
+        std::cout << "  FFT " << std::setw(4) << fftSize << ": inline analysis " << inlineUs << " us, latest frame "
+                  << std::setprecision(4) << latestUs << std::setprecision(2) << " us (" << sink << ")" << std::endl;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// bandmap: 预计算频带映射表 vs 每帧建表 / v0.1.3 线性分组
+// ----------------------------------------------------------------------------
+
+/**
+ * v0.1.3 的频带计算：等宽线性分组 + 每帧 log10f 增益，作为基线
+ */
+void LegacyCalculateBands(const std::vector<float>& magnitudes, std::vector<float>& bands) {
+    int bandCount = (int)bands.size();
+    int binsPerBand = (std::max)((int)magnitudes.size() / bandCount, 1);
+    for (int i = 0; i < bandCount; i++) {
+        float sum = 0;
+        int start = i * binsPerBand;
+        int actualBins = 0;
+        for (int j = 0; j < binsPerBand && (start + j) < (int)magnitudes.size(); j++) {
+            sum += magnitudes[start + j];
+            actualBins++;
+        }
+        bands[i] = (actualBins > 0) ? (sum / actualBins) : 0.0f;
+        float boost = 1.0f + log10f((float)i + 1.0f) * 4.0f;
+        if (i < 3) boost *= 2.5f;
+        if (i > bandCount - 5) boost *= 3.0f;
+        bands[i] *= boost;
+    }
+}
+
+void MicroBandMap(const MicroOptions& options) {
+    for (size_t fftSize : { (size_t)1024, (size_t)4096 }) {
+        auto magnitudes = Netease::FftHelper::Analyze(MakeSignal(fftSize, 54));
+        Netease::Spectrum::BandMap map(fftSize, 32);
+        std::vector<float> bands(32);
+
+        const int iterations = Iterations(options, 20000);
+        float sink = 0;
+        double legacyUs = TimeUs(iterations, [&](int) {
+            LegacyCalculateBands(magnitudes, bands);
+            sink += bands[3];
+        });
+        // 同样的三角滤波器组，每帧重新计算权重（log/exp/pow）
+        double perFrameUs = TimeUs(Iterations(options, 1000), [&](int) {
+            Netease::Spectrum::BandMap perFrame(fftSize, 32);
+            perFrame.Apply(magnitudes.data(), bands.data());
+            sink += bands[3];
+        });
+        double mapUs = TimeUs(iterations, [&](int) {
+            map.Apply(magnitudes.data(), bands.data());
+            sink += bands[3];
+        });
+        std::cout << "  FFT " << std::setw(4) << fftSize << " (" << KernelName(Netease::Spectrum::GetKernel())
+                  << "): linear v0.1.3 " << legacyUs << " us, per-frame map " << perFrameUs << " us, map " << mapUs
+                  << " us, " << map.WeightCount() << " weights (" << sink << ")" << std::endl;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// ingest: 采集接入（解码 + 下混 + 写入环形缓冲区）vs v0.1.4 之前的 f32 逐声道下混
+// ----------------------------------------------------------------------------
+
+const char* IngestKernelName(Netease::Ingest::Kernel kernel) {
+    switch (kernel) {
+        case Netease::Ingest::Kernel::Scalar: return "Scalar";
+        case Netease::Ingest::Kernel::SSE2: return "SSE2";
+        case Netease::Ingest::Kernel::AVX2: return "AVX2";
+        case Netease::Ingest::Kernel::NEON: return "NEON";
+        default: return "Auto";
+    }
+}
+
+// 小端编码 value ∈ [-1, 1)
+std::vector<uint8_t> Encode(const std::vector<float>& values, Netease::SampleFormat format) {
+    std::vector<uint8_t> out;
+    for (float v : values) {
+        switch (format) {
+            case Netease::SampleFormat::S16: {
+                int16_t s = (int16_t)std::lround(v * 32768.0f);
+                out.push_back(s & 0xFF);
+                out.push_back((s >> 8) & 0xFF);
+                break;
+            }
+            case Netease::SampleFormat::S24: {
+                int32_t s = (int32_t)std::lround(v * 8388608.0f);
+                for (int b = 0; b < 3; b++) out.push_back((s >> (8 * b)) & 0xFF);
+                break;
+            }
+            case Netease::SampleFormat::S32: {
+                int32_t s = (int32_t)std::llround((double)v * 2147483648.0);
+                for (int b = 0; b < 4; b++) out.push_back((s >> (8 * b)) & 0xFF);
+                break;
+            }
+            case Netease::SampleFormat::F32: {
+                uint8_t bytes[4];
+                std::memcpy(bytes, &v, 4);
+                out.insert(out.end(), bytes, bytes + 4);
+                break;
+            }
+        }
+    }
+    return out;
+}
+
+/**
+ * v0.1.4 之前的写入路径：逐帧逐声道累加（只支持 f32）
+ */
+void LegacyDownmix(const float* interleaved, size_t frames, int channels, float* mono) {
+    const float scale = 1.0f / (float)channels;
+    for (size_t i = 0; i < frames; i++) {
+        float sample = 0;
+        for (int c = 0; c < channels; c++) sample += interleaved[i * channels + c];
+        mono[i] = sample * scale;
+    }
+}
+
+void MicroIngest(const MicroOptions& options) {
+    // 10ms 回调块 × 多次；旧路径需要设备先转成 f32，这里只计下混部分（对旧路径有利）
+    const size_t frames = 480;
+    const int iterations = Iterations(options, 4000);
+    const Netease::SampleFormat formats[] = {
+        Netease::SampleFormat::S16, Netease::SampleFormat::S24, Netease::SampleFormat::S32, Netease::SampleFormat::F32,
+    };
+    const char* names[] = { "s16", "s24", "s32", "f32" };
+
+    for (int channels : { 2, 6, 8 }) {
+        std::mt19937 rng(91 + channels);
+        std::uniform_real_distribution<float> dist(-0.99f, 0.99f);
+        std::vector<float> values(frames * channels);
+        for (auto& v : values) v = dist(rng);
+        std::vector<float> mono(frames);
+
+        float sink = 0;
+        double legacyUs = TimeUs(iterations, [&](int i) {
+            LegacyDownmix(values.data(), frames, channels, mono.data());
+            sink += mono[i % frames];
+        });
+        std::cout << "  " << channels << " ch (" << IngestKernelName(Netease::Ingest::GetKernel())
+                  << "): legacy f32 downmix " << frames / legacyUs << " MFrames/s";
+
+        for (auto format : formats) {
+            auto encoded = Encode(values, format);
+            Netease::SpscRing<float> ring(4096);
+            double us = TimeUs(iterations, [&](int) {
+                Netease::WriteMono(ring, encoded.data(), format, channels, frames);
+            });
+            sink += ring.Written() > 0 ? 1.0f : 0.0f;
+            std::cout << ", " << names[(int)format] << " " << frames / us;
+        }
+        std::cout << " (" << sink << ")" << std::endl;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// decimate: 降采样 + 小 FFT vs 全速率大 FFT 的每帧分析开销
+// ----------------------------------------------------------------------------
+
+void MicroDecimate(const MicroOptions& options) {
+    // 频带上沿 4kHz（×4 后的平坦通带之内）；3 秒信号以 10ms 块写入并逐块 Pump，步长 512
+    const float maxHz = 4000.0f;
+    auto signal = MakeSignal((size_t)(48000 * 3 * (std::max)(options.scale, 0.1)), 13);
+
+    struct Case { size_t fft; int decimation; };
+    const Case cases[] = { { 1024, 1 }, { 4096, 1 }, { 2048, 2 }, { 1024, 4 }, { 512, 4 } };
+    for (const auto& c : cases) {
+        Netease::AnalysisConfig config;
+        config.fftSize = c.fft;
+        config.hopSize = 512;
+        config.decimation = c.decimation;
+        config.maxHz = maxHz;
+        config.maxCatchUpHops = 1u << 20;
+        Netease::SpscRing<float> ring(1u << 16);
+        Netease::AnalysisThread analysis(ring, config);
+
+        double seconds = 0;
+        for (size_t offset = 0; offset + 480 <= signal.size(); offset += 480) {
+            ring.Write(signal.data() + offset, 480);
+            auto begin = Clock::now();
+            analysis.Pump();
+            seconds += std::chrono::duration<double>(Clock::now() - begin).count();
+        }
+        double us = seconds * 1e6 / (double)(std::max)(analysis.FramesPublished(), (uint64_t)1);
+        std::cout << "  x" << c.decimation << " FFT " << std::setw(4) << c.fft << " (window "
+                  << c.fft * c.decimation * 1000 / 48000 << " ms, bin " << 48000.0 / c.decimation / c.fft
+                  << " Hz): " << us << " us/frame, " << analysis.FramesPublished() << " frames" << std::endl;
+    }
+
+    // 降采样器本身：每个输入样本的成本
+    for (int factor : { 2, 4 }) {
+        Netease::Decimator decimator(factor);
+        std::vector<float> out(decimator.MaxOutput(480));
+        float sink = 0;
+        const int iterations = Iterations(options, 20000);
+        double us = TimeUs(iterations, [&](int i) {
+            size_t offset = (size_t)(i % 100) * 480;
+            size_t produced = decimator.Process(signal.data() + offset % (signal.size() - 480), 480, out.data());
+            sink += out[produced - 1];
+        });
+        std::cout << "  Decimator x" << factor << " (" << decimator.TapCount() << " taps): "
+                  << std::setprecision(4) << us * 1000.0 / 480 << std::setprecision(2) << " ns/sample (" << sink
+                  << ")" << std::endl;
+    }
+}
+
+// ----------------------------------------------------------------------------
+// 微基准列表
+// ----------------------------------------------------------------------------
+
+struct Micro {
+    const char* name;
+    const char* description;
+    void (*run)(const MicroOptions&);
+};
+
+const Micro MICROS[] = {
+    { "fft", "双精度 FFT 计划 vs v0.1.3 递归实现 (1024 / 2048 / 4096 点)", &MicroFft },
+    { "realfft", "实数输入 FFT vs 同尺寸复数 FFT (双精度)", &MicroRealFft },
+    { "spectrum", "单精度频谱各 SIMD 内核 vs 双精度实数 FFT", &MicroSpectrum },
+    { "ring", "采集回调延迟：SpscRing vs v0.1.3 deque + mutex (并发读取)", &MicroRing },
+    { "context", "每帧 采集 -> 频带：分析上下文 vs 按值返回接口", &MicroContext },
+    { "thread", "渲染线程每帧频谱开销：帧内分析 vs 读取分析线程结果", &MicroThread },
+    { "bandmap", "32 频带：预计算映射表 vs 每帧建表 / v0.1.3 线性分组", &MicroBandMap },
+    { "ingest", "采集接入吞吐量 (MFrames/s)：各格式 / 声道数 vs 旧 f32 下混", &MicroIngest },
+    { "decimate", "降采样 + 小 FFT vs 全速率大 FFT：每帧分析开销", &MicroDecimate },
+};
+
+int RunMicros(const std::vector<std::string>& only, const MicroOptions& options) {
+    std::cout << std::fixed << std::setprecision(2);
+    int ran = 0;
+    for (const auto& micro : MICROS) {
+        bool selected = only.empty();
+        for (const auto& name : only) selected = selected || name == micro.name;
+        if (!selected) continue;
+        std::cout << "[" << micro.name << "] " << micro.description << std::endl;
+        micro.run(options);
+        ran++;
+    }
+    return ran;
+}
+
+void PrintUsage() {
+    std::cout << "Usage: NeteaseAudioBench [--synthetic | --wav <file> | --raw <file> [--rate <hz>] [--channels <n>]"
+                 " [--format s16|s24|s32|f32]] [--seconds <s>] [--fft <n>] [--hop <n>] [--bands <n>] [--decimate <n>]"
+                 " [--max-hz <hz>] [--block <n>]"
+              << std::endl
+              << "       NeteaseAudioBench --micro [--only <name>]... [--list] [--scale <x>]" << std::endl;
+}
+
+bool ParseFormat(const char* text, Netease::SampleFormat& format) {
+    if (std::strcmp(text, "s16") == 0) format = Netease::SampleFormat::S16;
+    else if (std::strcmp(text, "s24") == 0) format = Netease::SampleFormat::S24;
+    else if (std::strcmp(text, "s32") == 0) format = Netease::SampleFormat::S32;
+    else if (std::strcmp(text, "f32") == 0) format = Netease::SampleFormat::F32;
+    else return false;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string wavPath, rawPath;
+    Netease::RawFormat rawFormat;
+    Netease::AnalysisConfig analysisConfig;
+    double seconds = 3600;
+    size_t hop = 0;
+    size_t block = 480;
+    bool micro = false;
+    std::vector<std::string> only;
+    MicroOptions microOptions;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--synthetic") == 0) {
+            wavPath.clear();
+            rawPath.clear();
+        } else if (std::strcmp(arg, "--wav") == 0 && hasValue) {
+            wavPath = argv[++i];
+        } else if (std::strcmp(arg, "--raw") == 0 && hasValue) {
+            rawPath = argv[++i];
+        } else if (std::strcmp(arg, "--rate") == 0 && hasValue) {
+            rawFormat.sampleRate = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--channels") == 0 && hasValue) {
+            rawFormat.channels = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--format") == 0 && hasValue) {
+            if (!ParseFormat(argv[++i], rawFormat.format)) {
+                PrintUsage();
+                return 2;
+            }
+        } else if (std::strcmp(arg, "--seconds") == 0 && hasValue) {
+            seconds = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--fft") == 0 && hasValue) {
+            analysisConfig.fftSize = (size_t)std::atoll(argv[++i]);
+        } else if (std::strcmp(arg, "--hop") == 0 && hasValue) {
+            hop = (size_t)std::atoll(argv[++i]);
+        } else if (std::strcmp(arg, "--bands") == 0 && hasValue) {
+            analysisConfig.bandCount = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--decimate") == 0 && hasValue) {
+            analysisConfig.decimation = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--max-hz") == 0 && hasValue) {
+            analysisConfig.maxHz = (float)std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--block") == 0 && hasValue) {
+            block = (size_t)std::atoll(argv[++i]);
+        } else if (std::strcmp(arg, "--micro") == 0) {
+            micro = true;
+        } else if (std::strcmp(arg, "--only") == 0 && hasValue) {
+            micro = true;
+            only.push_back(argv[++i]);
+        } else if (std::strcmp(arg, "--scale") == 0 && hasValue) {
+            microOptions.scale = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--list") == 0) {
+            for (const auto& entry : MICROS) {
+                std::cout << std::left << std::setw(12) << entry.name << entry.description << std::endl;
+            }
+            return 0;
+        } else if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            PrintUsage();
+            return 0;
+        } else {
+            PrintUsage();
+            return 2;
+        }
+    }
+
+    if (micro) {
+        if (microOptions.scale <= 0 || RunMicros(only, microOptions) == 0) {
+            PrintUsage();
+            return 2;
+        }
+        return 0;
+    }
+
+    const size_t fft = analysisConfig.fftSize;
+    if (fft < 4 || (fft & (fft - 1)) != 0 || analysisConfig.bandCount <= 0 || block == 0 || seconds <= 0 ||
+        analysisConfig.decimation < 1) {
+        PrintUsage();
+        return 2;
+    }
+
+    // 1. 采样来源
+    std::unique_ptr<Netease::SampleSource> source;
+    std::string error;
+    if (!wavPath.empty()) {
+        auto file = Netease::FileSource::OpenWav(wavPath, &error);
+        if (file) file->SetLoop(true);
+        source = std::move(file);
+    } else if (!rawPath.empty()) {
+        auto file = Netease::FileSource::OpenRaw(rawPath, rawFormat, &error);
+        if (file) file->SetLoop(true);
+        source = std::move(file);
+    } else {
+        Netease::SyntheticConfig synthetic;
+        synthetic.seconds = seconds;
+        source = std::make_unique<Netease::SyntheticSource>(synthetic);
+    }
+    if (!source) {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+
+    const Netease::SourceFormat format = source->Format();
+    const uint64_t targetFrames = (uint64_t)(seconds * format.sampleRate);
+
+    // 2. 流水线：环形缓冲区 + 分析（同步抽取，不启动分析线程，保证每个步长都被分析）
+    // 步长按采集样本计：默认取窗口时长的一半
+    analysisConfig.hopSize = hop ? hop : fft / 2 * (size_t)analysisConfig.decimation;
+    analysisConfig.sampleRate = format.sampleRate;
+    analysisConfig.maxCatchUpHops = (size_t)-1;
+    Netease::SpscRing<float> ring((std::max)((size_t)16384, fft + block) * 2);
+    Netease::AnalysisThread analysis(ring, analysisConfig);
+    std::vector<float> interleaved(block * format.channels);
+
+    Stage read{ "source read" };
+    Stage downmix{ "downmix + ring" };
+    Stage analyze{ analysisConfig.decimation > 1 ? "decimate + FFT + bands" : "window + FFT + bands" };
+    Stage consume{ "latest frame" };
+
+    std::cout << "Source:    " << source->Name() << ", " << format.sampleRate << " Hz, " << format.channels
+              << " ch, " << seconds << " s" << std::endl;
+    std::cout << "Analysis:  FFT " << fft << ", hop " << analysisConfig.hopSize << ", " << analysisConfig.bandCount
+              << " bands, block " << block;
+    if (analysisConfig.decimation > 1) {
+        std::cout << ", decimate x" << analysisConfig.decimation << " ("
+                  << format.sampleRate / analysisConfig.decimation << " Hz)";
+    }
+    std::cout << std::endl;
+
+    uint64_t fed = 0;
+    float sink = 0;
+    auto begin = Clock::now();
+    while (fed < targetFrames) {
+        size_t want = (size_t)(std::min)((uint64_t)block, targetFrames - fed);
+        size_t frames = read.Run([&] { return source->Read(interleaved.data(), want); });
+        if (frames == 0) break;
+
+        downmix.Run([&] {
+            Netease::WriteMono(ring, interleaved.data(), frames, format.channels);
+            return 0;
+        });
+        size_t published = analyze.Run([&] { return analysis.Pump(); });
+        if (published > 0) {
+            sink += consume.Run([&] { return analysis.Latest().energy; });
+        }
+        fed += frames;
+    }
+    double wall = std::chrono::duration<double>(Clock::now() - begin).count();
+
+    // 3. 报告
+    const uint64_t frames = analysis.FramesPublished();
+    const double audioSeconds = (double)fed / format.sampleRate;
+    std::cout << std::fixed << std::setprecision(2)
+              << "Audio:     " << audioSeconds << " s in " << wall << " s (" << audioSeconds / wall << "x real time)"
+              << std::endl
+              << "Frames:    " << frames << " analyzed, " << analysis.HopsSkipped() << " skipped, "
+              << frames / wall << " frames/s" << std::endl;
+
+    std::cout << "Stage                    total s   us/call   ns/frame   allocs" << std::endl;
+    for (const Stage* stage : { &read, &downmix, &analyze, &consume }) {
+        std::cout << std::left << std::setw(24) << stage->name << std::right
+                  << std::setw(9) << stage->seconds
+                  << std::setw(10) << (stage->calls ? stage->seconds * 1e6 / stage->calls : 0.0)
+                  << std::setw(11) << (frames ? stage->seconds * 1e9 / frames : 0.0)
+                  << std::setw(9) << stage->allocations << std::endl;
+    }
+    std::cout << "(checksum " << sink << ")" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * CacheImport.cpp - 歌词缓存批量导入 / 预热工具
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ *
+ * 新机器上网易云 webdata/lyric 目录已有大量歌词、SDK 缓存为空时，
+ * 一次性并行导入到 SDK 缓存（包文件或 SDK 降级目录），并报告吞吐量。
+ *
+ * 用法：
+ *   NeteaseCacheImport [选项] [源目录 ...]
+ *
+ *   源目录为空时扫描网易云全部歌词缓存目录（GetLyricCacheDirs）
+ *
+ *   --pack             写入包文件后端（默认：逐文件写入 SDK 缓存目录）
+ *   --pack-dir <dir>   包文件目录（隐含 --pack）；未指定 --state-dir 时
+ *                      预算 / 验证器 / 失败记录随之写入 <dir>\state
+ *   --state-dir <dir>  SDK 缓存根目录（降级歌词目录与上述 sidecar），
+ *                      默认 %LOCALAPPDATA%\NeteaseHookSDK\cache
+ *   --threads <n>      解析线程数（默认：硬件并发数）
+ *   --overwrite        覆盖 SDK 缓存中已有的歌曲
+ *   --verbose          输出 SDK 日志
+ *
+ * 退出码：0 = 成功，1 = 有写入失败，2 = 参数错误
+ */
+
+#include "NeteaseAPI.h"
+#include "NeteaseDriver.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+
+namespace {
+
+void PrintUsage() {
+    std::cout << "Usage: NeteaseCacheImport [--pack] [--pack-dir <dir>] [--state-dir <dir>] [--threads <n>] [--overwrite] [--verbose] [dir ...]"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Netease::ImportOptions options;
+    Netease::CacheConfig config = Netease::API::GetCacheConfig();
+    std::string stateDir;
+    bool verbose = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "--pack") == 0) {
+            config.backend = Netease::CacheBackend::Pack;
+        } else if (std::strcmp(arg, "--pack-dir") == 0 && i + 1 < argc) {
+            config.backend = Netease::CacheBackend::Pack;
+            config.packDir = argv[++i];
+        } else if (std::strcmp(arg, "--state-dir") == 0 && i + 1 < argc) {
+            stateDir = argv[++i];
+        } else if (std::strcmp(arg, "--threads") == 0 && i + 1 < argc) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--overwrite") == 0) {
+            options.overwrite = true;
+        } else if (std::strcmp(arg, "--verbose") == 0) {
+            verbose = true;
+        } else if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            PrintUsage();
+            return 0;
+        } else if (arg[0] == '-') {
+            PrintUsage();
+            return 2;
+        } else {
+            options.sourceDirs.push_back(arg);
+        }
+    }
+
+    if (verbose) {
+        NeteaseDriver::SetGlobalLogging(true);
+        NeteaseDriver::SetGlobalLogLevel(2);
+    }
+    // 导入到独立包目录时，登记与淘汰也留在该目录，不改动用户的 SDK 缓存
+    if (stateDir.empty() && !config.packDir.empty()) {
+        stateDir = config.packDir + "\\state";
+    }
+    if (!stateDir.empty()) {
+        Netease::API::SetSDKCacheDir(stateDir);
+    }
+    Netease::API::SetCacheConfig(config);
+
+    Netease::ImportReport report = Netease::API::ImportLyricCache(options);
+
+    std::cout << "Scanned:   " << report.filesScanned << std::endl;
+    std::cout << "Imported:  " << report.imported << std::endl;
+    std::cout << "Skipped:   " << report.skipped << std::endl;
+    std::cout << "Invalid:   " << report.invalid << std::endl;
+    std::cout << "Failed:    " << report.failed << std::endl;
+    std::cout << std::fixed << std::setprecision(2)
+              << "Read:      " << report.bytesRead / (1024.0 * 1024.0) << " MB in " << report.seconds << " s" << std::endl
+              << "Throughput: " << report.FilesPerSec() << " files/s, " << report.MBPerSec() << " MB/s" << std::endl;
+
+    return report.failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,873 @@
+/**
+ * LyricBench.cpp - 歌词 / 缓存组件微基准
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ *
+ * 单元测试只校验正确性；各组件的耗时对比集中在这里，
+ * 不依赖网络与网易云客户端，可在任意机器上重复运行。
+ *
+ * 用法：
+ *   NeteaseLyricBench [选项]
+ *
+ *   --only <name>        只运行指定项（可重复）
+ *   --list               列出所有基准项
+ *   --scale <x>          迭代次数倍率（默认 1；冒烟测试可用 0.05）
+ *
+ * 退出码：0 = 成功，2 = 参数错误
+ */
+
+#include "httplib.h"    // 本地替身服务器（须在 Windows.h 之前包含）
+#include "JsonString.h"
+#include "NeteaseAPI.h"
+#include "LyricCacheIndex.h"
+#include "LyricPackStore.h"
+#include "LyricCodec.h"
+#include "Inflate.h"
+#include "RequestPolicy.h"
+#include "CacheBudget.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <set>
+#include <regex>
+
+namespace {
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    double scale = 1.0;
+};
+
+/**
+ * 临时目录：构造时清空创建，析构时删除
+ */
+struct TempDir {
+    fs::path path;
+
+    explicit TempDir(const std::string& name)
+        : path(fs::temp_directory_path() / ("netease_bench_" + name)) {
+        std::error_code ec;
+        fs::remove_all(path, ec);
+        fs::create_directories(path);
+    }
+    ~TempDir() {
+        std::error_code ec;
+        fs::remove_all(path, ec);
+    }
+};
+
+int Iterations(const Options& options, int base) {
+    int n = (int)(base * options.scale);
+    return n > 0 ? n : 1;
+}
+
+/**
+ * 计时：返回 fn 执行 iterations 次的平均耗时（微秒）
+ */
+template <typename Fn>
+double TimeUs(int iterations, Fn&& fn) {
+    auto begin = Clock::now();
+    for (int i = 0; i < iterations; i++) fn(i);
+    return std::chrono::duration<double, std::micro>(Clock::now() - begin).count() / iterations;
+}
+
+// ============================================================================
+// json: SIMD JSON 转义 / 反转义内核
+// ============================================================================
+
+const char* JsonKernelName(Netease::Json::Kernel kernel) {
+    switch (kernel) {
+        case Netease::Json::Kernel::Scalar: return "Scalar";
+        case Netease::Json::Kernel::SSE2: return "SSE2";
+        case Netease::Json::Kernel::AVX2: return "AVX2";
+        default: return "Auto";
+    }
+}
+
+// 模拟网易云歌词负载：时间戳 + 中文 \uXXXX + 换行
+std::string MakeEscapedLyricPayload(size_t targetBytes) {
+    std::string s;
+    int line = 0;
+    while (s.size() < targetBytes) {
+        char ts[32];
+        snprintf(ts, sizeof(ts), "[%02d:%02d.%02d]", line / 60, line % 60, (line * 7) % 100);
+        s += ts;
+        s += "Hello \\\"world\\\" \\u4f60\\u597d\\u4e16\\u754c \\ud83c\\udfb5 some ascii text here\\n";
+        line++;
+    }
+    return s;
+}
+
+void BenchJson(const Options& options) {
+    std::string payload = MakeEscapedLyricPayload(8 * 1024 * 1024);
+    payload += "\"";
+    std::string decoded;
+    Netease::Json::UnescapeString(payload, decoded);
+
+    const int iterations = Iterations(options, 10);
+    for (auto kernel : { Netease::Json::Kernel::Scalar, Netease::Json::Kernel::SSE2, Netease::Json::Kernel::AVX2 }) {
+        if (!Netease::Json::SetKernel(kernel)) continue;
+        std::string out;
+        double unescapeUs = TimeUs(iterations, [&](int) {
+            out.clear();
+            Netease::Json::UnescapeString(payload, out);
+        });
+        double escapeUs = TimeUs(iterations, [&](int) {
+            out.clear();
+            Netease::Json::AppendEscaped(out, decoded);
+        });
+        std::cout << "  " << std::left << std::setw(8) << JsonKernelName(kernel) << std::right
+                  << "unescape " << std::setw(6) << payload.size() / unescapeUs / 1e3 << " GB/s, escape "
+                  << std::setw(6) << decoded.size() / escapeUs / 1e3 << " GB/s" << std::endl;
+    }
+    Netease::Json::SetKernel(Netease::Json::Kernel::Auto);
+}
+
+// ============================================================================
+// index: 缓存目录索引 vs 逐目录探测文件
+// ============================================================================
+
+void BenchIndex(const Options& options) {
+    TempDir root("index");
+    const std::string highDir = (root.path / "high").string();
+    const std::string lowDir = (root.path / "low").string();
+    fs::create_directories(highDir);
+    fs::create_directories(lowDir);
+
+    const int fileCount = Iterations(options, 100000);
+    for (int i = 0; i < fileCount; ++i) {
+        std::ofstream((fs::path(lowDir) / std::to_string(1000000 + i)).string()) << "{}";
+    }
+
+    Netease::LyricCacheIndex index([&] { return std::vector<std::string>{ highDir, lowDir }; });
+    double buildUs = TimeUs(1, [&](int) { index.Rebuild(); });
+
+    // 旧实现：逐目录探测文件是否存在
+    auto probe = [&](long long songId) {
+        std::error_code ec;
+        for (const auto& dir : { highDir, lowDir }) {
+            if (fs::exists(fs::path(dir) / std::to_string(songId), ec)) return true;
+        }
+        return false;
+    };
+    auto indexFind = [&](long long songId) { return index.Find(songId).has_value(); };
+
+    const int lookups = Iterations(options, 20000);
+    int found = 0;
+    auto lookup = [&](auto&& fn, long long base) {
+        return TimeUs(lookups, [&](int i) { found += fn(base + (i * 7919) % fileCount) ? 1 : 0; });
+    };
+    double indexHitUs = lookup(indexFind, 1000000);
+    double indexMissUs = lookup(indexFind, 5000000);
+    double probeHitUs = lookup(probe, 1000000);
+    double probeMissUs = lookup(probe, 5000000);
+
+    std::cout << "  build (" << fileCount << " files)  " << buildUs / 1e3 << " ms" << std::endl;
+    std::cout << "  index   hit " << indexHitUs << " us, miss " << indexMissUs << " us" << std::endl;
+    std::cout << "  probe   hit " << probeHitUs << " us, miss " << probeMissUs << " us" << std::endl;
+    if (found != 2 * lookups) std::cout << "  (unexpected hit count " << found << ")" << std::endl;
+}
+
+// ============================================================================
+// pack: 包文件读取 vs 逐文件读取
+// ============================================================================
+
+std::string PackPayload(long long songId) {
+    return "{\"lyric\":\"[00:01.00]song " + std::to_string(songId)
+         + "\\n[00:02.00]" + std::string(200, 'x') + "\"}";
+}
+
+void BenchPack(const Options& options) {
+    TempDir root("pack");
+    const fs::path filesDir = root.path / "files";
+    fs::create_directories(filesDir);
+
+    Netease::LyricPackStore::Options packOptions;
+    packOptions.backgroundCompaction = false;
+    Netease::LyricPackStore store;
+    if (!store.Open((root.path / "pack").string(), packOptions)) {
+        std::cout << "  (failed to open pack store)" << std::endl;
+        return;
+    }
+
+    const int count = Iterations(options, 20000);
+    for (int i = 1; i <= count; ++i) {
+        std::string payload = PackPayload(i);
+        store.Put(i, payload);
+        std::ofstream((filesDir / std::to_string(i)).string(), std::ios::binary) << payload;
+    }
+
+    size_t packBytes = 0, fileBytes = 0;
+    double packUs = TimeUs(count, [&](int i) {
+        auto view = store.Get(i + 1);
+        packBytes += view ? view->payload.size() : 0;
+    });
+    double fileUs = TimeUs(count, [&](int i) {
+        std::ifstream ifs((filesDir / std::to_string(i + 1)).string(), std::ios::binary);
+        std::stringstream buffer;
+        buffer << ifs.rdbuf();
+        fileBytes += buffer.str().size();
+    });
+
+    std::cout << "  pack  " << packUs << " us/song, files " << fileUs << " us/song (" << count << " songs)" << std::endl;
+    if (packBytes != fileBytes) std::cout << "  (byte count mismatch " << packBytes << " vs " << fileBytes << ")" << std::endl;
+}
+
+// ============================================================================
+// codec: 缓存记录压缩率与解压速度
+// ============================================================================
+
+// 语料：优先使用本机真实的网易云歌词缓存，不足时补充合成歌词
+std::vector<std::string> LoadLyricCorpus(size_t maxFiles) {
+    std::vector<std::string> corpus;
+
+    if (const char* localAppData = std::getenv("LOCALAPPDATA")) {
+        std::error_code ec;
+        fs::path dir = fs::path(localAppData) / "Netease" / "CloudMusic" / "webdata" / "lyric";
+        for (const auto& entry : fs::directory_iterator(dir, ec)) {
+            if (corpus.size() >= maxFiles) break;
+            if (!entry.is_regular_file(ec)) continue;
+            std::ifstream ifs(entry.path(), std::ios::binary);
+            std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+            if (!content.empty() && content[0] == '{') corpus.push_back(std::move(content));
+        }
+    }
+
+    for (int song = 0; corpus.size() < 50; ++song) {
+        std::string lrc = "[00:00.000] 作词 : 某某\n[00:01.000] 作曲 : 某某\n[00:02.000] 编曲 : 某某\n";
+        std::string tlyric;
+        for (int line = 0; line < 40; ++line) {
+            char ts[32];
+            snprintf(ts, sizeof(ts), "[%02d:%02d.%03d]", line / 20, (line * 3 + song) % 60, (line * 37) % 1000);
+            lrc += ts + std::string(line % 2 ? "我们一起走过的时候 世界都变得温柔\n" : "君の声が聞こえる 夢を見ていた\n");
+            tlyric += ts + std::string("听到了你的声音 第 ") + std::to_string(song) + " 首\n";
+        }
+        std::string json = "{\"lyric\":\"";
+        Netease::Json::AppendEscaped(json, lrc);
+        json += "\",\"translateLyric\":\"";
+        Netease::Json::AppendEscaped(json, tlyric);
+        json += "\"}";
+        corpus.push_back(std::move(json));
+    }
+    return corpus;
+}
+
+void BenchCodec(const Options& options) {
+    auto corpus = LoadLyricCorpus(2000);
+
+    size_t rawBytes = 0, plainBytes = 0, dictBytes = 0;
+    std::vector<std::string> packed;
+    for (const auto& record : corpus) {
+        rawBytes += record.size();
+        plainBytes += Netease::LyricCodec::Compress(record, Netease::LyricCodec::Dictionary::None).size();
+        packed.push_back(Netease::LyricCodec::Compress(record));
+        dictBytes += packed.back().size();
+    }
+
+    std::string output;
+    double compressUs = TimeUs(Iterations(options, 5), [&](int) {
+        for (const auto& record : corpus) output = Netease::LyricCodec::Compress(record);
+    });
+    double decompressUs = TimeUs(Iterations(options, 20), [&](int) {
+        for (const auto& record : packed) Netease::LyricCodec::Decompress(record, output);
+    });
+
+    std::cout << "  corpus  " << corpus.size() << " records, " << rawBytes << " bytes" << std::endl;
+    std::cout << "  ratio   plain " << (double)rawBytes / plainBytes << "x, LRC dictionary "
+              << (double)rawBytes / dictBytes << "x" << std::endl;
+    std::cout << "  speed   compress " << rawBytes / compressUs << " MB/s, decompress "
+              << rawBytes / decompressUs << " MB/s" << std::endl;
+}
+
+// ============================================================================
+// inflate: 压缩传输的解压开销 vs 弱网下节省的传输时间
+// ============================================================================
+
+#ifndef NETEASE_BENCH_FIXTURE_DIR
+#define NETEASE_BENCH_FIXTURE_DIR "tests/fixtures"
+#endif
+
+std::string ReadFixture(const std::string& name) {
+    std::ifstream file(fs::path(NETEASE_BENCH_FIXTURE_DIR) / name, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+void BenchInflate(const Options& options) {
+    std::string plain = ReadFixture("lyric_sample.json");
+    std::string gz = ReadFixture("lyric_sample.json.gz");
+    if (plain.empty() || gz.empty()) {
+        std::cout << "  (fixtures not found in " << NETEASE_BENCH_FIXTURE_DIR << ")" << std::endl;
+        return;
+    }
+
+    std::string out;
+    out.reserve(plain.size());
+    bool ok = true;
+    double decodeUs = TimeUs(Iterations(options, 2000), [&](int) {
+        out.clear();
+        ok = Netease::Inflater::Inflate(gz, Netease::Inflater::Format::Gzip, out) && ok;
+    });
+
+    // 1 Mbps 弱网下节省的传输时间
+    double savedUs = (double)(plain.size() - gz.size()) * 8.0;
+    std::cout << "  gzip    " << plain.size() << " -> " << gz.size() << " bytes ("
+              << 100.0 * gz.size() / plain.size() << "%)" << std::endl;
+    std::cout << "  decode  " << decodeUs << " us, saved at 1Mbps " << savedUs / 1000.0 << " ms" << std::endl;
+    if (!ok || out != plain) std::cout << "  (decode mismatch)" << std::endl;
+}
+
+// ============================================================================
+// revalidate: 完整下载 + 写缓存 vs 条件请求 (304)
+// ============================================================================
+
+/**
+ * 本地替身服务器（127.0.0.1 随机端口）
+ */
+struct LocalServer {
+    httplib::Server server;
+    std::thread thread;
+    int port = 0;
+
+    bool Start() {
+        port = server.bind_to_any_port("127.0.0.1");
+        if (port <= 0) return false;
+        thread = std::thread([this] { server.listen_after_bind(); });
+        server.wait_until_ready();
+        return true;
+    }
+    std::string BaseUrl() const { return "http://127.0.0.1:" + std::to_string(port); }
+    ~LocalServer() {
+        server.stop();
+        if (thread.joinable()) thread.join();
+    }
+};
+
+void BenchRevalidate(const Options& options) {
+    const long long songId = 900000900;
+    const std::string etag = "\"lrc-bench-v1\"";
+    std::string body = "{\"lrc\":{\"version\":1,\"lyric\":\"";
+    for (int line = 0; line < 60; ++line) {
+        char ts[32];
+        snprintf(ts, sizeof(ts), "[%02d:%02d.00]", line / 60, line % 60);
+        body += ts + std::string("line ") + std::to_string(line) + " of the benchmark lyric\\n";
+    }
+    body += "\"},\"code\":200}";
+
+    LocalServer local;
+    local.server.Get("/api/song/lyric", [&](const httplib::Request& req, httplib::Response& res) {
+        res.set_header("ETag", etag);
+        if (req.get_header_value("If-None-Match") == etag) {
+            res.status = 304;
+            return;
+        }
+        res.set_content(body, "application/json");
+    });
+    if (!local.Start()) {
+        std::cout << "  (failed to bind local server)" << std::endl;
+        return;
+    }
+    Netease::API::SetApiBaseUrl(local.BaseUrl());
+    Netease::API::ClearLyricCache(songId);
+
+    const int iterations = Iterations(options, 50);
+    double fullUs = TimeUs(iterations, [&](int) { Netease::API::FetchLyricOnline(songId); });
+    int notModified = 0;
+    double conditionalUs = TimeUs(iterations, [&](int) {
+        notModified += Netease::API::RefreshLyric(songId) == Netease::RefreshStatus::NotModified ? 1 : 0;
+    });
+
+    std::cout << "  full download + cache write " << fullUs << " us, conditional (304) " << conditionalUs
+              << " us" << std::endl;
+    if (notModified != iterations) std::cout << "  (" << notModified << " / " << iterations << " were 304)" << std::endl;
+
+    Netease::API::ClearLyricCache(songId);
+    Netease::API::SetApiBaseUrl("");
+}
+
+// ============================================================================
+// policy: 故障注入下直连 vs 请求策略（对冲 / 重试）的延迟分布
+// ============================================================================
+
+void BenchPolicy(const Options& options) {
+    // 2% 慢响应 (400ms)，2.5% 503
+    std::atomic<int> hits{0};
+    LocalServer local;
+    local.server.Get("/data", [&](const httplib::Request&, httplib::Response& res) {
+        int index = hits++;
+        if (index % 50 == 3) std::this_thread::sleep_for(std::chrono::milliseconds(400));
+        if (index % 40 == 7) {
+            res.status = 503;
+            return;
+        }
+        res.set_content("{\"code\":200}", "application/json");
+    });
+    if (!local.Start()) {
+        std::cout << "  (failed to bind local server)" << std::endl;
+        return;
+    }
+    const std::string url = local.BaseUrl() + "/data";
+
+    const int requests = (std::max)(Iterations(options, 200), 20);
+    auto measure = [&](auto&& get, const char* name) {
+        std::vector<double> latencies;
+        int failures = 0;
+        for (int i = 0; i < requests; ++i) {
+            std::optional<Netease::Http::Response> response;
+            latencies.push_back(TimeUs(1, [&](int) { response = get(); }));
+            if (!response || response->status != 200) failures++;
+        }
+        std::sort(latencies.begin(), latencies.end());
+        std::cout << "  " << std::left << std::setw(8) << name << std::right
+                  << "p50 " << latencies[latencies.size() / 2] / 1e3 << " ms, p99 "
+                  << latencies[latencies.size() * 99 / 100] / 1e3 << " ms, failures " << failures << std::endl;
+    };
+
+    measure([&] { return Netease::Http::Get(url); }, "direct");
+
+    Netease::Http::PolicyOptions policyOptions;
+    policyOptions.backoffBaseMs = 10;
+    policyOptions.backoffMaxMs = 40;
+    policyOptions.hedgeMinSamples = 10;
+    Netease::Http::RequestPolicy policy(policyOptions);
+    for (int i = 0; i < 20; ++i) policy.Get(url, Netease::Http::Options());   // 预热延迟样本
+    measure([&] { return policy.Get(url, Netease::Http::Options()); }, "policy");
+
+    auto stats = policy.GetStats();
+    std::cout << "  hedged " << stats.hedged << " (wins " << stats.hedgeWins << "), retries " << stats.retries
+              << std::endl;
+}
+
+// ============================================================================
+// import: 并行批量导入 vs 逐首 CacheLyric
+// ============================================================================
+
+Netease::LyricData MakeImportLyric(long long songId) {
+    Netease::LyricData data;
+    for (int line = 0; line < 30; ++line) {
+        data.lrc += "[00:" + std::to_string(10 + line) + ".00]line " + std::to_string(line) + " 歌词\n";
+    }
+    data.tlyric = "[00:10.00]translation " + std::to_string(songId);
+    return data;
+}
+
+void UseBenchPack(const fs::path& dir) {
+    Netease::CacheConfig config;
+    config.backend = Netease::CacheBackend::Pack;
+    config.packDir = dir.string();
+    config.packBackgroundCompaction = false;
+    config.maxCacheBytes = 0;       // 不让预算淘汰干扰计时
+    config.maxCacheEntries = 0;
+    Netease::API::SetCacheConfig(config);
+}
+
+void BenchImport(const Options& options) {
+    TempDir root("import");
+    const long long firstId = 910400000;
+    const int count = Iterations(options, 3000);
+
+    // 模拟网易云 webdata/lyric 目录：每首约 1.5KB 的 JSON 歌词
+    const fs::path source = root.path / "source";
+    fs::create_directories(source);
+    for (int i = 0; i < count; ++i) {
+        Netease::LyricData data = MakeImportLyric(firstId + i);
+        std::string json = "{\"lyric\":\"";
+        Netease::Json::AppendEscaped(json, data.lrc);
+        json += "\",\"translateLyric\":\"";
+        Netease::Json::AppendEscaped(json, data.tlyric);
+        json += "\"}";
+        std::ofstream(source / std::to_string(firstId + i), std::ios::binary) << json;
+    }
+
+    // 旧路径：逐首 CacheLyric（每首一次刷盘；不含解析开销，对旧路径有利）
+    UseBenchPack(root.path / "sequential");
+    double sequentialUs = TimeUs(count, [&](int i) {
+        Netease::API::CacheLyric(firstId + i, MakeImportLyric(firstId + i));
+    });
+
+    UseBenchPack(root.path / "parallel");
+    Netease::ImportOptions importOptions;
+    importOptions.sourceDirs = { source.string() };
+    Netease::ImportReport report = Netease::API::ImportLyricCache(importOptions);
+
+    std::cout << "  import " << report.FilesPerSec() << " files/s, " << report.MBPerSec() << " MB/s ("
+              << report.seconds * 1000 << " ms), sequential CacheLyric " << sequentialUs * count / 1000
+              << " ms (" << count << " files)" << std::endl;
+    if (report.imported != (size_t)count) {
+        std::cout << "  (imported " << report.imported << " / " << count << ")" << std::endl;
+    }
+    Netease::API::SetCacheConfig(Netease::CacheConfig());
+}
+
+// ============================================================================
+// budget: 超出预算后按热度分批挑选淘汰对象
+// ============================================================================
+
+void BenchBudget(const Options& options) {
+    const size_t count = (size_t)Iterations(options, 50000);
+    const size_t overflow = count / 10;
+    int64_t now = 1700000000000LL;
+
+    Netease::CacheBudget::Options budgetOptions;
+    budgetOptions.maxEntries = count;
+    budgetOptions.maxBytes = 0;
+    Netease::CacheBudget budget("", budgetOptions, [&now] { return now; });
+    for (size_t i = 0; i < count + overflow; ++i) {
+        now += 1000;
+        budget.RecordWrite((long long)i, 1500);
+    }
+
+    const size_t batch = budgetOptions.evictionBatch;
+    size_t evicted = 0, batches = 0;
+    auto begin = Clock::now();
+    while (true) {
+        auto victims = budget.CollectVictims(batch);
+        if (victims.empty()) break;
+        for (long long songId : victims) budget.RecordEviction(songId);
+        evicted += victims.size();
+        batches++;
+    }
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+
+    std::cout << "  evicted " << evicted << " / " << count + overflow << " entries in " << batches << " batches of "
+              << batch << ": " << ms << " ms, " << (batches ? ms / batches : 0.0) << " ms/batch" << std::endl;
+}
+
+// ============================================================================
+// merge: 原文 / 翻译数值时间戳线性归并 vs v0.1.3 regex 实现
+// ============================================================================
+
+// v0.1.3 实现（regex + map + set），基线
+std::string LegacyMergeLyrics(const std::string& lrc, const std::string& tlyric) {
+    auto parseLyric = [](const std::string& lyric) {
+        std::map<std::string, std::string> result;
+        std::istringstream iss(lyric);
+        std::string line;
+        std::regex timePattern("\\[(\\d{2}:\\d{2}\\.\\d{2})\\]");
+        while (std::getline(iss, line)) {
+            std::smatch match;
+            if (std::regex_search(line, match, timePattern)) {
+                size_t textStart = line.find(']') + 1;
+                result[match[1].str()] = textStart < line.length() ? line.substr(textStart) : "";
+            }
+        }
+        return result;
+    };
+
+    auto lrcMap = parseLyric(lrc);
+    auto tlyricMap = parseLyric(tlyric);
+    std::ostringstream oss;
+    std::set<std::string> allTimestamps;
+    for (const auto& [ts, _] : lrcMap) allTimestamps.insert(ts);
+    for (const auto& [ts, _] : tlyricMap) allTimestamps.insert(ts);
+    for (const auto& ts : allTimestamps) {
+        std::string original = lrcMap[ts];
+        std::string translation = tlyricMap[ts];
+        oss << "[" << ts << "]";
+        if (!original.empty() && !translation.empty()) oss << original << " / " << translation;
+        else if (!original.empty()) oss << original;
+        else oss << translation;
+        oss << "\n";
+    }
+    return oss.str();
+}
+
+std::string FormatTag(int ms, int digits) {
+    char buffer[32];
+    if (digits == 3) {
+        snprintf(buffer, sizeof(buffer), "[%02d:%02d.%03d]", ms / 60000, ms / 1000 % 60, ms % 1000);
+    } else {
+        snprintf(buffer, sizeof(buffer), "[%02d:%02d.%02d]", ms / 60000, ms / 1000 % 60, ms % 1000 / 10);
+    }
+    return buffer;
+}
+
+void BenchMerge(const Options& options) {
+    // 长歌词：两轨各 3000 行，原文一半的行使用三位毫秒
+    std::string lrc;
+    std::string tlyric;
+    for (int i = 0; i < 3000; ++i) {
+        int ms = i * 1370;
+        lrc += FormatTag(ms, i % 2 ? 3 : 2) + "original line number " + std::to_string(i) + " with some words\n";
+        tlyric += FormatTag(ms, 2) + "翻译第 " + std::to_string(i) + " 行\n";
+    }
+
+    const int iterations = Iterations(options, 20);
+    size_t sink = 0;
+    double legacyUs = TimeUs(iterations, [&](int) { sink += LegacyMergeLyrics(lrc, tlyric).size(); });
+    double linearUs = TimeUs(iterations, [&](int) { sink += Netease::API::MergeLyrics(lrc, tlyric).size(); });
+
+    std::cout << "  regex " << legacyUs / 1e3 << " ms, linear merge " << linearUs / 1e3 << " ms, speedup "
+              << legacyUs / linearUs << "x (2 x 3000 lines, " << sink << ")" << std::endl;
+}
+
+// ============================================================================
+// timeline: 紧凑时间轴解析 + FindLine vs v0.1.3 App 的 map 解析器
+// ============================================================================
+
+// v0.1.3 App 实现（stringstream + std::map<double, string>），基线
+std::map<double, std::string> LegacyParseLrcToMap(const std::string& lrc, double* outOffset = nullptr) {
+    std::map<double, std::string> result;
+    std::stringstream ss(lrc);
+    std::string line;
+    while (std::getline(ss, line)) {
+        if (line.empty()) continue;
+        if (outOffset && line.find("[offset:") != std::string::npos) {
+            size_t start = line.find(':') + 1;
+            size_t end = line.find(']');
+            if (end != std::string::npos) {
+                try { *outOffset = std::stod(line.substr(start, end - start)) / 1000.0; } catch (...) {}
+            }
+            continue;
+        }
+
+        std::vector<double> timestamps;
+        size_t lastBracketEnd = 0;
+        size_t pos = 0;
+        while (true) {
+            size_t bracketStart = line.find('[', pos);
+            size_t bracketEnd = line.find(']', pos);
+            if (bracketStart == std::string::npos || bracketEnd == std::string::npos || bracketEnd < bracketStart) break;
+            std::string tag = line.substr(bracketStart + 1, bracketEnd - bracketStart - 1);
+            size_t colon = tag.find(':');
+            size_t dot = tag.find_last_of(".:");
+            if (colon != std::string::npos) {
+                int m = std::atoi(tag.substr(0, colon).c_str());
+                if (dot != std::string::npos && dot > colon) {
+                    int sec = std::atoi(tag.substr(colon + 1, dot - colon - 1).c_str());
+                    timestamps.push_back(m * 60.0 + sec + std::atof(("0." + tag.substr(dot + 1)).c_str()));
+                } else {
+                    timestamps.push_back(m * 60.0 + std::atoi(tag.substr(colon + 1).c_str()));
+                }
+            }
+            lastBracketEnd = bracketEnd;
+            pos = bracketEnd + 1;
+            size_t nextBracket = line.find('[', pos);
+            if (nextBracket == std::string::npos || line.find_first_not_of(" \t", pos) != nextBracket) break;
+            pos = nextBracket;
+        }
+        if (timestamps.empty()) continue;
+
+        std::string text = line.substr(lastBracketEnd + 1);
+        text.erase(0, text.find_first_not_of(" \t\r\n"));
+        size_t last = text.find_last_not_of(" \t\r\n");
+        if (last != std::string::npos) text.erase(last + 1);
+        if (!text.empty()) {
+            for (double ts : timestamps) result[ts] = text;
+        }
+    }
+    return result;
+}
+
+void BenchTimeline(const Options& options) {
+    // 长歌词：3000 行原文 + 3000 行翻译，每 10 行一个多标签副歌
+    std::string lrc = "[offset:120]\n";
+    std::string tlyric;
+    for (int i = 0; i < 3000; ++i) {
+        int ms = i * 1370;
+        if (i % 10 == 0) lrc += FormatTag(ms + 600000, 2);
+        lrc += FormatTag(ms, i % 2 ? 3 : 2) + "original line number " + std::to_string(i) + " with some words\n";
+        tlyric += FormatTag(ms, 2) + "翻译第 " + std::to_string(i) + " 行\n";
+    }
+
+    const int iterations = Iterations(options, 20);
+    size_t sink = 0;
+    double legacyUs = TimeUs(iterations, [&](int) {
+        double offset = 0;
+        sink += LegacyParseLrcToMap(lrc, &offset).size() + LegacyParseLrcToMap(tlyric).size();
+    });
+    double timelineUs = TimeUs(iterations, [&](int) { sink += Netease::API::ParseTimeline(lrc, tlyric).Size(); });
+    std::cout << "  parse (3300 + 3000 lines): map " << legacyUs / 1e3 << " ms, timeline " << timelineUs / 1e3
+              << " ms, speedup " << legacyUs / timelineUs << "x (" << sink << ")" << std::endl;
+
+    // FindLine：整首歌逐 10ms 查询
+    auto timeline = Netease::API::ParseTimeline(lrc, tlyric);
+    const int queries = (int)(timeline.timesMs.back() / 10);
+    int64_t found = 0;
+    double findUs = TimeUs(queries, [&](int i) { found += timeline.FindLine((int64_t)i * 10); });
+    std::cout << "  FindLine " << findUs * 1e3 << " ns/query (" << found << ")" << std::endl;
+}
+
+// ============================================================================
+// words: 逐字歌词 (yrc) 解析吞吐量，逐帧定位：游标 vs 二分查找
+// ============================================================================
+
+// 每行 wordsPerLine 个字，字长 wordMs，行间留 gapMs 空白
+std::string MakeYrc(int lines, int wordsPerLine, int wordMs, int gapMs) {
+    std::string yrc = "{\"t\":0,\"c\":[{\"tx\":\"\xe4\xbd\x9c\xe8\xaf\x8d: \"},{\"tx\":\"someone\"}]}\n";
+    int64_t t = 1000;
+    for (int line = 0; line < lines; ++line) {
+        int duration = wordsPerLine * wordMs;
+        yrc += "[" + std::to_string(t) + "," + std::to_string(duration) + "]";
+        for (int w = 0; w < wordsPerLine; ++w) {
+            yrc += "(" + std::to_string(t + w * wordMs) + "," + std::to_string(wordMs) + ",0)w" + std::to_string(w) + " ";
+        }
+        yrc += "\n";
+        t += duration + gapMs;
+    }
+    return yrc;
+}
+
+void BenchWords(const Options& options) {
+    std::string yrc = MakeYrc(2000, 10, 180, 300);
+
+    const int iterations = Iterations(options, 20);
+    size_t sink = 0;
+    double parseUs = TimeUs(iterations, [&](int) { sink += Netease::API::ParseWordTimeline(yrc).WordCount(); });
+
+    auto timeline = Netease::API::ParseWordTimeline(yrc);
+    const int frames = (int)((timeline.lineStartMs.back() + 2000) / 16);
+
+    // 60 FPS 顺序播放：游标 vs 每帧两次二分查找
+    Netease::WordCursor cursor(timeline);
+    double cursorUs = TimeUs(frames, [&](int frame) { sink += cursor.Update((int64_t)frame * 16).word; });
+    double searchUs = TimeUs(frames, [&](int frame) {
+        int64_t ms = (int64_t)frame * 16;
+        auto lineIt = std::upper_bound(timeline.lineStartMs.begin(), timeline.lineStartMs.end(), ms);
+        int line = (int)(lineIt - timeline.lineStartMs.begin()) - 1;
+        if (line < 0) return;
+        auto first = timeline.wordStartMs.begin() + timeline.LineWordBegin(line);
+        sink += std::upper_bound(first, timeline.wordStartMs.begin() + timeline.LineWordEnd(line), ms) - first;
+    });
+
+    std::cout << "  parse " << timeline.LineCount() << " lines / " << timeline.WordCount() << " words ("
+              << yrc.size() / 1024 << " KB): " << parseUs / 1e3 << " ms, " << yrc.size() / parseUs << " MB/s"
+              << std::endl;
+    std::cout << "  per frame: cursor " << cursorUs * 1e3 << " ns, binary search " << searchUs * 1e3 << " ns ("
+              << cursor.SeekCount() << " seeks, " << sink << ")" << std::endl;
+}
+
+// ============================================================================
+// cursor: 行级游标 vs v0.1.3 LyricSystem::UpdateIndex 的逐帧线性扫描
+// ============================================================================
+
+void BenchCursor(const Options& options) {
+    std::vector<int64_t> times;
+    std::vector<double> seconds;
+    for (int i = 0; i < 3000; ++i) {
+        times.push_back(i * 1370LL);
+        seconds.push_back(i * 1.37);
+    }
+    const int frames = (int)((times.back() + 5000) / 16);
+    const int passes = Iterations(options, 5);
+
+    // v0.1.3：每帧从 0 开始线性扫描
+    size_t sink = 0;
+    double linearUs = TimeUs(passes, [&](int) {
+        for (int frame = 0; frame < frames; ++frame) {
+            double now = frame * 16 / 1000.0;
+            int index = -1;
+            for (int i = 0; i < (int)seconds.size(); i++) {
+                if (seconds[i] <= now) index = i;
+                else break;
+            }
+            sink += index;
+        }
+    });
+
+    Netease::LineCursor cursor(times);
+    double cursorUs = TimeUs(passes, [&](int) {
+        cursor.Reset();
+        for (int frame = 0; frame < frames; ++frame) sink += cursor.Update((int64_t)frame * 16);
+    });
+
+    double linearNs = linearUs * 1e3 / frames;
+    double cursorNs = cursorUs * 1e3 / frames;
+    std::cout << "  per frame (3000 lines, 60 FPS): linear scan " << linearNs << " ns, cursor " << cursorNs
+              << " ns, speedup " << linearNs / cursorNs << "x (" << sink << ")" << std::endl;
+}
+
+// ============================================================================
+// 基准项列表
+// ============================================================================
+
+struct Bench {
+    const char* name;
+    const char* description;
+    void (*run)(const Options&);
+};
+
+const Bench BENCHES[] = {
+    { "json", "JSON 转义 / 反转义内核吞吐量 (8MB 歌词负载)", &BenchJson },
+    { "index", "缓存目录索引 构建 / 命中 / 未命中 vs 逐目录探测 (100k 文件)", &BenchIndex },
+    { "pack", "包文件读取 vs 逐文件读取 (20k 首)", &BenchPack },
+    { "codec", "缓存记录压缩率 / 压缩与解压速度 (本机缓存或合成语料)", &BenchCodec },
+    { "inflate", "gzip 歌词解压耗时 vs 1Mbps 下节省的传输时间", &BenchInflate },
+    { "revalidate", "歌词刷新: 完整下载 + 写缓存 vs 条件请求 304 (本地替身服务器)", &BenchRevalidate },
+    { "policy", "故障注入 (2% 慢 / 2.5% 503) 下直连 vs 对冲 + 重试的 p50 / p99", &BenchPolicy },
+    { "import", "并行批量导入 vs 逐首 CacheLyric (3k 首，包文件后端)", &BenchImport },
+    { "budget", "容量预算: 50k 条目超出 10% 后分批挑选淘汰对象", &BenchBudget },
+    { "merge", "MergeLyrics 线性归并 vs v0.1.3 regex (2 x 3000 行)", &BenchMerge },
+    { "timeline", "LRC 解析: 紧凑时间轴 vs v0.1.3 map 解析器，FindLine 查询", &BenchTimeline },
+    { "words", "逐字歌词 (yrc) 解析吞吐量，逐帧定位: 游标 vs 二分查找", &BenchWords },
+    { "cursor", "逐帧行定位: LineCursor vs v0.1.3 线性扫描 (3000 行)", &BenchCursor },
+};
+
+void PrintUsage() {
+    std::cout << "Usage: NeteaseLyricBench [--only <name>]... [--list] [--scale <x>]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    std::vector<std::string> only;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--only") == 0 && hasValue) {
+            only.push_back(argv[++i]);
+        } else if (std::strcmp(arg, "--scale") == 0 && hasValue) {
+            options.scale = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--list") == 0) {
+            for (const auto& bench : BENCHES) {
+                std::cout << std::left << std::setw(12) << bench.name << bench.description << std::endl;
+            }
+            return 0;
+        } else if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0) {
+            PrintUsage();
+            return 0;
+        } else {
+            PrintUsage();
+            return 2;
+        }
+    }
+    if (options.scale <= 0) {
+        PrintUsage();
+        return 2;
+    }
+
+    // 缓存根目录指向临时目录：写缓存的基准项不读写用户的 SDK 缓存与 sidecar
+    TempDir state("state");
+    Netease::API::SetSDKCacheDir(state.path.string());
+
+    std::cout << std::fixed << std::setprecision(2);
+    int ran = 0;
+    for (const auto& bench : BENCHES) {
+        bool selected = only.empty();
+        for (const auto& name : only) selected = selected || name == bench.name;
+        if (!selected) continue;
+        std::cout << "[" << bench.name << "] " << bench.description << std::endl;
+        bench.run(options);
+        ran++;
+    }
+    if (ran == 0) {
+        PrintUsage();
+        return 2;
+    }
+    return 0;
+}
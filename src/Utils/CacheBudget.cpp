@@ -0,0 +1,331 @@
+/**
+ * CacheBudget.cpp - SDK 歌词缓存容量预算与淘汰策略实现
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ */
+
+#include "CacheBudget.h"
+#include <Windows.h>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <algorithm>
+
+#define LOG_TAG "BUDGET"
+#include "SimpleLog.h"
+
+namespace Netease {
+
+namespace {
+
+// 访问记录很密集：落盘合并为每 30 秒最多一次
+const int64_t PERSIST_INTERVAL_MS = 30000;
+
+} // namespace
+
+CacheBudget::CacheBudget(std::string persistPath, const Options& options, Clock clock)
+    : m_PersistPath(std::move(persistPath))
+    , m_Options(options)
+    , m_Clock(std::move(clock))
+{
+}
+
+CacheBudget::~CacheBudget() {
+    Stop();
+}
+
+int64_t CacheBudget::Now() const {
+    if (m_Clock) return m_Clock();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * 排序键：热度 = hits * 2^(-(now - last) / halfLife)，
+ * 取 log2 后 now 项对所有条目相同，可消去：log2(hits) + last / halfLife。
+ * 比较时无需按当前时间逐条重算衰减。
+ */
+double CacheBudget::HeatKeyLocked(const Entry& entry) const {
+    if (m_Options.halfLifeMs <= 0) return (double)entry.lastAccessMs;
+    return std::log2((std::max)(entry.hits, 1e-9)) + (double)entry.lastAccessMs / (double)m_Options.halfLifeMs;
+}
+
+// ============================================================================
+// 记录
+// ============================================================================
+
+void CacheBudget::RecordWrite(long long songId, uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    EnsureLoadedLocked();
+
+    int64_t now = Now();
+    Entry& entry = m_Entries[songId];
+    m_Bytes = m_Bytes - entry.bytes + bytes;
+    entry.bytes = bytes;
+    if (entry.lastAccessMs > 0 && m_Options.halfLifeMs > 0) {
+        entry.hits *= std::exp2(-(double)(now - entry.lastAccessMs) / (double)m_Options.halfLifeMs);
+    }
+    entry.hits += 1;
+    entry.lastAccessMs = now;
+    MarkDirtyLocked();
+}
+
+bool CacheBudget::RecordAccess(long long songId) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    EnsureLoadedLocked();
+
+    auto it = m_Entries.find(songId);
+    if (it == m_Entries.end()) return false;
+
+    int64_t now = Now();
+    Entry& entry = it->second;
+    if (m_Options.halfLifeMs > 0) {
+        entry.hits *= std::exp2(-(double)(now - entry.lastAccessMs) / (double)m_Options.halfLifeMs);
+    }
+    entry.hits += 1;
+    entry.lastAccessMs = now;
+    MarkDirtyLocked();
+    return true;
+}
+
+void CacheBudget::Forget(long long songId) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    EnsureLoadedLocked();
+
+    auto it = m_Entries.find(songId);
+    if (it == m_Entries.end()) return;
+    m_Bytes -= it->second.bytes;
+    m_Entries.erase(it);
+    MarkDirtyLocked();
+}
+
+void CacheBudget::RecordEviction(long long songId) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    EnsureLoadedLocked();
+
+    auto it = m_Entries.find(songId);
+    if (it == m_Entries.end()) return;
+    m_Bytes -= it->second.bytes;
+    m_EvictedEntries++;
+    m_EvictedBytes += it->second.bytes;
+    m_Entries.erase(it);
+    MarkDirtyLocked();
+}
+
+void CacheBudget::Clear() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Entries.clear();
+    m_Bytes = 0;
+    m_Draining = false;
+    m_Loaded = true;
+    m_Dirty = false;
+    if (!m_PersistPath.empty()) {
+        DeleteFileA(m_PersistPath.c_str());
+    }
+}
+
+// ============================================================================
+// 预算
+// ============================================================================
+
+std::optional<CacheBudget::Entry> CacheBudget::Lookup(long long songId) const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    EnsureLoadedLocked();
+
+    auto it = m_Entries.find(songId);
+    if (it == m_Entries.end()) return std::nullopt;
+    return it->second;
+}
+
+bool CacheBudget::IsOverBudget() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    EnsureLoadedLocked();
+    return (m_Options.maxBytes > 0 && m_Bytes > m_Options.maxBytes) ||
+           (m_Options.maxEntries > 0 && m_Entries.size() > m_Options.maxEntries);
+}
+
+std::vector<long long> CacheBudget::CollectVictims(size_t limit) const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    EnsureLoadedLocked();
+
+    bool overBytes = m_Options.maxBytes > 0 && m_Bytes > m_Options.maxBytes;
+    bool overEntries = m_Options.maxEntries > 0 && m_Entries.size() > m_Options.maxEntries;
+    if (!overBytes && !overEntries && !m_Draining) return {};
+
+    // 低水位：任一维度超出后，两个维度都淘汰到各自的低水位以下（跨多批保持）
+    double watermark = (std::min)((std::max)(m_Options.lowWatermark, 0.0), 1.0);
+    uint64_t targetBytes = m_Options.maxBytes > 0 ? (uint64_t)(m_Options.maxBytes * watermark) : UINT64_MAX;
+    size_t targetEntries = m_Options.maxEntries > 0 ? (size_t)(m_Options.maxEntries * watermark) : SIZE_MAX;
+
+    std::vector<std::pair<double, long long>> order;
+    order.reserve(m_Entries.size());
+    for (const auto& [songId, entry] : m_Entries) {
+        order.emplace_back(HeatKeyLocked(entry), songId);
+    }
+
+    // 每批只需要最冷的 limit 条
+    size_t candidates = limit > 0 ? (std::min)(limit, order.size()) : order.size();
+    std::partial_sort(order.begin(), order.begin() + candidates, order.end());
+
+    std::vector<long long> victims;
+    uint64_t bytes = m_Bytes;
+    size_t entries = m_Entries.size();
+    for (size_t i = 0; i < candidates && (bytes > targetBytes || entries > targetEntries); ++i) {
+        victims.push_back(order[i].second);
+        bytes -= m_Entries.at(order[i].second).bytes;
+        entries--;
+    }
+    m_Draining = bytes > targetBytes || entries > targetEntries;
+    return victims;
+}
+
+CacheBudget::Stats CacheBudget::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    EnsureLoadedLocked();
+
+    Stats stats;
+    stats.entries = m_Entries.size();
+    stats.bytes = m_Bytes;
+    stats.evictedEntries = m_EvictedEntries;
+    stats.evictedBytes = m_EvictedBytes;
+    return stats;
+}
+
+void CacheBudget::SetOptions(const Options& options) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Options = options;
+}
+
+CacheBudget::Options CacheBudget::GetOptions() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Options;
+}
+
+void CacheBudget::Flush() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_Dirty) PersistLocked();
+}
+
+// ============================================================================
+// 后台淘汰
+// ============================================================================
+
+void CacheBudget::SetEvictor(Evictor evictor) {
+    std::lock_guard<std::mutex> lock(m_WorkerMutex);
+    m_Evictor = std::move(evictor);
+}
+
+void CacheBudget::ScheduleEviction() {
+    if (!IsOverBudget()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_WorkerMutex);
+        if (m_Stopping || !m_Evictor) return;
+        m_EvictionRequested = true;
+        if (!m_Worker.joinable()) {
+            m_Worker = std::thread(&CacheBudget::EvictionLoop, this);
+        }
+    }
+    m_WorkerCv.notify_one();
+}
+
+void CacheBudget::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_WorkerMutex);
+        m_Stopping = true;
+    }
+    m_WorkerCv.notify_all();
+    if (m_Worker.joinable()) {
+        m_Worker.join();
+    }
+
+    std::lock_guard<std::mutex> lock(m_WorkerMutex);
+    m_Stopping = false;
+    m_EvictionRequested = false;
+}
+
+void CacheBudget::EvictionLoop() {
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+
+    std::unique_lock<std::mutex> lock(m_WorkerMutex);
+    while (true) {
+        m_WorkerCv.wait(lock, [this] { return m_Stopping || m_EvictionRequested; });
+        if (m_Stopping) return;
+        m_EvictionRequested = false;
+        Evictor evictor = m_Evictor;
+        lock.unlock();
+
+        Options options = GetOptions();
+        size_t batch = (std::max)(options.evictionBatch, (size_t)1);
+        auto pause = std::chrono::milliseconds((std::max)(options.evictionPauseMs, 0));
+        size_t total = 0;
+        bool stopping = false;
+        while (!stopping) {
+            size_t evicted = evictor(batch);
+            if (evicted == 0) break;
+            total += evicted;
+
+            lock.lock();
+            stopping = m_WorkerCv.wait_for(lock, pause, [this] { return m_Stopping; });
+            lock.unlock();
+        }
+        Flush();
+        LOG_INFO("缓存淘汰" << (stopping ? "中断" : "完成") << ": " << total << " 首");
+
+        lock.lock();
+    }
+}
+
+// ============================================================================
+// 磁盘 sidecar
+//   每行: <songId>\t<bytes>\t<hits>\t<lastAccessMs>
+// ============================================================================
+
+void CacheBudget::EnsureLoadedLocked() const {
+    if (m_Loaded) return;
+    m_Loaded = true;
+    if (m_PersistPath.empty()) return;
+
+    std::ifstream ifs(m_PersistPath);
+    if (!ifs) return;
+
+    long long songId = 0;
+    Entry entry;
+    while (ifs >> songId >> entry.bytes >> entry.hits >> entry.lastAccessMs) {
+        auto [it, inserted] = m_Entries.emplace(songId, entry);
+        if (inserted) m_Bytes += entry.bytes;
+    }
+    LOG_DEBUG("已加载 " << m_Entries.size() << " 条缓存访问记录, " << m_Bytes << " 字节");
+}
+
+void CacheBudget::MarkDirtyLocked() {
+    m_Dirty = true;
+    if (Now() - m_LastPersistMs >= PERSIST_INTERVAL_MS) {
+        PersistLocked();
+    }
+}
+
+void CacheBudget::PersistLocked() {
+    m_Dirty = false;
+    m_LastPersistMs = Now();
+    if (m_PersistPath.empty()) return;
+
+    std::string tmpPath = m_PersistPath + ".tmp";
+    {
+        std::ofstream ofs(tmpPath, std::ios::trunc);
+        if (!ofs) return;
+        ofs.precision(17);
+        for (const auto& [songId, entry] : m_Entries) {
+            ofs << songId << '\t' << entry.bytes << '\t' << entry.hits << '\t' << entry.lastAccessMs << '\n';
+        }
+    }
+
+    if (!MoveFileExA(tmpPath.c_str(), m_PersistPath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        LOG_WARN("写入缓存访问记录失败: " << m_PersistPath);
+        DeleteFileA(tmpPath.c_str());
+    }
+}
+
+} // namespace Netease
@@ -0,0 +1,177 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <optional>
+#include <functional>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdint>
+
+/**
+ * CacheBudget.h - SDK 歌词缓存容量预算与淘汰策略
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ *
+ * 旧实现只有全清的 ClearAllCache，SDK 自有存储（包文件 / 降级目录）在长期运行的
+ * 设备上无限增长。本模块为 SDK 写入的每首歌记录大小与访问热度：
+ * - 预算：总字节数与条目数上限，超出后淘汰到低水位（默认预算的 90%），
+ *   避免每次写入都触发淘汰
+ * - 热度：按半衰期衰减的访问次数（LRFU）。半衰期越短越接近 LRU，越长越接近 LFU；
+ *   高频歌曲即使近期未播放也不会被一次性的大量新歌挤出
+ * - 内存 + 磁盘（文本 sidecar），不依赖目录扫描或文件 mtime
+ * - 只给出淘汰对象，实际删除由调用方提供的回调执行；
+ *   本对象持有的后台线程分批调用回调（增量淘汰），Stop 时等待线程退出
+ * - 时钟可注入，便于用合成访问序列测试
+ */
+
+namespace Netease {
+
+class CacheBudget {
+public:
+    struct Options {
+        uint64_t maxBytes = 128ULL * 1024 * 1024;       // 0 = 不限
+        size_t maxEntries = 50000;                      // 0 = 不限
+        int64_t halfLifeMs = 7LL * 24 * 3600 * 1000;    // 访问热度半衰期，<= 0 时退化为纯 LRU
+        double lowWatermark = 0.9;                      // 淘汰到预算的该比例
+        size_t evictionBatch = 64;                      // 后台淘汰每批条数
+        int evictionPauseMs = 20;                       // 批间暂停（让出存储写锁与磁盘）
+    };
+
+    struct Entry {
+        uint64_t bytes = 0;                 // 存储占用（压缩后的记录大小）
+        double hits = 0;                    // lastAccessMs 时刻的衰减访问次数
+        int64_t lastAccessMs = 0;
+    };
+
+    struct Stats {
+        uint64_t entries = 0;
+        uint64_t bytes = 0;
+        uint64_t evictedEntries = 0;        // 累计淘汰（进程内）
+        uint64_t evictedBytes = 0;
+    };
+
+    /**
+     * 时钟：返回 Unix 纪元毫秒
+     */
+    using Clock = std::function<int64_t()>;
+
+    /**
+     * 淘汰回调：删除最多 maxCount 首并逐条 RecordEviction，返回本批条数（0 = 已回到预算内）
+     */
+    using Evictor = std::function<size_t(size_t maxCount)>;
+
+    /**
+     * @param persistPath 磁盘 sidecar 路径，为空时仅内存
+     * @param options 预算与半衰期
+     * @param clock 时钟，为空时使用系统时间
+     */
+    CacheBudget(std::string persistPath, const Options& options, Clock clock = {});
+    explicit CacheBudget(std::string persistPath = "") : CacheBudget(std::move(persistPath), Options()) {}
+    ~CacheBudget();
+
+    CacheBudget(const CacheBudget&) = delete;
+    CacheBudget& operator=(const CacheBudget&) = delete;
+
+    /**
+     * 记录写入（新增或覆盖），同时计一次访问
+     */
+    void RecordWrite(long long songId, uint64_t bytes);
+
+    /**
+     * 记录一次命中
+     *
+     * @return 未被跟踪（不是 SDK 写入的条目）时返回 false
+     */
+    bool RecordAccess(long long songId);
+
+    /**
+     * 条目已删除（手动清除）
+     */
+    void Forget(long long songId);
+
+    /**
+     * 条目已被淘汰（计入淘汰统计）
+     */
+    void RecordEviction(long long songId);
+
+    void Clear();
+
+    std::optional<Entry> Lookup(long long songId) const;
+
+    bool IsOverBudget() const;
+
+    /**
+     * 挑选淘汰对象：热度从低到高，直到剩余部分降到低水位
+     *
+     * @param limit 最多返回多少首（增量淘汰的批大小），0 = 不限
+     * @return 未超出预算、且上一轮已降到低水位时为空
+     *
+     * @note 分批调用时，一旦超出预算就持续返回淘汰对象直到降到低水位
+     */
+    std::vector<long long> CollectVictims(size_t limit) const;
+
+    Stats GetStats() const;
+
+    void SetOptions(const Options& options);
+    Options GetOptions() const;
+
+    /**
+     * 立即写入 sidecar（访问记录平时合并写入）
+     */
+    void Flush();
+
+    /**
+     * 设置后台淘汰回调（为空时 ScheduleEviction 不做任何事）
+     */
+    void SetEvictor(Evictor evictor);
+
+    /**
+     * 超出预算时唤醒后台淘汰线程（首次调用时启动，已在淘汰时合并）
+     *
+     * 线程按 evictionBatch 条一批调用回调、批间暂停 evictionPauseMs，
+     * 回调返回 0 后写入 sidecar 并回到等待
+     */
+    void ScheduleEviction();
+
+    /**
+     * 停止后台淘汰线程：当前批完成后退出，批间暂停立即中断（析构时自动调用）
+     *
+     * @note 之后再次 ScheduleEviction 会重新启动线程
+     */
+    void Stop();
+
+private:
+    void EvictionLoop();
+
+    int64_t Now() const;
+    double HeatKeyLocked(const Entry& entry) const;
+    void EnsureLoadedLocked() const;
+    void MarkDirtyLocked();
+    void PersistLocked();
+
+    std::string m_PersistPath;
+    Options m_Options;
+    Clock m_Clock;
+
+    mutable std::mutex m_Mutex;
+    mutable std::unordered_map<long long, Entry> m_Entries;
+    mutable uint64_t m_Bytes = 0;
+    mutable bool m_Loaded = false;
+    mutable bool m_Draining = false;        // 超出预算后尚未降到低水位（跨批保持）
+    bool m_Dirty = false;
+    int64_t m_LastPersistMs = 0;
+    uint64_t m_EvictedEntries = 0;
+    uint64_t m_EvictedBytes = 0;
+
+    // 后台淘汰（独立的锁：回调会重新进入 Record* / CollectVictims）
+    std::mutex m_WorkerMutex;
+    std::condition_variable m_WorkerCv;
+    Evictor m_Evictor;
+    bool m_EvictionRequested = false;
+    bool m_Stopping = false;
+    std::thread m_Worker;
+};
+
+} // namespace Netease
@@ -0,0 +1,157 @@
+/**
+ * CacheRefresher.cpp - 过期缓存后台刷新实现
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ */
+
+#include "CacheRefresher.h"
+#include <Windows.h>
+#include <algorithm>
+#include <chrono>
+
+#define LOG_TAG "REFRESH"
+#include "SimpleLog.h"
+
+namespace Netease {
+
+CacheRefresher::CacheRefresher(const Options& options)
+    : m_Options(options)
+{
+    m_Options.concurrency = (std::max)(1, m_Options.concurrency);
+    if (!m_Options.task) {
+        m_Options.task = [](long long songId) { return API::RefreshLyric(songId); };
+    }
+}
+
+CacheRefresher::~CacheRefresher() {
+    Stop();
+}
+
+// ============================================================================
+// 调度
+// ============================================================================
+
+bool CacheRefresher::Start(const std::vector<long long>& songIds, FinishedCallback onFinished) {
+    std::vector<std::thread> finished;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_Running) return false;
+
+        finished = std::move(m_Workers);    // 上一轮已结束的线程，锁外 join
+        m_Workers.clear();
+
+        m_Queue.assign(songIds.begin(), songIds.end());
+        m_Stats = Stats();
+        m_Stats.scheduled = m_Queue.size();
+        m_OnFinished = std::move(onFinished);
+        m_Cancel = false;
+        m_Running = true;
+
+        // 歌曲数少于并发上限时只启动所需线程；空队列也启动一个，以统一触发结束回调
+        int workers = (int)(std::min)((size_t)m_Options.concurrency, (std::max)(m_Queue.size(), (size_t)1));
+        m_ActiveWorkers = workers;
+        for (int i = 0; i < workers; ++i) {
+            m_Workers.emplace_back(&CacheRefresher::WorkerLoop, this);
+        }
+        LOG_INFO("开始刷新 " << m_Queue.size() << " 首歌曲, 并发 " << workers);
+    }
+
+    for (auto& worker : finished) {
+        if (worker.joinable()) worker.join();
+    }
+    return true;
+}
+
+bool CacheRefresher::Wait(int timeoutMs) {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    return m_IdleCv.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return !m_Running; });
+}
+
+void CacheRefresher::Cancel() {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    if (!m_Running) return;
+    m_Cancel = true;
+    m_IdleCv.wait(lock, [this] { return !m_Running; });
+}
+
+void CacheRefresher::Stop() {
+    Cancel();
+    JoinWorkers();
+}
+
+bool CacheRefresher::IsRunning() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Running;
+}
+
+CacheRefresher::Stats CacheRefresher::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Stats;
+}
+
+void CacheRefresher::JoinWorkers() {
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        workers = std::move(m_Workers);
+        m_Workers.clear();
+    }
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+// ============================================================================
+// 工作线程
+// ============================================================================
+
+void CacheRefresher::WorkerLoop() {
+    if (m_Options.lowPriority) {
+        SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+    }
+
+    while (true) {
+        long long songId = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (m_Cancel || m_Queue.empty()) break;
+            songId = m_Queue.front();
+            m_Queue.pop_front();
+            m_InFlight++;
+            m_Stats.peakInFlight = (std::max)(m_Stats.peakInFlight, m_InFlight);
+        }
+
+        RefreshStatus status = m_Options.task(songId);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_InFlight--;
+        switch (status) {
+            case RefreshStatus::NotModified: m_Stats.notModified++; break;
+            case RefreshStatus::Updated:     m_Stats.updated++; break;
+            case RefreshStatus::NoLyric:     m_Stats.noLyric++; break;
+            case RefreshStatus::Failed:      m_Stats.failed++; break;
+        }
+    }
+
+    Stats stats;
+    FinishedCallback onFinished;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stats.cancelled += m_Queue.size();
+        m_Queue.clear();
+        if (--m_ActiveWorkers > 0) return;
+
+        stats = m_Stats;
+        onFinished = m_OnFinished;
+    }
+
+    LOG_INFO("刷新完成: 304=" << stats.notModified << ", 更新=" << stats.updated
+             << ", 失败=" << stats.failed << ", 取消=" << stats.cancelled);
+    if (onFinished) onFinished(stats);
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Running = false;
+    m_IdleCv.notify_all();
+}
+
+} // namespace Netease
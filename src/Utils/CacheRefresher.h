@@ -0,0 +1,104 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdint>
+#include "NeteaseAPI.h"
+
+/**
+ * CacheRefresher.h - 过期缓存后台刷新
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ *
+ * 对一批歌曲逐首执行条件刷新（默认 API::RefreshLyric）：
+ * - 固定数量的工作线程共享一个队列，同时在途的请求不超过 concurrency
+ * - 工作线程以后台优先级运行，不与播放 / UI 争抢
+ * - 可随时取消：未开始的歌曲直接丢弃，已发出的请求等待其完成
+ */
+
+namespace Netease {
+
+class CacheRefresher {
+public:
+    /**
+     * 单首刷新任务（在工作线程中调用）
+     */
+    using Task = std::function<RefreshStatus(long long songId)>;
+
+    struct Options {
+        int concurrency = 2;            // 同时在途的刷新请求上限
+        bool lowPriority = true;        // 后台线程优先级（THREAD_MODE_BACKGROUND）
+        Task task;                      // 为空时使用 API::RefreshLyric
+    };
+
+    struct Stats {
+        uint64_t scheduled = 0;         // 本轮排队的歌曲数
+        uint64_t notModified = 0;       // 304 确认仍有效
+        uint64_t updated = 0;           // 内容有变化（或无验证器，完整下载）
+        uint64_t noLyric = 0;           // 服务端已无歌词
+        uint64_t failed = 0;            // 网络错误 / 非预期响应
+        uint64_t cancelled = 0;         // 取消时尚未开始的歌曲
+        int peakInFlight = 0;           // 观察到的最大并发数
+    };
+
+    /**
+     * 一轮结束回调（在最后一个工作线程中调用）
+     */
+    using FinishedCallback = std::function<void(const Stats& stats)>;
+
+    explicit CacheRefresher(const Options& options);
+    CacheRefresher() : CacheRefresher(Options()) {}
+    ~CacheRefresher();
+
+    CacheRefresher(const CacheRefresher&) = delete;
+    CacheRefresher& operator=(const CacheRefresher&) = delete;
+
+    /**
+     * 开始一轮刷新
+     *
+     * @return 上一轮仍在进行时返回 false（不合并，避免重复刷新同一批歌曲）
+     */
+    bool Start(const std::vector<long long>& songIds, FinishedCallback onFinished = {});
+
+    /**
+     * 等待本轮结束
+     *
+     * @return 超时返回 false
+     */
+    bool Wait(int timeoutMs);
+
+    /**
+     * 取消本轮并等待在途请求结束
+     */
+    void Cancel();
+
+    /**
+     * 取消本轮并回收工作线程（SDK 关闭时调用；之后仍可再次 Start）
+     */
+    void Stop();
+
+    bool IsRunning() const;
+    Stats GetStats() const;
+
+private:
+    void WorkerLoop();
+    void JoinWorkers();
+
+    Options m_Options;
+
+    mutable std::mutex m_Mutex;
+    std::condition_variable m_IdleCv;
+    std::deque<long long> m_Queue;
+    std::vector<std::thread> m_Workers;
+    int m_ActiveWorkers = 0;
+    int m_InFlight = 0;
+    bool m_Running = false;             // 结束回调返回后才置为 false
+    bool m_Cancel = false;
+    Stats m_Stats;
+    FinishedCallback m_OnFinished;
+};
+
+} // namespace Netease
@@ -0,0 +1,255 @@
+/**
+ * HttpClient.cpp - 共享 HTTP GET 实现
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ */
+
+#include "HttpClient.h"
+#include "Inflate.h"
+#include <Windows.h>
+#include <wininet.h>
+#include <algorithm>
+#include <cctype>
+
+#define LOG_TAG "HTTP"
+#include "SimpleLog.h"
+
+#pragma comment(lib, "wininet.lib")
+
+namespace Netease::Http {
+
+namespace {
+
+const DWORD READ_CHUNK = 16 * 1024;
+
+// 压缩响应的预分配倍数：歌词 JSON 的 gzip 压缩率通常在 5~10 倍
+const size_t COMPRESSED_RESERVE_RATIO = 6;
+
+// 未给出 Content-Length 时的初始预分配
+const size_t DEFAULT_RESERVE = 64 * 1024;
+
+/**
+ * RAII 关闭 WinINet 句柄
+ */
+struct InternetHandle {
+    HINTERNET handle;
+    explicit InternetHandle(HINTERNET h) : handle(h) {}
+    ~InternetHandle() { if (handle) InternetCloseHandle(handle); }
+    InternetHandle(const InternetHandle&) = delete;
+    InternetHandle& operator=(const InternetHandle&) = delete;
+    explicit operator bool() const { return handle != nullptr; }
+};
+
+std::string QueryHeader(HINTERNET request, DWORD infoLevel) {
+    std::string value(256, '\0');
+    DWORD length = (DWORD)value.size();
+    if (!HttpQueryInfoA(request, infoLevel, &value[0], &length, NULL)) {
+        // 缓冲区不足时 length 为所需字节数（含结尾 NUL），按此重试（长 ETag 等）
+        if (GetLastError() != ERROR_INSUFFICIENT_BUFFER) return "";
+        value.resize(length);
+        if (!HttpQueryInfoA(request, infoLevel, &value[0], &length, NULL)) return "";
+    }
+    value.resize(length);
+    return value;
+}
+
+bool QueryNumber(HINTERNET request, DWORD infoLevel, DWORD& value) {
+    DWORD length = sizeof(value);
+    return HttpQueryInfoA(request, infoLevel | HTTP_QUERY_FLAG_NUMBER, &value, &length, NULL) != FALSE;
+}
+
+/**
+ * 请求期间把会话句柄登记到取消令牌；句柄已被 Cancel 关闭时不再重复关闭
+ */
+struct CancelScope {
+    Cancellation* token;
+    InternetHandle& session;
+    bool attached = false;
+
+    CancelScope(Cancellation* t, InternetHandle& s) : token(t), session(s) {
+        attached = !token || token->Attach(session.handle);
+    }
+    ~CancelScope() {
+        if (token && attached && token->Detach()) session.handle = nullptr;
+    }
+    CancelScope(const CancelScope&) = delete;
+    CancelScope& operator=(const CancelScope&) = delete;
+};
+
+} // namespace
+
+// ============================================================================
+// 取消令牌
+// ============================================================================
+
+void Cancellation::Cancel() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_Cancelled) return;
+    m_Cancelled = true;
+    if (m_Session) {
+        // 关闭会话句柄会中断其下所有阻塞中的 WinINet 调用
+        InternetCloseHandle((HINTERNET)m_Session);
+        m_Session = nullptr;
+        m_Closed = true;
+    }
+}
+
+bool Cancellation::IsCancelled() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Cancelled;
+}
+
+bool Cancellation::Attach(void* session) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_Cancelled) return false;
+    m_Session = session;
+    return true;
+}
+
+bool Cancellation::Detach() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Session = nullptr;
+    return m_Closed;
+}
+
+// ============================================================================
+// GET
+// ============================================================================
+
+std::optional<Response> Get(const std::string& url) {
+    return Get(url, Options());
+}
+
+std::optional<Response> Get(const std::string& url, const Options& options) {
+    InternetHandle session(InternetOpenA(options.userAgent.c_str(), INTERNET_OPEN_TYPE_PRECONFIG, NULL, NULL, 0));
+    if (!session) {
+        LOG_ERROR("InternetOpenA 失败: 错误码 " << GetLastError());
+        return std::nullopt;
+    }
+    CancelScope cancelScope(options.cancel.get(), session);
+    if (!cancelScope.attached) return std::nullopt;
+    auto cancelled = [&] { return options.cancel && options.cancel->IsCancelled(); };
+
+    DWORD timeout = (DWORD)options.timeoutMs;
+    InternetSetOptionA(session.handle, INTERNET_OPTION_CONNECT_TIMEOUT, &timeout, sizeof(timeout));
+    InternetSetOptionA(session.handle, INTERNET_OPTION_RECEIVE_TIMEOUT, &timeout, sizeof(timeout));
+
+    std::string headers = options.headers;
+    if (options.acceptCompressed) {
+        headers += "Accept-Encoding: gzip, deflate\r\n";
+    }
+    if (!options.ifNoneMatch.empty()) {
+        headers += "If-None-Match: " + options.ifNoneMatch + "\r\n";
+    }
+    if (!options.ifModifiedSince.empty()) {
+        headers += "If-Modified-Since: " + options.ifModifiedSince + "\r\n";
+    }
+
+    InternetHandle request(InternetOpenUrlA(
+        session.handle,
+        url.c_str(),
+        headers.empty() ? NULL : headers.c_str(),
+        (DWORD)headers.length(),
+        INTERNET_FLAG_NO_CACHE_WRITE | INTERNET_FLAG_RELOAD,
+        0
+    ));
+    if (!request) {
+        if (cancelled()) return std::nullopt;
+        LOG_WARN("请求失败: URL=" << url << " 错误码=" << GetLastError());
+        return std::nullopt;
+    }
+
+    Response response;
+    DWORD status = 0;
+    if (QueryNumber(request.handle, HTTP_QUERY_STATUS_CODE, status)) {
+        response.status = (int)status;
+    }
+    response.etag = QueryHeader(request.handle, HTTP_QUERY_ETAG);
+    response.lastModified = QueryHeader(request.handle, HTTP_QUERY_LAST_MODIFIED);
+
+    std::string encoding = QueryHeader(request.handle, HTTP_QUERY_CONTENT_ENCODING);
+    std::transform(encoding.begin(), encoding.end(), encoding.begin(),
+                   [](unsigned char c) { return (char)std::tolower(c); });
+    encoding.erase(std::remove_if(encoding.begin(), encoding.end(),
+                                  [](unsigned char c) { return std::isspace(c); }), encoding.end());
+    if (encoding == "identity") encoding.clear();
+
+    std::optional<Inflater> inflater;
+    if (encoding == "gzip" || encoding == "x-gzip") {
+        inflater.emplace(Inflater::Format::Gzip);
+    } else if (encoding == "deflate") {
+        inflater.emplace(Inflater::Format::Auto);   // 规范为 zlib，部分服务端发送原始 deflate
+    } else if (!encoding.empty()) {
+        LOG_WARN("不支持的 Content-Encoding: " << encoding << " URL=" << url);
+        return std::nullopt;
+    }
+    response.contentEncoding = encoding;
+
+    // 预分配：明文按 Content-Length，压缩按估计的解压后大小
+    DWORD contentLength = 0;
+    bool hasContentLength = QueryNumber(request.handle, HTTP_QUERY_CONTENT_LENGTH, contentLength);
+    size_t reserve = DEFAULT_RESERVE;
+    if (hasContentLength && contentLength > 0) {
+        reserve = inflater ? (size_t)contentLength * COMPRESSED_RESERVE_RATIO : (size_t)contentLength;
+    }
+    if (options.maxBodyBytes > 0) {
+        reserve = (std::min)(reserve, options.maxBodyBytes);
+    }
+    response.body.reserve(reserve);
+
+    std::string chunk;
+    if (inflater) chunk.resize(READ_CHUNK);
+
+    while (true) {
+        DWORD bytesRead = 0;
+        if (inflater) {
+            if (!InternetReadFile(request.handle, &chunk[0], READ_CHUNK, &bytesRead)) {
+                if (!cancelled()) LOG_WARN("读取响应失败: URL=" << url << " 错误码=" << GetLastError());
+                return std::nullopt;
+            }
+            if (bytesRead == 0) break;
+            if (inflater->Feed(chunk.data(), bytesRead, response.body) == Inflater::Status::Error) {
+                LOG_WARN("解压失败 (" << encoding << "): URL=" << url);
+                return std::nullopt;
+            }
+        } else {
+            // 明文直接读入正文缓冲区尾部
+            size_t offset = response.body.size();
+            response.body.resize(offset + READ_CHUNK);
+            BOOL ok = InternetReadFile(request.handle, &response.body[offset], READ_CHUNK, &bytesRead);
+            if (!ok) {
+                if (!cancelled()) LOG_WARN("读取响应失败: URL=" << url << " 错误码=" << GetLastError());
+                return std::nullopt;
+            }
+            response.body.resize(offset + bytesRead);
+            if (bytesRead == 0) break;
+        }
+        response.wireBytes += bytesRead;
+
+        if (options.maxBodyBytes > 0 && response.body.size() > options.maxBodyBytes) {
+            LOG_WARN("响应超过 " << options.maxBodyBytes << " 字节限制: " << url);
+            return std::nullopt;
+        }
+    }
+
+    // 读取中途被取消时正文可能不完整
+    if (cancelled()) return std::nullopt;
+
+    // 连接提前关闭时 InternetReadFile 也会以 0 字节结束：按 Content-Length 核对线上字节数
+    // （304 / 204 可以带描述完整表示的 Content-Length，不核对）
+    bool bodyless = response.status == 304 || response.status == 204;
+    if (hasContentLength && !bodyless && response.wireBytes != (uint64_t)contentLength) {
+        LOG_WARN("响应不完整: 收到 " << response.wireBytes << " / " << contentLength << " 字节 URL=" << url);
+        return std::nullopt;
+    }
+
+    // 无正文的响应（304 / HEAD 语义）可能仍带 Content-Encoding
+    if (inflater && response.wireBytes > 0 && inflater->GetStatus() != Inflater::Status::Done) {
+        LOG_WARN("压缩流不完整 (" << encoding << "): URL=" << url);
+        return std::nullopt;
+    }
+
+    return response;
+}
+
+} // namespace Netease::Http
@@ -0,0 +1,90 @@
+#pragma once
+#include <string>
+#include <optional>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+/**
+ * HttpClient.h - 共享 HTTP GET（WinINet）
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ *
+ * API::HttpGet 与 AlbumCover::DownloadFile 原先各自实现 WinINet 读取循环，
+ * 且都不发送 Accept-Encoding：高度可压缩的歌词 JSON 始终以明文传输。
+ * 本模块统一两者：
+ * - 发送 Accept-Encoding: gzip, deflate，按 Content-Encoding 在本地流式解压
+ *   （不开启 WinINet 自带解码，以便统计线上字节数并控制缓冲区）
+ * - 正文写入按 Content-Length 预分配的缓冲区，避免逐块扩容
+ * - 返回状态码、线上字节数，供调用方判断与统计
+ * - 条件请求：携带缓存验证器，304 表示缓存仍有效（无正文）
+ * - 取消：另一个线程可中断阻塞中的请求（对冲请求用它结束落后的一方）
+ */
+
+namespace Netease::Http {
+
+    /**
+     * 取消令牌
+     *
+     * Cancel() 关闭进行中请求的会话句柄，阻塞在连接 / 读取上的 Get 随即以 nullopt 返回；
+     * 请求开始前已取消则不发出请求。一个令牌只用于一次请求。
+     */
+    class Cancellation {
+    public:
+        void Cancel();
+        bool IsCancelled() const;
+
+        /**
+         * 由 Get 内部调用：登记 / 注销会话句柄
+         *
+         * @return Attach 在已取消时返回 false；Detach 在句柄已被 Cancel 关闭时返回 true
+         */
+        bool Attach(void* session);
+        bool Detach();
+
+    private:
+        mutable std::mutex m_Mutex;
+        void* m_Session = nullptr;
+        bool m_Cancelled = false;
+        bool m_Closed = false;
+    };
+
+    /**
+     * 请求选项
+     */
+    struct Options {
+        std::string headers;                // 额外请求头（每行以 \r\n 结尾）
+        int timeoutMs = 8000;               // 连接 / 接收超时
+        bool acceptCompressed = true;       // 协商 gzip / deflate 压缩传输
+        size_t maxBodyBytes = 0;            // 解压后正文上限，0 = 不限制
+        std::string userAgent = "Mozilla/5.0 (Windows NT 10.0; Win64; x64)";
+        std::string ifNoneMatch;            // 非空时发送 If-None-Match（上次的 ETag）
+        std::string ifModifiedSince;        // 非空时发送 If-Modified-Since（上次的 Last-Modified）
+        std::shared_ptr<Cancellation> cancel;   // 非空时可从其他线程取消
+    };
+
+    /**
+     * 响应
+     */
+    struct Response {
+        int status = 0;                     // HTTP 状态码
+        std::string body;                   // 正文（已解压）
+        std::string contentEncoding;        // 服务端使用的编码，空表示未压缩
+        uint64_t wireBytes = 0;             // 实际接收的正文字节数（压缩后）
+        std::string etag;                   // 响应头 ETag
+        std::string lastModified;           // 响应头 Last-Modified
+
+        bool IsNotModified() const { return status == 304; }
+    };
+
+    /**
+     * 发送 GET 请求
+     *
+     * @return 连接失败、超时、解压失败、超出大小上限或被取消时返回 nullopt；
+     *         非 2xx 状态码仍返回响应，由调用方判断
+     */
+    std::optional<Response> Get(const std::string& url, const Options& options);
+    std::optional<Response> Get(const std::string& url);
+
+} // namespace Netease::Http
@@ -0,0 +1,516 @@
+/**
+ * Inflate.cpp - DEFLATE 流式解压实现
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ */
+
+#include "Inflate.h"
+#include <cstring>
+
+namespace Netease {
+
+// ============================================================================
+// 常量表 (RFC 1951 3.2.5)
+// ============================================================================
+
+namespace {
+
+const uint16_t LENGTH_BASE[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+const uint8_t LENGTH_EXTRA[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+const uint16_t DIST_BASE[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+const uint8_t DIST_EXTRA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+// 码长码的传输顺序
+const uint8_t CODELEN_ORDER[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+uint32_t Crc32(const unsigned char* data, size_t size) {
+    static const auto table = [] {
+        struct { uint32_t v[256]; } t;
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t.v[i] = c;
+        }
+        return t;
+    }();
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table.v[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+uint32_t Adler32(const unsigned char* data, size_t size) {
+    uint32_t a = 1, b = 0;
+    while (size > 0) {
+        size_t n = size < 5552 ? size : 5552;   // 保证累加不溢出的最大批量
+        size -= n;
+        while (n--) {
+            a += *data++;
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (b << 16) | a;
+}
+
+} // namespace
+
+// ============================================================================
+// Huffman 表：低位 10 bit 直接查表，更长的码走规范码逐位解码
+// ============================================================================
+
+struct Inflater::Huffman {
+    static constexpr int FAST_BITS = 10;
+
+    uint16_t fast[1 << FAST_BITS];  // (码长 << 9) | 符号；0 表示走慢路径
+    uint16_t count[16];             // 每个码长的符号数
+    uint16_t symbol[288];           // 按 (码长, 符号) 排序的符号
+
+    bool Build(const uint8_t* lengths, int n) {
+        std::memset(count, 0, sizeof(count));
+        std::memset(fast, 0, sizeof(fast));
+        for (int i = 0; i < n; ++i) count[lengths[i]]++;
+        count[0] = 0;
+
+        // 过度订阅的码无效（不完整的码允许：只含一个距离码的块）
+        int left = 1;
+        for (int len = 1; len < 16; ++len) {
+            left = (left << 1) - count[len];
+            if (left < 0) return false;
+        }
+
+        uint16_t offset[16];
+        uint16_t next[16];
+        offset[1] = 0;
+        for (int len = 1; len < 15; ++len) offset[len + 1] = offset[len] + count[len];
+        int code = 0;
+        for (int len = 1; len < 16; ++len) {
+            code = (code + count[len - 1]) << 1;
+            next[len] = (uint16_t)code;
+        }
+
+        for (int sym = 0; sym < n; ++sym) {
+            int len = lengths[sym];
+            if (len == 0) continue;
+            symbol[offset[len]++] = (uint16_t)sym;
+
+            int c = next[len]++;
+            if (len > FAST_BITS) continue;
+            // 码以高位在前定义，而比特流低位在前：查表索引为反转后的码
+            int rev = 0;
+            for (int i = 0; i < len; ++i) rev |= ((c >> i) & 1) << (len - 1 - i);
+            for (int i = rev; i < (1 << FAST_BITS); i += 1 << len) {
+                fast[i] = (uint16_t)((len << 9) | sym);
+            }
+        }
+        return true;
+    }
+};
+
+struct Inflater::Tables {
+    Huffman lit;
+    Huffman dist;
+};
+
+// ============================================================================
+// 构造 / 重置
+// ============================================================================
+
+Inflater::Inflater(Format format) {
+    Reset(format);
+}
+
+Inflater::~Inflater() = default;
+
+void Inflater::Reset(Format format) {
+    m_Format = format;
+    m_Phase = Phase::StreamHeader;
+    m_Status = Status::NeedMore;
+    m_FinalBlock = false;
+    m_OutBaseSet = false;
+    m_OutBase = 0;
+    m_StoredLeft = 0;
+    m_In.clear();
+    m_Pos = 0;
+    m_Bits = 0;
+    m_BitCount = 0;
+    m_Active = nullptr;
+}
+
+bool Inflater::Inflate(std::string_view in, Format format, std::string& out) {
+    Inflater inflater(format);
+    return inflater.Feed(in.data(), in.size(), out) == Status::Done;
+}
+
+// ============================================================================
+// 主循环
+// ============================================================================
+
+Inflater::Status Inflater::Feed(const void* data, size_t size, std::string& out) {
+    if (m_Status != Status::NeedMore) return m_Status;
+    if (!m_OutBaseSet) {
+        m_OutBase = out.size();
+        m_OutBaseSet = true;
+    }
+    m_In.append(static_cast<const char*>(data), size);
+
+    while (m_Phase != Phase::Finished) {
+        Step step = Step::Corrupt;
+        switch (m_Phase) {
+            case Phase::StreamHeader: step = ParseStreamHeader(); break;
+            case Phase::BlockHeader:  step = ParseBlockHeader(); break;
+            case Phase::Stored:       step = CopyStored(out); break;
+            case Phase::Codes:        step = DecodeCodes(out); break;
+            case Phase::Trailer:      step = CheckTrailer(out); break;
+            case Phase::Finished:     break;
+        }
+        if (step == Step::Corrupt) {
+            m_Status = Status::Error;
+            return m_Status;
+        }
+        if (step == Step::Starved) break;
+    }
+
+    if (m_Phase == Phase::Finished) {
+        m_Status = Status::Done;
+        m_In.clear();
+        m_Pos = 0;
+    } else {
+        Compact();
+    }
+    return m_Status;
+}
+
+void Inflater::Compact() {
+    if (m_Pos > 0) {
+        m_In.erase(0, m_Pos);
+        m_Pos = 0;
+    }
+}
+
+bool Inflater::Need(int bits) {
+    while (m_BitCount <= 56 && m_Pos < m_In.size()) {
+        m_Bits |= (uint64_t)(unsigned char)m_In[m_Pos++] << m_BitCount;
+        m_BitCount += 8;
+    }
+    return m_BitCount >= bits;
+}
+
+// ============================================================================
+// 流头 / 流尾
+// ============================================================================
+
+Inflater::Step Inflater::ParseStreamHeader() {
+    Checkpoint cp = Save();
+    auto readByte = [this](uint32_t& value) {
+        if (!Need(8)) return false;
+        value = Peek(8);
+        Drop(8);
+        return true;
+    };
+
+    if (m_Format == Format::Auto) {
+        if (!Need(16)) return Step::Starved;
+        uint32_t b0 = Peek(8), b1 = Peek(16) >> 8;
+        if (b0 == 0x1F && b1 == 0x8B) {
+            m_Format = Format::Gzip;
+        } else if ((b0 & 0x0F) == 8 && (b0 >> 4) <= 7 && ((b0 << 8) | b1) % 31 == 0) {
+            m_Format = Format::Zlib;
+        } else {
+            m_Format = Format::Raw;
+        }
+    }
+
+    if (m_Format == Format::Zlib) {
+        uint32_t cmf, flg;
+        if (!readByte(cmf) || !readByte(flg)) { Restore(cp); return Step::Starved; }
+        if ((cmf & 0x0F) != 8 || ((cmf << 8) | flg) % 31 != 0) return Step::Corrupt;
+        if (flg & 0x20) return Step::Corrupt;           // 预设字典：HTTP 中不会出现
+    } else if (m_Format == Format::Gzip) {
+        uint32_t id1, id2, cm, flg, skip;
+        if (!readByte(id1) || !readByte(id2) || !readByte(cm) || !readByte(flg)) { Restore(cp); return Step::Starved; }
+        if (id1 != 0x1F || id2 != 0x8B || cm != 8 || (flg & 0xE0)) return Step::Corrupt;
+        for (int i = 0; i < 6; ++i) {                   // MTIME, XFL, OS
+            if (!readByte(skip)) { Restore(cp); return Step::Starved; }
+        }
+        if (flg & 0x04) {                               // FEXTRA
+            uint32_t lo, hi;
+            if (!readByte(lo) || !readByte(hi)) { Restore(cp); return Step::Starved; }
+            for (uint32_t i = 0, n = lo | (hi << 8); i < n; ++i) {
+                if (!readByte(skip)) { Restore(cp); return Step::Starved; }
+            }
+        }
+        for (uint32_t flag : { 0x08u, 0x10u }) {        // FNAME, FCOMMENT：以 0 结尾
+            if (!(flg & flag)) continue;
+            do {
+                if (!readByte(skip)) { Restore(cp); return Step::Starved; }
+            } while (skip != 0);
+        }
+        if (flg & 0x02) {                               // FHCRC
+            if (!readByte(skip) || !readByte(skip)) { Restore(cp); return Step::Starved; }
+        }
+    }
+
+    m_Phase = Phase::BlockHeader;
+    return Step::Advance;
+}
+
+Inflater::Step Inflater::CheckTrailer(const std::string& out) {
+    Checkpoint cp = Save();
+    Drop(m_BitCount % 8);   // 对齐到字节
+
+    const unsigned char* produced = reinterpret_cast<const unsigned char*>(out.data()) + m_OutBase;
+    size_t producedSize = out.size() - m_OutBase;
+
+    if (m_Format == Format::Gzip) {
+        if (!Need(64)) { Restore(cp); return Step::Starved; }
+        uint32_t crc = Peek(32);
+        Drop(32);
+        uint32_t isize = Peek(32);
+        Drop(32);
+        if (crc != Crc32(produced, producedSize) || isize != (uint32_t)producedSize) return Step::Corrupt;
+    } else if (m_Format == Format::Zlib) {
+        if (!Need(32)) { Restore(cp); return Step::Starved; }
+        uint32_t v = Peek(32);
+        Drop(32);
+        uint32_t adler = ((v & 0xFF) << 24) | ((v & 0xFF00) << 8) | ((v >> 8) & 0xFF00) | (v >> 24);
+        if (adler != Adler32(produced, producedSize)) return Step::Corrupt;
+    }
+
+    m_Phase = Phase::Finished;
+    return Step::Advance;
+}
+
+// ============================================================================
+// 块
+// ============================================================================
+
+Inflater::Step Inflater::ParseBlockHeader() {
+    Checkpoint cp = Save();
+    if (!Need(3)) return Step::Starved;
+    m_FinalBlock = Peek(1) != 0;
+    uint32_t type = (Peek(3) >> 1) & 3;
+    Drop(3);
+
+    switch (type) {
+        case 0: {
+            Drop(m_BitCount % 8);
+            if (!Need(32)) { Restore(cp); return Step::Starved; }
+            uint32_t len = Peek(16);
+            Drop(16);
+            uint32_t nlen = Peek(16);
+            Drop(16);
+            if (len != (~nlen & 0xFFFF)) return Step::Corrupt;
+            m_StoredLeft = len;
+            m_Phase = Phase::Stored;
+            return Step::Advance;
+        }
+        case 1:
+            m_Active = FixedTables();
+            m_Phase = Phase::Codes;
+            return Step::Advance;
+        case 2: {
+            Step step = ParseDynamicTables();
+            if (step == Step::Starved) Restore(cp);
+            return step;
+        }
+        default:
+            return Step::Corrupt;
+    }
+}
+
+Inflater::Step Inflater::ParseDynamicTables() {
+    if (!Need(14)) return Step::Starved;
+    int nlen = (int)Peek(5) + 257;
+    int ndist = (int)(Peek(10) >> 5) + 1;
+    int ncode = (int)(Peek(14) >> 10) + 4;
+    Drop(14);
+    if (nlen > 286 || ndist > 30) return Step::Corrupt;
+
+    uint8_t lengths[320] = {};
+    for (int i = 0; i < ncode; ++i) {
+        if (!Need(3)) return Step::Starved;
+        lengths[CODELEN_ORDER[i]] = (uint8_t)Peek(3);
+        Drop(3);
+    }
+
+    if (!m_Dynamic) m_Dynamic = std::make_unique<Tables>();
+    Huffman& codelen = m_Dynamic->lit;     // 暂借字面量表解码码长
+    if (!codelen.Build(lengths, 19)) return Step::Corrupt;
+
+    std::memset(lengths, 0, sizeof(lengths));
+    int index = 0;
+    while (index < nlen + ndist) {
+        int sym;
+        Step step = DecodeSymbol(codelen, sym);
+        if (step != Step::Advance) return step;
+
+        if (sym < 16) {
+            lengths[index++] = (uint8_t)sym;
+            continue;
+        }
+
+        uint8_t value = 0;
+        int repeat;
+        if (sym == 16) {
+            if (index == 0) return Step::Corrupt;
+            value = lengths[index - 1];
+            if (!Need(2)) return Step::Starved;
+            repeat = 3 + (int)Peek(2);
+            Drop(2);
+        } else if (sym == 17) {
+            if (!Need(3)) return Step::Starved;
+            repeat = 3 + (int)Peek(3);
+            Drop(3);
+        } else {
+            if (!Need(7)) return Step::Starved;
+            repeat = 11 + (int)Peek(7);
+            Drop(7);
+        }
+        if (index + repeat > nlen + ndist) return Step::Corrupt;
+        while (repeat--) lengths[index++] = value;
+    }
+
+    if (lengths[256] == 0) return Step::Corrupt;    // 必须有块结束符
+    if (!m_Dynamic->lit.Build(lengths, nlen) || !m_Dynamic->dist.Build(lengths + nlen, ndist)) {
+        return Step::Corrupt;
+    }
+
+    m_Active = m_Dynamic.get();
+    m_Phase = Phase::Codes;
+    return Step::Advance;
+}
+
+Inflater::Step Inflater::CopyStored(std::string& out) {
+    // 先取走位缓冲中已读入的整字节，再直接从输入拷贝
+    while (m_StoredLeft > 0 && m_BitCount >= 8) {
+        out.push_back((char)Peek(8));
+        Drop(8);
+        m_StoredLeft--;
+    }
+    if (m_StoredLeft > 0) {
+        size_t available = m_In.size() - m_Pos;
+        size_t n = available < m_StoredLeft ? available : m_StoredLeft;
+        out.append(m_In, m_Pos, n);
+        m_Pos += n;
+        m_StoredLeft -= (uint32_t)n;
+        if (m_StoredLeft > 0) return Step::Starved;
+    }
+    m_Phase = m_FinalBlock ? Phase::Trailer : Phase::BlockHeader;
+    return Step::Advance;
+}
+
+Inflater::Step Inflater::DecodeSymbol(const Huffman& h, int& symbol) {
+    if (Need(Huffman::FAST_BITS)) {
+        uint16_t entry = h.fast[Peek(Huffman::FAST_BITS)];
+        if (entry != 0) {
+            Drop(entry >> 9);
+            symbol = entry & 0x1FF;
+            return Step::Advance;
+        }
+    }
+
+    // 慢路径：规范 Huffman 码逐位比较（长码，或流末尾不足 FAST_BITS 位）
+    int code = 0, first = 0, index = 0;
+    for (int len = 1; len < 16; ++len) {
+        if (m_BitCount < len) return Step::Starved;
+        code |= (int)((m_Bits >> (len - 1)) & 1);
+        int count = h.count[len];
+        if (code - count < first) {
+            Drop(len);
+            symbol = h.symbol[index + (code - first)];
+            return Step::Advance;
+        }
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    return Step::Corrupt;
+}
+
+Inflater::Step Inflater::DecodeCodes(std::string& out) {
+    const Huffman& lit = m_Active->lit;
+    const Huffman& dist = m_Active->dist;
+
+    while (true) {
+        // 一个字面量或一组 (长度, 距离) 为一个回滚单元
+        Checkpoint cp = Save();
+        int sym;
+        Step step = DecodeSymbol(lit, sym);
+        if (step != Step::Advance) {
+            if (step == Step::Starved) Restore(cp);
+            return step;
+        }
+
+        if (sym < 256) {
+            out.push_back((char)sym);
+            continue;
+        }
+        if (sym == 256) {
+            m_Phase = m_FinalBlock ? Phase::Trailer : Phase::BlockHeader;
+            return Step::Advance;
+        }
+
+        sym -= 257;
+        if (sym >= 29) return Step::Corrupt;
+        if (!Need(LENGTH_EXTRA[sym])) { Restore(cp); return Step::Starved; }
+        size_t length = LENGTH_BASE[sym] + Peek(LENGTH_EXTRA[sym]);
+        Drop(LENGTH_EXTRA[sym]);
+
+        int dsym;
+        step = DecodeSymbol(dist, dsym);
+        if (step != Step::Advance) {
+            if (step == Step::Starved) Restore(cp);
+            return step;
+        }
+        if (dsym >= 30) return Step::Corrupt;
+        if (!Need(DIST_EXTRA[dsym])) { Restore(cp); return Step::Starved; }
+        size_t distance = DIST_BASE[dsym] + Peek(DIST_EXTRA[dsym]);
+        Drop(DIST_EXTRA[dsym]);
+
+        size_t start = out.size();
+        if (distance > start - m_OutBase) return Step::Corrupt;
+
+        out.resize(start + length);
+        char* dst = &out[start];
+        const char* src = dst - distance;
+        if (distance >= length) {
+            std::memcpy(dst, src, length);
+        } else {
+            for (size_t i = 0; i < length; ++i) dst[i] = src[i];   // 重叠：逐字节复制出重复串
+        }
+    }
+}
+
+const Inflater::Tables* Inflater::FixedTables() {
+    static const Tables* tables = [] {
+        auto* t = new Tables();
+        uint8_t lengths[288];
+        for (int i = 0; i < 144; ++i) lengths[i] = 8;
+        for (int i = 144; i < 256; ++i) lengths[i] = 9;
+        for (int i = 256; i < 280; ++i) lengths[i] = 7;
+        for (int i = 280; i < 288; ++i) lengths[i] = 8;
+        t->lit.Build(lengths, 288);
+        for (int i = 0; i < 30; ++i) lengths[i] = 5;
+        t->dist.Build(lengths, 30);
+        return t;
+    }();
+    return tables;
+}
+
+} // namespace Netease
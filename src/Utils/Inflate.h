@@ -0,0 +1,125 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Inflate.h - DEFLATE 流式解压 (gzip / zlib / 原始 deflate)
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ *
+ * 用于 HTTP 压缩传输（Content-Encoding: gzip / deflate）。
+ * 不引入 zlib：歌词 JSON 体积小、只需解压，自带实现即可。
+ *
+ * 流式：网络数据到达一块就喂一块，输出直接追加到调用方预分配的缓冲区；
+ * 输入不足以解出完整单元（块头 / 一个符号）时回滚到检查点，等待下一块数据。
+ * 输出缓冲区本身即滑动窗口（保留全部输出，回溯引用直接在其中拷贝）。
+ *
+ * 校验：gzip 校验 CRC32 + ISIZE，zlib 校验 Adler-32。
+ */
+
+namespace Netease {
+
+class Inflater {
+public:
+    enum class Format {
+        Auto,       // 按前两个字节识别 gzip / zlib，否则按原始 deflate
+        Raw,        // RFC 1951
+        Zlib,       // RFC 1950（HTTP "deflate" 的标准含义）
+        Gzip        // RFC 1952
+    };
+
+    enum class Status {
+        NeedMore,   // 尚未结束，等待更多输入
+        Done,       // 流结束且校验通过
+        Error       // 数据损坏 / 校验失败
+    };
+
+    explicit Inflater(Format format = Format::Auto);
+    ~Inflater();
+
+    Inflater(const Inflater&) = delete;
+    Inflater& operator=(const Inflater&) = delete;
+
+    /**
+     * 重置状态以解压新的流
+     */
+    void Reset(Format format = Format::Auto);
+
+    /**
+     * 喂入一块压缩数据，解压结果追加到 out
+     *
+     * @note 同一个流的每次调用必须传入同一个 out（回溯引用依赖之前的输出）
+     * @note Done 之后的多余输入被忽略
+     */
+    Status Feed(const void* data, size_t size, std::string& out);
+
+    Status GetStatus() const { return m_Status; }
+
+    /**
+     * 一次性解压
+     *
+     * @return 数据完整且校验通过返回 true
+     */
+    static bool Inflate(std::string_view in, Format format, std::string& out);
+
+private:
+    struct Huffman;
+    struct Tables;
+
+    static const Tables* FixedTables();
+
+    enum class Phase {
+        StreamHeader,
+        BlockHeader,
+        Stored,
+        Codes,
+        Trailer,
+        Finished
+    };
+
+    // 位读取（LSB 优先）；不足时返回 false，由调用方回滚
+    bool Need(int bits);
+    uint32_t Peek(int bits) const { return (uint32_t)(m_Bits & ((1ULL << bits) - 1)); }
+    void Drop(int bits) { m_Bits >>= bits; m_BitCount -= bits; }
+
+    struct Checkpoint {
+        size_t pos;
+        uint64_t bits;
+        int bitCount;
+    };
+    Checkpoint Save() const { return { m_Pos, m_Bits, m_BitCount }; }
+    void Restore(const Checkpoint& cp) { m_Pos = cp.pos; m_Bits = cp.bits; m_BitCount = cp.bitCount; }
+
+    // 单步结果：Advance 继续下一步，Starved 输入不足（已回滚），Corrupt 数据损坏
+    enum class Step { Advance, Starved, Corrupt };
+
+    Step DecodeSymbol(const Huffman& h, int& symbol);
+    Step ParseStreamHeader();
+    Step ParseBlockHeader();
+    Step ParseDynamicTables();
+    Step CopyStored(std::string& out);
+    Step DecodeCodes(std::string& out);
+    Step CheckTrailer(const std::string& out);
+    void Compact();
+
+    Format m_Format;
+    Phase m_Phase = Phase::StreamHeader;
+    Status m_Status = Status::NeedMore;
+    bool m_FinalBlock = false;
+    bool m_OutBaseSet = false;
+    size_t m_OutBase = 0;               // 本流输出在 out 中的起点
+    uint32_t m_StoredLeft = 0;
+
+    std::string m_In;                   // 未消费的输入（跨 Feed 保留）
+    size_t m_Pos = 0;
+    uint64_t m_Bits = 0;
+    int m_BitCount = 0;
+
+    std::unique_ptr<Tables> m_Dynamic;  // 动态 Huffman 表（固定表为静态共享）
+    const Tables* m_Active = nullptr;
+};
+
+} // namespace Netease
@@ -0,0 +1,305 @@
+/**
+ * JsonString.cpp - JSON 字符串转义/反转义内核实现
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ */
+
+#include "JsonString.h"
+#include "CpuFeatures.h"
+#include <atomic>
+#include <cstdint>
+
+namespace Netease::Json {
+
+namespace {
+
+// ============================================================================
+// 扫描内核：返回第一个需要特殊处理的字节偏移，未找到返回 n
+//   Control = false: 引号 / 反斜杠         (反转义)
+//   Control = true : 引号 / 反斜杠 / < 0x20 (转义)
+// ============================================================================
+
+inline unsigned CountTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctz(mask);
+#endif
+}
+
+template <bool Control>
+size_t FindSpecialScalar(const char* p, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        unsigned char c = (unsigned char)p[i];
+        if (c == '"' || c == '\\' || (Control && c < 0x20)) return i;
+    }
+    return n;
+}
+
+#if defined(NETEASE_ARCH_X86)
+
+template <bool Control>
+NETEASE_TARGET_SSE2 size_t FindSpecialSSE2(const char* p, size_t n) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i slash = _mm_set1_epi8('\\');
+    const __m128i ctrl = _mm_set1_epi8(0x1F);
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(p + i));
+        __m128i m = _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, slash));
+        if (Control) {
+            // 无符号 v <= 0x1F  <=>  min(v, 0x1F) == v
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_min_epu8(v, ctrl), v));
+        }
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(m);
+        if (mask) return i + CountTrailingZeros(mask);
+    }
+    return i + FindSpecialScalar<Control>(p + i, n - i);
+}
+
+template <bool Control>
+NETEASE_TARGET_AVX2 size_t FindSpecialAVX2(const char* p, size_t n) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i slash = _mm256_set1_epi8('\\');
+    const __m256i ctrl = _mm256_set1_epi8(0x1F);
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(p + i));
+        __m256i m = _mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, slash));
+        if (Control) {
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(_mm256_min_epu8(v, ctrl), v));
+        }
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(m);
+        if (mask) {
+            _mm256_zeroupper();
+            return i + CountTrailingZeros(mask);
+        }
+    }
+    // 显式清理 YMM 高位，避免后续 legacy SSE 代码的状态切换惩罚
+    _mm256_zeroupper();
+    return i + FindSpecialSSE2<Control>(p + i, n - i);
+}
+
+#endif // NETEASE_ARCH_X86
+
+using FindFn = size_t (*)(const char*, size_t);
+
+struct KernelTable {
+    FindFn findQuoteOrSlash;
+    FindFn findEscapable;
+};
+
+KernelTable TableFor(Kernel kernel) {
+    switch (kernel) {
+#if defined(NETEASE_ARCH_X86)
+        case Kernel::AVX2: return { &FindSpecialAVX2<false>, &FindSpecialAVX2<true> };
+        case Kernel::SSE2: return { &FindSpecialSSE2<false>, &FindSpecialSSE2<true> };
+#endif
+        default:           return { &FindSpecialScalar<false>, &FindSpecialScalar<true> };
+    }
+}
+
+bool IsSupported(Kernel kernel) {
+    const auto& cpu = Cpu::Get();
+    switch (kernel) {
+        case Kernel::Scalar: return true;
+#if defined(NETEASE_ARCH_X86)
+        case Kernel::SSE2: return cpu.sse2;
+        case Kernel::AVX2: return cpu.avx2;
+#endif
+        default: return false;
+    }
+}
+
+Kernel BestKernel() {
+    if (IsSupported(Kernel::AVX2)) return Kernel::AVX2;
+    if (IsSupported(Kernel::SSE2)) return Kernel::SSE2;
+    return Kernel::Scalar;
+}
+
+std::atomic<Kernel> g_Kernel{ BestKernel() };
+
+// ============================================================================
+// Unicode 辅助
+// ============================================================================
+
+inline int HexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 解析 4 位十六进制，失败返回 -1
+inline int ParseHex4(const char* p) {
+    int value = 0;
+    for (int k = 0; k < 4; ++k) {
+        int h = HexValue(p[k]);
+        if (h < 0) return -1;
+        value = (value << 4) | h;
+    }
+    return value;
+}
+
+inline void AppendUtf8(std::string& out, uint32_t cp) {
+    char buf[4];
+    size_t len;
+    if (cp <= 0x7F) {
+        buf[0] = (char)cp;
+        len = 1;
+    } else if (cp <= 0x7FF) {
+        buf[0] = (char)(0xC0 | (cp >> 6));
+        buf[1] = (char)(0x80 | (cp & 0x3F));
+        len = 2;
+    } else if (cp <= 0xFFFF) {
+        buf[0] = (char)(0xE0 | (cp >> 12));
+        buf[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        buf[2] = (char)(0x80 | (cp & 0x3F));
+        len = 3;
+    } else {
+        buf[0] = (char)(0xF0 | (cp >> 18));
+        buf[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+        buf[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        buf[3] = (char)(0x80 | (cp & 0x3F));
+        len = 4;
+    }
+    out.append(buf, len);
+}
+
+/**
+ * 解码 \uXXXX（i 指向 'u' 之后），返回新的读取位置
+ *
+ * - 高代理 + \u低代理 合并为一个补充平面码点
+ * - 孤立代理输出 U+FFFD
+ * - 十六进制非法时保留字符 'u'（与旧实现一致）
+ */
+size_t DecodeUnicodeEscape(const char* p, size_t n, size_t i, std::string& out) {
+    if (i + 4 > n) {
+        out += 'u';
+        return i;
+    }
+
+    int unit = ParseHex4(p + i);
+    if (unit < 0) {
+        out += 'u';
+        return i;
+    }
+    i += 4;
+
+    uint32_t cp = (uint32_t)unit;
+    if (cp >= 0xD800 && cp <= 0xDBFF) {
+        // 期望紧随其后的低代理 \uDC00-\uDFFF
+        if (i + 6 <= n && p[i] == '\\' && p[i + 1] == 'u') {
+            int low = ParseHex4(p + i + 2);
+            if (low >= 0xDC00 && low <= 0xDFFF) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + ((uint32_t)low - 0xDC00);
+                i += 6;
+                AppendUtf8(out, cp);
+                return i;
+            }
+        }
+        cp = 0xFFFD;
+    } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+        cp = 0xFFFD;
+    }
+
+    AppendUtf8(out, cp);
+    return i;
+}
+
+} // namespace
+
+// ============================================================================
+// 公共接口
+// ============================================================================
+
+bool SetKernel(Kernel kernel) {
+    if (kernel == Kernel::Auto) kernel = BestKernel();
+    if (!IsSupported(kernel)) return false;
+    g_Kernel.store(kernel);
+    return true;
+}
+
+Kernel GetKernel() {
+    return g_Kernel.load();
+}
+
+bool UnescapeString(std::string_view in, std::string& out, size_t* consumed) {
+    const FindFn find = TableFor(g_Kernel.load()).findQuoteOrSlash;
+    const char* p = in.data();
+    const size_t n = in.size();
+
+    // 注意：in 通常延伸到整个文档末尾，不能按 n 预留；整段 append 本身已摊还扩容
+    size_t i = 0;
+    while (i < n) {
+        size_t run = find(p + i, n - i);
+        out.append(p + i, run);
+        i += run;
+        if (i >= n) break;
+
+        if (p[i] == '"') {
+            if (consumed) *consumed = i + 1;
+            return true;
+        }
+
+        // 反斜杠
+        if (i + 1 >= n) break;
+        char e = p[i + 1];
+        i += 2;
+        switch (e) {
+            case '"':  out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/':  out += '/'; break;
+            case 'b':  out += '\b'; break;
+            case 'f':  out += '\f'; break;
+            case 'n':  out += '\n'; break;
+            case 'r':  out += '\r'; break;
+            case 't':  out += '\t'; break;
+            case 'u':  i = DecodeUnicodeEscape(p, n, i, out); break;
+            default:   out += e; break;
+        }
+    }
+
+    if (consumed) *consumed = n;
+    return false;
+}
+
+void AppendEscaped(std::string& out, std::string_view in) {
+    static const char HEX[] = "0123456789abcdef";
+    const FindFn find = TableFor(g_Kernel.load()).findEscapable;
+    const char* p = in.data();
+    const size_t n = in.size();
+
+    // 歌词中换行约占 1/16，预留少量余量避免反复扩容
+    out.reserve(out.size() + n + n / 8 + 16);
+
+    size_t i = 0;
+    while (i < n) {
+        size_t run = find(p + i, n - i);
+        out.append(p + i, run);
+        i += run;
+        if (i >= n) break;
+
+        unsigned char c = (unsigned char)p[i++];
+        switch (c) {
+            case '"':  out.append("\\\"", 2); break;
+            case '\\': out.append("\\\\", 2); break;
+            case '\b': out.append("\\b", 2); break;
+            case '\f': out.append("\\f", 2); break;
+            case '\n': out.append("\\n", 2); break;
+            case '\r': out.append("\\r", 2); break;
+            case '\t': out.append("\\t", 2); break;
+            default: {
+                char buf[6] = { '\\', 'u', '0', '0', HEX[c >> 4], HEX[c & 0xF] };
+                out.append(buf, 6);
+                break;
+            }
+        }
+    }
+}
+
+} // namespace Netease::Json
@@ -0,0 +1,60 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+/**
+ * JsonString.h - JSON 字符串转义/反转义内核
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ *
+ * 歌词负载主要由长转义字符串组成（\n、\"、大量中日文 \uXXXX），
+ * 逐字节处理是缓存读写路径上的主要开销。本模块：
+ * - 每次扫描 16 (SSE2) / 32 (AVX2) 字节，定位引号、反斜杠和控制字符
+ * - 中间的"干净"片段整段拷贝
+ * - \uXXXX 支持 UTF-16 代理对 -> UTF-8 (孤立代理输出 U+FFFD)
+ * - 运行时根据 CPUID 选择内核，无 SIMD 时回退到标量实现
+ */
+
+namespace Netease::Json {
+
+    /**
+     * 扫描内核类型
+     */
+    enum class Kernel {
+        Auto,     // 自动选择当前 CPU 支持的最快内核
+        Scalar,   // 逐字节
+        SSE2,     // 16 字节/次
+        AVX2      // 32 字节/次
+    };
+
+    /**
+     * 强制使用指定内核（用于测试与基准）
+     *
+     * @return CPU 不支持该内核时返回 false，且不做修改
+     */
+    bool SetKernel(Kernel kernel);
+
+    /**
+     * 当前生效的内核
+     */
+    Kernel GetKernel();
+
+    /**
+     * 反转义 JSON 字符串内容
+     *
+     * @param in 开引号之后的原始文本（可包含结束引号之后的内容）
+     * @param out 解码结果追加到此字符串
+     * @param consumed 可选，输出已消费的字节数（含结束引号）
+     * @return 遇到未转义的结束引号时返回 true
+     */
+    bool UnescapeString(std::string_view in, std::string& out, size_t* consumed = nullptr);
+
+    /**
+     * 转义字符串并追加到 out（不含两侧引号）
+     *
+     * @note 引号、反斜杠、\b\f\n\r\t 使用短转义，其余控制字符输出 \u00XX
+     * @note 非 ASCII 字节原样输出（UTF-8 直通）
+     */
+    void AppendEscaped(std::string& out, std::string_view in);
+
+} // namespace Netease::Json
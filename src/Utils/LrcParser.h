@@ -0,0 +1,96 @@
+#pragma once
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * LrcParser.h - LRC 逐行扫描内核
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ *
+ * MergeLyrics、LrcTimeline 与 App 共用的唯一 LRC 解析器：
+ * - 只做 string_view 切片 + from_chars，不做任何逐行分配
+ * - 行首连续多个时间标签（[00:10.00][01:20.00]副歌）逐个回调，文本相同
+ * - [mm:ss] / [mm:ss.x] / [mm:ss.xx] / [mm:ss.xxx]，小数点也接受 ':'
+ * - [offset:+/-N] 单独回调，由调用方决定如何应用
+ * - 兼容 CRLF；[ar:] / [ti:] 等元数据标签忽略
+ */
+
+namespace Netease::Lrc {
+
+    /**
+     * 解析时间标签内容（不含方括号）
+     *
+     * @return 毫秒；不是时间标签（如 ar:xxx / offset:100）时返回 -1
+     */
+    int64_t ParseTimeTag(std::string_view body);
+
+    /**
+     * 解析 offset 标签内容（不含方括号），如 "offset:-250"
+     *
+     * @return 不是合法的 offset 标签时返回 false
+     */
+    bool ParseOffsetTag(std::string_view body, int64_t& offsetMs);
+
+    /**
+     * 行数（换行符个数 + 1，空串为 0），用于预留容量
+     *
+     * @note memchr 逐段跳转，比逐字节 std::count 快一个数量级
+     */
+    size_t CountLines(std::string_view text);
+
+    /**
+     * 逐行扫描 LRC
+     *
+     * @param onTag 每个时间标签调用一次：(int64_t ms, string_view tag, string_view text)
+     *        tag 含方括号、保持原文写法；text 为标签之后的整行剩余部分（未去空白）。
+     *        同一行的多个标签得到同一个 text（data() 相同，可据此共享存储）
+     * @param onOffset 遇到 [offset:] 时调用：(int64_t offsetMs)
+     */
+    template <typename OnTag, typename OnOffset>
+    void Scan(std::string_view lyric, OnTag&& onTag, OnOffset&& onOffset) {
+        size_t pos = 0;
+        while (pos < lyric.size()) {
+            size_t end = lyric.find('\n', pos);
+            if (end == std::string_view::npos) end = lyric.size();
+            std::string_view line = lyric.substr(pos, end - pos);
+            pos = end + 1;
+
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            size_t cursor = line.find_first_not_of(" \t");
+            if (cursor == std::string_view::npos || line[cursor] != '[') continue;
+
+            // 先收集行首标签，文本确定后再逐个回调（超出栈上缓冲的标签在回调时重新解析）
+            const size_t BUFFERED = 8;
+            int64_t times[BUFFERED];
+            size_t tagsBegin = cursor;
+            size_t tagCount = 0;
+            while (cursor < line.size() && line[cursor] == '[') {
+                size_t close = line.find(']', cursor);
+                if (close == std::string_view::npos) break;
+                std::string_view body = line.substr(cursor + 1, close - cursor - 1);
+                int64_t ms = ParseTimeTag(body);
+                if (ms < 0) {
+                    int64_t offsetMs = 0;
+                    if (tagCount == 0 && ParseOffsetTag(body, offsetMs)) onOffset(offsetMs);
+                    break;
+                }
+                if (tagCount < BUFFERED) times[tagCount] = ms;
+                tagCount++;
+                cursor = close + 1;
+            }
+            if (tagCount == 0) continue;
+
+            std::string_view text = line.substr(cursor);
+            size_t index = 0;
+            for (size_t at = tagsBegin; at < cursor; ++index) {
+                size_t close = line.find(']', at);
+                std::string_view tag = line.substr(at, close - at + 1);
+                int64_t ms = index < BUFFERED ? times[index] : ParseTimeTag(tag.substr(1, tag.size() - 2));
+                onTag(ms, tag, text);
+                at = close + 1;
+            }
+        }
+    }
+
+} // namespace Netease::Lrc
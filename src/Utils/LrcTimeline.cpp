@@ -0,0 +1,290 @@
+/**
+ * LrcTimeline.cpp - LRC 解析内核与紧凑时间轴实现
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ */
+
+#include "NeteaseAPI.h"
+#include "LrcParser.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+
+namespace Netease {
+
+// ============================================================================
+// 标签解析
+// ============================================================================
+
+namespace Lrc {
+
+int64_t ParseTimeTag(std::string_view body) {
+    const char* p = body.data();
+    const char* end = p + body.size();
+    auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+
+    // from_chars 接受前导 '-'，时间标签只允许数字开头
+    if (p == end || !isDigit(*p)) return -1;
+    int64_t minutes = 0;
+    auto [afterMinutes, ec1] = std::from_chars(p, (std::min)(end, p + 6), minutes);
+    if (ec1 != std::errc() || afterMinutes == end || *afterMinutes != ':') return -1;
+
+    p = afterMinutes + 1;
+    if (p == end || !isDigit(*p)) return -1;
+    int64_t seconds = 0;
+    auto [afterSeconds, ec2] = std::from_chars(p, (std::min)(end, p + 2), seconds);
+    if (ec2 != std::errc()) return -1;
+
+    p = afterSeconds;
+    int64_t millis = 0;
+    if (p != end && (*p == '.' || *p == ':')) {
+        ++p;
+        if (p == end || !isDigit(*p)) return -1;
+        // 超过三位的小数只取前三位（毫秒）
+        const char* fracEnd = p;
+        while (fracEnd != end && isDigit(*fracEnd)) ++fracEnd;
+        const char* used = (std::min)(fracEnd, p + 3);
+        std::from_chars(p, used, millis);
+        for (ptrdiff_t digits = used - p; digits < 3; ++digits) millis *= 10;
+        p = fracEnd;
+    }
+
+    return p == end ? (minutes * 60 + seconds) * 1000 + millis : -1;
+}
+
+bool ParseOffsetTag(std::string_view body, int64_t& offsetMs) {
+    if (body.size() < 7 || body.compare(0, 7, "offset:") != 0) return false;
+
+    std::string_view value = body.substr(7);
+    size_t first = value.find_first_not_of(" \t");
+    if (first == std::string_view::npos) return false;
+    value.remove_prefix(first);
+    value = value.substr(0, value.find_last_not_of(" \t") + 1);
+    if (!value.empty() && value.front() == '+') value.remove_prefix(1);
+
+    int64_t parsed = 0;
+    auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+    if (ec != std::errc() || ptr != value.data() + value.size()) return false;
+    offsetMs = parsed;
+    return true;
+}
+
+size_t CountLines(std::string_view text) {
+    if (text.empty()) return 0;
+    size_t lines = 1;
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while ((p = (const char*)std::memchr(p, '\n', end - p)) != nullptr) {
+        lines++;
+        p++;
+    }
+    return lines;
+}
+
+} // namespace Lrc
+
+namespace {
+
+// 顺序前进时最多逐行步进几次，超过则改用二分查找
+const int MAX_FORWARD_STEPS = 4;
+
+std::string_view Trim(std::string_view text) {
+    auto isBlank = [](char c) { return c == ' ' || c == '\t'; };
+    while (!text.empty() && isBlank(text.front())) text.remove_prefix(1);
+    while (!text.empty() && isBlank(text.back())) text.remove_suffix(1);
+    return text;
+}
+
+// 一个时间标签：时间 + span 下标（排序后拆成结构数组）
+struct TimedSpan {
+    int64_t ms;
+    int32_t span;
+};
+
+/**
+ * 扫描一条轨道：文本追加到 arena，标签追加到 out（按时间稳定排序）
+ *
+ * @param allowEmpty 原文保留空行；翻译 / 罗马音的空行视为"无"
+ * @return 该轨道的 [offset:] 值
+ */
+int64_t ScanTrack(std::string_view lyric, LrcTimeline& timeline, std::vector<TimedSpan>& out, bool allowEmpty) {
+    int64_t offsetMs = 0;
+    const char* lastText = nullptr;
+    int32_t lastSpan = -1;
+
+    Lrc::Scan(lyric,
+        [&](int64_t ms, std::string_view, std::string_view raw) {
+            // 同一行的多个标签共享一段文本
+            if (raw.data() != lastText) {
+                lastText = raw.data();
+                std::string_view text = Trim(raw);
+                if (text.empty() && !allowEmpty) {
+                    lastSpan = -1;
+                } else {
+                    LrcTimeline::Span span;
+                    span.offset = (uint32_t)timeline.arena.size();
+                    span.length = (uint32_t)text.size();
+                    timeline.arena.append(text);
+                    timeline.arena.push_back('\0');
+                    lastSpan = (int32_t)timeline.spans.size();
+                    timeline.spans.push_back(span);
+                }
+            }
+            if (lastSpan >= 0) out.push_back({ ms, lastSpan });
+        },
+        [&](int64_t value) { offsetMs = value; });
+
+    // [offset:] 可能出现在任意位置，扫描结束后统一应用
+    if (offsetMs != 0) {
+        for (auto& item : out) item.ms += offsetMs;
+    }
+    auto byTime = [](const TimedSpan& a, const TimedSpan& b) { return a.ms < b.ms; };
+    if (!std::is_sorted(out.begin(), out.end(), byTime)) {
+        std::stable_sort(out.begin(), out.end(), byTime);
+    }
+    return offsetMs;
+}
+
+/**
+ * 为每个原文时间找最近的副轨道行（双指针，副轨道已排序）
+ */
+void MatchTrack(const std::vector<int64_t>& times, const std::vector<TimedSpan>& track,
+                int toleranceMs, std::vector<int32_t>& out) {
+    out.assign(times.size(), -1);
+    if (track.empty()) return;
+
+    size_t j = 0;
+    for (size_t i = 0; i < times.size(); ++i) {
+        int64_t t = times[i];
+        while (j + 1 < track.size() && track[j + 1].ms <= t) ++j;
+
+        // 候选：<= t 的最后一项与其后一项
+        size_t best = j;
+        if (j + 1 < track.size() && std::llabs(track[j + 1].ms - t) < std::llabs(track[j].ms - t)) {
+            best = j + 1;
+        }
+        if (std::llabs(track[best].ms - t) <= toleranceMs) {
+            out[i] = track[best].span;
+        }
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// LrcTimeline
+// ============================================================================
+
+int LrcTimeline::FindLine(int64_t ms) const {
+    auto it = std::upper_bound(timesMs.begin(), timesMs.end(), ms);
+    return (int)(it - timesMs.begin()) - 1;
+}
+
+LrcTimeline API::ParseTimeline(std::string_view lrc, std::string_view tlyric, std::string_view romalrc, int toleranceMs) {
+    LrcTimeline timeline;
+    // 预留：文本总量不超过输入长度（每行多一个 '\0'），行数不超过换行数
+    size_t lrcLines = Lrc::CountLines(lrc);
+    size_t tlyricLines = Lrc::CountLines(tlyric);
+    size_t romaLines = Lrc::CountLines(romalrc);
+    timeline.arena.reserve(lrc.size() + tlyric.size() + romalrc.size() + lrcLines + tlyricLines + romaLines);
+    timeline.spans.reserve(lrcLines + tlyricLines + romaLines);
+
+    std::vector<TimedSpan> original;
+    original.reserve(lrcLines);
+    timeline.offsetMs = ScanTrack(lrc, timeline, original, true);
+
+    timeline.timesMs.reserve(original.size());
+    timeline.text.reserve(original.size());
+    for (const auto& item : original) {
+        timeline.timesMs.push_back(item.ms);
+        timeline.text.push_back(item.span);
+    }
+
+    std::vector<TimedSpan> track;
+    track.reserve(tlyricLines);
+    ScanTrack(tlyric, timeline, track, false);
+    MatchTrack(timeline.timesMs, track, toleranceMs, timeline.translation);
+
+    track.clear();
+    track.reserve(romaLines);
+    ScanTrack(romalrc, timeline, track, false);
+    MatchTrack(timeline.timesMs, track, toleranceMs, timeline.romaji);
+
+    return timeline;
+}
+
+// ============================================================================
+// LineCursor
+// ============================================================================
+
+void LineCursor::Bind(const std::vector<int64_t>& timesMs) {
+    if (m_Times == &timesMs && m_Size == timesMs.size()) return;
+    m_Times = &timesMs;
+    m_Size = timesMs.size();
+    Reset();
+}
+
+int LineCursor::Update(int64_t timeMs) {
+    m_LastWasSeek = false;
+    if (!m_Times || m_Size == 0) {
+        m_Current = -1;
+        m_LastMs = timeMs;
+        return m_Current;
+    }
+
+    const std::vector<int64_t>& times = *m_Times;
+    const int size = (int)m_Size;
+    bool seek = m_LastMs != INT64_MIN && (timeMs < m_LastMs || timeMs - m_LastMs > m_SeekThresholdMs);
+    m_LastMs = timeMs;
+
+    // 快速路径：仍在当前行的区间内
+    if (!seek && (m_Current + 1 >= size || timeMs < times[m_Current + 1])) {
+        return m_Current;
+    }
+
+    int line = m_Current;
+    bool search = seek;
+    if (!search) {
+        for (int steps = 0; line + 1 < size && times[line + 1] <= timeMs; ++steps) {
+            if (steps == MAX_FORWARD_STEPS) {
+                search = true;
+                break;
+            }
+            ++line;
+        }
+    }
+    if (search) {
+        auto it = std::upper_bound(times.begin(), times.begin() + size, timeMs);
+        line = (int)(it - times.begin()) - 1;
+    }
+    if (seek) {
+        m_Seeks++;
+        m_LastWasSeek = true;
+    }
+
+    if (line != m_Current) {
+        Event event;
+        event.previous = m_Current;
+        event.current = line;
+        event.timeMs = timeMs;
+        event.seek = seek;
+        m_Current = line;
+        event.nextBoundaryMs = NextBoundaryMs();
+        if (m_Callback) m_Callback(event);
+    }
+    return m_Current;
+}
+
+int64_t LineCursor::NextBoundaryMs() const {
+    if (!m_Times || m_Current + 1 >= (int)m_Size) return INT64_MAX;
+    return (*m_Times)[m_Current + 1];
+}
+
+void LineCursor::Reset() {
+    m_Current = -1;
+    m_LastMs = INT64_MIN;
+    m_LastWasSeek = false;
+}
+
+} // namespace Netease
@@ -0,0 +1,428 @@
+/**
+ * LyricCacheIndex.cpp - 歌词缓存目录内存索引实现
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ */
+
+#include "LyricCacheIndex.h"
+#include <Windows.h>
+#include <charconv>
+#include <cwctype>
+#include <memory>
+
+#define LOG_TAG "INDEX"
+#include "SimpleLog.h"
+
+namespace Netease {
+
+namespace {
+
+// 取最低位的目录序号（目录按优先级排列，序号越小优先级越高）
+inline int LowestBit(uint32_t mask) {
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int)index;
+}
+
+// 根目录通知中是否包含歌词目录相关的路径
+// (webdata\lyric、Download\Lyric、UWP 包 LocalState\Lyric、SDK cache\lyric)
+bool HasRelevantTopologyChange(const DWORD* buffer) {
+    static const wchar_t* const KEYWORDS[] = { L"lyric", L"webdata", L"download", L"localstate", L"1f8b0f94" };
+
+    auto* info = (const FILE_NOTIFY_INFORMATION*)buffer;
+    while (true) {
+        std::wstring name(info->FileName, info->FileNameLength / sizeof(WCHAR));
+        for (auto& c : name) c = (wchar_t)towlower(c);
+        for (const wchar_t* keyword : KEYWORDS) {
+            if (name.find(keyword) != std::wstring::npos) return true;
+        }
+
+        if (info->NextEntryOffset == 0) break;
+        info = (const FILE_NOTIFY_INFORMATION*)((const BYTE*)info + info->NextEntryOffset);
+    }
+    return false;
+}
+
+} // namespace
+
+// ============================================================================
+// 构造/析构
+// ============================================================================
+
+LyricCacheIndex::LyricCacheIndex(DirProvider provider, std::vector<std::string> watchRoots)
+    : m_Provider(std::move(provider))
+    , m_WatchRoots(std::move(watchRoots))
+{
+}
+
+LyricCacheIndex::~LyricCacheIndex() {
+    StopWatching();
+}
+
+// ============================================================================
+// 查询与维护
+// ============================================================================
+
+void LyricCacheIndex::EnsureBuilt() const {
+    if (m_Built.load(std::memory_order_acquire)) return;
+
+    // 多个查询同时触发首次构建时只扫描一次
+    auto* self = const_cast<LyricCacheIndex*>(this);
+    std::lock_guard<std::mutex> rebuildLock(self->m_RebuildMutex);
+    if (!m_Built.load(std::memory_order_acquire)) {
+        self->RebuildLocked();
+    }
+}
+
+std::optional<std::string> LyricCacheIndex::Find(long long songId) const {
+    EnsureBuilt();
+
+    std::shared_lock<std::shared_mutex> lock(m_Mutex);
+    auto it = m_Entries.find(songId);
+    if (it == m_Entries.end() || it->second == 0) {
+        return std::nullopt;
+    }
+    return m_Dirs[LowestBit(it->second)];
+}
+
+void LyricCacheIndex::Add(long long songId, const std::string& dir) {
+    EnsureBuilt();
+
+    {
+        std::unique_lock<std::shared_mutex> lock(m_Mutex);
+        int index = DirIndexLocked(dir);
+        if (index >= 0) {
+            m_Entries[songId] |= (1u << index);
+            return;
+        }
+    }
+
+    // 目录是新出现的（例如首次写入时刚创建），重建以确定其优先级
+    Rebuild();
+}
+
+void LyricCacheIndex::Remove(long long songId, const std::string& dir) {
+    EnsureBuilt();
+
+    std::unique_lock<std::shared_mutex> lock(m_Mutex);
+    auto it = m_Entries.find(songId);
+    if (it == m_Entries.end()) return;
+
+    if (dir.empty()) {
+        m_Entries.erase(it);
+        return;
+    }
+
+    int index = DirIndexLocked(dir);
+    if (index < 0) return;
+    it->second &= ~(1u << index);
+    if (it->second == 0) {
+        m_Entries.erase(it);
+    }
+}
+
+void LyricCacheIndex::RemoveAllIn(const std::string& dir) {
+    EnsureBuilt();
+
+    std::unique_lock<std::shared_mutex> lock(m_Mutex);
+    int index = DirIndexLocked(dir);
+    if (index < 0) return;
+
+    uint32_t clearMask = ~(1u << index);
+    for (auto it = m_Entries.begin(); it != m_Entries.end();) {
+        it->second &= clearMask;
+        if (it->second == 0) {
+            it = m_Entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void LyricCacheIndex::Rebuild() {
+    std::lock_guard<std::mutex> rebuildLock(m_RebuildMutex);
+    RebuildLocked();
+}
+
+void LyricCacheIndex::RebuildLocked() {
+    // 在 m_Mutex 外完成目录解析和扫描，避免长时间阻塞查询；
+    // 调用方持有 m_RebuildMutex，扫描与提交之间不会有其他重建插入
+    std::vector<std::string> dirs = m_Provider ? m_Provider() : std::vector<std::string>{};
+    if (dirs.size() > MAX_DIRS) {
+        LOG_WARN("缓存目录过多 (" << dirs.size() << ")，仅索引前 " << MAX_DIRS << " 个");
+        dirs.resize(MAX_DIRS);
+    }
+
+    std::unordered_map<long long, uint32_t> entries;
+    for (size_t i = 0; i < dirs.size(); ++i) {
+        ScanDir(dirs[i], 1u << i, entries);
+    }
+
+    {
+        std::unique_lock<std::shared_mutex> lock(m_Mutex);
+        m_Dirs = std::move(dirs);
+        m_Entries = std::move(entries);
+    }
+
+    m_Built.store(true, std::memory_order_release);
+    m_Generation.fetch_add(1);
+
+    // 唤醒监听线程，按新的目录集合重建句柄
+    if (m_Watching && m_WakeEvent) {
+        SetEvent((HANDLE)m_WakeEvent);
+    }
+    LOG_INFO("缓存索引已重建: " << Size() << " 首歌曲");
+}
+
+std::vector<std::string> LyricCacheIndex::GetDirs() const {
+    EnsureBuilt();
+    std::shared_lock<std::shared_mutex> lock(m_Mutex);
+    return m_Dirs;
+}
+
+size_t LyricCacheIndex::Size() const {
+    std::shared_lock<std::shared_mutex> lock(m_Mutex);
+    return m_Entries.size();
+}
+
+int LyricCacheIndex::DirIndexLocked(const std::string& dir) const {
+    for (size_t i = 0; i < m_Dirs.size(); ++i) {
+        if (_stricmp(m_Dirs[i].c_str(), dir.c_str()) == 0) return (int)i;
+    }
+    return -1;
+}
+
+void LyricCacheIndex::RescanDir(const std::string& dir) {
+    std::unordered_map<long long, uint32_t> scanned;
+    ScanDir(dir, 1u, scanned);
+
+    std::unique_lock<std::shared_mutex> lock(m_Mutex);
+    int index = DirIndexLocked(dir);
+    if (index < 0) return;
+
+    uint32_t bit = 1u << index;
+    for (auto it = m_Entries.begin(); it != m_Entries.end();) {
+        if (scanned.count(it->first)) {
+            it->second |= bit;
+        } else {
+            it->second &= ~bit;
+        }
+        if (it->second == 0) {
+            it = m_Entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (const auto& [songId, _] : scanned) {
+        m_Entries[songId] |= bit;
+    }
+}
+
+// ============================================================================
+// 目录扫描
+// ============================================================================
+
+std::optional<long long> LyricCacheIndex::ParseSongId(const char* name, size_t len) {
+    // 缓存文件名为纯数字 songId（跳过 .tmp 等临时文件）
+    if (len == 0 || len > 19) return std::nullopt;
+    long long value = 0;
+    auto [ptr, ec] = std::from_chars(name, name + len, value);
+    if (ec != std::errc() || ptr != name + len) return std::nullopt;
+    return value;
+}
+
+void LyricCacheIndex::ScanDir(const std::string& dir, uint32_t bit, std::unordered_map<long long, uint32_t>& entries) {
+    WIN32_FIND_DATAA fd;
+    std::string pattern = dir + "\\*";
+
+    // FindExInfoBasic 跳过 8.3 短文件名，LARGE_FETCH 减少大目录的内核往返
+    HANDLE hFind = FindFirstFileExA(pattern.c_str(), FindExInfoBasic, &fd,
+                                    FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+    if (hFind == INVALID_HANDLE_VALUE) return;
+
+    do {
+        if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) continue;
+        if (auto songId = ParseSongId(fd.cFileName, strlen(fd.cFileName))) {
+            entries[*songId] |= bit;
+        }
+    } while (FindNextFileA(hFind, &fd));
+
+    FindClose(hFind);
+}
+
+// ============================================================================
+// 变更监听 (ReadDirectoryChangesW)
+// ============================================================================
+
+bool LyricCacheIndex::StartWatching() {
+    if (m_Watching) return true;
+
+    m_WakeEvent = CreateEventA(NULL, FALSE, FALSE, NULL);
+    if (!m_WakeEvent) return false;
+
+    m_Watching = true;
+    m_WatchThread = std::thread(&LyricCacheIndex::WatchLoop, this);
+    return true;
+}
+
+void LyricCacheIndex::StopWatching() {
+    if (!m_Watching) return;
+
+    m_Watching = false;
+    SetEvent((HANDLE)m_WakeEvent);
+    if (m_WatchThread.joinable()) {
+        m_WatchThread.join();
+    }
+    CloseHandle((HANDLE)m_WakeEvent);
+    m_WakeEvent = nullptr;
+}
+
+void LyricCacheIndex::WatchLoop() {
+    struct Watch {
+        std::string path;
+        bool isCacheDir;            // true: 逐文件更新; false: 根目录拓扑变化
+        HANDLE hDir = INVALID_HANDLE_VALUE;
+        OVERLAPPED overlapped = {};
+        DWORD buffer[16 * 1024];    // 64KB, DWORD 对齐
+    };
+
+    const DWORD FILE_FILTER = FILE_NOTIFY_CHANGE_FILE_NAME;
+    const DWORD ROOT_FILTER = FILE_NOTIFY_CHANGE_DIR_NAME;
+
+    auto arm = [&](Watch& w) -> bool {
+        ResetEvent(w.overlapped.hEvent);
+        return ReadDirectoryChangesW(w.hDir, w.buffer, sizeof(w.buffer),
+                                     w.isCacheDir ? FALSE : TRUE,
+                                     w.isCacheDir ? FILE_FILTER : ROOT_FILTER,
+                                     NULL, &w.overlapped, NULL) != 0;
+    };
+
+    auto closeAll = [](std::vector<std::unique_ptr<Watch>>& watches) {
+        for (auto& w : watches) {
+            CancelIoEx(w->hDir, &w->overlapped);
+            DWORD ignored;
+            GetOverlappedResult(w->hDir, &w->overlapped, &ignored, TRUE);
+            CloseHandle(w->overlapped.hEvent);
+            CloseHandle(w->hDir);
+        }
+        watches.clear();
+    };
+
+    EnsureBuilt();
+
+    while (m_Watching) {
+        // 1. 为当前目录集合建立监听句柄
+        uint64_t generation = m_Generation.load();
+        std::vector<std::unique_ptr<Watch>> watches;
+
+        std::vector<std::pair<std::string, bool>> targets;
+        for (const auto& dir : GetDirs()) targets.emplace_back(dir, true);
+        for (const auto& root : m_WatchRoots) targets.emplace_back(root, false);
+
+        for (const auto& [path, isCacheDir] : targets) {
+            // WaitForMultipleObjects 上限 64（含停止事件）
+            if (watches.size() >= MAXIMUM_WAIT_OBJECTS - 1) break;
+
+            HANDLE hDir = CreateFileA(path.c_str(), FILE_LIST_DIRECTORY,
+                                      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                      NULL, OPEN_EXISTING,
+                                      FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+            if (hDir == INVALID_HANDLE_VALUE) continue;
+
+            auto w = std::make_unique<Watch>();
+            w->path = path;
+            w->isCacheDir = isCacheDir;
+            w->hDir = hDir;
+            w->overlapped.hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+            if (!w->overlapped.hEvent || !arm(*w)) {
+                if (w->overlapped.hEvent) CloseHandle(w->overlapped.hEvent);
+                CloseHandle(hDir);
+                continue;
+            }
+            watches.push_back(std::move(w));
+        }
+
+        // 2. 等待事件，直到目录集合变化或收到停止信号（均通过唤醒事件通知）
+        bool needRebuild = false;
+        while (m_Watching && !needRebuild && generation == m_Generation.load()) {
+            std::vector<HANDLE> handles;
+            handles.push_back((HANDLE)m_WakeEvent);
+            for (auto& w : watches) handles.push_back(w->overlapped.hEvent);
+
+            DWORD result = WaitForMultipleObjects((DWORD)handles.size(), handles.data(), FALSE, INFINITE);
+            if (result == WAIT_FAILED) break;
+            if (result == WAIT_OBJECT_0) continue;  // 重新检查停止标志与目录版本
+
+            size_t index = result - WAIT_OBJECT_0 - 1;
+            if (index >= watches.size()) continue;
+            Watch& w = *watches[index];
+
+            DWORD bytes = 0;
+            if (!GetOverlappedResult(w.hDir, &w.overlapped, &bytes, FALSE)) {
+                // 目录被删除等错误：整体重建
+                needRebuild = true;
+                break;
+            }
+
+            if (!w.isCacheDir) {
+                // 根目录下子目录变化：只有与歌词目录相关时才重新解析目录集合
+                // (CloudMusic / Packages 下有大量无关的缓存目录频繁增删)
+                if (bytes == 0 || HasRelevantTopologyChange(w.buffer)) {
+                    needRebuild = true;
+                    break;
+                }
+                if (!arm(w)) needRebuild = true;
+                continue;
+            }
+
+            if (bytes == 0) {
+                // 通知缓冲区溢出，事件已丢失：重扫该目录
+                RescanDir(w.path);
+            } else {
+                auto* info = (const FILE_NOTIFY_INFORMATION*)w.buffer;
+                while (true) {
+                    // 文件名是 songId 纯数字，直接从 UTF-16 截取 ASCII
+                    char name[32];
+                    size_t len = info->FileNameLength / sizeof(WCHAR);
+                    bool ascii = len < sizeof(name);
+                    for (size_t i = 0; ascii && i < len; ++i) {
+                        if (info->FileName[i] > 0x7F) ascii = false;
+                        else name[i] = (char)info->FileName[i];
+                    }
+
+                    if (ascii) {
+                        if (auto songId = ParseSongId(name, len)) {
+                            switch (info->Action) {
+                                case FILE_ACTION_ADDED:
+                                case FILE_ACTION_RENAMED_NEW_NAME:
+                                    Add(*songId, w.path);
+                                    break;
+                                case FILE_ACTION_REMOVED:
+                                case FILE_ACTION_RENAMED_OLD_NAME:
+                                    Remove(*songId, w.path);
+                                    break;
+                                default:
+                                    break;
+                            }
+                        }
+                    }
+
+                    if (info->NextEntryOffset == 0) break;
+                    info = (const FILE_NOTIFY_INFORMATION*)((const BYTE*)info + info->NextEntryOffset);
+                }
+            }
+
+            if (!arm(w)) {
+                needRebuild = true;
+            }
+        }
+
+        closeAll(watches);
+
+        if (needRebuild && m_Watching) {
+            Rebuild();
+        }
+    }
+}
+
+} // namespace Netease
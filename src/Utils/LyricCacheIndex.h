@@ -0,0 +1,134 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <optional>
+#include <functional>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * LyricCacheIndex.h - 歌词缓存目录内存索引
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ *
+ * 旧实现中每次 GetLocalLyric 都会：查询 AppData 路径 -> 枚举 Packages ->
+ * 对每个候选目录 exists/is_directory -> 逐目录探测文件。本模块将其替换为：
+ * - 目录集合只解析一次，由文件系统变更通知刷新
+ * - 内存中维护 songId -> 所在目录 (位掩码) 的哈希索引
+ * - 命中时返回目录路径；未命中只需一次哈希探测，零系统调用
+ *
+ * 变更通知 (Windows: ReadDirectoryChangesW)：
+ * - 缓存目录：逐文件增删，增量更新索引；缓冲区溢出时重扫该目录
+ * - 监听根目录：子目录增删（新安装的 UWP 包 / 首次创建的缓存目录）时重建
+ */
+
+namespace Netease {
+
+class LyricCacheIndex {
+public:
+    /**
+     * 目录提供者：返回按优先级排列、实际存在的缓存目录
+     */
+    using DirProvider = std::function<std::vector<std::string>()>;
+
+    /** 最多跟踪的目录数（位掩码宽度） */
+    static constexpr size_t MAX_DIRS = 32;
+
+    /**
+     * @param provider 目录提供者（重建时调用）
+     * @param watchRoots 需要监听子目录变化的根目录（可为空）
+     *
+     * @note 构造时不扫描，首次查询时惰性构建
+     */
+    explicit LyricCacheIndex(DirProvider provider, std::vector<std::string> watchRoots = {});
+    ~LyricCacheIndex();
+
+    LyricCacheIndex(const LyricCacheIndex&) = delete;
+    LyricCacheIndex& operator=(const LyricCacheIndex&) = delete;
+
+    /**
+     * 查找歌曲所在的最高优先级目录
+     *
+     * @return 目录路径；未命中返回 nullopt（不触发任何系统调用）
+     */
+    std::optional<std::string> Find(long long songId) const;
+
+    /**
+     * 记录写入（CacheLyric 成功后调用）
+     *
+     * @note 目录不在当前集合中时（例如刚被创建）触发一次重建
+     */
+    void Add(long long songId, const std::string& dir);
+
+    /**
+     * 记录删除
+     *
+     * @param dir 指定目录；为空时从所有目录中移除
+     */
+    void Remove(long long songId, const std::string& dir = "");
+
+    /**
+     * 移除某目录下的全部条目（ClearAllCache 后调用）
+     */
+    void RemoveAllIn(const std::string& dir);
+
+    /**
+     * 重新解析目录集合并全量扫描
+     *
+     * @note 多个线程同时重建（启动扫描与监听线程的重扫）时串行执行，
+     *       后开始的扫描总是最后提交，旧的扫描结果不会覆盖新的
+     */
+    void Rebuild();
+
+    /**
+     * 当前目录集合（按优先级）
+     */
+    std::vector<std::string> GetDirs() const;
+
+    /**
+     * 已索引的歌曲数量
+     */
+    size_t Size() const;
+
+    /**
+     * 启动后台变更监听线程
+     *
+     * @return 是否成功启动（非 Windows 平台返回 false）
+     */
+    bool StartWatching();
+
+    /**
+     * 停止后台监听线程
+     */
+    void StopWatching();
+
+private:
+    void EnsureBuilt() const;
+    void RebuildLocked();
+    int DirIndexLocked(const std::string& dir) const;
+    void RescanDir(const std::string& dir);
+    void WatchLoop();
+
+    static std::optional<long long> ParseSongId(const char* name, size_t len);
+    static void ScanDir(const std::string& dir, uint32_t bit, std::unordered_map<long long, uint32_t>& entries);
+
+    DirProvider m_Provider;
+    std::vector<std::string> m_WatchRoots;
+
+    mutable std::shared_mutex m_Mutex;
+    std::vector<std::string> m_Dirs;                    // 按优先级排列
+    std::unordered_map<long long, uint32_t> m_Entries;  // songId -> 所在目录位掩码
+    mutable std::atomic<bool> m_Built{false};
+    std::mutex m_RebuildMutex;                          // 串行化 Rebuild（扫描在 m_Mutex 之外进行）
+    std::atomic<uint64_t> m_Generation{0};              // 目录集合版本（监听线程据此重建句柄）
+
+    std::thread m_WatchThread;
+    std::atomic<bool> m_Watching{false};
+    void* m_WakeEvent = nullptr;                        // HANDLE，停止或目录集合变化时触发
+};
+
+} // namespace Netease
@@ -0,0 +1,339 @@
+/**
+ * LyricCodec.cpp - 缓存记录压缩编解码实现
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ */
+
+#include "LyricCodec.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Netease::LyricCodec {
+
+namespace {
+
+// ============================================================================
+// 格式常量
+// ============================================================================
+
+constexpr char MAGIC[4] = { '\0', 'N', 'L', 'Z' };
+constexpr size_t HEADER_SIZE = 9;       // 魔数 4 + 字典 1 + 原始长度 4
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t MAX_OFFSET = 65535;
+constexpr int HASH_BITS = 14;
+constexpr size_t MAX_EXPANSION = 255;   // 每个输入字节最多产生 255 字节输出（扩展长度字节）
+
+// ============================================================================
+// 内置 LRC 字典 (v1)
+//
+// 从网易云缓存语料中统计的高频片段：JSON 骨架、署名行、时间戳、中英日高频词。
+// 非 ASCII 内容以 UTF-8 字节转义书写，不依赖编译器源码字符集。
+// 注意：修改内容必须同时新增字典 ID，已写入磁盘的记录依赖字节级一致。
+// ============================================================================
+
+const char LRC_DICTIONARY_V1[] =
+    "{\"lyric\":\""
+    "\",\"translateLyric\":\""
+    "\",\"romalrc\":\""
+    "\"}"
+    "[ti:"
+    "[ar:"
+    "[al:"
+    "[by:"
+    "[offset:"
+    "[kana:"
+    "[00:00.000] \xe4\xbd\x9c\xe8\xaf\x8d : "                    // [00:00.000] 作词 :
+    "\\n[00:01.000] \xe4\xbd\x9c\xe6\x9b\xb2 : "                 // \n[00:01.000] 作曲 :
+    "\\n[00:02.000] \xe7\xbc\x96\xe6\x9b\xb2 : "                 // \n[00:02.000] 编曲 :
+    " \xe5\x88\xb6\xe4\xbd\x9c\xe4\xba\xba : "                   //  制作人 :
+    " \xe5\x92\x8c\xe5\xa3\xb0 : "                               //  和声 :
+    " \xe5\x90\x89\xe4\xbb\x96 : "                               //  吉他 :
+    " \xe8\xb4\x9d\xe6\x96\xaf : "                               //  贝斯 :
+    " \xe9\xbc\x93 : "                                           //  鼓 :
+    " \xe9\x94\xae\xe7\x9b\x98 : "                               //  键盘 :
+    " \xe5\xbc\xa6\xe4\xb9\x90 : "                               //  弦乐 :
+    " \xe6\xb7\xb7\xe9\x9f\xb3 : "                               //  混音 :
+    " \xe6\xaf\x8d\xe5\xb8\xa6 : "                               //  母带 :
+    " \xe5\xbd\x95\xe9\x9f\xb3 : "                               //  录音 :
+    " \xe5\x87\xba\xe5\x93\x81 : "                               //  出品 :
+    " \xe7\x9b\x91\xe5\x88\xb6 : "                               //  监制 :
+    " \xe5\x8f\x91\xe8\xa1\x8c : "                               //  发行 :
+    " \xe4\xbc\x81\xe5\x88\x92 : "                               //  企划 :
+    " \xe4\xbd\x9c\xe8\xa9\x9e : "                               //  作詞 :
+    " \xe7\xb7\xa8\xe6\x9b\xb2 : "                               //  編曲 :
+    " Lyricist : "
+    " Composer : "
+    " Arranger : "
+    " Producer : "
+    " OP : "
+    " SP : "
+    "\xe6\x9c\xaa\xe7\xbb\x8f\xe8\x91\x97\xe4\xbd\x9c\xe6\x9d\x83\xe4\xba\xba\xe8\xae\xb8\xe5\x8f\xaf\xef\xbc\x8c\xe4\xb8\x8d\xe5\xbe\x97\xe7\xbf\xbb\xe5\x94\xb1\xe3\x80\x81\xe7\xbf\xbb\xe5\xbd\x95\xe6\x88\x96\xe4\xbd\xbf\xe7\x94\xa8" // 未经著作权人许可，不得翻唱、翻录或使用
+    "\xe7\xba\xaf\xe9\x9f\xb3\xe4\xb9\x90\xef\xbc\x8c\xe8\xaf\xb7\xe6\xac\xa3\xe8\xb5\x8f" // 纯音乐，请欣赏
+    "\xe6\xad\xa4\xe6\xad\x8c\xe6\x9b\xb2\xe4\xb8\xba\xe6\xb2\xa1\xe6\x9c\x89\xe5\xa1\xab\xe8\xaf\x8d\xe7\x9a\x84\xe7\xba\xaf\xe9\x9f\xb3\xe4\xb9\x90\xef\xbc\x8c\xe8\xaf\xb7\xe6\x82\xa8\xe6\xac\xa3\xe8\xb5\x8f" // 此歌曲为没有填词的纯音乐，请您欣赏
+    " the "
+    " you "
+    " and "
+    " to "
+    " me "
+    " my "
+    " in "
+    " of "
+    " it "
+    " is "
+    " your "
+    "I'm "
+    "don't "
+    " love"
+    " know"
+    " never"
+    " baby"
+    " heart"
+    " night"
+    " feel"
+    "\xe6\x88\x91\xe4\xbb\xac"                                   // 我们
+    "\xe4\xbd\xa0\xe7\x9a\x84"                                   // 你的
+    "\xe6\x88\x91\xe7\x9a\x84"                                   // 我的
+    "\xe8\x87\xaa\xe5\xb7\xb1"                                   // 自己
+    "\xe6\xb2\xa1\xe6\x9c\x89"                                   // 没有
+    "\xe4\xb8\x80\xe4\xb8\xaa"                                   // 一个
+    "\xe6\x97\xb6\xe5\x80\x99"                                   // 时候
+    "\xe4\xb8\x96\xe7\x95\x8c"                                   // 世界
+    "\xe6\xb0\xb8\xe8\xbf\x9c"                                   // 永远
+    "\xe4\xbb\x80\xe4\xb9\x88"                                   // 什么
+    "\xe4\xb8\x8d\xe6\x98\xaf"                                   // 不是
+    "\xe5\xb0\xb1\xe6\x98\xaf"                                   // 就是
+    "\xe5\x9b\x9e\xe5\xbf\x86"                                   // 回忆
+    "\xe6\xb8\xa9\xe6\x9f\x94"                                   // 温柔
+    "\xe6\x80\x9d\xe5\xbf\xb5"                                   // 思念
+    "\xe7\xa6\xbb\xe5\xbc\x80"                                   // 离开
+    "\xe5\x96\x9c\xe6\xac\xa2"                                   // 喜欢
+    "\xe7\x88\xb1\xe4\xbd\xa0"                                   // 爱你
+    "\xe4\xb8\x8d\xe4\xbc\x9a"                                   // 不会
+    "\xe5\x8f\xaf\xe4\xbb\xa5"                                   // 可以
+    "\xe5\xb7\xb2\xe7\xbb\x8f"                                   // 已经
+    "\xe8\xbf\x98\xe6\x98\xaf"                                   // 还是
+    "\xe5\xa6\x82\xe6\x9e\x9c"                                   // 如果
+    "\xe8\xbf\x99\xe6\xa0\xb7"                                   // 这样
+    "\xe5\x90\x9b\xe3\x81\xae"                                   // 君の
+    "\xe5\x83\x95\xe3\x81\xaf"                                   // 僕は
+    "\xe7\xa7\x81\xe3\x81\xaf"                                   // 私は
+    "\xe3\x81\xaa\xe3\x81\x84"                                   // ない
+    "\xe3\x81\x8b\xe3\x82\x89"                                   // から
+    "\xe3\x81\xbe\xe3\x81\xa7"                                   // まで
+    "\xe3\x81\xa6\xe3\x82\x82"                                   // ても
+    "\xe3\x81\x84\xe3\x82\x8b"                                   // いる
+    "\xe3\x81\x97\xe3\x81\xa6"                                   // して
+    "\xe3\x81\x93\xe3\x81\xae"                                   // この
+    "\xe3\x81\x82\xe3\x81\xae"                                   // あの
+    "\xe5\xbf\x83\xe3\x82\x92"                                   // 心を
+    "\xe5\xa4\xa2\xe3\x82\x92"                                   // 夢を
+    "\\n[00:"
+    "\\n[01:"
+    "\\n[02:"
+    "\\n[03:"
+    "\\n[04:"
+    "\\n[05:"
+    "\n[00:"
+    "\n[01:"
+    "\n[02:"
+    "\n[03:"
+    "\n[04:"
+    "\n[05:"
+    ".000]"
+    ".00]"
+    "0]"
+    "\\n"
+    ;
+
+std::string_view DictionaryFor(Dictionary id) {
+    switch (id) {
+        case Dictionary::LrcV1: return std::string_view(LRC_DICTIONARY_V1, sizeof(LRC_DICTIONARY_V1) - 1);
+        default:                return std::string_view();
+    }
+}
+
+inline uint32_t Read32(const unsigned char* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t Hash4(uint32_t v) {
+    return (v * 2654435761u) >> (32 - HASH_BITS);
+}
+
+inline void WriteLength(std::string& out, size_t extra) {
+    while (extra >= 255) {
+        out += (char)255;
+        extra -= 255;
+    }
+    out += (char)extra;
+}
+
+inline bool ReadLength(const unsigned char*& ip, const unsigned char* end, size_t& length) {
+    unsigned char b;
+    do {
+        if (ip >= end) return false;
+        b = *ip++;
+        length += b;
+    } while (b == 255);
+    return true;
+}
+
+void EmitSequence(std::string& out, const unsigned char* literals, size_t literalLen,
+                  size_t offset, size_t matchLen) {
+    size_t matchCode = matchLen ? matchLen - MIN_MATCH : 0;
+    unsigned char token = (unsigned char)(((literalLen < 15 ? literalLen : 15) << 4)
+                                        | (matchCode < 15 ? matchCode : 15));
+    out += (char)token;
+    if (literalLen >= 15) WriteLength(out, literalLen - 15);
+    out.append((const char*)literals, literalLen);
+
+    if (matchLen == 0) return;  // 最后一个序列
+    out += (char)(offset & 0xFF);
+    out += (char)(offset >> 8);
+    if (matchCode >= 15) WriteLength(out, matchCode - 15);
+}
+
+} // namespace
+
+// ============================================================================
+// 公共接口
+// ============================================================================
+
+bool IsCompressed(std::string_view data) {
+    return data.size() >= HEADER_SIZE && memcmp(data.data(), MAGIC, sizeof(MAGIC)) == 0;
+}
+
+size_t RawSize(std::string_view packed) {
+    if (!IsCompressed(packed)) return 0;
+    uint32_t size;
+    memcpy(&size, packed.data() + 5, sizeof(size));
+    return size;
+}
+
+std::string Compress(std::string_view raw, Dictionary dictionary) {
+    std::string_view dict = DictionaryFor(dictionary);
+
+    // 字典作为虚拟前缀：拼接后统一搜索
+    std::string window;
+    window.reserve(dict.size() + raw.size());
+    window.append(dict);
+    window.append(raw);
+    const unsigned char* base = (const unsigned char*)window.data();
+    const size_t start = dict.size();
+    const size_t end = window.size();
+
+    std::string out;
+    out.reserve(HEADER_SIZE + raw.size() / 2 + 16);
+    out.append(MAGIC, sizeof(MAGIC));
+    out += (char)dictionary;
+    uint32_t rawSize = (uint32_t)raw.size();
+    out.append((const char*)&rawSize, sizeof(rawSize));
+
+    std::vector<int32_t> table((size_t)1 << HASH_BITS, -1);
+    for (size_t p = 0; p + MIN_MATCH <= start; ++p) {
+        table[Hash4(Read32(base + p))] = (int32_t)p;
+    }
+
+    size_t anchor = start;
+    size_t ip = start;
+    while (ip + MIN_MATCH <= end) {
+        uint32_t seq = Read32(base + ip);
+        uint32_t h = Hash4(seq);
+        int32_t candidate = table[h];
+        table[h] = (int32_t)ip;
+
+        if (candidate >= 0 && ip - (size_t)candidate <= MAX_OFFSET && Read32(base + candidate) == seq) {
+            size_t matchLen = MIN_MATCH;
+            while (ip + matchLen < end && base[candidate + matchLen] == base[ip + matchLen]) {
+                matchLen++;
+            }
+
+            EmitSequence(out, base + anchor, ip - anchor, ip - (size_t)candidate, matchLen);
+
+            // 匹配区间内的位置也登记进哈希表（歌词记录较小，换取更高压缩率）
+            for (size_t q = ip + 1; q < ip + matchLen && q + MIN_MATCH <= end; ++q) {
+                table[Hash4(Read32(base + q))] = (int32_t)q;
+            }
+            ip += matchLen;
+            anchor = ip;
+        } else {
+            // 连续未命中时加速跳过（不可压缩数据退化为接近 memcpy）
+            ip += 1 + ((ip - anchor) >> 6);
+        }
+    }
+
+    EmitSequence(out, base + anchor, end - anchor, 0, 0);
+    return out;
+}
+
+bool Decompress(std::string_view packed, std::string& out) {
+    if (!IsCompressed(packed)) return false;
+
+    Dictionary id = (Dictionary)(unsigned char)packed[4];
+    std::string_view dict = DictionaryFor(id);
+    if (id != Dictionary::None && dict.empty()) return false;
+
+    // 头部长度不可信：先按上限和输入长度能产生的最大输出校验，再分配
+    size_t rawSize = RawSize(packed);
+    if (rawSize > MAX_RAW_SIZE || rawSize > (packed.size() - HEADER_SIZE) * MAX_EXPANSION) return false;
+    out.resize(rawSize);
+
+    const unsigned char* ip = (const unsigned char*)packed.data() + HEADER_SIZE;
+    const unsigned char* const iend = (const unsigned char*)packed.data() + packed.size();
+    unsigned char* const obase = (unsigned char*)out.data();
+    unsigned char* op = obase;
+    unsigned char* const oend = obase + rawSize;
+
+    while (ip < iend) {
+        unsigned char token = *ip++;
+
+        // 字面量
+        size_t literalLen = token >> 4;
+        if (literalLen == 15 && !ReadLength(ip, iend, literalLen)) return false;
+        if (literalLen > (size_t)(iend - ip) || literalLen > (size_t)(oend - op)) return false;
+        memcpy(op, ip, literalLen);
+        ip += literalLen;
+        op += literalLen;
+
+        if (ip >= iend) break;  // 最后一个序列
+
+        // 匹配
+        if (iend - ip < 2) return false;
+        size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        size_t matchLen = token & 0x0F;
+        if (matchLen == 15 && !ReadLength(ip, iend, matchLen)) return false;
+        matchLen += MIN_MATCH;
+
+        size_t produced = (size_t)(op - obase);
+        if (offset == 0 || offset > produced + dict.size()) return false;
+        if (matchLen > (size_t)(oend - op)) return false;
+
+        if (offset > produced) {
+            // 起点落在字典中：先拷贝字典尾部，剩余部分从输出开头继续
+            size_t dictPos = dict.size() - (offset - produced);
+            size_t fromDict = dict.size() - dictPos;
+            if (fromDict > matchLen) fromDict = matchLen;
+            memcpy(op, dict.data() + dictPos, fromDict);
+            op += fromDict;
+            matchLen -= fromDict;
+        }
+
+        const unsigned char* match = op - offset;
+        if (offset >= matchLen) {
+            memcpy(op, match, matchLen);
+            op += matchLen;
+        } else {
+            // 重叠拷贝（游程），必须逐字节
+            for (size_t i = 0; i < matchLen; ++i) op[i] = match[i];
+            op += matchLen;
+        }
+    }
+
+    return op == oend;
+}
+
+} // namespace Netease::LyricCodec
@@ -0,0 +1,69 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+/**
+ * LyricCodec.h - 缓存记录压缩编解码
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ *
+ * 歌词 JSON 压缩率极高：时间戳、署名行、翻译/罗马音重复的时间轴、
+ * 连续的 CJK 片段都会大量重复。本模块提供 LZ4 类的字节对齐 LZ77：
+ * - 无熵编码，解码只有拷贝，速度远高于磁盘读取
+ * - 内置一份针对 LRC/网易云 JSON 的共享字典（署名行、时间戳、JSON 骨架、高频词），
+ *   作为虚拟前缀参与匹配，小记录也能获得可观的压缩率
+ * - 自描述头部：以 NUL 字节开头，不可能与 JSON / 纯文本 LRC 混淆，
+ *   读取方可据此透明识别
+ *
+ * 记录格式:
+ *   [0x00 'N' 'L' 'Z'] [字典 ID: 1B] [原始长度: u32 LE] [序列...]
+ *   序列 = token(高 4 位字面量长度, 低 4 位匹配长度-4) + 扩展长度 + 字面量
+ *          + 偏移 u16 LE + 扩展匹配长度；最后一个序列只有字面量
+ */
+
+namespace Netease::LyricCodec {
+
+    /**
+     * 原始长度上限：头部长度来自磁盘，解压前据此拒绝损坏或恶意的记录
+     */
+    constexpr size_t MAX_RAW_SIZE = 64u * 1024 * 1024;
+
+    /**
+     * 字典 ID
+     */
+    enum class Dictionary : unsigned char {
+        None = 0,
+        LrcV1 = 1       // 内置 LRC 字典
+    };
+
+    /**
+     * 是否为压缩记录（检查魔数）
+     */
+    bool IsCompressed(std::string_view data);
+
+    /**
+     * 压缩
+     *
+     * @param raw 原始数据
+     * @param dictionary 使用的共享字典
+     * @return 带头部的压缩记录
+     * @note raw 超过 MAX_RAW_SIZE 时生成的记录无法解压，调用方应直接存原文
+     */
+    std::string Compress(std::string_view raw, Dictionary dictionary = Dictionary::LrcV1);
+
+    /**
+     * 解压
+     *
+     * @param packed 压缩记录（含头部）
+     * @param out 解压结果（覆盖）
+     * @return 数据损坏、截断、字典未知或原始长度超出上限时返回 false
+     */
+    bool Decompress(std::string_view packed, std::string& out);
+
+    /**
+     * 读取头部中的原始长度，非压缩记录返回 0
+     */
+    size_t RawSize(std::string_view packed);
+
+} // namespace Netease::LyricCodec
@@ -0,0 +1,937 @@
+/**
+ * LyricPackStore.cpp - 追加式歌词包文件存储实现
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ */
+
+#include "LyricPackStore.h"
+#include <Windows.h>
+#include <filesystem>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#define LOG_TAG "PACK"
+#include "SimpleLog.h"
+
+namespace fs = std::filesystem;
+
+namespace Netease {
+
+namespace {
+
+// ============================================================================
+// 磁盘格式
+// ============================================================================
+
+constexpr uint32_t PACK_MAGIC = 0x4B504C4E;     // "NLPK"
+constexpr uint32_t RECORD_MAGIC = 0x43524C4E;   // "NLRC"
+constexpr uint32_t INDEX_MAGIC = 0x58494C4E;    // "NLIX"
+constexpr uint32_t FORMAT_VERSION = 1;
+
+constexpr uint16_t FLAG_TOMBSTONE = 1;
+constexpr uint32_t MAX_PAYLOAD = 64u * 1024 * 1024;
+constexpr uint64_t MIN_CAPACITY = 1024;
+
+struct PackHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t generation;
+};
+
+struct RecordHeader {
+    uint32_t magic;
+    uint16_t codec;
+    uint16_t flags;
+    int64_t songId;
+    uint32_t payloadLen;
+    uint32_t crc;           // 覆盖记录头（crc 置 0）+ payload
+};
+
+struct IndexHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t generation;
+    uint64_t capacity;      // 槽位数（2 的幂）
+    uint64_t count;         // 存活记录
+    uint64_t used;          // 存活 + 已删除槽位（决定扩容时机）
+    uint64_t committedTail; // 索引已覆盖的 pack 长度；0 表示索引不可信
+    uint64_t liveBytes;
+    uint64_t deadBytes;
+};
+
+enum SlotState : uint32_t {
+    SLOT_EMPTY = 0,
+    SLOT_LIVE = 1,
+    SLOT_DELETED = 2
+};
+
+struct Slot {
+    int64_t songId;
+    uint64_t offset;
+    uint32_t length;        // 整条记录长度（含记录头与对齐填充）
+    uint32_t state;
+};
+
+static_assert(sizeof(PackHeader) == 16, "PackHeader 布局变化");
+static_assert(sizeof(RecordHeader) == 24, "RecordHeader 布局变化");
+static_assert(sizeof(IndexHeader) == 64, "IndexHeader 布局变化");
+static_assert(sizeof(Slot) == 24, "Slot 布局变化");
+
+inline uint64_t Align8(uint64_t n) { return (n + 7) & ~uint64_t(7); }
+
+inline uint64_t NextPow2(uint64_t n) {
+    uint64_t p = MIN_CAPACITY;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+inline uint64_t HashSongId(int64_t songId) {
+    // splitmix64 终结器：songId 连续分布，需要打散
+    uint64_t x = (uint64_t)songId;
+    x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// ============================================================================
+// CRC32 (IEEE 802.3)
+// ============================================================================
+
+struct Crc32Table {
+    uint32_t entries[256];
+    constexpr Crc32Table() : entries() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            entries[i] = c;
+        }
+    }
+};
+
+constexpr Crc32Table CRC_TABLE;
+
+inline uint32_t Crc32Update(uint32_t crc, const void* data, size_t len) {
+    auto* p = (const unsigned char*)data;
+    crc = ~crc;
+    for (size_t i = 0; i < len; ++i) crc = CRC_TABLE.entries[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+inline uint32_t RecordCrc(RecordHeader header, const char* payload) {
+    header.crc = 0;
+    uint32_t crc = Crc32Update(0, &header, sizeof(header));
+    return Crc32Update(crc, payload, header.payloadLen);
+}
+
+/**
+ * 校验 offset 处的记录，成功时返回整条记录长度，失败返回 0
+ */
+uint64_t ValidateRecord(const char* base, uint64_t size, uint64_t offset, const RecordHeader** out) {
+    if (offset + sizeof(RecordHeader) > size) return 0;
+    auto* rh = (const RecordHeader*)(base + offset);
+    if (rh->magic != RECORD_MAGIC || rh->payloadLen > MAX_PAYLOAD) return 0;
+
+    uint64_t length = Align8(sizeof(RecordHeader) + rh->payloadLen);
+    if (offset + length > size) return 0;
+    if (RecordCrc(*rh, base + offset + sizeof(RecordHeader)) != rh->crc) return 0;
+
+    *out = rh;
+    return length;
+}
+
+bool WriteAll(HANDLE h, uint64_t offset, const void* data, size_t len) {
+    LARGE_INTEGER pos;
+    pos.QuadPart = (LONGLONG)offset;
+    if (!SetFilePointerEx(h, pos, NULL, FILE_BEGIN)) return false;
+
+    auto* p = (const char*)data;
+    while (len > 0) {
+        DWORD chunk = (DWORD)std::min<size_t>(len, 16 * 1024 * 1024);
+        DWORD written = 0;
+        if (!WriteFile(h, p, chunk, &written, NULL) || written == 0) return false;
+        p += written;
+        len -= written;
+    }
+    return true;
+}
+
+bool TruncateAt(HANDLE h, uint64_t size) {
+    LARGE_INTEGER pos;
+    pos.QuadPart = (LONGLONG)size;
+    return SetFilePointerEx(h, pos, NULL, FILE_BEGIN) && SetEndOfFile(h);
+}
+
+uint64_t FileSize(HANDLE h) {
+    LARGE_INTEGER size;
+    return GetFileSizeEx(h, &size) ? (uint64_t)size.QuadPart : 0;
+}
+
+HANDLE OpenDataFile(const std::string& path, DWORD disposition) {
+    // 单进程独占写入；允许删除以便清理被视图引用的旧代文件
+    return CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                       FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, disposition,
+                       FILE_ATTRIBUTE_NORMAL, NULL);
+}
+
+} // namespace
+
+// ============================================================================
+// 只读映射（零拷贝视图的生命周期载体）
+// ============================================================================
+
+struct LyricPackStore::Mapping {
+    HANDLE hMap = NULL;
+    const char* base = nullptr;
+    uint64_t size = 0;
+    uint64_t generation = 0;
+
+    static std::shared_ptr<Mapping> Create(HANDLE hFile, uint64_t generation) {
+        auto m = std::make_shared<Mapping>();
+        m->generation = generation;
+        m->size = FileSize(hFile);
+        if (m->size == 0) return m;
+
+        m->hMap = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (!m->hMap) return nullptr;
+        m->base = (const char*)MapViewOfFile(m->hMap, FILE_MAP_READ, 0, 0, 0);
+        if (!m->base) return nullptr;
+        return m;
+    }
+
+    ~Mapping() {
+        if (base) UnmapViewOfFile(base);
+        if (hMap) CloseHandle(hMap);
+    }
+};
+
+// ============================================================================
+// 单代存储：pack 文件 + 内存映射索引
+// ============================================================================
+
+struct LyricPackStore::Generation {
+    uint64_t gen = 0;
+    HANDLE hPack = INVALID_HANDLE_VALUE;
+    HANDLE hIndex = INVALID_HANDLE_VALUE;
+    HANDLE hIndexMap = NULL;
+    IndexHeader* header = nullptr;
+    Slot* slots = nullptr;
+    uint64_t tail = 0;          // 下一条记录的写入位置
+
+    ~Generation() {
+        UnmapIndex();
+        if (hIndex != INVALID_HANDLE_VALUE) CloseHandle(hIndex);
+        if (hPack != INVALID_HANDLE_VALUE) CloseHandle(hPack);
+    }
+
+    bool MapIndex(uint64_t capacity) {
+        uint64_t size = sizeof(IndexHeader) + capacity * sizeof(Slot);
+        hIndexMap = CreateFileMappingA(hIndex, NULL, PAGE_READWRITE,
+                                       (DWORD)(size >> 32), (DWORD)size, NULL);
+        if (!hIndexMap) return false;
+        header = (IndexHeader*)MapViewOfFile(hIndexMap, FILE_MAP_WRITE, 0, 0, (SIZE_T)size);
+        if (!header) return false;
+        slots = (Slot*)(header + 1);
+        return true;
+    }
+
+    void UnmapIndex() {
+        if (header) UnmapViewOfFile(header);
+        if (hIndexMap) CloseHandle(hIndexMap);
+        header = nullptr;
+        slots = nullptr;
+        hIndexMap = NULL;
+    }
+
+    void ResetIndex(uint64_t capacity) {
+        memset(slots, 0, capacity * sizeof(Slot));
+        header->magic = INDEX_MAGIC;
+        header->version = FORMAT_VERSION;
+        header->generation = gen;
+        header->capacity = capacity;
+        header->count = 0;
+        header->used = 0;
+        header->committedTail = 0;
+        header->liveBytes = 0;
+        header->deadBytes = 0;
+    }
+
+    Slot* Find(int64_t songId) const {
+        uint64_t mask = header->capacity - 1;
+        uint64_t i = HashSongId(songId) & mask;
+        for (uint64_t probe = 0; probe < header->capacity; ++probe, i = (i + 1) & mask) {
+            Slot& s = slots[i];
+            if (s.state == SLOT_EMPTY) return nullptr;
+            if (s.state == SLOT_LIVE && s.songId == songId) return &s;
+        }
+        return nullptr;
+    }
+
+    bool Rehash(uint64_t capacity) {
+        std::vector<Slot> live;
+        live.reserve((size_t)header->count);
+        for (uint64_t i = 0; i < header->capacity; ++i) {
+            if (slots[i].state == SLOT_LIVE) live.push_back(slots[i]);
+        }
+
+        // 重排期间索引不可信：崩溃后重新打开会从 pack 全量重建
+        IndexHeader saved = *header;
+        header->committedTail = 0;
+        FlushViewOfFile(header, sizeof(IndexHeader));
+
+        UnmapIndex();
+        if (!MapIndex(capacity)) return false;
+
+        ResetIndex(capacity);
+        header->liveBytes = saved.liveBytes;
+        header->deadBytes = saved.deadBytes;
+        for (const auto& s : live) Insert(s.songId, s.offset, s.length);
+        header->committedTail = saved.committedTail;
+        return true;
+    }
+
+    bool Insert(int64_t songId, uint64_t offset, uint32_t length) {
+        // 负载因子上限 0.7（已删除槽位计入）
+        if ((header->used + 1) * 10 > header->capacity * 7) {
+            if (!Rehash(header->capacity * 2)) return false;
+        }
+
+        uint64_t mask = header->capacity - 1;
+        uint64_t i = HashSongId(songId) & mask;
+        while (slots[i].state == SLOT_LIVE) i = (i + 1) & mask;
+
+        if (slots[i].state == SLOT_EMPTY) header->used++;
+        slots[i] = { songId, offset, length, SLOT_LIVE };
+        header->count++;
+        return true;
+    }
+
+    /**
+     * 将一条已写入 pack 的记录应用到索引
+     *
+     * pack 只追加：slot 指向的偏移不早于本记录，说明记录已反映在索引中
+     * （重放时 slot 已落盘而 committedTail 未推进），跳过
+     */
+    Slot* Apply(int64_t songId, uint64_t offset, uint64_t length, bool tombstone) {
+        Slot* s = Find(songId);
+        if (s && s->offset >= offset) return s;
+        if (s) {
+            header->liveBytes -= s->length;
+            header->deadBytes += s->length;
+            if (tombstone) {
+                s->state = SLOT_DELETED;
+                header->count--;
+                header->deadBytes += length;    // 墓碑本身也是死数据
+            } else {
+                s->offset = offset;
+                s->length = (uint32_t)length;
+                header->liveBytes += length;
+            }
+            return s;
+        }
+
+        if (tombstone) {
+            header->deadBytes += length;
+            return nullptr;
+        }
+        if (!Insert(songId, offset, (uint32_t)length)) return nullptr;
+        header->liveBytes += length;
+        return Find(songId);
+    }
+
+    /**
+     * 按存活 slot 重新统计 count / liveBytes / deadBytes（end 为 pack 有效长度）
+     */
+    void RecountBytes(uint64_t end) {
+        uint64_t count = 0, live = 0;
+        for (uint64_t i = 0; i < header->capacity; ++i) {
+            if (slots[i].state != SLOT_LIVE) continue;
+            count++;
+            live += slots[i].length;
+        }
+        header->count = count;
+        header->liveBytes = live;
+        header->deadBytes = end - sizeof(PackHeader) - live;
+    }
+
+    bool Write(const void* data, size_t len) {
+        if (!WriteAll(hPack, tail, data, len)) {
+            TruncateAt(hPack, tail);  // 丢弃部分写入
+            return false;
+        }
+        tail += len;
+        return true;
+    }
+
+    /**
+     * 发布 tail：slot 先落盘，再推进 committedTail
+     */
+    void Commit(const Slot* touched, bool sync) {
+        if (sync && touched) {
+            FlushViewOfFile(touched, sizeof(Slot));
+            FlushFileBuffers(hIndex);
+        }
+        header->committedTail = tail;
+        if (sync) FlushViewOfFile(header, sizeof(IndexHeader));
+    }
+
+    /**
+     * 从 from 开始重放 pack 记录，截断撕裂尾部
+     */
+    bool Replay(uint64_t from) {
+        uint64_t size = FileSize(hPack);
+        uint64_t offset = from;
+        {
+            auto map = Mapping::Create(hPack, gen);
+            if (!map) return false;
+            while (offset < size) {
+                const RecordHeader* rh = nullptr;
+                uint64_t length = ValidateRecord(map->base, size, offset, &rh);
+                if (length == 0) break;
+                Apply(rh->songId, offset, length, (rh->flags & FLAG_TOMBSTONE) != 0);
+                offset += length;
+            }
+        }
+
+        // committedTail 之后的记录可能部分已应用过（删除后被重放的旧记录会先复活再被墓碑删除），
+        // 增量计数不可信；pack 中除存活记录外都是死数据，按 slot 重新统计
+        if (offset > from) RecountBytes(offset);
+
+        // 映射释放后才能截断
+        if (offset < size) {
+            LOG_WARN("pack 尾部存在 " << (size - offset) << " 字节无效数据，已截断");
+            if (!TruncateAt(hPack, offset)) return false;
+        }
+        tail = offset;
+        header->committedTail = tail;
+        return true;
+    }
+};
+
+// ============================================================================
+// 打开/关闭
+// ============================================================================
+
+LyricPackStore::LyricPackStore() = default;
+
+LyricPackStore::~LyricPackStore() {
+    Close();
+}
+
+std::string LyricPackStore::PackPath(uint64_t gen) const {
+    return m_Root + "\\lyrics." + std::to_string(gen) + ".pack";
+}
+
+std::string LyricPackStore::IndexPath(uint64_t gen) const {
+    return m_Root + "\\lyrics." + std::to_string(gen) + ".idx";
+}
+
+bool LyricPackStore::Open(const std::string& root, const Options& options) {
+    Close();
+
+    std::error_code ec;
+    fs::create_directories(root, ec);
+    m_Root = root;
+    m_Options = options;
+
+    // 读取当前代号
+    uint64_t gen = 1;
+    bool hasCurrent = false;
+    {
+        std::string currentPath = m_Root + "\\CURRENT";
+        HANDLE h = CreateFileA(currentPath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (h != INVALID_HANDLE_VALUE) {
+            char buf[32] = {0};
+            DWORD read = 0;
+            if (ReadFile(h, buf, sizeof(buf) - 1, &read, NULL) && read > 0) {
+                uint64_t parsed = strtoull(buf, nullptr, 10);
+                if (parsed > 0) {
+                    gen = parsed;
+                    hasCurrent = true;
+                }
+            }
+            CloseHandle(h);
+        }
+    }
+
+    std::unique_ptr<Generation> g;
+    if (!OpenGeneration(gen, g)) {
+        LOG_ERROR("打开 pack 存储失败: " << m_Root);
+        return false;
+    }
+    if (!hasCurrent && !PublishGeneration(gen)) {
+        return false;
+    }
+
+    {
+        std::unique_lock<std::shared_mutex> lock(m_Mutex);
+        m_Gen = std::move(g);
+    }
+    RemoveStaleGenerations(gen);
+
+    if (m_Options.backgroundCompaction) {
+        m_Running = true;
+        m_CompactThread = std::thread(&LyricPackStore::CompactionLoop, this);
+    }
+
+    auto stats = GetStats();
+    LOG_INFO("pack 存储已打开: gen=" << stats.generation << ", " << stats.entries << " 条记录, "
+             << stats.packBytes << " 字节");
+    MaybeScheduleCompaction();
+    return true;
+}
+
+bool LyricPackStore::OpenGeneration(uint64_t gen, std::unique_ptr<Generation>& out) {
+    auto g = std::make_unique<Generation>();
+    g->gen = gen;
+
+    g->hPack = OpenDataFile(PackPath(gen), OPEN_ALWAYS);
+    if (g->hPack == INVALID_HANDLE_VALUE) return false;
+
+    // pack 头校验；损坏或为空时重新初始化
+    uint64_t packSize = FileSize(g->hPack);
+    PackHeader ph = {};
+    DWORD read = 0;
+    bool headerValid = packSize >= sizeof(PackHeader)
+        && ReadFile(g->hPack, &ph, sizeof(ph), &read, NULL) && read == sizeof(ph)
+        && ph.magic == PACK_MAGIC && ph.version == FORMAT_VERSION && ph.generation == gen;
+    if (!headerValid) {
+        if (packSize > 0) LOG_WARN("pack 头无效，重新初始化: " << PackPath(gen));
+        ph = { PACK_MAGIC, FORMAT_VERSION, gen };
+        if (!TruncateAt(g->hPack, 0) || !WriteAll(g->hPack, 0, &ph, sizeof(ph))) return false;
+        packSize = sizeof(PackHeader);
+    }
+
+    g->hIndex = OpenDataFile(IndexPath(gen), OPEN_ALWAYS);
+    if (g->hIndex == INVALID_HANDLE_VALUE) return false;
+
+    // 索引校验：头部、代号、容量与文件大小一致
+    uint64_t indexSize = FileSize(g->hIndex);
+    IndexHeader ih = {};
+    bool indexValid = indexSize >= sizeof(IndexHeader)
+        && ReadFile(g->hIndex, &ih, sizeof(ih), &read, NULL) && read == sizeof(ih)
+        && ih.magic == INDEX_MAGIC && ih.version == FORMAT_VERSION && ih.generation == gen
+        && ih.capacity >= MIN_CAPACITY && (ih.capacity & (ih.capacity - 1)) == 0
+        && indexSize >= sizeof(IndexHeader) + ih.capacity * sizeof(Slot)
+        && ih.used <= ih.capacity && ih.count <= ih.used
+        && ih.committedTail >= sizeof(PackHeader) && ih.committedTail <= packSize;
+
+    uint64_t capacity = indexValid ? ih.capacity : NextPow2(packSize / 1024);
+    if (!g->MapIndex(capacity)) return false;
+
+    uint64_t replayFrom = ih.committedTail;
+    if (!indexValid) {
+        if (indexSize > 0) LOG_WARN("索引不可信，从 pack 全量重建");
+        g->ResetIndex(capacity);
+        replayFrom = sizeof(PackHeader);
+    }
+
+    if (!g->Replay(replayFrom)) return false;
+    FlushViewOfFile(g->header, 0);
+
+    out = std::move(g);
+    return true;
+}
+
+bool LyricPackStore::CreateGeneration(uint64_t gen, uint64_t capacity, std::unique_ptr<Generation>& out) {
+    auto g = std::make_unique<Generation>();
+    g->gen = gen;
+
+    g->hPack = OpenDataFile(PackPath(gen), CREATE_ALWAYS);
+    if (g->hPack == INVALID_HANDLE_VALUE) return false;
+    PackHeader ph = { PACK_MAGIC, FORMAT_VERSION, gen };
+    if (!g->Write(&ph, sizeof(ph))) return false;
+
+    g->hIndex = OpenDataFile(IndexPath(gen), CREATE_ALWAYS);
+    if (g->hIndex == INVALID_HANDLE_VALUE) return false;
+    if (!g->MapIndex(capacity)) return false;
+    g->ResetIndex(capacity);
+    g->header->committedTail = g->tail;
+
+    out = std::move(g);
+    return true;
+}
+
+bool LyricPackStore::PublishGeneration(uint64_t gen) {
+    std::string currentPath = m_Root + "\\CURRENT";
+    std::string tmpPath = currentPath + ".tmp";
+    std::string content = std::to_string(gen);
+
+    HANDLE h = CreateFileA(tmpPath.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (h == INVALID_HANDLE_VALUE) return false;
+    DWORD written = 0;
+    bool ok = WriteFile(h, content.data(), (DWORD)content.size(), &written, NULL) && written == content.size();
+    FlushFileBuffers(h);
+    CloseHandle(h);
+
+    if (!ok || !MoveFileExA(tmpPath.c_str(), currentPath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        LOG_ERROR("发布 CURRENT 失败: gen=" << gen);
+        DeleteFileA(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+void LyricPackStore::RemoveStaleGenerations(uint64_t keep) {
+    std::string keepPack = "lyrics." + std::to_string(keep) + ".pack";
+    std::string keepIndex = "lyrics." + std::to_string(keep) + ".idx";
+
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(m_Root, ec)) {
+        std::string name = entry.path().filename().string();
+        bool isGenFile = name.rfind("lyrics.", 0) == 0
+            && (name.size() > 5 && (name.compare(name.size() - 5, 5, ".pack") == 0
+                                 || name.compare(name.size() - 4, 4, ".idx") == 0));
+        if (isGenFile && name != keepPack && name != keepIndex) {
+            // 仍被视图映射时删除会延迟到最后一个句柄关闭
+            DeleteFileA(entry.path().string().c_str());
+        }
+    }
+}
+
+void LyricPackStore::Close() {
+    if (m_Running) {
+        {
+            std::lock_guard<std::mutex> lock(m_SignalMutex);
+            m_Running = false;
+        }
+        m_SignalCv.notify_all();
+    }
+    if (m_CompactThread.joinable()) {
+        m_CompactThread.join();
+    }
+
+    std::unique_lock<std::shared_mutex> lock(m_Mutex);
+    if (m_Gen) {
+        FlushViewOfFile(m_Gen->header, 0);
+        FlushFileBuffers(m_Gen->hIndex);
+        m_Gen.reset();
+    }
+    std::lock_guard<std::mutex> mapLock(m_MapMutex);
+    m_ReadMap.reset();
+}
+
+bool LyricPackStore::IsOpen() const {
+    std::shared_lock<std::shared_mutex> lock(m_Mutex);
+    return m_Gen != nullptr;
+}
+
+// ============================================================================
+// 读写
+// ============================================================================
+
+std::shared_ptr<LyricPackStore::Mapping> LyricPackStore::MapForRead(uint64_t end) const {
+    // 调用方持有 m_Mutex（共享或独占），m_Gen 稳定
+    std::lock_guard<std::mutex> lock(m_MapMutex);
+    if (m_ReadMap && m_ReadMap->generation == m_Gen->gen && m_ReadMap->size >= end) {
+        return m_ReadMap;
+    }
+
+    // pack 已增长或已切换代：重新映射。旧映射由仍存活的视图继续持有
+    auto map = Mapping::Create(m_Gen->hPack, m_Gen->gen);
+    if (!map || map->size < end) return nullptr;
+    m_ReadMap = map;
+    return map;
+}
+
+namespace {
+
+/**
+ * 编码一条记录（记录头 + payload，补齐到 8 字节）
+ */
+void EncodeRecord(long long songId, std::string_view payload, LyricPackStore::Codec codec, bool tombstone, std::string& out) {
+    RecordHeader rh = {};
+    rh.magic = RECORD_MAGIC;
+    rh.codec = (uint16_t)codec;
+    rh.flags = tombstone ? FLAG_TOMBSTONE : 0;
+    rh.songId = songId;
+    rh.payloadLen = (uint32_t)payload.size();
+    rh.crc = RecordCrc(rh, payload.data());
+
+    uint64_t length = Align8(sizeof(RecordHeader) + payload.size());
+    size_t start = out.size();
+    out.append((const char*)&rh, sizeof(rh));
+    out.append(payload.data(), payload.size());
+    out.resize(start + (size_t)length, '\0');
+}
+
+} // namespace
+
+bool LyricPackStore::AppendLocked(Generation& g, long long songId, std::string_view payload, Codec codec, bool tombstone) {
+    if (payload.size() > MAX_PAYLOAD) return false;
+
+    std::string record;
+    record.reserve((size_t)Align8(sizeof(RecordHeader) + payload.size()));
+    EncodeRecord(songId, payload, codec, tombstone, record);
+
+    // 1. 记录落盘
+    uint64_t offset = g.tail;
+    if (!g.Write(record.data(), record.size())) {
+        LOG_ERROR("写入 pack 失败: " << GetLastError());
+        return false;
+    }
+    if (m_Options.syncWrites) FlushFileBuffers(g.hPack);
+
+    // 2. 发布到索引  3. 推进 committedTail
+    const Slot* touched = g.Apply(songId, offset, record.size(), tombstone);
+    g.Commit(touched, m_Options.syncWrites);
+    return true;
+}
+
+bool LyricPackStore::Put(long long songId, std::string_view payload, Codec codec) {
+    {
+        std::unique_lock<std::shared_mutex> lock(m_Mutex);
+        if (!m_Gen) return false;
+        if (!AppendLocked(*m_Gen, songId, payload, codec, false)) return false;
+    }
+    MaybeScheduleCompaction();
+    return true;
+}
+
+size_t LyricPackStore::PutBatch(const std::vector<BatchItem>& items) {
+    if (items.empty()) return 0;
+
+    size_t written = 0;
+    {
+        std::unique_lock<std::shared_mutex> lock(m_Mutex);
+        if (!m_Gen) return 0;
+        Generation& g = *m_Gen;
+
+        // 1. 全部记录一次写入并刷盘（提交顺序与单条写入相同，只是每一步合并）
+        std::string records;
+        std::vector<std::pair<uint64_t, uint64_t>> placed;     // offset, length
+        placed.reserve(items.size());
+        for (const auto& item : items) {
+            if (item.payload.size() > MAX_PAYLOAD) {
+                placed.emplace_back(0, 0);
+                continue;
+            }
+            size_t before = records.size();
+            EncodeRecord(item.songId, item.payload, item.codec, false, records);
+            placed.emplace_back(g.tail + before, records.size() - before);
+        }
+        if (!g.Write(records.data(), records.size())) {
+            LOG_ERROR("批量写入 pack 失败: " << GetLastError());
+            return 0;
+        }
+        if (m_Options.syncWrites) FlushFileBuffers(g.hPack);
+
+        // 2. 发布到索引（扩容可能移动槽位，最后整体刷新）
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (placed[i].second == 0) continue;
+            if (g.Apply(items[i].songId, placed[i].first, placed[i].second, false)) written++;
+        }
+        if (m_Options.syncWrites) {
+            FlushViewOfFile(g.slots, (SIZE_T)(g.header->capacity * sizeof(Slot)));
+            FlushFileBuffers(g.hIndex);
+        }
+
+        // 3. 推进 committedTail
+        g.Commit(nullptr, m_Options.syncWrites);
+    }
+    MaybeScheduleCompaction();
+    return written;
+}
+
+std::optional<LyricPackStore::View> LyricPackStore::Get(long long songId) const {
+    std::shared_lock<std::shared_mutex> lock(m_Mutex);
+    if (!m_Gen) return std::nullopt;
+
+    const Slot* s = m_Gen->Find(songId);
+    if (!s) return std::nullopt;
+
+    auto map = MapForRead(s->offset + s->length);
+    if (!map) return std::nullopt;
+
+    // 已在写入/重放时校验 CRC，这里只做廉价的结构检查
+    auto* rh = (const RecordHeader*)(map->base + s->offset);
+    if (rh->magic != RECORD_MAGIC || rh->songId != songId || (rh->flags & FLAG_TOMBSTONE)
+        || sizeof(RecordHeader) + rh->payloadLen > s->length) {
+        LOG_WARN("索引与 pack 不一致: ID=" << songId);
+        return std::nullopt;
+    }
+
+    View view;
+    view.keepAlive = map;
+    view.payload = std::string_view(map->base + s->offset + sizeof(RecordHeader), rh->payloadLen);
+    view.codec = (Codec)rh->codec;
+    return view;
+}
+
+bool LyricPackStore::Contains(long long songId) const {
+    std::shared_lock<std::shared_mutex> lock(m_Mutex);
+    return m_Gen && m_Gen->Find(songId) != nullptr;
+}
+
+bool LyricPackStore::Remove(long long songId) {
+    {
+        std::unique_lock<std::shared_mutex> lock(m_Mutex);
+        if (!m_Gen || !m_Gen->Find(songId)) return false;
+        if (!AppendLocked(*m_Gen, songId, {}, Codec::Raw, true)) return false;
+    }
+    MaybeScheduleCompaction();
+    return true;
+}
+
+int LyricPackStore::Clear() {
+    std::lock_guard<std::mutex> compactLock(m_CompactMutex);
+
+    std::unique_ptr<Generation> old;
+    int count = 0;
+    {
+        std::unique_lock<std::shared_mutex> lock(m_Mutex);
+        if (!m_Gen) return 0;
+        count = (int)m_Gen->header->count;
+
+        std::unique_ptr<Generation> next;
+        if (!CreateGeneration(m_Gen->gen + 1, MIN_CAPACITY, next)) return 0;
+        FlushFileBuffers(next->hPack);
+        if (!PublishGeneration(next->gen)) return 0;
+
+        old = std::move(m_Gen);
+        m_Gen = std::move(next);
+        std::lock_guard<std::mutex> mapLock(m_MapMutex);
+        m_ReadMap.reset();
+    }
+
+    uint64_t keep = old->gen + 1;
+    old.reset();
+    RemoveStaleGenerations(keep);
+    return count;
+}
+
+LyricPackStore::Stats LyricPackStore::GetStats() const {
+    std::shared_lock<std::shared_mutex> lock(m_Mutex);
+    Stats stats;
+    if (!m_Gen) return stats;
+    stats.generation = m_Gen->gen;
+    stats.entries = m_Gen->header->count;
+    stats.packBytes = m_Gen->tail;
+    stats.liveBytes = m_Gen->header->liveBytes;
+    stats.deadBytes = m_Gen->header->deadBytes;
+    return stats;
+}
+
+// ============================================================================
+// 压缩
+// ============================================================================
+
+void LyricPackStore::MaybeScheduleCompaction() {
+    if (!m_Running) return;
+
+    auto stats = GetStats();
+    uint64_t total = stats.liveBytes + stats.deadBytes;
+    if (stats.deadBytes < m_Options.compactMinDeadBytes) return;
+    if (total == 0 || (double)stats.deadBytes < m_Options.compactDeadRatio * (double)total) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_SignalMutex);
+        m_CompactRequested = true;
+    }
+    m_SignalCv.notify_one();
+}
+
+void LyricPackStore::CompactionLoop() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_SignalMutex);
+            m_SignalCv.wait(lock, [this] { return m_CompactRequested || !m_Running; });
+            if (!m_Running) return;
+            m_CompactRequested = false;
+        }
+        Compact();
+    }
+}
+
+bool LyricPackStore::Compact() {
+    std::lock_guard<std::mutex> compactLock(m_CompactMutex);
+
+    // 1. 快照存活记录（共享锁，不阻塞读取）
+    std::vector<Slot> live;
+    std::shared_ptr<Mapping> map;
+    uint64_t gen = 0;
+    uint64_t snapshotTail = 0;
+    {
+        std::shared_lock<std::shared_mutex> lock(m_Mutex);
+        if (!m_Gen) return false;
+        gen = m_Gen->gen;
+        snapshotTail = m_Gen->tail;
+        for (uint64_t i = 0; i < m_Gen->header->capacity; ++i) {
+            if (m_Gen->slots[i].state == SLOT_LIVE) live.push_back(m_Gen->slots[i]);
+        }
+        map = MapForRead(snapshotTail);
+        if (!map) return false;
+    }
+    std::sort(live.begin(), live.end(), [](const Slot& a, const Slot& b) { return a.offset < b.offset; });
+
+    // 2. 在锁外顺序拷贝到新一代
+    std::unique_ptr<Generation> next;
+    if (!CreateGeneration(gen + 1, NextPow2(live.size() * 2), next)) return false;
+
+    auto abandon = [&] {
+        next.reset();
+        DeleteFileA(PackPath(gen + 1).c_str());
+        DeleteFileA(IndexPath(gen + 1).c_str());
+        return false;
+    };
+
+    std::string batch;
+    const size_t BATCH_BYTES = 4 * 1024 * 1024;
+    uint64_t batchStart = next->tail;
+    for (const auto& s : live) {
+        next->Apply(s.songId, batchStart + batch.size(), s.length, false);
+        batch.append(map->base + s.offset, s.length);
+        if (batch.size() >= BATCH_BYTES) {
+            if (!next->Write(batch.data(), batch.size())) return abandon();
+            batch.clear();
+            batchStart = next->tail;
+        }
+    }
+    if (!batch.empty() && !next->Write(batch.data(), batch.size())) return abandon();
+
+    // 3. 独占锁：追平快照之后的写入，然后发布
+    std::unique_ptr<Generation> old;
+    {
+        std::unique_lock<std::shared_mutex> lock(m_Mutex);
+        if (!m_Gen || m_Gen->gen != gen) return abandon();
+
+        if (m_Gen->tail > snapshotTail) {
+            auto tailMap = MapForRead(m_Gen->tail);
+            if (!tailMap) return abandon();
+            for (uint64_t offset = snapshotTail; offset < m_Gen->tail;) {
+                const RecordHeader* rh = nullptr;
+                uint64_t length = ValidateRecord(tailMap->base, tailMap->size, offset, &rh);
+                if (length == 0) return abandon();
+                uint64_t newOffset = next->tail;
+                if (!next->Write(tailMap->base + offset, (size_t)length)) return abandon();
+                next->Apply(rh->songId, newOffset, length, (rh->flags & FLAG_TOMBSTONE) != 0);
+                offset += length;
+            }
+        }
+
+        FlushFileBuffers(next->hPack);
+        next->Commit(nullptr, false);
+        FlushViewOfFile(next->header, 0);
+        FlushFileBuffers(next->hIndex);
+        if (!PublishGeneration(gen + 1)) return abandon();
+
+        old = std::move(m_Gen);
+        m_Gen = std::move(next);
+        std::lock_guard<std::mutex> mapLock(m_MapMutex);
+        m_ReadMap.reset();
+    }
+
+    uint64_t before = snapshotTail;
+    uint64_t after = GetStats().packBytes;
+    old.reset();
+    map.reset();
+    RemoveStaleGenerations(gen + 1);
+
+    LOG_INFO("pack 压缩完成: gen=" << (gen + 1) << ", " << before << " -> " << after << " 字节");
+    return true;
+}
+
+} // namespace Netease
@@ -0,0 +1,190 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <memory>
+#include <shared_mutex>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * LyricPackStore.h - 追加式歌词包文件存储
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ *
+ * 逐文件缓存（一首歌一个 JSON 文件）在数万首歌曲时会带来大量 inode、
+ * ClearAllCache 的目录遍历、以及每次查询一次 open()。本模块提供替代后端：
+ *
+ * 目录布局 (<root>):
+ *   CURRENT           当前代号（文本），压缩完成后原子替换
+ *   lyrics.<gen>.pack 追加式记录文件（数据的唯一事实来源）
+ *   lyrics.<gen>.idx  内存映射的开放寻址哈希索引（可由 pack 重建）
+ *
+ * 提交顺序（崩溃安全）：
+ *   1. 追加记录并刷盘 (FlushFileBuffers)
+ *   2. 写入索引槽位并刷新映射页
+ *   3. 推进索引头中的 committedTail
+ * 任意一步中断后，重新打开时从 committedTail 重放 pack 尾部，
+ * 校验失败（撕裂写入）的尾部记录会被截断。
+ *
+ * 读取：返回指向只读映射的视图（零拷贝），视图持有映射引用，
+ * 在压缩/重映射后仍然有效。
+ *
+ * 压缩：死数据（覆盖/删除）超过阈值时由后台线程写入新一代 pack + idx，
+ * 再原子替换 CURRENT。
+ */
+
+namespace Netease {
+
+class LyricPackStore {
+public:
+    /**
+     * 记录编码（payload 格式）
+     */
+    enum class Codec : uint16_t {
+        Raw = 0,    // 网易云兼容 JSON 原文
+        Lz = 1      // LyricCodec 压缩记录（自描述头部）
+    };
+
+    /**
+     * 存储选项
+     */
+    struct Options {
+        bool syncWrites = true;                          // 每次提交刷盘（关闭后仅依赖页缓存）
+        bool backgroundCompaction = true;                // 是否启用后台压缩线程
+        uint64_t compactMinDeadBytes = 1024 * 1024;      // 死数据至少达到该字节数
+        double compactDeadRatio = 0.5;                   // 且占 pack 数据的比例超过该值
+    };
+
+    /**
+     * 零拷贝读取视图
+     *
+     * @note 持有映射引用：视图存活期间底层内存始终有效
+     */
+    struct View {
+        std::shared_ptr<const void> keepAlive;
+        std::string_view payload;
+        Codec codec = Codec::Raw;
+    };
+
+    /**
+     * 统计信息
+     */
+    struct Stats {
+        uint64_t generation = 0;
+        uint64_t entries = 0;       // 存活记录数
+        uint64_t packBytes = 0;     // pack 文件有效长度
+        uint64_t liveBytes = 0;     // 存活记录占用（含记录头）
+        uint64_t deadBytes = 0;     // 覆盖/删除产生的死数据
+    };
+
+    LyricPackStore();
+    ~LyricPackStore();
+
+    LyricPackStore(const LyricPackStore&) = delete;
+    LyricPackStore& operator=(const LyricPackStore&) = delete;
+
+    /**
+     * 打开（或创建）存储目录
+     *
+     * @note 自动完成崩溃恢复：重放未发布记录、截断撕裂尾部、必要时重建索引
+     */
+    bool Open(const std::string& root, const Options& options);
+    bool Open(const std::string& root) { return Open(root, Options()); }
+
+    /**
+     * 关闭存储（停止后台压缩，刷新索引）
+     */
+    void Close();
+
+    bool IsOpen() const;
+
+    /**
+     * 写入（覆盖）一条记录
+     */
+    bool Put(long long songId, std::string_view payload, Codec codec = Codec::Raw);
+
+    /**
+     * 批量写入项
+     */
+    struct BatchItem {
+        long long songId = 0;
+        std::string_view payload;
+        Codec codec = Codec::Raw;
+    };
+
+    /**
+     * 批量写入（批量导入）：所有记录一次追加、一次刷盘、一次提交
+     *
+     * @return 成功写入的条数
+     */
+    size_t PutBatch(const std::vector<BatchItem>& items);
+
+    /**
+     * 读取记录（零拷贝）
+     */
+    std::optional<View> Get(long long songId) const;
+
+    /**
+     * 是否存在记录（仅查询索引）
+     */
+    bool Contains(long long songId) const;
+
+    /**
+     * 删除记录（追加墓碑）
+     */
+    bool Remove(long long songId);
+
+    /**
+     * 清空所有记录（切换到新的空代）
+     *
+     * @return 清除前的记录数
+     */
+    int Clear();
+
+    /**
+     * 立即执行一次压缩（同步）
+     */
+    bool Compact();
+
+    Stats GetStats() const;
+
+private:
+    struct Mapping;
+    struct Generation;
+
+    bool OpenGeneration(uint64_t gen, std::unique_ptr<Generation>& out);
+    bool CreateGeneration(uint64_t gen, uint64_t capacity, std::unique_ptr<Generation>& out);
+    bool PublishGeneration(uint64_t gen);
+    void RemoveStaleGenerations(uint64_t keep);
+
+    std::shared_ptr<Mapping> MapForRead(uint64_t end) const;
+    bool AppendLocked(Generation& g, long long songId, std::string_view payload, Codec codec, bool tombstone);
+    void MaybeScheduleCompaction();
+    void CompactionLoop();
+
+    std::string PackPath(uint64_t gen) const;
+    std::string IndexPath(uint64_t gen) const;
+
+    std::string m_Root;
+    Options m_Options;
+
+    mutable std::shared_mutex m_Mutex;                   // 保护 m_Gen 及其索引
+    std::unique_ptr<Generation> m_Gen;
+
+    mutable std::mutex m_MapMutex;                       // 保护读映射
+    mutable std::shared_ptr<Mapping> m_ReadMap;
+
+    std::mutex m_CompactMutex;                           // 串行化压缩
+    std::mutex m_SignalMutex;
+    std::condition_variable m_SignalCv;
+    bool m_CompactRequested = false;
+    std::atomic<bool> m_Running{false};
+    std::thread m_CompactThread;
+};
+
+} // namespace Netease
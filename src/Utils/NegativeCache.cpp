@@ -0,0 +1,190 @@
+/**
+ * NegativeCache.cpp - 无歌词 / 请求失败结果缓存实现
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ */
+
+#include "NegativeCache.h"
+#include <Windows.h>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+
+#define LOG_TAG "NEGCACHE"
+#include "SimpleLog.h"
+
+namespace Netease {
+
+NegativeCache::NegativeCache(std::string persistPath, const Options& options, Clock clock)
+    : m_PersistPath(std::move(persistPath))
+    , m_Options(options)
+    , m_Clock(std::move(clock))
+{
+}
+
+int64_t NegativeCache::Now() const {
+    if (m_Clock) return m_Clock();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// ============================================================================
+// 查询
+// ============================================================================
+
+bool NegativeCache::ShouldSkip(long long songId) const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    EnsureLoadedLocked();
+
+    auto it = m_Entries.find(songId);
+    return it != m_Entries.end() && Now() < it->second.untilMs;
+}
+
+std::optional<NegativeCache::Entry> NegativeCache::Lookup(long long songId) const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    EnsureLoadedLocked();
+
+    auto it = m_Entries.find(songId);
+    if (it == m_Entries.end()) return std::nullopt;
+    return it->second;
+}
+
+size_t NegativeCache::Size() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    EnsureLoadedLocked();
+    return m_Entries.size();
+}
+
+// ============================================================================
+// 记录
+// ============================================================================
+
+void NegativeCache::RecordNoLyric(long long songId) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    EnsureLoadedLocked();
+
+    int64_t now = Now();
+    Entry& entry = m_Entries[songId];
+    entry.reason = Reason::NoLyric;
+    entry.untilMs = now + m_Options.noLyricTtlMs;
+    entry.failures = 0;
+
+    EvictLocked(now, songId);
+    PersistLocked();
+}
+
+void NegativeCache::RecordFailure(long long songId) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    EnsureLoadedLocked();
+
+    int64_t now = Now();
+    Entry& entry = m_Entries[songId];
+    entry.reason = Reason::Transient;
+    entry.failures++;
+
+    // base * 2^(n-1)，封顶 max（移位次数限制在 30 以内避免溢出）
+    uint32_t shift = std::min<uint32_t>(entry.failures - 1, 30);
+    int64_t backoff = std::min<int64_t>(m_Options.backoffBaseMs << shift, m_Options.backoffMaxMs);
+    entry.untilMs = now + backoff;
+
+    LOG_DEBUG("请求失败: ID=" << songId << ", 第 " << entry.failures << " 次, 退避 " << backoff << "ms");
+
+    EvictLocked(now, songId);
+    PersistLocked();
+}
+
+void NegativeCache::Forget(long long songId) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    EnsureLoadedLocked();
+
+    if (m_Entries.erase(songId) > 0) {
+        PersistLocked();
+    }
+}
+
+void NegativeCache::Clear() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Entries.clear();
+    m_Loaded = true;
+    if (!m_PersistPath.empty()) {
+        DeleteFileA(m_PersistPath.c_str());
+    }
+}
+
+void NegativeCache::SetOptions(const Options& options) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Options = options;
+}
+
+void NegativeCache::EvictLocked(int64_t now, long long keep) {
+    if (m_Entries.size() <= m_Options.maxEntries) return;
+
+    // 先丢弃已到期且超过退避上限的条目（其退避计数已无参考价值）
+    for (auto it = m_Entries.begin(); it != m_Entries.end();) {
+        if (it->second.untilMs + m_Options.backoffMaxMs < now) {
+            it = m_Entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (m_Entries.size() <= m_Options.maxEntries) return;
+
+    // 仍超出：淘汰最早到期的条目（刚写入的条目除外）
+    std::vector<std::pair<int64_t, long long>> order;
+    order.reserve(m_Entries.size());
+    for (const auto& [songId, entry] : m_Entries) {
+        if (songId != keep) order.emplace_back(entry.untilMs, songId);
+    }
+    size_t excess = (std::min)(m_Entries.size() - m_Options.maxEntries, order.size());
+    std::nth_element(order.begin(), order.begin() + excess, order.end());
+    for (size_t i = 0; i < excess; ++i) m_Entries.erase(order[i].second);
+}
+
+// ============================================================================
+// 磁盘 sidecar
+//   每行: <songId> <reason> <untilMs> <failures>
+// ============================================================================
+
+void NegativeCache::EnsureLoadedLocked() const {
+    if (m_Loaded) return;
+    m_Loaded = true;
+    if (m_PersistPath.empty()) return;
+
+    std::ifstream ifs(m_PersistPath);
+    if (!ifs) return;
+
+    std::string line;
+    while (std::getline(ifs, line)) {
+        std::istringstream iss(line);
+        long long songId = 0;
+        int reason = 0;
+        Entry entry;
+        if (!(iss >> songId >> reason >> entry.untilMs >> entry.failures)) continue;
+        if (reason != (int)Reason::NoLyric && reason != (int)Reason::Transient) continue;
+        entry.reason = (Reason)reason;
+        m_Entries[songId] = entry;
+    }
+    LOG_DEBUG("已加载 " << m_Entries.size() << " 条失败记录");
+}
+
+void NegativeCache::PersistLocked() {
+    if (m_PersistPath.empty()) return;
+
+    std::string tmpPath = m_PersistPath + ".tmp";
+    {
+        std::ofstream ofs(tmpPath, std::ios::trunc);
+        if (!ofs) return;
+        for (const auto& [songId, entry] : m_Entries) {
+            ofs << songId << ' ' << (int)entry.reason << ' ' << entry.untilMs << ' ' << entry.failures << '\n';
+        }
+    }
+
+    if (!MoveFileExA(tmpPath.c_str(), m_PersistPath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        LOG_WARN("写入失败记录 sidecar 失败: " << m_PersistPath);
+        DeleteFileA(tmpPath.c_str());
+    }
+}
+
+} // namespace Netease
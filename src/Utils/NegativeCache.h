@@ -0,0 +1,106 @@
+#pragma once
+#include <string>
+#include <optional>
+#include <functional>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+
+/**
+ * NegativeCache.h - 无歌词 / 请求失败结果缓存
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ *
+ * FetchLyricOnline 对 nolyric / uncollected 歌曲以及网络失败都返回 nullopt，
+ * 旧实现不记录结果：纯音乐每次重播、每次 GetLyric 都会重新发起请求（超时 8 秒）。
+ * 本模块记录失败结果，使重复未命中只需一次哈希查找：
+ * - 确认无歌词 (NoLyric)：长 TTL（默认 7 天）
+ * - 临时失败 (Transient)：按 songId 指数退避（30s, 60s, 120s ... 上限 1 小时）
+ * - 内存 + 磁盘（文本 sidecar，重启后仍有效）
+ * - 时钟可注入，便于测试
+ */
+
+namespace Netease {
+
+class NegativeCache {
+public:
+    enum class Reason : int {
+        NoLyric = 1,        // 服务端确认无歌词（纯音乐 / 未收录）
+        Transient = 2       // 网络错误、超时、非 200 响应
+    };
+
+    struct Options {
+        int64_t noLyricTtlMs = 7LL * 24 * 3600 * 1000;
+        int64_t backoffBaseMs = 30LL * 1000;
+        int64_t backoffMaxMs = 3600LL * 1000;
+        size_t maxEntries = 10000;                  // 超出时淘汰最早到期的条目
+    };
+
+    struct Entry {
+        Reason reason = Reason::Transient;
+        int64_t untilMs = 0;                        // 在此之前跳过网络请求
+        uint32_t failures = 0;                      // 连续临时失败次数（决定退避时长）
+    };
+
+    /**
+     * 时钟：返回 Unix 纪元毫秒（需跨进程重启保持单调，因此不用 steady_clock）
+     */
+    using Clock = std::function<int64_t()>;
+
+    /**
+     * @param persistPath 磁盘 sidecar 路径，为空时仅内存
+     * @param options TTL 与退避参数
+     * @param clock 时钟，为空时使用系统时间
+     */
+    NegativeCache(std::string persistPath, const Options& options, Clock clock = {});
+    explicit NegativeCache(std::string persistPath = "") : NegativeCache(std::move(persistPath), Options()) {}
+
+    /**
+     * 是否应跳过网络请求（存在未到期的失败记录）
+     */
+    bool ShouldSkip(long long songId) const;
+
+    /**
+     * 查询记录（包括已到期但仍保留退避计数的记录）
+     */
+    std::optional<Entry> Lookup(long long songId) const;
+
+    /**
+     * 记录"确认无歌词"
+     */
+    void RecordNoLyric(long long songId);
+
+    /**
+     * 记录临时失败（退避时长随连续失败次数翻倍）
+     */
+    void RecordFailure(long long songId);
+
+    /**
+     * 移除记录（获取成功或手动写入缓存后调用）
+     */
+    void Forget(long long songId);
+
+    /**
+     * 清空全部记录（含磁盘）
+     */
+    void Clear();
+
+    void SetOptions(const Options& options);
+    size_t Size() const;
+
+private:
+    int64_t Now() const;
+    void EnsureLoadedLocked() const;
+    void PersistLocked();
+    void EvictLocked(int64_t now, long long keep);
+
+    std::string m_PersistPath;
+    Options m_Options;
+    Clock m_Clock;
+
+    mutable std::mutex m_Mutex;
+    mutable bool m_Loaded = false;
+    mutable std::unordered_map<long long, Entry> m_Entries;
+};
+
+} // namespace Netease
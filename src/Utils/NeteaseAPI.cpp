@@ -5,8 +5,18 @@
  */
 
 #include "NeteaseAPI.h"
+#include "JsonString.h"
+#include "LyricCacheIndex.h"
+#include "LyricPackStore.h"
+#include "LyricCodec.h"
+#include "NegativeCache.h"
+#include "HttpClient.h"
+#include "RequestPolicy.h"
+#include "ValidatorStore.h"
+#include "CacheRefresher.h"
+#include "CacheBudget.h"
+#include "LrcParser.h"
 #include <Windows.h>
-#include <wininet.h>
 #include <shlwapi.h>
 #include <shlobj.h>
 #include <fstream>
@@ -16,17 +26,214 @@
 #include <map>
 #include <set>
 #include <iostream>
+#include <mutex>
+#include <deque>
+#include <unordered_map>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <algorithm>
 
 #define LOG_TAG "API"
 #include "SimpleLog.h"
 
-#pragma comment(lib, "wininet.lib")
 #pragma comment(lib, "shlwapi.lib")
 
 namespace fs = std::filesystem;
 
 namespace Netease {
 
+namespace {
+
+// 缓存配置与包文件存储（刻意不析构：避免 DLL 卸载时 join 压缩线程）
+struct CacheState {
+    std::mutex mutex;
+    CacheConfig config;
+    std::shared_ptr<LyricPackStore> pack;
+    bool packFailed = false;    // 打开失败后不再重试，直到配置变化
+};
+
+CacheState& GetCacheState() {
+    static CacheState* state = new CacheState();
+    return *state;
+}
+
+// API 基础地址（默认官方地址，测试时指向替身服务器）
+const char* const DEFAULT_API_BASE_URL = "https://music.163.com";
+
+struct EndpointState {
+    std::mutex mutex;
+    std::string baseUrl = DEFAULT_API_BASE_URL;
+    std::string sdkCacheDir;        // 非空时覆盖默认 SDK 缓存根目录
+};
+
+EndpointState& GetEndpointState() {
+    static EndpointState* state = new EndpointState();
+    return *state;
+}
+
+// 元数据进程内缓存：元数据几乎不变，预取与切歌共享同一份结果
+struct MetadataEntry {
+    SongMetadata meta;
+    std::string etag;               // 条件刷新用的验证器
+    std::string lastModified;
+};
+
+struct MetadataCache {
+    static constexpr size_t CAPACITY = 512;
+
+    std::mutex mutex;
+    std::unordered_map<long long, MetadataEntry> entries;
+    std::deque<long long> order;    // 插入顺序，超出容量时淘汰最早的
+};
+
+MetadataCache& GetMetadataCache() {
+    static MetadataCache* cache = new MetadataCache();
+    return *cache;
+}
+
+void StoreMetadata(long long songId, MetadataEntry entry) {
+    auto& cache = GetMetadataCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto [it, inserted] = cache.entries.insert_or_assign(songId, std::move(entry));
+    if (inserted) {
+        cache.order.push_back(songId);
+        if (cache.order.size() > MetadataCache::CAPACITY) {
+            cache.entries.erase(cache.order.front());
+            cache.order.pop_front();
+        }
+    }
+}
+
+// 后台刷新任务（刻意不析构，理由同上）；并发配置变化时在空闲时重建
+struct RefreshState {
+    std::mutex mutex;
+    CacheRefresher* refresher = nullptr;
+    int concurrency = 0;
+};
+
+RefreshState& GetRefreshState() {
+    static RefreshState* state = new RefreshState();
+    return *state;
+}
+
+/**
+ * 发送 API 请求（统一 Referer / Cookie；验证器非空时为条件请求）
+ */
+std::optional<Http::Response> ApiRequest(const std::string& url, const std::string& cookie,
+                                         const std::string& etag = "", const std::string& lastModified = "") {
+    Http::Options options;
+    options.timeoutMs = 8000; // 8 秒
+    
+    // 添加 Cookie
+    options.headers = "Referer: https://music.163.com/\r\n";
+    if (!cookie.empty()) {
+        options.headers += "Cookie: " + cookie + "\r\n";
+    }
+    options.ifNoneMatch = etag;
+    options.ifModifiedSince = lastModified;
+    
+    // v0.1.4: 对冲 / 重试 / 熔断
+    return Http::RequestPolicy::Default().Get(url, options);
+}
+
+NegativeCache::Options NegativeOptionsFrom(const CacheConfig& config) {
+    NegativeCache::Options options;
+    options.noLyricTtlMs = (int64_t)config.noLyricTtlSec * 1000;
+    options.backoffBaseMs = (int64_t)config.failureBackoffBaseSec * 1000;
+    options.backoffMaxMs = (int64_t)config.failureBackoffMaxSec * 1000;
+    return options;
+}
+
+CacheBudget::Options BudgetOptionsFrom(const CacheConfig& config) {
+    CacheBudget::Options options;
+    options.maxBytes = config.maxCacheBytes;
+    options.maxEntries = config.maxCacheEntries;
+    options.halfLifeMs = (int64_t)config.accessHalfLifeSec * 1000;
+    return options;
+}
+
+// TrimCache 同步淘汰的每批条数（后台淘汰使用 CacheBudget::Options::evictionBatch）
+const size_t EVICTION_BATCH = 64;
+
+struct EvictionState {
+    std::mutex batchMutex;      // 后台线程与 TrimCache 不会同时处理同一批
+};
+
+EvictionState& GetEvictionState() {
+    static EvictionState* state = new EvictionState();
+    return *state;
+}
+
+// MergeLyrics 两参数版本的匹配容差（[00:10.123] 与 [00:10.12] 视为同一行）
+const int MERGE_TOLERANCE_MS = 10;
+
+// MergeLyrics：一个时间标签对应的一行（多标签行展开为多条）
+struct TimedLine {
+    int64_t ms;
+    std::string_view tag;       // 含方括号的原始标签，输出时保留原始精度
+    std::string_view text;
+};
+
+/**
+ * 逐行解析 LRC，结果按时间排序（稳定：同一时刻保持原有顺序）
+ * 
+ * @note 结果引用 lyric 的内存，不做任何逐行分配
+ */
+void ParseTimedLines(std::string_view lyric, std::vector<TimedLine>& out) {
+    out.reserve(out.size() + Lrc::CountLines(lyric));
+    
+    Lrc::Scan(lyric,
+        [&out](int64_t ms, std::string_view tag, std::string_view text) { out.push_back({ ms, tag, text }); },
+        [](int64_t) {});
+    
+    auto byTime = [](const TimedLine& a, const TimedLine& b) { return a.ms < b.ms; };
+    if (!std::is_sorted(out.begin(), out.end(), byTime)) {
+        std::stable_sort(out.begin(), out.end(), byTime);
+    }
+}
+
+// 批量导入：文件名即歌曲 ID（纯数字；.tmp 等其他文件忽略）
+bool ParseSongIdFileName(const std::string& name, long long& songId) {
+    if (name.empty() || name.size() > 18) return false;
+    for (char c : name) {
+        if (c < '0' || c > '9') return false;
+    }
+    songId = std::stoll(name);
+    return songId > 0;
+}
+
+// 批量导入：原版歌词至少包含一个 [mm:ss 时间标签
+bool HasTimeTag(std::string_view lrc) {
+    for (size_t pos = lrc.find('['); pos != std::string_view::npos; pos = lrc.find('[', pos + 1)) {
+        size_t i = pos + 1;
+        while (i < lrc.size() && std::isdigit((unsigned char)lrc[i])) i++;
+        if (i > pos + 1 && i + 1 < lrc.size() && lrc[i] == ':' && std::isdigit((unsigned char)lrc[i + 1])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 批量导入：CRLF / CR 统一为 LF
+void NormalizeLineEndings(std::string& text) {
+    if (text.find('\r') == std::string::npos) return;
+    
+    std::string out;
+    out.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] != '\r') {
+            out += text[i];
+            continue;
+        }
+        out += '\n';
+        if (i + 1 < text.size() && text[i + 1] == '\n') i++;
+    }
+    text.swap(out);
+}
+
+} // namespace
+
 // ============================================================================
 // LyricData 成员实现
 // ============================================================================
@@ -51,26 +258,48 @@ std::optional<LyricData> API::GetLyric(long long songId, bool useCache, const st
         }
     }
     
-    // 2. 在线获取 (始终尝试更新缓存)
-    auto online = FetchLyricOnline(songId, cookie, true);
-    if (online) {
-        online->fromCache = false;
+    // 2. 近期确认无歌词或请求失败：跳过网络请求
+    if (useCache && NegativeResults().ShouldSkip(songId)) {
+        return std::nullopt;
     }
     
-    return online;
+    // 3. 在线获取 (始终尝试更新缓存)
+    // v0.1.4: 强制刷新时带验证器发送条件请求，304 返回本地缓存
+    RefreshStatus status;
+    return FetchLyric(songId, cookie, true, !useCache, status);
 }
 
 std::optional<SongMetadata> API::GetSongDetail(long long songId) {
+    // v0.1.4: 进程内缓存（预取线程写入后切歌时直接命中）
+    auto& cache = GetMetadataCache();
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        auto it = cache.entries.find(songId);
+        if (it != cache.entries.end()) {
+            return it->second.meta;
+        }
+    }
+    
     // 构造 URL
-    std::string url = "http://music.163.com/api/song/detail?id=" + std::to_string(songId) + 
+    std::string url = GetApiBaseUrl() + "/api/song/detail?id=" + std::to_string(songId) + 
                       "&ids=[" + std::to_string(songId) + "]";
     
     // 发送 HTTP 请求
-    std::string response = HttpGet(url);
-    if (response.empty()) {
+    auto reply = ApiRequest(url, "");
+    if (!reply || reply->body.empty()) {
         return std::nullopt;
     }
     
+    auto meta = ParseSongDetail(reply->body, songId);
+    if (!meta) {
+        return std::nullopt;
+    }
+    
+    StoreMetadata(songId, { *meta, reply->etag, reply->lastModified });
+    return meta;
+}
+
+std::optional<SongMetadata> API::ParseSongDetail(const std::string& response, long long songId) {
     // 解析 JSON 响应
     // 提取 songs 数组中的第一个元素
     SongMetadata meta;
@@ -127,43 +356,110 @@ std::optional<SongMetadata> API::GetSongDetail(long long songId) {
         }
     }
     
-    return meta.title.empty() ? std::nullopt : std::make_optional(meta);
+    if (meta.title.empty()) {
+        return std::nullopt;
+    }
+    return meta;
 }
 
 std::optional<LyricData> API::GetLocalLyric(long long songId) {
-    auto dirs = GetLyricCacheDirs();
-    std::string songIdStr = std::to_string(songId);
+    // v0.1.4: 包文件后端优先（零拷贝视图，SDK 自身写入的最新数据）
+    if (auto pack = PackStore()) {
+        if (auto view = pack->Get(songId)) {
+            if (auto data = ParseCacheContent(view->payload)) {
+                // v0.1.4: 访问热度（预算启用前写入的记录在首次命中时纳入跟踪）
+                if (!Budget().RecordAccess(songId)) {
+                    Budget().RecordWrite(songId, view->payload.size());
+                }
+                return data;
+            }
+        }
+    }
     
-    for (const auto& dir : dirs) {
-        std::string filePath = dir + "\\" + songIdStr;
-        if (PathFileExistsA(filePath.c_str())) {
-            return ParseCacheFile(filePath);
+    auto& index = CacheIndex();
+    std::string songIdStr = std::to_string(songId);
+    const std::string sdkLyricDir = GetSDKCacheDir() + "\\lyric";
+    
+    // 一次哈希探测定位最高优先级目录；未命中直接返回
+    while (auto dir = index.Find(songId)) {
+        std::string filePath = *dir + "\\" + songIdStr;
+        auto data = ParseCacheFile(filePath);
+        if (data || PathFileExistsA(filePath.c_str())) {
+            // v0.1.4: 只有 SDK 降级目录计入预算（网易云目录由客户端自己管理）
+            if (data && *dir == sdkLyricDir && !Budget().RecordAccess(songId)) {
+                std::error_code ec;
+                auto size = fs::file_size(filePath, ec);
+                if (!ec) Budget().RecordWrite(songId, size);
+            }
+            return data;
         }
+        
+        // 索引过期（文件已被外部删除且通知尚未到达）：修正后继续查找下一目录
+        index.Remove(songId, *dir);
     }
     
     return std::nullopt;
 }
 
 std::optional<LyricData> API::FetchLyricOnline(long long songId, const std::string& cookie, bool autoCache) {
+    RefreshStatus status;
+    return FetchLyric(songId, cookie, autoCache, false, status);
+}
+
+std::optional<LyricData> API::FetchLyric(long long songId, const std::string& cookie, bool autoCache,
+                                         bool conditional, RefreshStatus& status) {
     // 构造 URL
-    std::string url = "https://music.163.com/api/song/lyric?id=" + std::to_string(songId) + 
-                      "&lv=-1&kv=-1&tv=-1";
+    std::string url = GetApiBaseUrl() + "/api/song/lyric?id=" + std::to_string(songId) + 
+                      "&lv=-1&kv=-1&tv=-1&yv=-1";   // v0.1.4: yv 请求逐字歌词
+    
+    // v0.1.4: 本地缓存带有验证器时发送条件请求
+    std::optional<ValidatorStore::Entry> validators;
+    std::optional<LyricData> local;
+    if (conditional) {
+        validators = Validators().Lookup(songId);
+        if (validators && validators->CanRevalidate()) {
+            local = GetLocalLyric(songId);
+        }
+    }
     
     // 发送 HTTP 请求
-    std::string response = HttpGet(url, cookie);
-    if (response.empty()) {
+    auto& negative = NegativeResults();
+    status = RefreshStatus::Failed;
+    auto reply = local
+        ? ApiRequest(url, cookie, validators->etag, validators->lastModified)
+        : ApiRequest(url, cookie);
+    if (!reply) {
+        negative.RecordFailure(songId);
+        return std::nullopt;
+    }
+    
+    // 304：缓存仍有效，只更新确认时间；内容已由服务端确认，视为在线结果
+    if (reply->IsNotModified() && local) {
+        Validators().Touch(songId);
+        status = RefreshStatus::NotModified;
+        local->fromCache = false;
+        return local;
+    }
+    
+    const std::string& response = reply->body;
+    if (response.empty() || reply->status >= 300) {
+        negative.RecordFailure(songId);
         return std::nullopt;
     }
     
     // 检查响应状态
     std::string code = ExtractJsonValue(response, "code");
     if (!code.empty() && code != "200") {
+        negative.RecordFailure(songId);
         return std::nullopt;
     }
     
     // 检查是否无歌词
     if (ExtractJsonValue(response, "nolyric") == "true" || 
         ExtractJsonValue(response, "uncollected") == "true") {
+        negative.RecordNoLyric(songId);
+        Validators().Forget(songId);
+        status = RefreshStatus::NoLyric;
         return std::nullopt;
     }
     
@@ -198,23 +494,130 @@ std::optional<LyricData> API::FetchLyricOnline(long long songId, const std::stri
         }
     }
     
+    // v0.1.4: 提取 yrc.lyric（逐字歌词，如果存在）
+    size_t yrcPos = response.find("\"yrc\"");
+    if (yrcPos != std::string::npos) {
+        size_t lyricStart = response.find("\"lyric\"", yrcPos);
+        if (lyricStart != std::string::npos) {
+            data.yrc = ExtractJsonValue(response.substr(yrcPos), "lyric");
+        }
+    }
+    
     // 如果没有歌词，返回 nullopt
     if (data.lrc.empty()) {
+        negative.RecordNoLyric(songId);
+        Validators().Forget(songId);
+        status = RefreshStatus::NoLyric;
         return std::nullopt;
     }
+    negative.Forget(songId);
     
-    // 自动缓存
-    if (autoCache) {
-        CacheLyric(songId, data);
+    // 自动缓存（缓存内容与本次响应一致，记录其验证器）
+    if (autoCache && CacheLyric(songId, data)) {
+        Validators().Record(songId, reply->etag, reply->lastModified);
     }
     
+    status = RefreshStatus::Updated;
     return data;
 }
 
+RefreshStatus API::RefreshLyric(long long songId, const std::string& cookie) {
+    RefreshStatus status;
+    FetchLyric(songId, cookie, true, true, status);
+    return status;
+}
+
+RefreshStatus API::RefreshSongDetail(long long songId) {
+    std::optional<MetadataEntry> cached;
+    {
+        auto& cache = GetMetadataCache();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        auto it = cache.entries.find(songId);
+        if (it != cache.entries.end()) {
+            cached = it->second;
+        }
+    }
+    
+    std::string url = GetApiBaseUrl() + "/api/song/detail?id=" + std::to_string(songId) + 
+                      "&ids=[" + std::to_string(songId) + "]";
+    auto reply = cached
+        ? ApiRequest(url, "", cached->etag, cached->lastModified)
+        : ApiRequest(url, "");
+    if (!reply) {
+        return RefreshStatus::Failed;
+    }
+    if (reply->IsNotModified() && cached) {
+        return RefreshStatus::NotModified;
+    }
+    if (reply->body.empty() || reply->status >= 300) {
+        return RefreshStatus::Failed;
+    }
+    
+    auto meta = ParseSongDetail(reply->body, songId);
+    if (!meta) {
+        return RefreshStatus::Failed;
+    }
+    StoreMetadata(songId, { *meta, reply->etag, reply->lastModified });
+    return RefreshStatus::Updated;
+}
+
+std::vector<long long> API::GetStaleLyrics(size_t maxCount) {
+    int64_t maxAgeMs = (int64_t)GetCacheConfig().revalidateAfterSec * 1000;
+    return Validators().CollectStale(maxAgeMs, maxCount);
+}
+
+bool API::RefreshStaleLyricsAsync(size_t maxCount) {
+    std::vector<long long> stale = GetStaleLyrics(maxCount);
+    if (stale.empty()) {
+        return false;
+    }
+    
+    int concurrency = GetCacheConfig().refreshConcurrency;
+    auto& state = GetRefreshState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (state.refresher && state.refresher->IsRunning()) {
+        return false;
+    }
+    if (!state.refresher || state.concurrency != concurrency) {
+        delete state.refresher;     // 空闲时重建（析构只 join 已结束的线程）
+        CacheRefresher::Options options;
+        options.concurrency = concurrency;
+        state.refresher = new CacheRefresher(options);
+        state.concurrency = concurrency;
+    }
+    
+    // 一轮结束后把合并的 304 确认时间落盘
+    return state.refresher->Start(stale, [](const CacheRefresher::Stats&) {
+        Validators().Flush();
+    });
+}
+
 bool API::CacheLyric(long long songId, const LyricData& data) {
+    // 已有歌词：之前的失败记录失效
+    NegativeResults().Forget(songId);
+    
+    // 内容不再对应服务端的验证器（在线获取时由调用方重新记录）
+    Validators().Forget(songId);
+    
     std::string songIdStr = std::to_string(songId);
     std::string jsonContent = SerializeLyricToJson(data);
     
+    // v0.1.4: SDK 自有存储写入压缩记录（读取端按魔数透明识别）
+    bool compress = GetCacheConfig().compressRecords;
+    
+    // v0.1.4: 包文件后端：单次追加，不再逐首创建文件
+    if (auto pack = PackStore()) {
+        std::string payload = compress ? LyricCodec::Compress(jsonContent) : jsonContent;
+        bool stored = pack->Put(songId, payload, compress ? LyricPackStore::Codec::Lz : LyricPackStore::Codec::Raw);
+        if (stored) {
+            // v0.1.4: 容量预算（超出时后台淘汰最冷的条目）
+            Budget().RecordWrite(songId, payload.size());
+            ScheduleEviction();
+            return true;
+        }
+        // 写入失败时回落到逐文件布局
+    }
+    
     // 尝试写入网易云标准路径
     char localAppData[MAX_PATH];
     if (SHGetFolderPathA(NULL, CSIDL_LOCAL_APPDATA, NULL, 0, localAppData) == S_OK) {
@@ -235,6 +638,7 @@ bool API::CacheLyric(long long songId, const LyricData& data) {
                 
                 // 原子替换
                 if (MoveFileExA(tmpPath.c_str(), filePath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+                    CacheIndex().Add(songId, neteaseDir);
                     return true;
                 }
             }
@@ -253,10 +657,14 @@ bool API::CacheLyric(long long songId, const LyricData& data) {
         
         std::ofstream ofs(tmpPath, std::ios::binary);
         if (ofs) {
-            ofs << jsonContent;
+            std::string payload = compress ? LyricCodec::Compress(jsonContent) : jsonContent;
+            ofs << payload;
             ofs.close();
             
             if (MoveFileExA(tmpPath.c_str(), filePath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+                CacheIndex().Add(songId, sdkCacheDir);
+                Budget().RecordWrite(songId, payload.size());
+                ScheduleEviction();
                 return true;
             }
         }
@@ -271,13 +679,21 @@ bool API::ClearLyricCache(long long songId) {
     std::string songIdStr = std::to_string(songId);
     bool deleted = false;
     
-    auto dirs = GetLyricCacheDirs();
-    for (const auto& dir : dirs) {
+    auto& index = CacheIndex();
+    for (const auto& dir : index.GetDirs()) {
         std::string filePath = dir + "\\" + songIdStr;
         if (DeleteFileA(filePath.c_str())) {
             deleted = true;
         }
     }
+    index.Remove(songId);
+    NegativeResults().Forget(songId);
+    Validators().Forget(songId);
+    Budget().Forget(songId);
+    
+    if (auto pack = PackStore()) {
+        deleted = pack->Remove(songId) || deleted;
+    }
     
     return deleted;
 }
@@ -299,112 +715,335 @@ int API::ClearAllCache() {
         // 忽略错误
     }
     
+    CacheIndex().RemoveAllIn(sdkCacheDir);
+    NegativeResults().Clear();
+    Validators().Clear();
+    Budget().Clear();
+    
+    {
+        auto& metadata = GetMetadataCache();
+        std::lock_guard<std::mutex> lock(metadata.mutex);
+        metadata.entries.clear();
+        metadata.order.clear();
+    }
+    
+    if (auto pack = PackStore()) {
+        count += pack->Clear();
+    }
     return count;
 }
 
-std::string API::MergeLyrics(const std::string& lrc, const std::string& tlyric) {
-    if (lrc.empty()) return tlyric;
-    if (tlyric.empty()) return lrc;
+ImportReport API::ImportLyricCache(const ImportOptions& options) {
+    ImportReport report;
+    auto start = std::chrono::steady_clock::now();
+    
+    std::string sdkLyricDir = GetSDKCacheDir() + "\\lyric";
+    std::vector<std::string> sourceDirs = options.sourceDirs;
+    if (sourceDirs.empty()) {
+        for (const auto& dir : GetLyricCacheDirs()) {
+            if (dir != sdkLyricDir) sourceDirs.push_back(dir);
+        }
+    }
     
-    // 解析时间戳和文本的映射
-    auto parseLyric = [](const std::string& lyric) -> std::map<std::string, std::string> {
-        std::map<std::string, std::string> result;
-        std::istringstream iss(lyric);
-        std::string line;
-        
-        std::regex timePattern("\\[(\\d{2}:\\d{2}\\.\\d{2})\\]");
-        
-        while (std::getline(iss, line)) {
-            std::smatch match;
-            if (std::regex_search(line, match, timePattern)) {
-                std::string timestamp = match[1].str();
-                size_t textStart = line.find(']') + 1;
-                std::string text = (textStart < line.length()) ? line.substr(textStart) : "";
-                result[timestamp] = text;
+    // 1. 扫描：同一首歌以靠前的目录为准
+    struct Candidate {
+        long long songId;
+        std::string path;
+    };
+    std::vector<Candidate> candidates;
+    std::set<long long> seen;
+    for (const auto& dir : sourceDirs) {
+        std::error_code ec;
+        for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+            long long songId = 0;
+            if (!it->is_regular_file(ec) || !ParseSongIdFileName(it->path().filename().string(), songId)) {
+                continue;
+            }
+            report.filesScanned++;
+            if (!seen.insert(songId).second) {
+                report.skipped++;
+                continue;
             }
+            candidates.push_back({ songId, it->path().string() });
         }
-        
-        return result;
-    };
+    }
     
-    auto lrcMap = parseLyric(lrc);
-    auto tlyricMap = parseLyric(tlyric);
+    // 2. 并行读取 / 解析 / 校验 / 规范化（Files 后端同时直接写入）
+    auto pack = PackStore();
+    bool compress = GetCacheConfig().compressRecords;
+    if (!pack) {
+        std::error_code ec;
+        fs::create_directories(sdkLyricDir, ec);
+    }
+    
+    enum class Outcome { Pending, Imported, Skipped, Invalid, Failed };
+    struct Prepared {
+        Outcome outcome = Outcome::Pending;
+        std::string payload;                // 仅 Pack 后端：待批量写入的记录
+        uint64_t bytesRead = 0;
+        uint64_t storedBytes = 0;
+    };
+    std::vector<Prepared> prepared(candidates.size());
+    std::atomic<size_t> next{ 0 };
+    
+    auto worker = [&] {
+        for (size_t i = next++; i < candidates.size(); i = next++) {
+            const Candidate& candidate = candidates[i];
+            Prepared& result = prepared[i];
+            std::string songIdStr = std::to_string(candidate.songId);
+            std::string targetPath = sdkLyricDir + "\\" + songIdStr;
+            
+            if (!options.overwrite) {
+                std::error_code ec;
+                bool exists = pack ? pack->Get(candidate.songId).has_value() : fs::exists(targetPath, ec);
+                if (exists) {
+                    result.outcome = Outcome::Skipped;
+                    continue;
+                }
+            }
+            
+            std::ifstream ifs(candidate.path, std::ios::binary | std::ios::ate);
+            std::streamoff size = ifs ? (std::streamoff)ifs.tellg() : 0;
+            std::string content(size > 0 ? (size_t)size : 0, '\0');
+            if (size <= 0 || !ifs.seekg(0) || !ifs.read(content.data(), size)) {
+                result.outcome = Outcome::Invalid;
+                continue;
+            }
+            result.bytesRead = (uint64_t)size;
+            
+            // 去除 UTF-8 BOM（否则 JSON 会被当作纯文本）
+            std::string_view view = content;
+            if (view.substr(0, 3) == "\xEF\xBB\xBF") view.remove_prefix(3);
+            
+            auto data = ParseCacheContent(view);
+            if (!data) {
+                result.outcome = Outcome::Invalid;
+                continue;
+            }
+            NormalizeLineEndings(data->lrc);
+            NormalizeLineEndings(data->tlyric);
+            NormalizeLineEndings(data->romalrc);
+            NormalizeLineEndings(data->yrc);
+            if (!HasTimeTag(data->lrc)) {
+                result.outcome = Outcome::Invalid;
+                continue;
+            }
+            
+            std::string json = SerializeLyricToJson(*data);
+            std::string payload = compress ? LyricCodec::Compress(json) : std::move(json);
+            result.storedBytes = payload.size();
+            if (pack) {
+                result.payload = std::move(payload);
+                continue;
+            }
+            
+            std::string tmpPath = targetPath + ".tmp";
+            {
+                std::ofstream ofs(tmpPath, std::ios::binary | std::ios::trunc);
+                ofs << payload;
+            }
+            result.outcome = MoveFileExA(tmpPath.c_str(), targetPath.c_str(), MOVEFILE_REPLACE_EXISTING)
+                ? Outcome::Imported : Outcome::Failed;
+            if (result.outcome == Outcome::Failed) DeleteFileA(tmpPath.c_str());
+        }
+    };
     
-    // 合并
-    std::ostringstream oss;
-    std::set<std::string> allTimestamps;
+    size_t threadCount = options.threads > 0 ? (size_t)options.threads : (size_t)std::thread::hardware_concurrency();
+    threadCount = (std::min)((std::max)(threadCount, (size_t)1), (std::max)(candidates.size(), (size_t)1));
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threadCount; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
     
-    for (const auto& [ts, _] : lrcMap) allTimestamps.insert(ts);
-    for (const auto& [ts, _] : tlyricMap) allTimestamps.insert(ts);
+    // 3. Pack 后端：按批追加，每批只刷盘一次
+    if (pack) {
+        LyricPackStore::Codec codec = compress ? LyricPackStore::Codec::Lz : LyricPackStore::Codec::Raw;
+        size_t batchSize = (std::max)(options.batchSize, (size_t)1);
+        std::vector<size_t> batch;
+        std::vector<LyricPackStore::BatchItem> items;
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            if (prepared[i].outcome == Outcome::Pending) batch.push_back(i);
+            if (batch.empty() || (batch.size() < batchSize && i + 1 < candidates.size())) continue;
+            
+            items.clear();
+            for (size_t index : batch) {
+                items.push_back({ candidates[index].songId, prepared[index].payload, codec });
+            }
+            // PutBatch 只在整批写入失败时返回 0（单条超长记录极少见，不单独区分）
+            Outcome outcome = pack->PutBatch(items) > 0 ? Outcome::Imported : Outcome::Failed;
+            for (size_t index : batch) {
+                prepared[index].outcome = outcome;
+                std::string().swap(prepared[index].payload);
+            }
+            batch.clear();
+        }
+    }
     
-    for (const auto& ts : allTimestamps) {
-        std::string original = lrcMap[ts];
-        std::string translation = tlyricMap[ts];
-        
-        oss << "[" << ts << "]";
-        
-        if (!original.empty() && !translation.empty()) {
-            oss << original << " / " << translation;
-        } else if (!original.empty()) {
-            oss << original;
-        } else {
-            oss << translation;
+    // 4. 汇总并登记（导入的内容取代之前的失败记录 / 验证器）
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        const Prepared& result = prepared[i];
+        report.bytesRead += result.bytesRead;
+        switch (result.outcome) {
+            case Outcome::Imported:
+                report.imported++;
+                NegativeResults().Forget(candidates[i].songId);
+                Validators().Forget(candidates[i].songId);
+                Budget().RecordWrite(candidates[i].songId, result.storedBytes);
+                if (!pack) CacheIndex().Add(candidates[i].songId, sdkLyricDir);
+                break;
+            case Outcome::Skipped: report.skipped++; break;
+            case Outcome::Invalid: report.invalid++; break;
+            case Outcome::Pending:
+            case Outcome::Failed:  report.failed++; break;
         }
-        
-        oss << "\n";
     }
     
-    return oss.str();
+    ScheduleEviction();
+    
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO("批量导入完成: 扫描 " << report.filesScanned << ", 导入 " << report.imported
+             << ", 跳过 " << report.skipped << ", 无效 " << report.invalid << ", 失败 " << report.failed
+             << " (" << threadCount << " 线程, " << report.FilesPerSec() << " 文件/s, "
+             << report.MBPerSec() << " MB/s)");
+    return report;
 }
 
-// ============================================================================
-// API 私有辅助函数实现
-// ============================================================================
+CacheUsage API::GetCacheUsage() {
+    CacheBudget::Stats stats = Budget().GetStats();
+    CacheUsage usage;
+    usage.entries = stats.entries;
+    usage.bytes = stats.bytes;
+    usage.evictedEntries = stats.evictedEntries;
+    usage.evictedBytes = stats.evictedBytes;
+    return usage;
+}
 
-std::string API::HttpGet(const std::string& url, const std::string& cookie) {
-    HINTERNET hInternet = InternetOpenA(
-        "Mozilla/5.0 (Windows NT 10.0; Win64; x64)", 
-        INTERNET_OPEN_TYPE_PRECONFIG, 
-        NULL, NULL, 0
-    );
-    
-    if (!hInternet) return "";
-    
-    // 设置超时
-    DWORD timeout = 8000; // 8 秒
-    InternetSetOptionA(hInternet, INTERNET_OPTION_CONNECT_TIMEOUT, &timeout, sizeof(timeout));
-    InternetSetOptionA(hInternet, INTERNET_OPTION_RECEIVE_TIMEOUT, &timeout, sizeof(timeout));
-    
-    // 添加 Cookie
-    std::string headers = "Referer: https://music.163.com/\r\n";
-    if (!cookie.empty()) {
-        headers += "Cookie: " + cookie + "\r\n";
+size_t API::TrimCache() {
+    size_t total = 0;
+    while (size_t evicted = EvictBatch(EVICTION_BATCH)) {
+        total += evicted;
+    }
+    Budget().Flush();
+    return total;
+}
+
+void API::SetCacheConfig(const CacheConfig& config) {
+    auto& state = GetCacheState();
+    std::shared_ptr<LyricPackStore> old;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.config = config;
+        old = std::move(state.pack);    // 下次访问时按新配置重新打开
+        state.packFailed = false;
+    }
+    NegativeResults().SetOptions(NegativeOptionsFrom(config));
+    Budget().SetOptions(BudgetOptionsFrom(config));
+    ScheduleEviction();     // 预算缩小时立即开始淘汰
+    // 正在使用旧存储的调用方持有引用，最后一个引用释放时关闭
+}
+
+CacheConfig API::GetCacheConfig() {
+    auto& state = GetCacheState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.config;
+}
+
+void API::SetApiBaseUrl(const std::string& baseUrl) {
+    auto& state = GetEndpointState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.baseUrl = baseUrl.empty() ? DEFAULT_API_BASE_URL : baseUrl;
+    while (state.baseUrl.size() > 1 && state.baseUrl.back() == '/') {
+        state.baseUrl.pop_back();
     }
+}
+
+std::string API::GetApiBaseUrl() {
+    auto& state = GetEndpointState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.baseUrl;
+}
+
+void API::Shutdown() {
+    // 先停刷新：其在途请求仍会经过请求策略
+    {
+        auto& state = GetRefreshState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (state.refresher) state.refresher->Stop();
+    }
+    Budget().Stop();        // 当前批淘汰完成后退出
+    Http::RequestPolicy::Default().Shutdown();
+}
+
+std::string API::MergeLyrics(const std::string& lrc, const std::string& tlyric) {
+    return MergeLyrics(lrc, tlyric, MERGE_TOLERANCE_MS);
+}
+
+std::string API::MergeLyrics(const std::string& lrc, const std::string& tlyric, int toleranceMs) {
+    if (lrc.empty()) return tlyric;
+    if (tlyric.empty()) return lrc;
+    
+    // v0.1.4: 数值时间戳 + 有序数组，一次双指针归并（取代 regex + map + set）
+    std::vector<TimedLine> original;
+    std::vector<TimedLine> translation;
+    ParseTimedLines(lrc, original);
+    ParseTimedLines(tlyric, translation);
     
-    HINTERNET hConnect = InternetOpenUrlA(
-        hInternet, 
-        url.c_str(), 
-        headers.c_str(), 
-        headers.length(), 
-        INTERNET_FLAG_NO_CACHE_WRITE | INTERNET_FLAG_RELOAD, 
-        0
-    );
+    std::string out;
+    out.reserve(lrc.size() + tlyric.size() + (std::min)(original.size(), translation.size()) * 3);
     
-    std::string response;
+    auto append = [&out](const TimedLine& line) {
+        out += line.tag;
+        out += line.text;
+        out += '\n';
+    };
     
-    if (hConnect) {
-        char buffer[4096];
-        DWORD bytesRead;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < original.size() && j < translation.size()) {
+        const TimedLine& a = original[i];
+        const TimedLine& b = translation[j];
+        int64_t delta = a.ms - b.ms;
         
-        while (InternetReadFile(hConnect, buffer, sizeof(buffer), &bytesRead) && bytesRead > 0) {
-            response.append(buffer, bytesRead);
+        if (delta >= -toleranceMs && delta <= toleranceMs) {
+            // 同一行：使用原文的时间标签（保留其原始精度）
+            out += a.tag;
+            if (!a.text.empty() && !b.text.empty()) {
+                out += a.text;
+                out += " / ";
+                out += b.text;
+            } else {
+                out += a.text.empty() ? b.text : a.text;
+            }
+            out += '\n';
+            i++;
+            j++;
+        } else if (delta < 0) {
+            append(original[i++]);
+        } else {
+            append(translation[j++]);
         }
-        
-        InternetCloseHandle(hConnect);
     }
+    for (; i < original.size(); ++i) append(original[i]);
+    for (; j < translation.size(); ++j) append(translation[j]);
     
-    InternetCloseHandle(hInternet);
-    return response;
+    return out;
+}
+
+// ============================================================================
+// API 私有辅助函数实现
+// ============================================================================
+
+std::string API::HttpGet(const std::string& url, const std::string& cookie) {
+    // v0.1.4: 共享 HTTP 层（协商 gzip/deflate 压缩传输，本地流式解压）
+    auto response = ApiRequest(url, cookie);
+    if (!response) {
+        return "";
+    }
+    return std::move(response->body);
 }
 
 std::vector<std::string> API::GetLyricCacheDirs() {
@@ -456,13 +1095,126 @@ std::vector<std::string> API::GetLyricCacheDirs() {
     return dirs;
 }
 
+LyricCacheIndex& API::CacheIndex() {
+    // 刻意不析构：避免 DLL 卸载期间在加载器锁内 join 监听线程
+    static LyricCacheIndex* index = [] {
+        std::vector<std::string> watchRoots;
+        char localAppData[MAX_PATH];
+        if (SHGetFolderPathA(NULL, CSIDL_LOCAL_APPDATA, NULL, 0, localAppData) == S_OK) {
+            std::string baseDir = localAppData;
+            watchRoots.push_back(baseDir + "\\Netease\\CloudMusic");  // webdata / Download 首次创建
+            watchRoots.push_back(baseDir + "\\Packages");               // UWP 版安装/卸载
+        }
+        watchRoots.push_back(GetSDKCacheDir());                        // SDK 降级路径
+        
+        auto* created = new LyricCacheIndex([] { return GetLyricCacheDirs(); }, std::move(watchRoots));
+        created->StartWatching();
+        return created;
+    }();
+    return *index;
+}
+
+std::shared_ptr<LyricPackStore> API::PackStore() {
+    auto& state = GetCacheState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (state.config.backend != CacheBackend::Pack || state.packFailed) {
+        return nullptr;
+    }
+    
+    if (!state.pack) {
+        std::string dir = state.config.packDir.empty() ? GetSDKCacheDir() + "\\pack" : state.config.packDir;
+        
+        LyricPackStore::Options options;
+        options.syncWrites = state.config.packSyncWrites;
+        options.backgroundCompaction = state.config.packBackgroundCompaction;
+        
+        auto store = std::make_shared<LyricPackStore>();
+        if (!store->Open(dir, options)) {
+            LOG_WARN("包文件存储不可用，回落到逐文件缓存: " << dir);
+            state.packFailed = true;
+            return nullptr;
+        }
+        state.pack = std::move(store);
+    }
+    return state.pack;
+}
+
+NegativeCache& API::NegativeResults() {
+    static NegativeCache* cache = new NegativeCache(
+        GetSDKCacheDir() + "\\negative_cache.txt", NegativeOptionsFrom(GetCacheConfig()));
+    return *cache;
+}
+
+CacheBudget& API::Budget() {
+    static CacheBudget* budget = [] {
+        auto* created = new CacheBudget(
+            GetSDKCacheDir() + "\\cache_access.txt", BudgetOptionsFrom(GetCacheConfig()));
+        created->SetEvictor([](size_t maxCount) { return EvictBatch(maxCount); });
+        return created;
+    }();
+    return *budget;
+}
+
+size_t API::EvictBatch(size_t maxCount) {
+    auto& state = GetEvictionState();
+    std::lock_guard<std::mutex> lock(state.batchMutex);
+    
+    std::vector<long long> victims = Budget().CollectVictims(maxCount);
+    if (victims.empty()) {
+        return 0;
+    }
+    
+    std::string sdkLyricDir = GetSDKCacheDir() + "\\lyric";
+    auto pack = PackStore();
+    for (long long songId : victims) {
+        if (pack) {
+            pack->Remove(songId);
+        }
+        std::string filePath = sdkLyricDir + "\\" + std::to_string(songId);
+        if (DeleteFileA(filePath.c_str())) {
+            CacheIndex().Remove(songId, sdkLyricDir);
+        }
+        Validators().Forget(songId);    // 否则过期刷新会把淘汰的歌词重新下载回来
+        Budget().RecordEviction(songId);
+    }
+    return victims.size();
+}
+
+void API::ScheduleEviction() {
+    // 后台线程由预算对象持有，分批淘汰：每批之间暂停，不长时间占用包文件写锁
+    Budget().ScheduleEviction();
+}
+
+ValidatorStore& API::Validators() {
+    static ValidatorStore* store = new ValidatorStore(GetSDKCacheDir() + "\\lyric_validators.txt");
+    return *store;
+}
+
+void API::SetSDKCacheDir(const std::string& dir) {
+    auto& state = GetEndpointState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.sdkCacheDir = dir;
+    while (state.sdkCacheDir.size() > 1
+           && (state.sdkCacheDir.back() == '\\' || state.sdkCacheDir.back() == '/')) {
+        state.sdkCacheDir.pop_back();
+    }
+}
+
 std::string API::GetSDKCacheDir() {
-    char localAppData[MAX_PATH];
-    if (SHGetFolderPathA(NULL, CSIDL_LOCAL_APPDATA, NULL, 0, localAppData) != S_OK) {
-        return ".\\cache"; // 降级：当前目录
+    std::string cacheDir;
+    {
+        auto& state = GetEndpointState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        cacheDir = state.sdkCacheDir;
     }
     
-    std::string cacheDir = std::string(localAppData) + "\\NeteaseHookSDK\\cache";
+    if (cacheDir.empty()) {
+        char localAppData[MAX_PATH];
+        if (SHGetFolderPathA(NULL, CSIDL_LOCAL_APPDATA, NULL, 0, localAppData) != S_OK) {
+            return ".\\cache"; // 降级：当前目录
+        }
+        cacheDir = std::string(localAppData) + "\\NeteaseHookSDK\\cache";
+    }
     
     // 确保目录存在
     try {
@@ -474,7 +1226,7 @@ std::string API::GetSDKCacheDir() {
     return cacheDir;
 }
 
-std::string API::ExtractJsonValue(const std::string& json, const std::string& key) {
+std::string API::ExtractJsonValue(std::string_view json, const std::string& key) {
     std::string keyPattern = "\"" + key + "\"";
     size_t keyPos = json.find(keyPattern);
     
@@ -496,60 +1248,12 @@ std::string API::ExtractJsonValue(const std::string& json, const std::string& ke
     
     if (valueStart >= json.length()) return "";
     
-    // 字符串值
+    // 字符串值 (SIMD 内核整段拷贝未转义片段，含代理对解码)
     if (json[valueStart] == '"') {
         std::string value;
-        bool escaped = false;
-        
-        for (size_t i = valueStart + 1; i < json.length(); ++i) {
-            char c = json[i];
-            
-            if (escaped) {
-                switch (c) {
-                    case '"': value += '"'; break;
-                    case '\\': value += '\\'; break;
-                    case '/': value += '/'; break;
-                    case 'b': value += '\b'; break;
-                    case 'f': value += '\f'; break;
-                    case 'n': value += '\n'; break;
-                    case 'r': value += '\r'; break;
-                    case 't': value += '\t'; break;
-                    case 'u': {  // Unicode 转义序列 \uXXXX (修复中文显示)
-                        if (i + 4 < json.length()) {
-                            std::string hexStr = json.substr(i + 1, 4);
-                            try {
-                                int codepoint = std::stoi(hexStr, nullptr, 16);
-                                
-                                // 转换为 UTF-8
-                                if (codepoint <= 0x7F) {
-                                    value += (char)codepoint;
-                                } else if (codepoint <= 0x7FF) {
-                                    value += (char)(0xC0 | (codepoint >> 6));
-                                    value += (char)(0x80 | (codepoint & 0x3F));
-                                } else if (codepoint <= 0xFFFF) {
-                                    value += (char)(0xE0 | (codepoint >> 12));
-                                    value += (char)(0x80 | ((codepoint >> 6) & 0x3F));
-                                    value += (char)(0x80 | (codepoint & 0x3F));
-                                }
-                                i += 4; // 跳过已处理的4位十六进制
-                            } catch (...) {
-                                value += c; // 解析失败，保留原字符
-                            }
-                        }
-                        break;
-                    }
-                    default: value += c; break;
-                }
-                escaped = false;
-            } else {
-                if (c == '\\') {
-                    escaped = true;
-                } else if (c == '"') {
-                    return value; // 结束
-                } else {
-                    value += c;
-                }
-            }
+        std::string_view rest(json.data() + valueStart + 1, json.length() - valueStart - 1);
+        if (Json::UnescapeString(rest, value)) {
+            return value; // 结束
         }
     }
     // 数字值 或 布尔值
@@ -558,32 +1262,54 @@ std::string API::ExtractJsonValue(const std::string& json, const std::string& ke
         while (endPos < json.length() && (isdigit(json[endPos]) || json[endPos] == '.' || isalpha(json[endPos]))) {
             endPos++;
         }
-        return json.substr(valueStart, endPos - valueStart);
+        return std::string(json.substr(valueStart, endPos - valueStart));
     }
     
     return "";
 }
 
 std::optional<LyricData> API::ParseCacheFile(const std::string& filePath) {
-    std::ifstream ifs(filePath, std::ios::binary);
+    std::ifstream ifs(filePath, std::ios::binary | std::ios::ate);
     if (!ifs) return std::nullopt;
     
-    std::stringstream buffer;
-    buffer << ifs.rdbuf();
-    std::string content = buffer.str();
+    // 按文件大小一次性读取（避免 stringstream 的二次拷贝）
+    std::streamoff size = ifs.tellg();
+    if (size <= 0) return std::nullopt;
     
+    std::string content((size_t)size, '\0');
+    ifs.seekg(0);
+    if (!ifs.read(content.data(), size)) return std::nullopt;
+    
+    return ParseCacheContent(content);
+}
+
+std::optional<LyricData> API::ParseCacheContent(std::string_view content) {
     if (content.empty()) return std::nullopt;
     
+    // v0.1.4: 压缩记录先解压（魔数以 NUL 开头，不会与 JSON / 纯文本冲突）
+    if (LyricCodec::IsCompressed(content)) {
+        std::string raw;
+        if (!LyricCodec::Decompress(content, raw)) {
+            LOG_WARN("压缩缓存记录损坏，已忽略");
+            return std::nullopt;
+        }
+        return ParseCacheContent(raw);
+    }
+    
     LyricData data;
     
     // 尝试 JSON 解析
-    if (content.find("{") == 0) {
+    if (content.front() == '{') {
         data.lrc = ExtractJsonValue(content, "lyric");
         data.tlyric = ExtractJsonValue(content, "translateLyric");
         data.romalrc = ExtractJsonValue(content, "romalrc");
+        // 网易云客户端缓存没有该字段：先确认带引号的键存在，避免回退到无引号匹配误中歌词正文
+        if (content.find("\"yrc\"") != std::string_view::npos) {
+            data.yrc = ExtractJsonValue(content, "yrc");
+        }
     } else {
         // 纯文本格式
-        data.lrc = content;
+        data.lrc = std::string(content);
     }
     
     data.fromCache = true;
@@ -592,33 +1318,30 @@ std::optional<LyricData> API::ParseCacheFile(const std::string& filePath) {
 }
 
 std::string API::SerializeLyricToJson(const LyricData& data) {
-    // 转义 JSON 字符串
-    auto escapeJson = [](const std::string& str) -> std::string {
-        std::string result;
-        for (char c : str) {
-            switch (c) {
-                case '\"': result += "\\\""; break;
-                case '\\': result += "\\\\"; break;
-                case '\n': result += "\\n"; break;
-                case '\r': result += "\\r"; break;
-                case '\t': result += "\\t"; break;
-                default: result += c;
-            }
-        }
-        return result;
-    };
-    
-    std::ostringstream oss;
-    oss << "{";
-    oss << "\"lyric\":\"" << escapeJson(data.lrc) << "\",";
-    oss << "\"translateLyric\":\"" << escapeJson(data.tlyric) << "\"";
+    // 一次性预留，转义由 SIMD 内核批量追加
+    std::string json;
+    json.reserve(data.lrc.size() + data.tlyric.size() + data.romalrc.size() + data.yrc.size() + 64);
+
+    json += "{\"lyric\":\"";
+    Json::AppendEscaped(json, data.lrc);
+    json += "\",\"translateLyric\":\"";
+    Json::AppendEscaped(json, data.tlyric);
+    json += '"';
     
     if (!data.romalrc.empty()) {
-        oss << ",\"romalrc\":\"" << escapeJson(data.romalrc) << "\"";
+        json += ",\"romalrc\":\"";
+        Json::AppendEscaped(json, data.romalrc);
+        json += '"';
+    }
+    
+    if (!data.yrc.empty()) {
+        json += ",\"yrc\":\"";
+        Json::AppendEscaped(json, data.yrc);
+        json += '"';
     }
     
-    oss << "}";
-    return oss.str();
+    json += '}';
+    return json;
 }
 
 } // namespace Netease
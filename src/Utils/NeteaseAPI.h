@@ -2,6 +2,11 @@
 #include <string>
 #include <vector>
 #include <optional>
+#include <memory>
+#include <string_view>
+#include <cstdint>
+#include <climits>
+#include <functional>
 
 /**
  * NeteaseAPI.h - 网易云音乐数据获取工具
@@ -23,6 +28,12 @@
 
 namespace Netease {
 
+    class LyricCacheIndex;
+    class LyricPackStore;
+    class NegativeCache;
+    class ValidatorStore;
+    class CacheBudget;
+
     /**
      * 歌曲元数据结构
      * 
@@ -46,6 +57,7 @@ namespace Netease {
         std::string lrc;            // 原版歌词（LRC 格式）
         std::string tlyric;         // 翻译歌词（LRC 格式，可能为空）
         std::string romalrc;        // 罗马音歌词（LRC 格式，可能为空）
+        std::string yrc;            // 逐字歌词（网易云 yrc 格式，可能为空）(v0.1.4)
         bool fromCache = false;     // 是否来自本地缓存
         
         /**
@@ -61,6 +73,283 @@ namespace Netease {
         bool IsValid() const { return !lrc.empty(); }
     };
 
+    /**
+     * 紧凑歌词时间轴 (v0.1.4)
+     *
+     * 结构数组布局，由 API::ParseTimeline 生成：
+     * - timesMs 按时间升序（已应用 [offset:]），一行多个时间标签展开为多项
+     * - 所有文本（原文 / 翻译 / 罗马音）连续存放在 arena 中，每段以 '\0' 结尾，可直接当作 C 字符串
+     * - text / translation / romaji 为 spans 下标；多标签行共享同一段文本，-1 表示无翻译 / 罗马音
+     */
+    struct LrcTimeline {
+        struct Span {
+            uint32_t offset = 0;    // arena 中的起始位置
+            uint32_t length = 0;    // 字节数（不含结尾 '\0'）
+        };
+
+        std::vector<int64_t> timesMs;       // 原文时间戳（毫秒）
+        std::vector<int32_t> text;          // 原文 -> spans
+        std::vector<int32_t> translation;   // 翻译 -> spans，-1 = 无
+        std::vector<int32_t> romaji;        // 罗马音 -> spans，-1 = 无
+        std::vector<Span> spans;
+        std::string arena;
+        int64_t offsetMs = 0;               // 原文中的 [offset:] 值
+
+        size_t Size() const { return timesMs.size(); }
+        bool Empty() const { return timesMs.empty(); }
+
+        std::string_view Text(size_t line) const { return SpanText(text[line]); }
+        std::string_view Translation(size_t line) const { return SpanText(translation[line]); }
+        std::string_view Romaji(size_t line) const { return SpanText(romaji[line]); }
+
+        /**
+         * span 对应的 C 字符串；span < 0 时返回 nullptr
+         */
+        const char* SpanCStr(int32_t span) const {
+            return span < 0 ? nullptr : arena.data() + spans[span].offset;
+        }
+
+        std::string_view SpanText(int32_t span) const {
+            if (span < 0) return {};
+            return std::string_view(arena.data() + spans[span].offset, spans[span].length);
+        }
+
+        /**
+         * 当前应显示的行：最后一个 timesMs <= ms 的下标（二分查找）
+         *
+         * @return 第一行之前返回 -1
+         */
+        int FindLine(int64_t ms) const;
+    };
+
+    /**
+     * 行级播放游标 (v0.1.4)
+     *
+     * 在升序时间戳数组（LrcTimeline::timesMs 等）上跟踪当前行，即最后一个 时间 <= 播放时间 的下标：
+     * - 顺序播放时从上一次的位置向后步进（均摊 O(1)），未到下一行边界时直接返回
+     * - 时间回退，或一次前进超过 seekThresholdMs，判定为跳转（拖动进度条），改用二分查找
+     * - 当前行变化时回调，并给出下一次变化的精确时间：调用方可以睡到那一刻，而不必逐帧轮询
+     *
+     * @note 只保存数组的地址；数组重新分配或被替换后需再次 Bind
+     */
+    class LineCursor {
+    public:
+        struct Event {
+            int previous = -1;              // 变化前的行
+            int current = -1;               // 变化后的行，-1 = 第一行之前
+            int64_t timeMs = 0;             // 触发变化的播放时间
+            int64_t nextBoundaryMs = 0;     // 下一次变化的时间，INT64_MAX = 已是最后一行
+            bool seek = false;              // 由跳转引起（而非顺序播放）
+        };
+
+        using LineChangedCallback = std::function<void(const Event& event)>;
+
+        LineCursor() = default;
+        explicit LineCursor(const std::vector<int64_t>& timesMs) { Bind(timesMs); }
+
+        /**
+         * 绑定时间戳数组；与当前绑定的数组（地址与长度）相同时不做任何事，否则重置状态
+         */
+        void Bind(const std::vector<int64_t>& timesMs);
+
+        void SetCallback(LineChangedCallback callback) { m_Callback = std::move(callback); }
+        void SetSeekThresholdMs(int64_t thresholdMs) { m_SeekThresholdMs = thresholdMs; }
+
+        /**
+         * 移动到 timeMs
+         *
+         * @return 当前行，-1 = 第一行之前 / 未绑定
+         */
+        int Update(int64_t timeMs);
+
+        int Current() const { return m_Current; }
+
+        /**
+         * 当前行保持不变的截止时间（下一行的开始时间），INT64_MAX = 不会再变化
+         */
+        int64_t NextBoundaryMs() const;
+
+        bool LastUpdateWasSeek() const { return m_LastWasSeek; }
+        uint64_t SeekCount() const { return m_Seeks; }
+
+        /**
+         * 回到第一行之前（保留绑定与回调）
+         */
+        void Reset();
+
+    private:
+        const std::vector<int64_t>* m_Times = nullptr;
+        size_t m_Size = 0;
+        int m_Current = -1;
+        int64_t m_LastMs = INT64_MIN;
+        int64_t m_SeekThresholdMs = 2000;
+        bool m_LastWasSeek = false;
+        uint64_t m_Seeks = 0;
+        LineChangedCallback m_Callback;
+    };
+
+    /**
+     * 逐字（卡拉 OK）歌词时间轴 (v0.1.4)
+     *
+     * 由 API::ParseWordTimeline 从网易云 yrc 格式解析：
+     *   [行开始ms,行时长ms](字开始ms,字时长ms,0)字(字开始ms,字时长ms,0)字...
+     *
+     * 所有数组扁平存放：
+     * - 行按开始时间升序；lineFirstWord 末尾多一个哨兵，第 i 行的字为 [lineFirstWord[i], lineFirstWord[i + 1])
+     * - 字的文本在 arena 中按顺序紧挨存放（不加分隔符），wordTextOffset 同样带哨兵，
+     *   因此一整行的文本也是 arena 中连续的一段
+     */
+    struct WordTimeline {
+        std::vector<int64_t> lineStartMs;
+        std::vector<int32_t> lineDurationMs;
+        std::vector<uint32_t> lineFirstWord;    // 行数 + 1
+
+        std::vector<int64_t> wordStartMs;       // 绝对时间（毫秒）
+        std::vector<int32_t> wordDurationMs;
+        std::vector<uint32_t> wordTextOffset;   // 字数 + 1
+        std::string arena;
+
+        size_t LineCount() const { return lineStartMs.size(); }
+        size_t WordCount() const { return wordStartMs.size(); }
+        bool Empty() const { return lineStartMs.empty(); }
+
+        uint32_t LineWordBegin(size_t line) const { return lineFirstWord[line]; }
+        uint32_t LineWordEnd(size_t line) const { return lineFirstWord[line + 1]; }
+
+        std::string_view WordText(size_t word) const {
+            return std::string_view(arena.data() + wordTextOffset[word], wordTextOffset[word + 1] - wordTextOffset[word]);
+        }
+
+        std::string_view LineText(size_t line) const {
+            uint32_t begin = wordTextOffset[LineWordBegin(line)];
+            uint32_t end = wordTextOffset[LineWordEnd(line)];
+            return std::string_view(arena.data() + begin, end - begin);
+        }
+    };
+
+    /**
+     * 逐字歌词播放游标 (v0.1.4)
+     *
+     * 每帧以当前播放时间调用 Update：时间顺序前进时从上一次的位置向后步进（均摊 O(1)），
+     * 时间回退或一次跳过多行（拖动进度条）时改为二分查找。
+     *
+     * @note 只保存时间轴的引用，时间轴必须比游标活得久
+     */
+    class WordCursor {
+    public:
+        struct Position {
+            int line = -1;          // 最后一个已开始的行，-1 = 第一行之前
+            int word = -1;          // 该行中最后一个已开始的字（全局下标），-1 = 该行第一个字之前
+            float wordFill = 0.0f;  // 当前字的填充比例 [0, 1]；之前的字视为 1，之后的字视为 0
+        };
+
+        explicit WordCursor(const WordTimeline& timeline) : m_Timeline(timeline) {}
+
+        /**
+         * 移动到 timeMs 并返回位置
+         */
+        const Position& Update(int64_t timeMs);
+
+        const Position& Current() const { return m_Position; }
+
+        /**
+         * 某个字在当前时间的填充比例（渲染时逐字调用）
+         */
+        float FillOf(size_t word) const;
+
+        /**
+         * 退回到初始状态（切歌 / 时间轴内容变化后调用）
+         */
+        void Reset();
+
+        uint64_t SeekCount() const { return m_Seeks; }     // 走二分查找的次数
+
+    private:
+        const WordTimeline& m_Timeline;
+        Position m_Position;
+        int64_t m_LastMs = INT64_MIN;
+        uint64_t m_Seeks = 0;
+    };
+
+    /**
+     * 缓存后端 (v0.1.4)
+     */
+    enum class CacheBackend {
+        Files,      // 逐文件 JSON（网易云兼容布局，默认）
+        Pack        // 追加式包文件 + 内存映射索引（大量歌曲时推荐）
+    };
+
+    /**
+     * 条件刷新结果 (v0.1.4)
+     */
+    enum class RefreshStatus {
+        NotModified,    // 304：本地缓存仍有效，未传输正文
+        Updated,        // 下载了完整内容并写入缓存
+        NoLyric,        // 服务端确认无歌词
+        Failed          // 网络错误 / 非预期响应，缓存保持不变
+    };
+
+    /**
+     * 缓存配置 (v0.1.4)
+     */
+    struct CacheConfig {
+        CacheBackend backend = CacheBackend::Files;
+        std::string packDir;                    // 包文件目录，为空时使用 SDK 缓存目录下的 pack
+        bool packSyncWrites = true;             // 每次写入刷盘（崩溃安全）
+        bool packBackgroundCompaction = true;   // 死数据过多时后台压缩
+        bool compressRecords = true;            // SDK 自有存储（降级目录 / 包文件）压缩写入；网易云目录始终明文
+        
+        // 失败结果缓存：GetLyric 在有效期内不再重复请求
+        int noLyricTtlSec = 7 * 24 * 3600;      // 确认无歌词（纯音乐 / 未收录）
+        int failureBackoffBaseSec = 30;         // 临时失败首次退避，之后逐次翻倍
+        int failureBackoffMaxSec = 3600;        // 退避上限
+        
+        // 条件刷新：超过该时长未确认的缓存视为过期，由 RefreshStaleLyricsAsync 刷新
+        int revalidateAfterSec = 7 * 24 * 3600;
+        int refreshConcurrency = 2;             // 后台刷新同时在途的请求上限
+        
+        // 容量预算（仅 SDK 自有存储：包文件 / 降级目录），超出后在后台按访问热度增量淘汰
+        uint64_t maxCacheBytes = 128ULL * 1024 * 1024;  // 0 = 不限
+        size_t maxCacheEntries = 50000;                 // 0 = 不限
+        int accessHalfLifeSec = 7 * 24 * 3600;          // 访问热度半衰期：越短越接近 LRU，越长越接近 LFU
+    };
+
+    /**
+     * SDK 缓存占用 (v0.1.4)
+     */
+    struct CacheUsage {
+        uint64_t entries = 0;                   // 预算跟踪的条目数
+        uint64_t bytes = 0;                     // 存储占用（压缩后）
+        uint64_t evictedEntries = 0;            // 本进程累计淘汰
+        uint64_t evictedBytes = 0;
+    };
+
+    /**
+     * 批量导入选项 (v0.1.4)
+     */
+    struct ImportOptions {
+        std::vector<std::string> sourceDirs;    // 为空时扫描 GetLyricCacheDirs（不含 SDK 自有目录）
+        int threads = 0;                        // 解析线程数，0 = 硬件并发数
+        bool overwrite = false;                 // 目标存储已有的歌曲是否覆盖
+        size_t batchSize = 512;                 // 包文件后端每批写入条数（一次刷盘）
+    };
+
+    /**
+     * 批量导入结果 (v0.1.4)
+     */
+    struct ImportReport {
+        size_t filesScanned = 0;                // 扫描到的候选文件（文件名为歌曲 ID）
+        size_t imported = 0;                    // 写入 SDK 缓存的条目
+        size_t skipped = 0;                     // 目标已存在 / 多个目录中的重复歌曲
+        size_t invalid = 0;                     // 无法解析或不含时间轴的文件
+        size_t failed = 0;                      // 写入失败
+        uint64_t bytesRead = 0;                 // 读取的源文件字节数
+        double seconds = 0.0;                   // 总耗时（扫描 + 解析 + 写入）
+        
+        double FilesPerSec() const { return seconds > 0 ? filesScanned / seconds : 0.0; }
+        double MBPerSec() const { return seconds > 0 ? bytesRead / (1024.0 * 1024.0) / seconds : 0.0; }
+    };
+
     /**
      * 网易云音乐 API 工具类
      * 
@@ -89,6 +378,10 @@ namespace Netease {
          * 
          * @note 缓存写入失败不影响返回结果
          * @note 第二次访问相同歌曲时几乎瞬时返回
+         * @note v0.1.4: 无歌词 / 请求失败的结果会被记录，有效期内直接返回 nullopt
+         *       （useCache=false 时忽略该记录强制请求）
+         * @note v0.1.4: useCache=false 且本地缓存带有验证器时发送条件请求，
+         *       304 直接返回本地缓存内容，不传输正文；内容已由服务端确认，fromCache 仍为 false
          * 
          * @example
          * // 普通使用
@@ -113,10 +406,54 @@ namespace Netease {
          * @return 成功返回歌曲元数据，失败返回 nullopt
          * 
          * @note 不需要登录
-         * @note 暂不缓存（元数据较少变化，后续版本可添加）
+         * @note v0.1.4: 成功结果缓存在进程内（ClearAllCache 时清空），失败结果不缓存
          */
         static std::optional<SongMetadata> GetSongDetail(long long songId);
 
+        // ====================================================================
+        // 条件刷新接口 (v0.1.4)
+        // ====================================================================
+
+        /**
+         * 条件刷新歌词缓存
+         * 
+         * 本地缓存带有 ETag / Last-Modified 时发送 If-None-Match / If-Modified-Since，
+         * 304 仅更新确认时间；否则（或内容有变化）完整下载并写入缓存
+         * 
+         * @param songId 歌曲 ID
+         * @param cookie 可选的 Cookie 字符串
+         * @return 刷新结果
+         * 
+         * @note 验证器只记录 SDK 在线获取并写入缓存的歌词；
+         *       网易云客户端自身写入的缓存首次刷新时完整下载
+         */
+        static RefreshStatus RefreshLyric(long long songId, const std::string& cookie = "");
+
+        /**
+         * 条件刷新进程内元数据缓存
+         * 
+         * @return 未缓存时完整获取（成功返回 Updated）
+         */
+        static RefreshStatus RefreshSongDetail(long long songId);
+
+        /**
+         * 列出超过 revalidateAfterSec 未确认的歌词缓存（最久未确认的在前）
+         * 
+         * @param maxCount 最多返回多少首，0 = 不限制
+         */
+        static std::vector<long long> GetStaleLyrics(size_t maxCount = 0);
+
+        /**
+         * 在后台条件刷新过期的歌词缓存
+         * 
+         * @param maxCount 本轮最多刷新多少首，0 = 全部
+         * @return 已开始返回 true；上一轮仍在进行或没有过期条目时返回 false
+         * 
+         * @note 同时在途的请求数不超过 CacheConfig::refreshConcurrency
+         * @note 工作线程以后台优先级运行
+         */
+        static bool RefreshStaleLyricsAsync(size_t maxCount = 0);
+
         // ====================================================================
         // 高级接口（精细控制）
         // ====================================================================
@@ -135,6 +472,7 @@ namespace Netease {
          * 
          * @note 支持 JSON 格式（{"lyric": "..."}）和纯文本格式
          * @note 自动处理 \\n 转义符
+         * @note v0.1.4: 通过内存索引定位，未命中时不触发任何文件系统调用
          */
         static std::optional<LyricData> GetLocalLyric(long long songId);
 
@@ -191,6 +529,89 @@ namespace Netease {
          */
         static int ClearAllCache();
 
+        /**
+         * 批量导入本地歌词缓存 (v0.1.4)
+         * 
+         * 新机器上网易云目录已有大量歌词而 SDK 缓存为空时使用：
+         * 1. 扫描源目录中以歌曲 ID 命名的文件
+         * 2. 多线程并行读取、解析（与 GetLocalLyric 相同的格式识别）、校验、规范化
+         * 3. 批量写入当前缓存后端：Pack 后端按批追加并只刷盘一次，
+         *    Files 后端写入 SDK 缓存目录并登记到目录索引
+         * 
+         * @return 导入统计（含吞吐量）
+         * 
+         * @note 校验：原版歌词必须包含至少一个 [mm:ss] 时间标签
+         * @note 规范化：去除 UTF-8 BOM，CRLF / CR 统一为 LF，按 CacheConfig 压缩写入
+         * @note 同一首歌出现在多个源目录时，以靠前的目录为准
+         */
+        static ImportReport ImportLyricCache(const ImportOptions& options);
+        static ImportReport ImportLyricCache() { return ImportLyricCache(ImportOptions()); }
+
+        /**
+         * 获取 SDK 缓存占用 (v0.1.4)
+         */
+        static CacheUsage GetCacheUsage();
+
+        /**
+         * 立即把 SDK 缓存淘汰到预算内 (v0.1.4)
+         * 
+         * @return 淘汰的条目数
+         * 
+         * @note 平时写入超出预算时会在后台自动分批淘汰，无需手动调用
+         * @note 按访问热度（半衰期衰减的访问次数）从低到高淘汰，降到预算的 90% 为止
+         */
+        static size_t TrimCache();
+
+        /**
+         * 设置缓存配置 (v0.1.4)
+         * 
+         * @note 切换到 Pack 后端后，写入只进入包文件；读取时包文件优先，
+         *       其次仍会查找网易云原有的逐文件缓存
+         * @note 包文件打开失败（例如被其他进程占用）时自动回落到逐文件布局
+         */
+        static void SetCacheConfig(const CacheConfig& config);
+
+        /**
+         * 获取当前缓存配置
+         */
+        static CacheConfig GetCacheConfig();
+
+        /**
+         * 设置 API 基础地址 (v0.1.4)
+         * 
+         * @param baseUrl 协议 + 主机 (+ 端口)，如 "http://127.0.0.1:8080"；
+         *                为空时恢复默认 https://music.163.com
+         * 
+         * @note 用于测试替身服务器或自建反向代理，路径部分保持 /api/song/...
+         */
+        static void SetApiBaseUrl(const std::string& baseUrl);
+
+        /**
+         * 获取当前 API 基础地址
+         */
+        static std::string GetApiBaseUrl();
+
+        /**
+         * 改用指定目录作为 SDK 缓存根目录 (v0.1.4)
+         * 
+         * 降级歌词目录、默认包文件目录，以及失败记录 / 验证器 / 容量预算的 sidecar 都放在这里。
+         * 
+         * @param dir 为空时恢复 %LOCALAPPDATA%\\NeteaseHookSDK\\cache
+         * 
+         * @note 供导入工具、测试等隔离运行使用，须在首次访问缓存之前调用：
+         *       sidecar 在首次使用时按当时的目录打开，之后不再切换
+         */
+        static void SetSDKCacheDir(const std::string& dir);
+
+        /**
+         * 停止 SDK 的后台线程 (v0.1.4)
+         * 
+         * 取消后台缓存刷新并等待在途刷新请求结束，等待后台缓存淘汰完成当前批，
+         * 取消并等待在途的对冲请求。卸载 SDK 或进程退出前调用；
+         * 之后仍可继续使用，需要时后台线程会重新启动
+         */
+        static void Shutdown();
+
         // ====================================================================
         // 工具函数
         // ====================================================================
@@ -210,9 +631,49 @@ namespace Netease {
          *   tlyric = "[00:10.00]你好世界"
          * 输出：
          *   "[00:10.00]Hello world / 你好世界"
+         * 
+         * @note v0.1.4: 支持 [mm:ss.xxx] 三位毫秒与一行多个时间标签；
+         *       输出按时间排序，时间标签保持原文中的写法；两行时间差在 10ms 内视为同一行
          */
         static std::string MergeLyrics(const std::string& lrc, const std::string& tlyric);
-        
+
+        /**
+         * 合并原文与翻译歌词，指定匹配容差 (v0.1.4)
+         * 
+         * @param toleranceMs 时间差在该范围内的两行视为同一行（翻译与原文精度不同时常见，
+         *        如 [00:10.123] 与 [00:10.12]）
+         * 
+         * @note 独立重载而非默认参数：保留 v0.1.3 两参数版本的符号
+         */
+        static std::string MergeLyrics(const std::string& lrc, const std::string& tlyric, int toleranceMs);
+
+        /**
+         * 解析为紧凑时间轴 (v0.1.4)
+         *
+         * 与 MergeLyrics 共用同一个解析器：支持一行多个时间标签、[mm:ss.xxx] 与 [offset:]。
+         * 翻译 / 罗马音按时间就近匹配到原文行（差值不超过 toleranceMs），各自的 [offset:] 分别应用。
+         * 文本去除首尾空白；空行保留（length = 0），由调用方决定是否显示。
+         *
+         * @param toleranceMs 翻译 / 罗马音与原文的最大时间差
+         * @note 整个时间轴只有常数次分配（各数组按行数预留，文本写入同一个 arena）
+         */
+        static LrcTimeline ParseTimeline(std::string_view lrc, std::string_view tlyric = {},
+                                         std::string_view romalrc = {}, int toleranceMs = 300);
+
+        static LrcTimeline ParseTimeline(const LyricData& lyric, int toleranceMs = 300) {
+            return ParseTimeline(lyric.lrc, lyric.tlyric, lyric.romalrc, toleranceMs);
+        }
+
+        /**
+         * 解析逐字歌词 (v0.1.4)
+         *
+         * 以 '{' 开头的 JSON 署名行（作词 / 作曲）跳过；字时间小于行开始时间时按相对时间处理。
+         * 行不是按时间排列时整体重排，保证游标可以二分查找。
+         *
+         * @param yrc LyricData::yrc
+         */
+        static WordTimeline ParseWordTimeline(std::string_view yrc);
+
     private:
         /**
          * 发送 HTTP GET 请求
@@ -236,6 +697,67 @@ namespace Netease {
          */
         static std::vector<std::string> GetLyricCacheDirs();
 
+        /**
+         * 获取缓存目录索引（进程内单例）
+         * 
+         * @note 首次调用时扫描所有缓存目录并启动变更监听
+         * @note 目录集合由文件系统通知刷新，不再每次查询都重新探测
+         */
+        static LyricCacheIndex& CacheIndex();
+
+        /**
+         * 获取包文件存储（仅 Pack 后端）
+         * 
+         * @return 已打开的存储；Files 后端或打开失败时返回 nullptr
+         */
+        static std::shared_ptr<LyricPackStore> PackStore();
+
+        /**
+         * 获取失败结果缓存（进程内单例，持久化到 SDK 缓存目录）
+         */
+        static NegativeCache& NegativeResults();
+
+        /**
+         * 获取歌词缓存验证器（进程内单例，持久化到 SDK 缓存目录）
+         */
+        static ValidatorStore& Validators();
+
+        /**
+         * 获取缓存容量预算（进程内单例，访问记录持久化到 SDK 缓存目录）
+         */
+        static CacheBudget& Budget();
+
+        /**
+         * 淘汰一批最冷的条目（删除包文件记录 / 降级目录文件）
+         * 
+         * @return 本批淘汰条数；未超出预算时为 0
+         */
+        static size_t EvictBatch(size_t maxCount);
+
+        /**
+         * 超出预算时唤醒后台淘汰线程（线程由 Budget() 持有，Shutdown 时停止）
+         */
+        static void ScheduleEviction();
+
+        /**
+         * 在线获取歌词（FetchLyricOnline / RefreshLyric 的共同实现）
+         * 
+         * @param conditional 本地缓存带有验证器时发送条件请求；304 时返回本地缓存
+         * @param status 输出刷新结果
+         */
+        static std::optional<LyricData> FetchLyric(
+            long long songId,
+            const std::string& cookie,
+            bool autoCache,
+            bool conditional,
+            RefreshStatus& status
+        );
+
+        /**
+         * 解析 /api/song/detail 响应
+         */
+        static std::optional<SongMetadata> ParseSongDetail(const std::string& response, long long songId);
+
         /**
          * 获取 SDK 缓存目录（降级路径）
          * 
@@ -254,7 +776,7 @@ namespace Netease {
          * @note 简单实现，仅支持字符串值提取
          * @note 不处理嵌套对象
          */
-        static std::string ExtractJsonValue(const std::string& json, const std::string& key);
+        static std::string ExtractJsonValue(std::string_view json, const std::string& key);
 
         /**
          * 解析网易云本地缓存文件
@@ -267,6 +789,11 @@ namespace Netease {
          */
         static std::optional<LyricData> ParseCacheFile(const std::string& filePath);
 
+        /**
+         * 解析缓存内容（文件内容或包文件记录视图）
+         */
+        static std::optional<LyricData> ParseCacheContent(std::string_view content);
+
         /**
          * 将歌词数据序列化为网易云兼容的 JSON 格式
          * 
@@ -0,0 +1,201 @@
+/**
+ * Prefetcher.cpp - 播放队列预取实现
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ */
+
+#include "Prefetcher.h"
+#include "NeteaseAPI.h"
+#include <Windows.h>
+#include <algorithm>
+#include <chrono>
+
+#define LOG_TAG "PREFETCH"
+#include "SimpleLog.h"
+
+namespace Netease {
+
+Prefetcher::Prefetcher(const Options& options)
+    : m_Options(options)
+{
+}
+
+Prefetcher::~Prefetcher() {
+    Stop();
+}
+
+// ============================================================================
+// 队列更新
+// ============================================================================
+
+void Prefetcher::UpdateQueue(const std::vector<long long>& upcoming) {
+    size_t count = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        std::vector<long long> queue;
+        for (long long songId : upcoming) {
+            if (queue.size() >= m_Options.depth) break;
+            if (songId > 0 && std::find(queue.begin(), queue.end(), songId) == queue.end()) {
+                queue.push_back(songId);
+            }
+        }
+        if (m_Stopping || queue == m_Queue) return;
+        count = queue.size();
+        m_Queue = queue;
+
+        // 新代号：尚未开始的任务全部作废
+        uint64_t generation = ++m_Generation;
+        m_Stats.generation = generation;
+        m_Stats.cancelled += m_Pending.size();
+        m_Pending.clear();
+
+        for (long long songId : queue) {
+            if (m_Busy && songId == m_ActiveSong) {
+                m_ActiveGeneration = generation;    // 正在处理且仍在队列中：沿用，不取消
+            } else if (m_Done.count(songId)) {
+                m_Stats.skipped++;
+            } else {
+                m_Pending.push_back(songId);
+            }
+        }
+
+        if (!m_Worker.joinable() && !m_Pending.empty()) {
+            m_Worker = std::thread(&Prefetcher::WorkerLoop, this);
+        }
+    }
+    LOG_DEBUG("队列更新: " << count << " 首, 代号 " << m_Generation.load());
+    m_WorkCv.notify_one();
+}
+
+void Prefetcher::SetCoverWarmer(CoverWarmer warmer) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_CoverWarmer = std::move(warmer);
+}
+
+void Prefetcher::SetDepth(size_t depth) {
+    std::vector<long long> queue;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Options.depth = depth;
+        queue = m_Queue;
+        m_Queue.clear();    // 强制按新深度重新计算
+    }
+    UpdateQueue(queue);
+}
+
+bool Prefetcher::WaitIdle(int timeoutMs) {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    return m_IdleCv.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] {
+        return m_Stopping || (m_Pending.empty() && !m_Busy);
+    });
+}
+
+void Prefetcher::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+        m_Pending.clear();
+        ++m_Generation;
+    }
+    m_WorkCv.notify_all();
+    m_IdleCv.notify_all();
+    if (m_Worker.joinable()) {
+        m_Worker.join();
+    }
+
+    // 允许重新启动：下一次 UpdateQueue 即使队列相同也会重新派发
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stopping = false;
+    m_Queue.clear();
+}
+
+Prefetcher::Stats Prefetcher::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Stats;
+}
+
+// ============================================================================
+// 后台线程
+// ============================================================================
+
+void Prefetcher::WorkerLoop() {
+    if (m_Options.lowPriority) {
+        // 同时降低 CPU 与 I/O 优先级，不与播放 / UI 争抢
+        SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+    }
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (true) {
+        m_WorkCv.wait(lock, [this] { return m_Stopping || !m_Pending.empty(); });
+        if (m_Stopping) break;
+
+        long long songId = m_Pending.front();
+        m_Pending.pop_front();
+        m_ActiveSong = songId;
+        m_ActiveGeneration = m_Generation.load();
+        m_Busy = true;
+
+        lock.unlock();
+        PrefetchOne(songId);
+        lock.lock();
+
+        m_Busy = false;
+        if (m_Pending.empty()) {
+            m_IdleCv.notify_all();
+        }
+    }
+    m_Busy = false;
+    m_IdleCv.notify_all();
+}
+
+bool Prefetcher::IsActiveStale() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_Stopping || m_ActiveGeneration != m_Generation.load()) {
+        m_Stats.cancelled++;
+        return true;
+    }
+    return false;
+}
+
+void Prefetcher::PrefetchOne(long long songId) {
+    auto start = std::chrono::steady_clock::now();
+
+    // 1. 元数据（写入进程内缓存，同时得到封面 URL）
+    auto meta = API::GetSongDetail(songId);
+    if (IsActiveStale()) return;
+
+    // 2. 歌词（已有本地缓存或近期失败记录时不联网）
+    API::GetLyric(songId);
+    if (IsActiveStale()) return;
+
+    // 3. 封面
+    CoverWarmer warmer;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        warmer = m_CoverWarmer;
+    }
+    if (warmer && meta && !meta->albumPicUrl.empty()) {
+        warmer(songId, meta->albumPicUrl);
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (meta) {
+        MarkDoneLocked(songId);     // 元数据失败时允许下次队列更新重试
+    }
+    m_Stats.completed++;
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    LOG_DEBUG("已预取: ID=" << songId << " (" << elapsed << "ms)");
+}
+
+void Prefetcher::MarkDoneLocked(long long songId) {
+    if (!m_Done.insert(songId).second) return;
+    m_DoneOrder.push_back(songId);
+    while (m_DoneOrder.size() > m_Options.rememberCount) {
+        m_Done.erase(m_DoneOrder.front());
+        m_DoneOrder.pop_front();
+    }
+}
+
+} // namespace Netease
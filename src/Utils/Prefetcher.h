@@ -0,0 +1,121 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_set>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Prefetcher.h - 播放队列预取
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ *
+ * 旧流程中歌曲的一切资源都在检测到切歌之后才开始获取，
+ * 每首歌的前几秒都显示 "Loading lyrics..." 且没有封面。
+ * 本模块根据播放队列（由 Driver 通过 CDP 读取）提前获取接下来 N 首歌曲：
+ * - 元数据：API::GetSongDetail（写入进程内元数据缓存）
+ * - 歌词：API::GetLyric（写入磁盘 / 包文件缓存，以及失败结果缓存）
+ * - 封面：交给调用方提供的回调（SDK 不依赖图形库）
+ *
+ * 调度：
+ * - 单个后台线程，以后台优先级运行（CPU 与 I/O 均低于播放 / UI）
+ * - 队列每次变化代号 +1；旧代号的任务在阶段之间检测到后立即放弃
+ *   （已发出的 HTTP 请求无法中断，但不会再发起后续阶段）
+ * - 本进程内已预取过的歌曲不重复预取
+ */
+
+namespace Netease {
+
+class Prefetcher {
+public:
+    struct Options {
+        size_t depth = 3;               // 预取接下来几首
+        bool lowPriority = true;        // 后台线程优先级（THREAD_MODE_BACKGROUND）
+        size_t rememberCount = 256;     // 记住最近多少首已预取的歌曲
+    };
+
+    /**
+     * 封面预热回调：songId + 封面 URL（在预取线程中调用）
+     */
+    using CoverWarmer = std::function<void(long long songId, const std::string& coverUrl)>;
+
+    struct Stats {
+        uint64_t generation = 0;    // 当前队列代号
+        uint64_t completed = 0;     // 完成预取的歌曲数
+        uint64_t cancelled = 0;     // 因队列变化被放弃的任务数
+        uint64_t skipped = 0;       // 已预取过而跳过的歌曲数
+    };
+
+    explicit Prefetcher(const Options& options);
+    Prefetcher() : Prefetcher(Options()) {}
+    ~Prefetcher();
+
+    Prefetcher(const Prefetcher&) = delete;
+    Prefetcher& operator=(const Prefetcher&) = delete;
+
+    /**
+     * 更新即将播放的歌曲（按播放顺序，不含当前歌曲）
+     *
+     * @note 只取前 depth 首；与上次相同时不产生新代号
+     * @note 首次调用时启动后台线程
+     */
+    void UpdateQueue(const std::vector<long long>& upcoming);
+
+    /**
+     * 设置封面预热回调（为空时跳过封面阶段）
+     */
+    void SetCoverWarmer(CoverWarmer warmer);
+
+    /**
+     * 调整预取深度（0 = 暂停预取并取消待处理任务）
+     */
+    void SetDepth(size_t depth);
+
+    /**
+     * 等待当前代号的任务全部处理完毕
+     *
+     * @return 超时返回 false
+     */
+    bool WaitIdle(int timeoutMs);
+
+    /**
+     * 停止后台线程并放弃待处理任务（析构时自动调用）
+     *
+     * @note 之后再次 UpdateQueue 会重新启动后台线程
+     */
+    void Stop();
+
+    Stats GetStats() const;
+
+private:
+    void WorkerLoop();
+    bool IsActiveStale();
+    void PrefetchOne(long long songId);
+    void MarkDoneLocked(long long songId);
+
+    Options m_Options;
+    CoverWarmer m_CoverWarmer;
+
+    mutable std::mutex m_Mutex;
+    std::condition_variable m_WorkCv;
+    std::condition_variable m_IdleCv;
+    std::vector<long long> m_Queue;             // 上次设置的队列（用于判断是否变化）
+    std::deque<long long> m_Pending;            // 当前代号待处理
+    std::unordered_set<long long> m_Done;       // 已预取（按 m_DoneOrder 淘汰）
+    std::deque<long long> m_DoneOrder;
+    bool m_Busy = false;                        // 工作线程正在处理任务
+    long long m_ActiveSong = 0;                 // 正在处理的歌曲
+    uint64_t m_ActiveGeneration = 0;            // 其所属代号（队列变化但仍包含它时沿用）
+    bool m_Stopping = false;
+    Stats m_Stats;
+
+    std::atomic<uint64_t> m_Generation{0};
+    std::thread m_Worker;
+};
+
+} // namespace Netease
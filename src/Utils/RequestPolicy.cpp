@@ -0,0 +1,473 @@
+/**
+ * RequestPolicy.cpp - 请求策略实现
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ */
+
+#include "RequestPolicy.h"
+#include <Windows.h>
+#include <unordered_map>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+
+#define LOG_TAG "POLICY"
+#include "SimpleLog.h"
+
+namespace Netease::Http {
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+// 每个主机保留最近多少个延迟样本
+const size_t LATENCY_WINDOW = 128;
+
+// 对冲线程数：同时在途的对冲请求上限（对冲只发生在 p95 之外，通常远小于此）
+const size_t HEDGE_WORKERS = 2;
+
+/**
+ * 主机键：scheme://host:port（小写），不含路径
+ */
+std::string HostKey(const std::string& url) {
+    size_t scheme = url.find("://");
+    size_t start = scheme == std::string::npos ? 0 : scheme + 3;
+    size_t end = url.find_first_of("/?#", start);
+    std::string key = url.substr(0, end == std::string::npos ? url.size() : end);
+    std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return key;
+}
+
+/**
+ * 临时失败：网络错误 / 超时 / 5xx / 429（值得重试，且计入熔断）
+ */
+bool IsTransient(const std::optional<Response>& response) {
+    return !response || response->status >= 500 || response->status == 429;
+}
+
+/**
+ * 完全抖动退避：[0, min(max, base * 2^(retry-1))]
+ */
+int JitteredBackoffMs(int retry, const PolicyOptions& options) {
+    thread_local std::mt19937 rng(std::random_device{}());
+    int shift = (std::min)(retry - 1, 16);
+    long long cap = (std::min)((long long)options.backoffBaseMs << shift, (long long)options.backoffMaxMs);
+    if (cap <= 0) return 0;
+    return (int)std::uniform_int_distribution<long long>(0, cap)(rng);
+}
+
+int64_t SteadyNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(SteadyClock::now().time_since_epoch()).count();
+}
+
+struct HostState {
+    std::vector<int> latencies;             // 环形缓冲区（成功请求的耗时）
+    size_t next = 0;
+    int consecutiveFailures = 0;
+    BreakerState breaker = BreakerState::Closed;
+    int64_t openUntilMs = 0;
+};
+
+/**
+ * 一轮尝试（首个请求 + 可能的对冲请求）的共享结果
+ */
+struct Race {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic<bool> primaryDone{false};
+    bool hedgeLaunched = false;
+    bool hedgeDone = false;
+    bool decided = false;                   // 已有非临时失败的结果
+    int winner = -1;                        // 0 = 首个请求，1 = 对冲请求
+    std::optional<Response> result;         // 胜出的响应，或最近一次失败响应
+
+    std::shared_ptr<Cancellation> primaryCancel = std::make_shared<Cancellation>();
+    std::shared_ptr<Cancellation> hedgeCancel = std::make_shared<Cancellation>();
+
+    /**
+     * 提交一个请求的结果（调用方持有 mutex）
+     */
+    void OfferLocked(int index, std::optional<Response> response) {
+        if (decided) return;
+        if (!IsTransient(response)) {
+            decided = true;
+            winner = index;
+            result = std::move(response);
+        } else if (response) {
+            result = std::move(response);
+        }
+    }
+};
+
+/**
+ * 等待发出的对冲请求
+ */
+struct HedgeTask {
+    std::string key;
+    std::string url;
+    Options options;
+    std::shared_ptr<Race> race;
+    SteadyClock::time_point deadline;
+};
+
+} // namespace
+
+struct RequestPolicy::Shared {
+    mutable std::mutex mutex;
+    PolicyOptions options;
+    std::unordered_map<std::string, HostState> hosts;
+    PolicyStats stats;
+
+    Fetcher fetch;
+    Clock clock;
+
+    // 对冲线程：首次需要对冲时启动，Shutdown 时取消在途请求并 join
+    std::mutex hedgeMutex;
+    std::condition_variable hedgeCv;
+    std::vector<HedgeTask> hedgeQueue;
+    std::vector<std::shared_ptr<Race>> hedgeRunning;
+    std::vector<std::thread> hedgeWorkers;
+    bool stopping = false;
+
+    int HedgeDelayLocked(const HostState& host) const {
+        if (host.latencies.size() < (std::max)(options.hedgeMinSamples, (size_t)1)) {
+            return options.hedgeDefaultDelayMs;
+        }
+        std::vector<int> samples = host.latencies;
+        double percentile = (std::min)((std::max)(options.hedgePercentile, 0.0), 1.0);
+        size_t rank = (size_t)(percentile * (samples.size() - 1) + 0.5);
+        std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+        return (std::max)(samples[rank], options.hedgeMinDelayMs);
+    }
+
+    /**
+     * 熔断准入
+     *
+     * @param probe 输出：本次请求是否为半开状态下的探测请求
+     * @return false 表示应直接失败
+     */
+    bool AdmitLocked(HostState& host, bool& probe) {
+        probe = false;
+        switch (host.breaker) {
+            case BreakerState::Closed:
+                return true;
+            case BreakerState::Open:
+                if (clock() < host.openUntilMs) return false;
+                host.breaker = BreakerState::HalfOpen;
+                probe = true;
+                return true;
+            case BreakerState::HalfOpen:
+                return false;   // 只放行一个探测请求
+        }
+        return true;
+    }
+
+    void RecordLatencyLocked(HostState& host, int latencyMs) {
+        if (host.latencies.size() < LATENCY_WINDOW) {
+            host.latencies.push_back(latencyMs);
+        } else {
+            host.latencies[host.next] = latencyMs;
+            host.next = (host.next + 1) % LATENCY_WINDOW;
+        }
+    }
+
+    /**
+     * 记录一轮尝试的最终成败（对冲的两个请求合计一次）
+     */
+    void RecordOutcomeLocked(const std::string& key, HostState& host, bool transient, bool probe) {
+        if (!transient) {
+            host.consecutiveFailures = 0;
+            if (host.breaker != BreakerState::Closed) {
+                LOG_INFO("主机恢复，熔断关闭: " << key);
+                host.breaker = BreakerState::Closed;
+            }
+            return;
+        }
+
+        host.consecutiveFailures++;
+        bool trip = probe ||
+            (host.breaker == BreakerState::Closed && host.consecutiveFailures >= options.breakerThreshold);
+        if (trip) {
+            host.breaker = BreakerState::Open;
+            host.openUntilMs = clock() + options.breakerCooldownMs;
+            LOG_WARN("连续失败 " << host.consecutiveFailures << " 次，熔断打开 " << options.breakerCooldownMs
+                     << "ms: " << key);
+        }
+    }
+
+    /**
+     * 发出一个请求并记录延迟；被取消的请求按已等待的时间计入（至少这么慢）
+     */
+    std::optional<Response> Attempt(const std::string& key, const std::string& url, const Options& options) {
+        auto start = SteadyClock::now();
+        std::optional<Response> response = fetch(url, options);
+        int latencyMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(SteadyClock::now() - start).count();
+
+        bool cancelled = options.cancel && options.cancel->IsCancelled();
+        if (!IsTransient(response) || cancelled) {
+            std::lock_guard<std::mutex> lock(mutex);
+            RecordLatencyLocked(hosts[key], latencyMs);
+        }
+        return response;
+    }
+
+    /**
+     * 登记对冲任务：deadline 前首个请求仍未返回则由对冲线程发出
+     *
+     * @return 已停止时返回 false（不对冲）
+     */
+    bool ScheduleHedge(HedgeTask task) {
+        {
+            std::lock_guard<std::mutex> lock(hedgeMutex);
+            if (stopping) return false;
+            hedgeQueue.push_back(std::move(task));
+            while (hedgeWorkers.size() < HEDGE_WORKERS) {
+                hedgeWorkers.emplace_back(&Shared::HedgeLoop, this);
+            }
+        }
+        hedgeCv.notify_all();
+        return true;
+    }
+
+    void HedgeLoop();
+    void RunHedge(HedgeTask& task);
+};
+
+RequestPolicy::RequestPolicy(const PolicyOptions& options, Fetcher fetcher, Clock clock)
+    : m_Shared(std::make_unique<Shared>())
+{
+    m_Shared->options = options;
+    m_Shared->fetch = fetcher ? std::move(fetcher) : Fetcher([](const std::string& url, const Options& options) {
+        return Http::Get(url, options);
+    });
+    m_Shared->clock = clock ? std::move(clock) : Clock(SteadyNowMs);
+}
+
+RequestPolicy::RequestPolicy()
+    : RequestPolicy(PolicyOptions())
+{
+}
+
+RequestPolicy::~RequestPolicy() {
+    Shutdown();
+}
+
+RequestPolicy& RequestPolicy::Default() {
+    static RequestPolicy* policy = new RequestPolicy();
+    return *policy;
+}
+
+// ============================================================================
+// 请求
+// ============================================================================
+
+std::optional<Response> RequestPolicy::Get(const std::string& url, const Options& options) {
+    Shared* shared = m_Shared.get();
+    std::string key = HostKey(url);
+
+    PolicyOptions policy;
+    {
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        policy = shared->options;
+        shared->stats.requests++;
+    }
+
+    std::optional<Response> last;
+    int rounds = (std::max)(policy.maxAttempts, 1);
+    for (int round = 0; round < rounds; ++round) {
+        if (round > 0) {
+            int backoff = JitteredBackoffMs(round, policy);
+            LOG_DEBUG("第 " << round << " 次重试，等待 " << backoff << "ms: " << url);
+            std::this_thread::sleep_for(std::chrono::milliseconds(backoff));
+        }
+
+        bool probe = false;
+        int hedgeDelay = 0;
+        {
+            std::lock_guard<std::mutex> lock(shared->mutex);
+            HostState& host = shared->hosts[key];
+            if (!shared->AdmitLocked(host, probe)) {
+                shared->stats.shortCircuited++;
+                LOG_DEBUG("熔断中，直接失败: " << url);
+                return last;
+            }
+            if (round > 0) shared->stats.retries++;
+            shared->stats.attempts++;
+            hedgeDelay = (std::min)(shared->HedgeDelayLocked(host), options.timeoutMs);
+        }
+
+        // 首个请求超过对冲延迟仍未返回：对冲线程再发一个（探测请求不对冲）
+        auto race = std::make_shared<Race>();
+        Options primaryOptions = options;
+        primaryOptions.cancel = race->primaryCancel;
+        if (policy.hedge && !probe) {
+            Options hedgeOptions = options;
+            hedgeOptions.cancel = race->hedgeCancel;
+            shared->ScheduleHedge({ key, url, std::move(hedgeOptions), race,
+                                    SteadyClock::now() + std::chrono::milliseconds(hedgeDelay) });
+        }
+
+        // 首个请求在调用线程上执行
+        std::optional<Response> response = shared->Attempt(key, url, primaryOptions);
+
+        std::unique_lock<std::mutex> lock(race->mutex);
+        race->primaryDone = true;
+        race->OfferLocked(0, std::move(response));
+        bool cancelHedge = race->decided && race->hedgeLaunched && !race->hedgeDone;
+        if (cancelHedge) {
+            race->hedgeCancel->Cancel();    // 首个请求胜出：中断落后的对冲请求
+        }
+
+        // 首个请求失败而对冲请求仍在途：等待其结果
+        race->cv.wait(lock, [&] { return race->decided || !race->hedgeLaunched || race->hedgeDone; });
+        bool decided = race->decided;
+        int winner = race->winner;
+        std::optional<Response> result = std::move(race->result);
+        lock.unlock();
+        shared->hedgeCv.notify_all();       // 未发出的对冲任务可以丢弃了
+
+        {
+            std::lock_guard<std::mutex> statsLock(shared->mutex);
+            shared->RecordOutcomeLocked(key, shared->hosts[key], !decided, probe);
+            if (winner == 1) shared->stats.hedgeWins++;
+        }
+
+        if (decided) return result;
+        if (result) {
+            last = std::move(result);
+        }
+    }
+
+    LOG_WARN("重试 " << rounds << " 轮后仍失败: " << url);
+    return last;
+}
+
+// ============================================================================
+// 对冲线程
+// ============================================================================
+
+void RequestPolicy::Shared::HedgeLoop() {
+    std::unique_lock<std::mutex> lock(hedgeMutex);
+    while (!stopping) {
+        // 首个请求已返回的任务直接丢弃
+        hedgeQueue.erase(std::remove_if(hedgeQueue.begin(), hedgeQueue.end(),
+            [](const HedgeTask& task) { return task.race->primaryDone.load(); }), hedgeQueue.end());
+        if (hedgeQueue.empty()) {
+            hedgeCv.wait(lock);
+            continue;
+        }
+
+        auto next = std::min_element(hedgeQueue.begin(), hedgeQueue.end(),
+            [](const HedgeTask& a, const HedgeTask& b) { return a.deadline < b.deadline; });
+        if (SteadyClock::now() < next->deadline) {
+            hedgeCv.wait_until(lock, next->deadline);
+            continue;
+        }
+
+        HedgeTask task = std::move(*next);
+        hedgeQueue.erase(next);
+        {
+            std::lock_guard<std::mutex> raceLock(task.race->mutex);
+            if (task.race->primaryDone) continue;
+            task.race->hedgeLaunched = true;
+        }
+        hedgeRunning.push_back(task.race);
+
+        lock.unlock();
+        RunHedge(task);
+        lock.lock();
+        hedgeRunning.erase(std::find(hedgeRunning.begin(), hedgeRunning.end(), task.race));
+    }
+}
+
+void RequestPolicy::Shared::RunHedge(HedgeTask& task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.hedged++;
+        stats.attempts++;
+    }
+    LOG_DEBUG("超过对冲延迟未返回，发出对冲请求: " << task.url);
+
+    std::optional<Response> response = Attempt(task.key, task.url, task.options);
+
+    Race& race = *task.race;
+    bool cancelPrimary = false;
+    {
+        std::lock_guard<std::mutex> lock(race.mutex);
+        race.hedgeDone = true;
+        race.OfferLocked(1, std::move(response));
+        cancelPrimary = race.decided && race.winner == 1 && !race.primaryDone;
+    }
+    if (cancelPrimary) {
+        race.primaryCancel->Cancel();       // 对冲请求胜出：中断阻塞中的首个请求
+    }
+    race.cv.notify_all();
+}
+
+void RequestPolicy::Shutdown() {
+    Shared* shared = m_Shared.get();
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(shared->hedgeMutex);
+        shared->stopping = true;
+        shared->hedgeQueue.clear();
+        for (const auto& race : shared->hedgeRunning) {
+            race->hedgeCancel->Cancel();
+        }
+        workers.swap(shared->hedgeWorkers);
+    }
+    shared->hedgeCv.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+
+    // 之后的对冲请求重新启动线程
+    std::lock_guard<std::mutex> lock(shared->hedgeMutex);
+    shared->stopping = false;
+}
+
+// ============================================================================
+// 配置与状态
+// ============================================================================
+
+void RequestPolicy::SetOptions(const PolicyOptions& options) {
+    std::lock_guard<std::mutex> lock(m_Shared->mutex);
+    m_Shared->options = options;
+}
+
+PolicyOptions RequestPolicy::GetOptions() const {
+    std::lock_guard<std::mutex> lock(m_Shared->mutex);
+    return m_Shared->options;
+}
+
+int RequestPolicy::GetHedgeDelayMs(const std::string& url) const {
+    std::lock_guard<std::mutex> lock(m_Shared->mutex);
+    auto it = m_Shared->hosts.find(HostKey(url));
+    if (it == m_Shared->hosts.end()) return m_Shared->options.hedgeDefaultDelayMs;
+    return m_Shared->HedgeDelayLocked(it->second);
+}
+
+BreakerState RequestPolicy::GetBreakerState(const std::string& url) const {
+    std::lock_guard<std::mutex> lock(m_Shared->mutex);
+    auto it = m_Shared->hosts.find(HostKey(url));
+    return it == m_Shared->hosts.end() ? BreakerState::Closed : it->second.breaker;
+}
+
+PolicyStats RequestPolicy::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_Shared->mutex);
+    return m_Shared->stats;
+}
+
+void RequestPolicy::Reset() {
+    std::lock_guard<std::mutex> lock(m_Shared->mutex);
+    m_Shared->hosts.clear();
+    m_Shared->stats = PolicyStats();
+}
+
+} // namespace Netease::Http
@@ -0,0 +1,134 @@
+#pragma once
+#include <string>
+#include <optional>
+#include <memory>
+#include <functional>
+#include <cstdint>
+#include "HttpClient.h"
+
+/**
+ * RequestPolicy.h - 请求策略：对冲请求 / 抖动重试 / 按主机熔断
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ *
+ * 旧实现每次请求固定 8 秒超时且不重试：一次慢响应就让调用方等满整个超时窗口，
+ * 服务端短暂故障时每首歌都要各自超时一遍。本模块包在 Http::Get 外层：
+ * - 对冲：首次尝试在调用线程上执行，超过该主机近期延迟的 p95 仍未返回时，
+ *   由固定数量的对冲线程再发一个相同请求，先返回的结果胜出（GET 幂等），
+ *   落后的一方通过取消令牌中断
+ * - 重试：网络错误 / 超时 / 5xx / 429 视为临时失败，按"完全抖动"指数退避重试
+ * - 熔断：同一主机连续临时失败达到阈值后打开，冷却期内直接失败；
+ *   冷却结束放行一个探测请求（半开），成功后关闭。
+ *   每轮尝试（首个请求 + 对冲请求）只按最终结果计一次成败
+ *
+ * API 请求与封面下载共用进程内默认实例（Default）。
+ */
+
+namespace Netease::Http {
+
+    /**
+     * 策略参数
+     */
+    struct PolicyOptions {
+        // 重试
+        int maxAttempts = 3;                // 每个请求最多几轮（含首轮）
+        int backoffBaseMs = 200;            // 第 n 次重试在 [0, base * 2^(n-1)] 内随机等待
+        int backoffMaxMs = 2000;
+
+        // 对冲
+        bool hedge = true;
+        double hedgePercentile = 0.95;      // 按该分位数决定何时发出对冲请求
+        size_t hedgeMinSamples = 20;        // 样本不足时使用默认延迟
+        int hedgeDefaultDelayMs = 1000;
+        int hedgeMinDelayMs = 20;           // 下限：避免极快主机上每个请求都被对冲
+
+        // 熔断
+        int breakerThreshold = 5;           // 连续临时失败次数
+        int breakerCooldownMs = 10000;      // 打开后多久放行探测请求
+    };
+
+    enum class BreakerState {
+        Closed,     // 正常
+        Open,       // 冷却中，直接失败
+        HalfOpen    // 探测请求在途
+    };
+
+    /**
+     * 累计统计
+     */
+    struct PolicyStats {
+        uint64_t requests = 0;              // Get 调用次数
+        uint64_t attempts = 0;              // 实际发出的 HTTP 请求（含对冲）
+        uint64_t hedged = 0;                // 发出对冲请求的次数
+        uint64_t hedgeWins = 0;             // 对冲请求先返回的次数
+        uint64_t retries = 0;               // 重试轮数
+        uint64_t shortCircuited = 0;        // 熔断直接失败的请求数
+    };
+
+    class RequestPolicy {
+    public:
+        /**
+         * 发出单个 HTTP 请求（默认 Http::Get；测试可替换为桩）
+         */
+        using Fetcher = std::function<std::optional<Response>(const std::string& url, const Options& options)>;
+
+        /**
+         * 单调时钟（毫秒），决定熔断冷却；默认 steady_clock
+         */
+        using Clock = std::function<int64_t()>;
+
+        explicit RequestPolicy(const PolicyOptions& options, Fetcher fetcher = nullptr, Clock clock = nullptr);
+        RequestPolicy();
+
+        /**
+         * 调用 Shutdown
+         */
+        ~RequestPolicy();
+
+        RequestPolicy(const RequestPolicy&) = delete;
+        RequestPolicy& operator=(const RequestPolicy&) = delete;
+
+        /**
+         * 进程内默认实例（API / 封面下载共用，刻意不析构；对冲线程由 API::Shutdown 停止）
+         */
+        static RequestPolicy& Default();
+
+        /**
+         * 按策略发送 GET 请求
+         *
+         * @return 与 Http::Get 相同；重试用尽时返回最后一次的响应（可能为 5xx），
+         *         全部为网络错误或被熔断时返回 nullopt
+         * @note options.cancel 由策略内部使用（中断落后的请求），调用方设置的值会被替换
+         */
+        std::optional<Response> Get(const std::string& url, const Options& options);
+
+        void SetOptions(const PolicyOptions& options);
+        PolicyOptions GetOptions() const;
+
+        /**
+         * 当前对冲延迟（主机由 URL 的 scheme://host:port 决定）
+         */
+        int GetHedgeDelayMs(const std::string& url) const;
+
+        BreakerState GetBreakerState(const std::string& url) const;
+
+        PolicyStats GetStats() const;
+
+        /**
+         * 清空延迟样本、熔断状态与统计
+         */
+        void Reset();
+
+        /**
+         * 停止对冲线程：取消在途的对冲请求并 join（可重复调用）
+         *
+         * @note 之后再需要对冲时重新启动线程
+         */
+        void Shutdown();
+
+    private:
+        struct Shared;
+        std::unique_ptr<Shared> m_Shared;
+    };
+
+} // namespace Netease::Http
@@ -0,0 +1,211 @@
+/**
+ * ValidatorStore.cpp - 歌词缓存验证器实现
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ */
+
+#include "ValidatorStore.h"
+#include <Windows.h>
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+
+#define LOG_TAG "VALIDATOR"
+#include "SimpleLog.h"
+
+namespace Netease {
+
+namespace {
+
+// 合并 304 确认的落盘间隔
+const int64_t PERSIST_INTERVAL_MS = 2000;
+
+// sidecar 以制表符分隔；含控制字符的值（不合规的响应头）不保存
+bool IsStorable(const std::string& value) {
+    return std::none_of(value.begin(), value.end(), [](char c) { return c == '\t' || c == '\r' || c == '\n'; });
+}
+
+} // namespace
+
+ValidatorStore::ValidatorStore(std::string persistPath, size_t maxEntries, Clock clock)
+    : m_PersistPath(std::move(persistPath))
+    , m_MaxEntries(maxEntries)
+    , m_Clock(std::move(clock))
+{
+}
+
+int64_t ValidatorStore::Now() const {
+    if (m_Clock) return m_Clock();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// ============================================================================
+// 查询
+// ============================================================================
+
+std::optional<ValidatorStore::Entry> ValidatorStore::Lookup(long long songId) const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    EnsureLoadedLocked();
+
+    auto it = m_Entries.find(songId);
+    if (it == m_Entries.end()) return std::nullopt;
+    return it->second;
+}
+
+std::vector<long long> ValidatorStore::CollectStale(int64_t maxAgeMs, size_t limit) const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    EnsureLoadedLocked();
+
+    int64_t cutoff = Now() - maxAgeMs;
+    std::vector<std::pair<int64_t, long long>> stale;
+    for (const auto& [songId, entry] : m_Entries) {
+        if (entry.validatedMs <= cutoff) stale.emplace_back(entry.validatedMs, songId);
+    }
+
+    if (limit > 0 && stale.size() > limit) {
+        std::partial_sort(stale.begin(), stale.begin() + limit, stale.end());
+        stale.resize(limit);
+    } else {
+        std::sort(stale.begin(), stale.end());
+    }
+
+    std::vector<long long> result;
+    result.reserve(stale.size());
+    for (const auto& item : stale) result.push_back(item.second);
+    return result;
+}
+
+size_t ValidatorStore::Size() const {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    EnsureLoadedLocked();
+    return m_Entries.size();
+}
+
+// ============================================================================
+// 记录
+// ============================================================================
+
+void ValidatorStore::Record(long long songId, const std::string& etag, const std::string& lastModified) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    EnsureLoadedLocked();
+
+    Entry& entry = m_Entries[songId];
+    entry.etag = IsStorable(etag) ? etag : "";
+    entry.lastModified = IsStorable(lastModified) ? lastModified : "";
+    entry.validatedMs = Now();
+
+    EvictLocked(songId);
+    MarkDirtyLocked();
+}
+
+void ValidatorStore::Touch(long long songId) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    EnsureLoadedLocked();
+
+    auto it = m_Entries.find(songId);
+    if (it == m_Entries.end()) return;
+    it->second.validatedMs = Now();
+    MarkDirtyLocked();
+}
+
+void ValidatorStore::Forget(long long songId) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    EnsureLoadedLocked();
+
+    if (m_Entries.erase(songId) > 0) {
+        MarkDirtyLocked();
+    }
+}
+
+void ValidatorStore::Clear() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Entries.clear();
+    m_Loaded = true;
+    m_Dirty = false;
+    if (!m_PersistPath.empty()) {
+        DeleteFileA(m_PersistPath.c_str());
+    }
+}
+
+void ValidatorStore::Flush() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_Dirty) PersistLocked();
+}
+
+void ValidatorStore::EvictLocked(long long keep) {
+    if (m_Entries.size() <= m_MaxEntries) return;
+
+    // 淘汰最久未确认的条目（刚写入的条目除外）
+    std::vector<std::pair<int64_t, long long>> order;
+    order.reserve(m_Entries.size());
+    for (const auto& [songId, entry] : m_Entries) {
+        if (songId != keep) order.emplace_back(entry.validatedMs, songId);
+    }
+    size_t excess = (std::min)(m_Entries.size() - m_MaxEntries, order.size());
+    std::nth_element(order.begin(), order.begin() + excess, order.end());
+    for (size_t i = 0; i < excess; ++i) m_Entries.erase(order[i].second);
+}
+
+// ============================================================================
+// 磁盘 sidecar
+//   每行: <songId>\t<validatedMs>\t<etag>\t<lastModified>
+// ============================================================================
+
+void ValidatorStore::EnsureLoadedLocked() const {
+    if (m_Loaded) return;
+    m_Loaded = true;
+    if (m_PersistPath.empty()) return;
+
+    std::ifstream ifs(m_PersistPath);
+    if (!ifs) return;
+
+    std::string line;
+    while (std::getline(ifs, line)) {
+        size_t t1 = line.find('\t');
+        size_t t2 = t1 == std::string::npos ? t1 : line.find('\t', t1 + 1);
+        size_t t3 = t2 == std::string::npos ? t2 : line.find('\t', t2 + 1);
+        if (t3 == std::string::npos) continue;
+
+        try {
+            long long songId = std::stoll(line.substr(0, t1));
+            Entry entry;
+            entry.validatedMs = std::stoll(line.substr(t1 + 1, t2 - t1 - 1));
+            entry.etag = line.substr(t2 + 1, t3 - t2 - 1);
+            entry.lastModified = line.substr(t3 + 1);
+            m_Entries[songId] = std::move(entry);
+        } catch (...) {
+            // 损坏的行直接跳过
+        }
+    }
+    LOG_DEBUG("已加载 " << m_Entries.size() << " 条验证器");
+}
+
+void ValidatorStore::MarkDirtyLocked() {
+    m_Dirty = true;
+    if (Now() - m_LastPersistMs >= PERSIST_INTERVAL_MS) {
+        PersistLocked();
+    }
+}
+
+void ValidatorStore::PersistLocked() {
+    m_Dirty = false;
+    m_LastPersistMs = Now();
+    if (m_PersistPath.empty()) return;
+
+    std::string tmpPath = m_PersistPath + ".tmp";
+    {
+        std::ofstream ofs(tmpPath, std::ios::trunc);
+        if (!ofs) return;
+        for (const auto& [songId, entry] : m_Entries) {
+            ofs << songId << '\t' << entry.validatedMs << '\t' << entry.etag << '\t' << entry.lastModified << '\n';
+        }
+    }
+
+    if (!MoveFileExA(tmpPath.c_str(), m_PersistPath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        LOG_WARN("写入验证器 sidecar 失败: " << m_PersistPath);
+        DeleteFileA(tmpPath.c_str());
+    }
+}
+
+} // namespace Netease
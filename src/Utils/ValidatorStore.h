@@ -0,0 +1,96 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <optional>
+#include <functional>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+
+/**
+ * ValidatorStore.h - 歌词缓存验证器 (ETag / Last-Modified)
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ *
+ * 旧实现的强制刷新（GetLyric(id, false) / FetchLyricOnline）总是下载完整响应，
+ * 也没有任何机制判断缓存是否过期。本模块记录在线获取歌词时服务端返回的验证器：
+ * - 刷新时发送 If-None-Match / If-Modified-Since，304 即确认缓存仍然有效
+ * - 记录最近一次确认有效的时间，供后台任务挑选过期条目
+ * - 内存 + 磁盘（文本 sidecar，与失败结果缓存同目录）；
+ *   批量刷新时 304 确认很密集，磁盘写入合并为每 2 秒最多一次，Flush 立即写入
+ * - 时钟可注入，便于测试
+ */
+
+namespace Netease {
+
+class ValidatorStore {
+public:
+    struct Entry {
+        std::string etag;               // ETag 原样保存（含引号 / W/ 前缀）
+        std::string lastModified;       // Last-Modified 原样保存
+        int64_t validatedMs = 0;        // 最近一次下载或 304 确认的时间
+
+        bool CanRevalidate() const { return !etag.empty() || !lastModified.empty(); }
+    };
+
+    /**
+     * 时钟：返回 Unix 纪元毫秒
+     */
+    using Clock = std::function<int64_t()>;
+
+    /**
+     * @param persistPath 磁盘 sidecar 路径，为空时仅内存
+     * @param maxEntries 超出时淘汰最久未确认的条目
+     * @param clock 时钟，为空时使用系统时间
+     */
+    ValidatorStore(std::string persistPath, size_t maxEntries, Clock clock = {});
+    explicit ValidatorStore(std::string persistPath = "") : ValidatorStore(std::move(persistPath), 20000) {}
+
+    std::optional<Entry> Lookup(long long songId) const;
+
+    /**
+     * 记录完整下载得到的验证器（两者都为空时仍记录时间，用于过期判断）
+     */
+    void Record(long long songId, const std::string& etag, const std::string& lastModified);
+
+    /**
+     * 304 确认：只更新确认时间
+     */
+    void Touch(long long songId);
+
+    void Forget(long long songId);
+    void Clear();
+
+    /**
+     * 立即写入尚未落盘的变更
+     */
+    void Flush();
+
+    /**
+     * 列出超过 maxAgeMs 未确认的歌曲，最久未确认的在前
+     *
+     * @param limit 最多返回多少首，0 = 不限制
+     */
+    std::vector<long long> CollectStale(int64_t maxAgeMs, size_t limit = 0) const;
+
+    size_t Size() const;
+
+private:
+    int64_t Now() const;
+    void EnsureLoadedLocked() const;
+    void MarkDirtyLocked();
+    void PersistLocked();
+    void EvictLocked(long long keep);
+
+    std::string m_PersistPath;
+    size_t m_MaxEntries;
+    Clock m_Clock;
+
+    mutable std::mutex m_Mutex;
+    mutable bool m_Loaded = false;
+    mutable std::unordered_map<long long, Entry> m_Entries;
+    bool m_Dirty = false;
+    int64_t m_LastPersistMs = 0;
+};
+
+} // namespace Netease
@@ -0,0 +1,252 @@
+/**
+ * WordTimeline.cpp - 逐字歌词 (yrc) 解析与播放游标实现
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ */
+
+#include "NeteaseAPI.h"
+#include "LrcParser.h"
+#include <algorithm>
+#include <charconv>
+#include <numeric>
+
+namespace Netease {
+
+namespace {
+
+// 顺序前进时最多逐项步进几次，超过则视为跳转，改用二分查找
+const int MAX_FORWARD_STEPS = 4;
+
+/**
+ * 解析 "<a>,<b>" 或 "<a>,<b>,<c>" 形式的数字组，p 指向第一个数字，close 为结束符
+ *
+ * @return 成功时返回结束符之后的位置，失败返回 nullptr
+ */
+const char* ParseNumberGroup(const char* p, const char* end, char close, int64_t* values, int count) {
+    for (int i = 0; i < count; ++i) {
+        if (p == end || *p < '0' || *p > '9') return nullptr;
+        auto [next, ec] = std::from_chars(p, end, values[i]);
+        if (ec != std::errc() || next == end) return nullptr;
+        char expected = i + 1 < count ? ',' : close;
+        if (*next != expected) return nullptr;
+        p = next + 1;
+    }
+    return p;
+}
+
+/**
+ * 字标签 "(开始,时长,0)"；第三个数字（保留字段）可省略
+ */
+const char* ParseWordTag(const char* p, const char* end, int64_t& startMs, int64_t& durationMs) {
+    if (p == end || *p != '(') return nullptr;
+    int64_t values[3] = {};
+    const char* next = ParseNumberGroup(p + 1, end, ')', values, 3);
+    if (!next) next = ParseNumberGroup(p + 1, end, ')', values, 2);
+    if (!next) return nullptr;
+    startMs = values[0];
+    durationMs = values[1];
+    return next;
+}
+
+/**
+ * 按行开始时间稳定重排（yrc 几乎总是有序，只在检测到乱序时调用）
+ */
+void SortLines(WordTimeline& timeline) {
+    size_t lines = timeline.LineCount();
+    std::vector<uint32_t> order(lines);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return timeline.lineStartMs[a] < timeline.lineStartMs[b];
+    });
+
+    WordTimeline sorted;
+    sorted.lineStartMs.reserve(lines);
+    sorted.lineDurationMs.reserve(lines);
+    sorted.lineFirstWord.reserve(lines + 1);
+    sorted.wordStartMs.reserve(timeline.WordCount());
+    sorted.wordDurationMs.reserve(timeline.WordCount());
+    sorted.wordTextOffset.reserve(timeline.WordCount() + 1);
+    sorted.arena.reserve(timeline.arena.size());
+
+    for (uint32_t line : order) {
+        sorted.lineStartMs.push_back(timeline.lineStartMs[line]);
+        sorted.lineDurationMs.push_back(timeline.lineDurationMs[line]);
+        sorted.lineFirstWord.push_back((uint32_t)sorted.wordStartMs.size());
+        for (uint32_t word = timeline.LineWordBegin(line); word < timeline.LineWordEnd(line); ++word) {
+            sorted.wordStartMs.push_back(timeline.wordStartMs[word]);
+            sorted.wordDurationMs.push_back(timeline.wordDurationMs[word]);
+            sorted.wordTextOffset.push_back((uint32_t)sorted.arena.size());
+            sorted.arena.append(timeline.WordText(word));
+        }
+    }
+    sorted.lineFirstWord.push_back((uint32_t)sorted.wordStartMs.size());
+    sorted.wordTextOffset.push_back((uint32_t)sorted.arena.size());
+    timeline = std::move(sorted);
+}
+
+} // namespace
+
+// ============================================================================
+// 解析
+// ============================================================================
+
+WordTimeline API::ParseWordTimeline(std::string_view yrc) {
+    WordTimeline timeline;
+    size_t lines = Lrc::CountLines(yrc);
+    timeline.lineStartMs.reserve(lines);
+    timeline.lineDurationMs.reserve(lines);
+    timeline.lineFirstWord.reserve(lines + 1);
+    // 每个字至少占 "(a,b,0)" 7 字节加 1 字节文本
+    timeline.wordStartMs.reserve(yrc.size() / 8);
+    timeline.wordDurationMs.reserve(yrc.size() / 8);
+    timeline.wordTextOffset.reserve(yrc.size() / 8 + 1);
+    timeline.arena.reserve(yrc.size() / 2);
+
+    bool sorted = true;
+    size_t pos = 0;
+    while (pos < yrc.size()) {
+        size_t lineEnd = yrc.find('\n', pos);
+        if (lineEnd == std::string_view::npos) lineEnd = yrc.size();
+        const char* p = yrc.data() + pos;
+        const char* end = yrc.data() + lineEnd;
+        pos = lineEnd + 1;
+
+        if (p != end && end[-1] == '\r') --end;
+        while (p != end && (*p == ' ' || *p == '\t')) ++p;
+        // JSON 署名行 ({"t":0,"c":[...]}) 与空行
+        if (p == end || *p != '[') continue;
+
+        int64_t header[2] = {};
+        p = ParseNumberGroup(p + 1, end, ']', header, 2);
+        if (!p) continue;
+
+        if (!timeline.lineStartMs.empty() && header[0] < timeline.lineStartMs.back()) sorted = false;
+        timeline.lineStartMs.push_back(header[0]);
+        timeline.lineDurationMs.push_back((int32_t)header[1]);
+        timeline.lineFirstWord.push_back((uint32_t)timeline.wordStartMs.size());
+
+        int64_t startMs = 0;
+        int64_t durationMs = 0;
+        const char* next = ParseWordTag(p, end, startMs, durationMs);
+        while (next) {
+            // 文本一直延续到下一个合法的字标签（歌词中的 "(" 保留为文本）
+            const char* text = next;
+            int64_t nextStart = 0;
+            int64_t nextDuration = 0;
+            const char* following = nullptr;
+            const char* scan = text;
+            while (scan != end) {
+                scan = std::find(scan, end, '(');
+                if (scan == end) break;
+                following = ParseWordTag(scan, end, nextStart, nextDuration);
+                if (following) break;
+                ++scan;
+            }
+
+            // 旧格式中字时间相对于行开始
+            if (startMs < header[0]) startMs += header[0];
+            if (timeline.wordStartMs.size() > timeline.lineFirstWord.back() && startMs < timeline.wordStartMs.back()) {
+                startMs = timeline.wordStartMs.back();
+            }
+            timeline.wordStartMs.push_back(startMs);
+            timeline.wordDurationMs.push_back((int32_t)durationMs);
+            timeline.wordTextOffset.push_back((uint32_t)timeline.arena.size());
+            timeline.arena.append(text, scan - text);
+
+            next = following;
+            startMs = nextStart;
+            durationMs = nextDuration;
+        }
+    }
+    timeline.lineFirstWord.push_back((uint32_t)timeline.wordStartMs.size());
+    timeline.wordTextOffset.push_back((uint32_t)timeline.arena.size());
+
+    if (!sorted) SortLines(timeline);
+    return timeline;
+}
+
+// ============================================================================
+// 游标
+// ============================================================================
+
+const WordCursor::Position& WordCursor::Update(int64_t timeMs) {
+    const WordTimeline& timeline = m_Timeline;
+    const int lines = (int)timeline.LineCount();
+    if (lines == 0) {
+        m_Position = Position();
+        m_LastMs = timeMs;
+        return m_Position;
+    }
+
+    // 1. 行：顺序前进时逐行步进，回退或跨越多行时二分查找
+    int line = m_Position.line;
+    bool seek = timeMs < m_LastMs;
+    if (!seek) {
+        for (int steps = 0; line + 1 < lines && timeline.lineStartMs[line + 1] <= timeMs; ++steps) {
+            if (steps == MAX_FORWARD_STEPS) {
+                seek = true;
+                break;
+            }
+            ++line;
+        }
+    }
+    if (seek) {
+        m_Seeks++;
+        auto it = std::upper_bound(timeline.lineStartMs.begin(), timeline.lineStartMs.end(), timeMs);
+        line = (int)(it - timeline.lineStartMs.begin()) - 1;
+    }
+
+    // 2. 字：同一行内从上次的位置继续
+    int word = -1;
+    if (line >= 0) {
+        const int begin = (int)timeline.LineWordBegin(line);
+        const int end = (int)timeline.LineWordEnd(line);
+        bool search = seek;
+        word = (!seek && line == m_Position.line) ? m_Position.word : -1;
+        if (!search) {
+            int current = word < 0 ? begin - 1 : word;
+            for (int steps = 0; current + 1 < end && timeline.wordStartMs[current + 1] <= timeMs; ++steps) {
+                if (steps == MAX_FORWARD_STEPS) {
+                    search = true;
+                    break;
+                }
+                ++current;
+            }
+            word = current < begin ? -1 : current;
+        }
+        if (search) {
+            auto first = timeline.wordStartMs.begin() + begin;
+            auto it = std::upper_bound(first, timeline.wordStartMs.begin() + end, timeMs);
+            word = it == first ? -1 : (int)(it - timeline.wordStartMs.begin()) - 1;
+        }
+    }
+
+    m_Position.line = line;
+    m_Position.word = word;
+    m_Position.wordFill = 0.0f;
+    if (word >= 0) {
+        int32_t duration = timeline.wordDurationMs[word];
+        float fill = duration <= 0 ? 1.0f : (float)(timeMs - timeline.wordStartMs[word]) / (float)duration;
+        m_Position.wordFill = (std::min)((std::max)(fill, 0.0f), 1.0f);
+    }
+    m_LastMs = timeMs;
+    return m_Position;
+}
+
+float WordCursor::FillOf(size_t word) const {
+    if (m_Position.line < 0) return 0.0f;
+    if (m_Position.word >= 0) {
+        if ((int)word < m_Position.word) return 1.0f;
+        if ((int)word == m_Position.word) return m_Position.wordFill;
+        return 0.0f;
+    }
+    // 当前行已开始但第一个字还没开始：只有之前各行的字已唱完
+    return word < m_Timeline.LineWordBegin(m_Position.line) ? 1.0f : 0.0f;
+}
+
+void WordCursor::Reset() {
+    m_Position = Position();
+    m_LastMs = INT64_MIN;
+}
+
+} // namespace Netease
@@ -6,10 +6,35 @@
  */
 
 #include "../src/Utils/NeteaseAPI.h"
+#include "../src/Utils/JsonString.h"
+#include "../src/Utils/LyricCacheIndex.h"
+#include "../src/Utils/LyricPackStore.h"
+#include "../src/Utils/LyricCodec.h"
+#include "../src/Utils/NegativeCache.h"
+#include "../src/Utils/Prefetcher.h"
+#include "../src/Utils/Inflate.h"
+#include "../src/Utils/HttpClient.h"
+#include "../src/Utils/CacheRefresher.h"
+#include "../src/Utils/RequestPolicy.h"
+#include "../src/Utils/CacheBudget.h"
 #include <gtest/gtest.h>
+#include "httplib.h"    // 测试替身服务器（须在 Windows.h 之前包含）
 #include <Windows.h>
 #include <fstream>
+#include <sstream>
 #include <filesystem>
+#include <random>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <algorithm>
+#include <tuple>
+#include <functional>
+#include <map>
+#include <set>
+#include <regex>
+#include <shlobj.h>
 
 namespace fs = std::filesystem;
 
@@ -408,6 +433,2682 @@ TEST_F(NeteaseAPIPerformanceTest, CacheRead_IsFasterThanOnline) {
     EXPECT_LT(cacheDuration, onlineDuration) << "缓存读取应该比在线获取快";
 }
 
+// ============================================================================
+// 12. JSON 转义内核测试 (v0.1.4)
+// ============================================================================
+
+namespace {
+
+const Netease::Json::Kernel kAllKernels[] = {
+    Netease::Json::Kernel::Scalar,
+    Netease::Json::Kernel::SSE2,
+    Netease::Json::Kernel::AVX2
+};
+
+const char* KernelName(Netease::Json::Kernel k) {
+    switch (k) {
+        case Netease::Json::Kernel::Scalar: return "Scalar";
+        case Netease::Json::Kernel::SSE2: return "SSE2";
+        case Netease::Json::Kernel::AVX2: return "AVX2";
+        default: return "Auto";
+    }
+}
+
+// 模拟网易云歌词负载：时间戳 + 中文 \uXXXX + 换行
+std::string MakeEscapedLyricPayload(size_t targetBytes) {
+    std::string s;
+    int line = 0;
+    while (s.size() < targetBytes) {
+        char ts[32];
+        snprintf(ts, sizeof(ts), "[%02d:%02d.%02d]", line / 60, line % 60, (line * 7) % 100);
+        s += ts;
+        s += "Hello \\\"world\\\" \\u4f60\\u597d\\u4e16\\u754c \\ud83c\\udfb5 some ascii text here\\n";
+        line++;
+    }
+    return s;
+}
+
+} // namespace
+
+class JsonKernelTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        Netease::Json::SetKernel(Netease::Json::Kernel::Auto);
+    }
+};
+
+TEST_F(JsonKernelTest, Unescape_SurrogatePair_ToUtf8) {
+    for (auto k : kAllKernels) {
+        if (!Netease::Json::SetKernel(k)) continue;
+        std::string out;
+        size_t consumed = 0;
+        std::string_view in = "\\ud83c\\udfb5 \\u4f60\\u597d\"tail";
+        ASSERT_TRUE(Netease::Json::UnescapeString(in, out, &consumed)) << KernelName(k);
+        EXPECT_EQ(out, "\xF0\x9F\x8E\xB5 \xE4\xBD\xA0\xE5\xA5\xBD") << KernelName(k);
+        EXPECT_EQ(consumed, in.find("tail"));
+    }
+}
+
+TEST_F(JsonKernelTest, Unescape_LoneSurrogate_ReplacementChar) {
+    std::string out;
+    ASSERT_TRUE(Netease::Json::UnescapeString("\\ud83c x \\udfb5\"", out));
+    EXPECT_EQ(out, "\xEF\xBF\xBD x \xEF\xBF\xBD");
+}
+
+TEST_F(JsonKernelTest, Unescape_MissingQuote_ReturnsFalse) {
+    std::string out;
+    EXPECT_FALSE(Netease::Json::UnescapeString("no closing quote \\n", out));
+}
+
+TEST_F(JsonKernelTest, AllKernels_RoundTripAtEveryAlignment) {
+    // 在每个偏移处放置特殊字符，覆盖 16/32 字节块边界
+    const char specials[] = { '"', '\\', '\n', '\r', '\t', '\x01', '\x1f', 'A', '\xe4' };
+    for (auto k : kAllKernels) {
+        if (!Netease::Json::SetKernel(k)) continue;
+        for (size_t len = 0; len < 70; ++len) {
+            for (char sp : specials) {
+                std::string raw(len, 'x');
+                if (len > 0) raw[len / 2] = sp;
+                raw += sp;
+
+                std::string escaped;
+                Netease::Json::AppendEscaped(escaped, raw);
+                escaped += "\"";
+
+                std::string decoded;
+                ASSERT_TRUE(Netease::Json::UnescapeString(escaped, decoded)) << KernelName(k);
+                ASSERT_EQ(decoded, raw) << KernelName(k) << " len=" << len;
+            }
+        }
+    }
+}
+
+TEST_F(JsonKernelTest, CacheRoundTrip_PreservesUnicodeAndControls) {
+    Netease::LyricData data;
+    data.lrc = "[00:01.00]\xF0\x9F\x8E\xB5 \"q\" \\ \x01\n[00:02.00]\xE4\xBD\xA0\xE5\xA5\xBD\t";
+    data.tlyric = "[00:01.00]\xE8\xAF\x91";
+
+    long long testId = 777001;
+    ASSERT_TRUE(Netease::API::CacheLyric(testId, data));
+    auto cached = Netease::API::GetLocalLyric(testId);
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ(cached->lrc, data.lrc);
+    EXPECT_EQ(cached->tlyric, data.tlyric);
+    Netease::API::ClearLyricCache(testId);
+}
+
+// 吞吐量见 NeteaseLyricBench --only json
+TEST_F(JsonKernelTest, LargePayload_AllKernelsAgree) {
+    std::string payload = MakeEscapedLyricPayload(1024 * 1024);
+    payload += "\"";
+
+    Netease::Json::SetKernel(Netease::Json::Kernel::Scalar);
+    std::string expected;
+    ASSERT_TRUE(Netease::Json::UnescapeString(payload, expected));
+    std::string expectedEscaped;
+    Netease::Json::AppendEscaped(expectedEscaped, expected);
+
+    for (auto k : kAllKernels) {
+        if (!Netease::Json::SetKernel(k)) continue;
+        std::string out;
+        ASSERT_TRUE(Netease::Json::UnescapeString(payload, out)) << KernelName(k);
+        EXPECT_EQ(out, expected) << KernelName(k);
+
+        std::string esc;
+        Netease::Json::AppendEscaped(esc, expected);
+        EXPECT_EQ(esc, expectedEscaped) << KernelName(k);
+    }
+}
+
+// ============================================================================
+// 13. 缓存目录索引测试 (v0.1.4)
+// ============================================================================
+
+class LyricCacheIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root = fs::temp_directory_path() / ("netease_index_test_" + std::to_string(GetCurrentProcessId()));
+        fs::remove_all(root);
+        fs::create_directories(root / "high");
+        fs::create_directories(root / "low");
+        highDir = (root / "high").string();
+        lowDir = (root / "low").string();
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(root, ec);
+    }
+
+    static void Touch(const std::string& dir, const std::string& name) {
+        std::ofstream(dir + "\\" + name) << "{}";
+    }
+
+    // 轮询等待监听线程处理通知
+    template <typename Pred>
+    static bool WaitFor(Pred pred, int timeoutMs = 2000) {
+        for (int waited = 0; waited < timeoutMs; waited += 20) {
+            if (pred()) return true;
+            Sleep(20);
+        }
+        return pred();
+    }
+
+    fs::path root;
+    std::string highDir;
+    std::string lowDir;
+};
+
+TEST_F(LyricCacheIndexTest, Find_ReturnsHighestPriorityDir) {
+    Touch(highDir, "100");
+    Touch(lowDir, "100");
+    Touch(lowDir, "200");
+    Touch(lowDir, "200.tmp");  // 临时文件不计入
+
+    Netease::LyricCacheIndex index([&] { return std::vector<std::string>{ highDir, lowDir }; });
+
+    EXPECT_EQ(index.Find(100).value_or(""), highDir);
+    EXPECT_EQ(index.Find(200).value_or(""), lowDir);
+    EXPECT_FALSE(index.Find(300).has_value());
+    EXPECT_EQ(index.Size(), 2u);
+
+    // 移除高优先级副本后回落到低优先级目录
+    index.Remove(100, highDir);
+    EXPECT_EQ(index.Find(100).value_or(""), lowDir);
+
+    index.RemoveAllIn(lowDir);
+    EXPECT_EQ(index.Size(), 0u);
+}
+
+TEST_F(LyricCacheIndexTest, Watcher_TracksExternalChanges) {
+    Netease::LyricCacheIndex index([&] { return std::vector<std::string>{ highDir, lowDir }; });
+    ASSERT_TRUE(index.StartWatching());
+    EXPECT_FALSE(index.Find(4242).has_value());
+
+    // 外部进程（网易云客户端）写入
+    Touch(lowDir, "4242");
+    EXPECT_TRUE(WaitFor([&] { return index.Find(4242).has_value(); }));
+
+    // 原子重命名写入 (.tmp -> songId)
+    Touch(highDir, "4242.tmp");
+    fs::rename(highDir + "\\4242.tmp", highDir + "\\4242");
+    EXPECT_TRUE(WaitFor([&] { return index.Find(4242).value_or("") == highDir; }));
+
+    // 外部删除
+    fs::remove(highDir + "\\4242");
+    fs::remove(lowDir + "\\4242");
+    EXPECT_TRUE(WaitFor([&] { return !index.Find(4242).has_value(); }));
+
+    index.StopWatching();
+}
+
+TEST_F(LyricCacheIndexTest, LargeDir_HitsAndMissesMatchFilesystem) {
+    // 构建与查询耗时见 NeteaseLyricBench --only index
+    const int fileCount = 5000;
+    for (int i = 0; i < fileCount; ++i) {
+        Touch(lowDir, std::to_string(1000000 + i));
+    }
+
+    Netease::LyricCacheIndex index([&] { return std::vector<std::string>{ highDir, lowDir }; });
+    index.Rebuild();
+    ASSERT_EQ(index.Size(), (size_t)fileCount);
+
+    auto probe = [&](long long songId) {
+        // 旧实现：逐目录探测文件是否存在
+        for (const auto& dir : { highDir, lowDir }) {
+            std::string path = dir + "\\" + std::to_string(songId);
+            if (GetFileAttributesA(path.c_str()) != INVALID_FILE_ATTRIBUTES) return true;
+        }
+        return false;
+    };
+
+    const int lookups = 2000;
+    int indexHits = 0, indexMisses = 0;
+    for (int i = 0; i < lookups; ++i) {
+        long long hitId = 1000000 + (i * 7919) % fileCount;
+        long long missId = 5000000 + (i * 7919) % fileCount;
+        bool hit = index.Find(hitId).has_value();
+        bool miss = index.Find(missId).has_value();
+        EXPECT_EQ(hit, probe(hitId)) << hitId;
+        EXPECT_EQ(miss, probe(missId)) << missId;
+        indexHits += hit ? 1 : 0;
+        indexMisses += miss ? 1 : 0;
+    }
+    EXPECT_EQ(indexHits, lookups);
+    EXPECT_EQ(indexMisses, 0);
+}
+
+TEST_F(LyricCacheIndexTest, ConcurrentRebuilds_LaterScanWins) {
+    Touch(highDir, "100");
+    Touch(lowDir, "200");
+
+    // 第一次扫描（较旧的目录集合）故意拖慢；第二次在其进行中发起。
+    // 未串行化时第二次先提交，随后被第一次的旧结果覆盖
+    std::atomic<int> calls{0};
+    std::atomic<int> inProvider{0};
+    std::atomic<int> maxConcurrent{0};
+    std::atomic<bool> firstStarted{false};
+    Netease::LyricCacheIndex index([&] {
+        int concurrent = ++inProvider;
+        int seen = maxConcurrent.load();
+        while (concurrent > seen && !maxConcurrent.compare_exchange_weak(seen, concurrent)) {}
+
+        std::vector<std::string> dirs;
+        if (++calls == 1) {
+            firstStarted = true;
+            Sleep(200);
+            dirs = { lowDir };
+        } else {
+            dirs = { highDir, lowDir };
+        }
+        --inProvider;
+        return dirs;
+    });
+
+    std::thread first([&] { index.Rebuild(); });
+    ASSERT_TRUE(WaitFor([&] { return firstStarted.load(); }));
+    std::thread second([&] { index.Rebuild(); });
+    first.join();
+    second.join();
+
+    EXPECT_EQ(calls.load(), 2);
+    EXPECT_EQ(maxConcurrent.load(), 1);
+    EXPECT_EQ(index.Find(100).value_or(""), highDir);
+    EXPECT_EQ(index.Find(200).value_or(""), lowDir);
+    EXPECT_EQ(index.Size(), 2u);
+}
+
+// ============================================================================
+// 14. 包文件缓存后端测试 (v0.1.4)
+// ============================================================================
+
+class LyricPackStoreTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root = (fs::temp_directory_path() / ("netease_pack_test_" + std::to_string(GetCurrentProcessId()))).string();
+        fs::remove_all(root);
+        options.backgroundCompaction = false;
+    }
+
+    void TearDown() override {
+        Netease::API::SetCacheConfig(Netease::CacheConfig());
+        std::error_code ec;
+        fs::remove_all(root, ec);
+    }
+
+    static std::string Payload(long long songId, int version) {
+        return "{\"lyric\":\"[00:01.00]song " + std::to_string(songId) + " v" + std::to_string(version)
+             + "\\n[00:02.00]" + std::string(200, 'x') + "\"}";
+    }
+
+    std::string root;
+    Netease::LyricPackStore::Options options;
+};
+
+TEST_F(LyricPackStoreTest, PutGetRemove_PersistAcrossReopen) {
+    {
+        Netease::LyricPackStore store;
+        ASSERT_TRUE(store.Open(root, options));
+        for (int i = 0; i < 5000; ++i) {
+            ASSERT_TRUE(store.Put(1000 + i, Payload(1000 + i, 0)));
+        }
+        EXPECT_TRUE(store.Remove(1003));
+        EXPECT_FALSE(store.Remove(42));
+        EXPECT_TRUE(store.Put(1004, Payload(1004, 1)));
+        EXPECT_EQ(store.GetStats().entries, 4999u);
+    }
+
+    Netease::LyricPackStore store;
+    ASSERT_TRUE(store.Open(root, options));
+    EXPECT_EQ(store.GetStats().entries, 4999u);
+    EXPECT_FALSE(store.Get(1003).has_value());
+    EXPECT_EQ(store.Get(1004)->payload, Payload(1004, 1));
+    EXPECT_EQ(store.Get(5999)->payload, Payload(5999, 0));
+}
+
+TEST_F(LyricPackStoreTest, Recovery_TruncatesTornTailAndRebuildsIndex) {
+    {
+        Netease::LyricPackStore store;
+        ASSERT_TRUE(store.Open(root, options));
+        for (int i = 1; i <= 10; ++i) store.Put(i, Payload(i, 0));
+    }
+
+    // 模拟写入中途崩溃：尾部残留半条记录
+    std::string packPath = root + "\\lyrics.1.pack";
+    auto intactSize = fs::file_size(packPath);
+    {
+        std::ofstream ofs(packPath, std::ios::binary | std::ios::app);
+        ofs << "NLRC-torn-record-without-valid-crc";
+    }
+    {
+        Netease::LyricPackStore store;
+        ASSERT_TRUE(store.Open(root, options));
+        EXPECT_EQ(store.GetStats().entries, 10u);
+        EXPECT_EQ(fs::file_size(packPath), intactSize);
+        store.Put(77, Payload(77, 0));
+    }
+
+    // 索引丢失：从 pack 全量重建
+    fs::remove(root + "\\lyrics.1.idx");
+    Netease::LyricPackStore store;
+    ASSERT_TRUE(store.Open(root, options));
+    EXPECT_EQ(store.GetStats().entries, 11u);
+    EXPECT_TRUE(store.Get(77).has_value());
+}
+
+TEST_F(LyricPackStoreTest, Recovery_ReplayOfAppliedRecordsKeepsByteCounts) {
+    Netease::LyricPackStore::Stats before;
+    {
+        Netease::LyricPackStore store;
+        ASSERT_TRUE(store.Open(root, options));
+        for (int i = 1; i <= 50; ++i) store.Put(i, Payload(i, 0));
+        for (int i = 1; i <= 20; ++i) store.Put(i, Payload(i, 1));
+        for (int i = 41; i <= 50; ++i) store.Remove(i);
+        store.Put(45, Payload(45, 2));
+        before = store.GetStats();
+    }
+
+    // 模拟 slot 已落盘而 committedTail 未推进：把索引头中的 committedTail 回退到 pack 起点，
+    // 重新打开时所有记录都会被重放一遍
+    {
+        std::fstream idx(root + "\\lyrics.1.idx", std::ios::binary | std::ios::in | std::ios::out);
+        ASSERT_TRUE(idx.is_open());
+        const uint64_t packStart = 16;      // sizeof(PackHeader)
+        idx.seekp(40);                      // offsetof(IndexHeader, committedTail)
+        idx.write((const char*)&packStart, sizeof(packStart));
+    }
+
+    Netease::LyricPackStore store;
+    ASSERT_TRUE(store.Open(root, options));
+    auto after = store.GetStats();
+    EXPECT_EQ(after.entries, before.entries);
+    EXPECT_EQ(after.liveBytes, before.liveBytes);
+    EXPECT_EQ(after.deadBytes, before.deadBytes) << "已应用的记录重放时不应再次计入死数据";
+    EXPECT_EQ(store.Get(5)->payload, Payload(5, 1));
+    EXPECT_FALSE(store.Get(44).has_value());
+    EXPECT_EQ(store.Get(45)->payload, Payload(45, 2));
+}
+
+TEST_F(LyricPackStoreTest, Compact_ReclaimsSpaceAndKeepsViewsValid) {
+    Netease::LyricPackStore store;
+    ASSERT_TRUE(store.Open(root, options));
+    for (int version = 0; version < 10; ++version) {
+        for (int i = 1; i <= 1000; ++i) store.Put(i, Payload(i, version));
+    }
+
+    auto held = store.Get(5);
+    ASSERT_TRUE(held.has_value());
+
+    auto before = store.GetStats();
+    ASSERT_TRUE(store.Compact());
+    auto after = store.GetStats();
+
+    EXPECT_EQ(after.generation, before.generation + 1);
+    EXPECT_EQ(after.deadBytes, 0u);
+    EXPECT_LT(after.packBytes * 5, before.packBytes);
+    EXPECT_EQ(held->payload, Payload(5, 9)) << "压缩前取得的视图应保持有效";
+    for (int i = 1; i <= 1000; ++i) {
+        ASSERT_EQ(store.Get(i)->payload, Payload(i, 9));
+    }
+
+    EXPECT_EQ(store.Clear(), 1000);
+    EXPECT_FALSE(store.Get(1).has_value());
+}
+
+TEST_F(LyricPackStoreTest, ApiBackend_RoundTripThroughCache) {
+    Netease::CacheConfig config;
+    config.backend = Netease::CacheBackend::Pack;
+    config.packDir = root;
+    Netease::API::SetCacheConfig(config);
+
+    const long long testId = 777002;
+    Netease::LyricData data;
+    data.lrc = "[00:01.00]包文件\n[00:02.00]\"quoted\"";
+    data.tlyric = "[00:01.00]pack file";
+
+    ASSERT_TRUE(Netease::API::CacheLyric(testId, data));
+    auto cached = Netease::API::GetLocalLyric(testId);
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ(cached->lrc, data.lrc);
+    EXPECT_EQ(cached->tlyric, data.tlyric);
+
+    EXPECT_TRUE(Netease::API::ClearLyricCache(testId));
+    EXPECT_FALSE(Netease::API::GetLocalLyric(testId).has_value());
+}
+
+TEST_F(LyricPackStoreTest, PackReads_MatchPerFileContent) {
+    // 与逐文件读取的耗时对比见 NeteaseLyricBench --only pack
+    const int count = 2000;
+    std::string filesDir = root + "\\files";
+    fs::create_directories(filesDir);
+
+    Netease::LyricPackStore store;
+    ASSERT_TRUE(store.Open(root + "\\pack", options));
+    for (int i = 0; i < count; ++i) {
+        std::string payload = Payload(i + 1, 0);
+        store.Put(i + 1, payload);
+        std::ofstream(filesDir + "\\" + std::to_string(i + 1), std::ios::binary) << payload;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        auto view = store.Get(i + 1);
+        ASSERT_TRUE(view.has_value()) << i + 1;
+        std::ifstream ifs(filesDir + "\\" + std::to_string(i + 1), std::ios::binary);
+        std::stringstream buffer;
+        buffer << ifs.rdbuf();
+        ASSERT_EQ(view->payload, buffer.str()) << i + 1;
+    }
+}
+
+// ============================================================================
+// 15. 缓存记录压缩测试 (v0.1.4)
+// ============================================================================
+
+namespace {
+
+// 语料：优先使用本机真实的网易云歌词缓存，不足时补充合成歌词
+std::vector<std::string> LoadLyricCorpus(size_t maxFiles) {
+    std::vector<std::string> corpus;
+
+    char localAppData[MAX_PATH];
+    if (SHGetFolderPathA(NULL, CSIDL_LOCAL_APPDATA, NULL, 0, localAppData) == S_OK) {
+        std::error_code ec;
+        fs::path dir = fs::path(localAppData) / "Netease" / "CloudMusic" / "webdata" / "lyric";
+        for (const auto& entry : fs::directory_iterator(dir, ec)) {
+            if (corpus.size() >= maxFiles) break;
+            if (!entry.is_regular_file(ec)) continue;
+            std::ifstream ifs(entry.path(), std::ios::binary);
+            std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+            if (!content.empty() && content[0] == '{') corpus.push_back(std::move(content));
+        }
+    }
+
+    for (int song = 0; corpus.size() < 50; ++song) {
+        Netease::LyricData data;
+        data.lrc = "[00:00.000] 作词 : 某某\n[00:01.000] 作曲 : 某某\n[00:02.000] 编曲 : 某某\n";
+        for (int line = 0; line < 40; ++line) {
+            char ts[32];
+            snprintf(ts, sizeof(ts), "[%02d:%02d.%03d]", line / 20, (line * 3 + song) % 60, (line * 37) % 1000);
+            data.lrc += ts + std::string(line % 2 ? "我们一起走过的时候 世界都变得温柔\n" : "君の声が聞こえる 夢を見ていた\n");
+            data.tlyric += ts + std::string("听到了你的声音 第 ") + std::to_string(song) + " 首\n";
+        }
+        std::string json = "{\"lyric\":\"";
+        Netease::Json::AppendEscaped(json, data.lrc);
+        json += "\",\"translateLyric\":\"";
+        Netease::Json::AppendEscaped(json, data.tlyric);
+        json += "\"}";
+        corpus.push_back(std::move(json));
+    }
+    return corpus;
+}
+
+} // namespace
+
+TEST(LyricCodecTest, RoundTrip_RandomAndRepetitiveInputs) {
+    std::mt19937 rng(12345);
+    for (int iteration = 0; iteration < 2000; ++iteration) {
+        std::string input(rng() % 4096, '\0');
+        int alphabet = 1 + (int)(rng() % 255);
+        for (auto& c : input) c = (char)(rng() % alphabet);
+
+        for (auto dict : { Netease::LyricCodec::Dictionary::None, Netease::LyricCodec::Dictionary::LrcV1 }) {
+            std::string packed = Netease::LyricCodec::Compress(input, dict);
+            ASSERT_TRUE(Netease::LyricCodec::IsCompressed(packed));
+            EXPECT_EQ(Netease::LyricCodec::RawSize(packed), input.size());
+
+            std::string output;
+            ASSERT_TRUE(Netease::LyricCodec::Decompress(packed, output));
+            ASSERT_EQ(output, input);
+        }
+    }
+}
+
+TEST(LyricCodecTest, Decompress_CorruptInput_FailsSafely) {
+    std::string packed = Netease::LyricCodec::Compress(LoadLyricCorpus(1)[0]);
+    std::string output;
+
+    // 截断
+    for (size_t len = 0; len < packed.size(); len += 7) {
+        EXPECT_FALSE(Netease::LyricCodec::Decompress(std::string_view(packed.data(), len), output));
+    }
+
+    // 随机翻转字节：不得越界（结果可能成功也可能失败）
+    std::mt19937 rng(7);
+    for (int i = 0; i < 1000; ++i) {
+        std::string corrupted = packed;
+        corrupted[9 + rng() % (corrupted.size() - 9)] ^= (char)(1 + rng() % 255);
+        Netease::LyricCodec::Decompress(corrupted, output);
+    }
+
+    // 头部原始长度超出上限或超出输入可能产生的长度：分配前拒绝
+    for (uint32_t rawSize : { 0xFFFFFFFFu, (uint32_t)Netease::LyricCodec::MAX_RAW_SIZE + 1,
+                              (uint32_t)(packed.size() * 255 + 1) }) {
+        std::string oversized = packed;
+        memcpy(&oversized[5], &rawSize, sizeof(rawSize));
+        EXPECT_FALSE(Netease::LyricCodec::Decompress(oversized, output)) << rawSize;
+        EXPECT_LE(output.capacity(), packed.size() * 255);
+    }
+
+    // 非压缩数据不会被识别为压缩记录
+    EXPECT_FALSE(Netease::LyricCodec::IsCompressed("{\"lyric\":\"\"}"));
+    EXPECT_FALSE(Netease::LyricCodec::IsCompressed("[00:01.00]plain"));
+}
+
+TEST(LyricCodecTest, SdkCacheFile_TransparentToGetLocalLyric) {
+    const long long testId = 777003;
+    Netease::LyricData data;
+    data.lrc = "[00:01.00]压缩记录\n[00:02.00]second line";
+    data.tlyric = "[00:01.00]compressed record";
+
+    // 模拟 SDK 降级目录中的压缩记录（外部写入，由目录监听发现）
+    char localAppData[MAX_PATH];
+    ASSERT_EQ(SHGetFolderPathA(NULL, CSIDL_LOCAL_APPDATA, NULL, 0, localAppData), S_OK);
+    fs::path dir = fs::path(localAppData) / "NeteaseHookSDK" / "cache" / "lyric";
+    fs::create_directories(dir);
+
+    std::string json = "{\"lyric\":\"";
+    Netease::Json::AppendEscaped(json, data.lrc);
+    json += "\",\"translateLyric\":\"";
+    Netease::Json::AppendEscaped(json, data.tlyric);
+    json += "\"}";
+    std::ofstream(dir / std::to_string(testId), std::ios::binary) << Netease::LyricCodec::Compress(json);
+
+    std::optional<Netease::LyricData> cached;
+    for (int waited = 0; waited < 2000 && !cached; waited += 20) {
+        cached = Netease::API::GetLocalLyric(testId);
+        if (!cached) Sleep(20);
+    }
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ(cached->lrc, data.lrc);
+    EXPECT_EQ(cached->tlyric, data.tlyric);
+
+    Netease::API::ClearLyricCache(testId);
+}
+
+TEST(LyricCodecTest, Corpus_DictionaryImprovesRatio) {
+    // 解压速度见 NeteaseLyricBench --only codec
+    auto corpus = LoadLyricCorpus(2000);
+
+    size_t rawBytes = 0, plainBytes = 0, dictBytes = 0;
+    std::string output;
+    for (const auto& record : corpus) {
+        rawBytes += record.size();
+        plainBytes += Netease::LyricCodec::Compress(record, Netease::LyricCodec::Dictionary::None).size();
+        std::string packed = Netease::LyricCodec::Compress(record);
+        dictBytes += packed.size();
+        ASSERT_TRUE(Netease::LyricCodec::Decompress(packed, output));
+        ASSERT_EQ(output, record);
+    }
+
+    EXPECT_LT(dictBytes, plainBytes);
+    EXPECT_LT(dictBytes * 2, rawBytes);
+}
+
+// ============================================================================
+// 16. 失败结果缓存测试 (v0.1.4)
+// ============================================================================
+
+class NegativeCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path = (fs::temp_directory_path() / ("netease_negative_" + std::to_string(GetCurrentProcessId()) + ".txt")).string();
+        fs::remove(path);
+        options.noLyricTtlMs = 1000 * 1000;
+        options.backoffBaseMs = 1000;
+        options.backoffMaxMs = 8000;
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove(path, ec);
+    }
+
+    Netease::NegativeCache::Clock clock() {
+        return [this] { return now; };
+    }
+
+    std::string path;
+    Netease::NegativeCache::Options options;
+    int64_t now = 1700000000000LL;
+};
+
+TEST_F(NegativeCacheTest, NoLyric_SkippedUntilTtl) {
+    Netease::NegativeCache cache("", options, clock());
+    EXPECT_FALSE(cache.ShouldSkip(1));
+
+    cache.RecordNoLyric(1);
+    EXPECT_TRUE(cache.ShouldSkip(1));
+
+    now += options.noLyricTtlMs - 1;
+    EXPECT_TRUE(cache.ShouldSkip(1));
+    now += 1;
+    EXPECT_FALSE(cache.ShouldSkip(1));
+}
+
+TEST_F(NegativeCacheTest, Failure_ExponentialBackoffWithCap) {
+    Netease::NegativeCache cache("", options, clock());
+
+    const int64_t expected[] = { 1000, 2000, 4000, 8000, 8000 };
+    for (int64_t backoff : expected) {
+        cache.RecordFailure(2);
+        EXPECT_TRUE(cache.ShouldSkip(2));
+        now += backoff - 1;
+        EXPECT_TRUE(cache.ShouldSkip(2));
+        now += 1;
+        EXPECT_FALSE(cache.ShouldSkip(2)) << "退避 " << backoff << "ms 后应允许重试";
+    }
+    EXPECT_EQ(cache.Lookup(2)->failures, 5u);
+
+    // 成功后重置
+    cache.Forget(2);
+    cache.RecordFailure(2);
+    EXPECT_EQ(cache.Lookup(2)->failures, 1u);
+    EXPECT_EQ(cache.Lookup(2)->untilMs, now + 1000);
+}
+
+TEST_F(NegativeCacheTest, Persist_SurvivesRestart) {
+    {
+        Netease::NegativeCache cache(path, options, clock());
+        cache.RecordNoLyric(10);
+        cache.RecordFailure(11);
+        cache.RecordFailure(11);
+    }
+
+    Netease::NegativeCache reloaded(path, options, clock());
+    EXPECT_TRUE(reloaded.ShouldSkip(10));
+    EXPECT_TRUE(reloaded.ShouldSkip(11));
+    EXPECT_EQ(reloaded.Lookup(10)->reason, Netease::NegativeCache::Reason::NoLyric);
+    EXPECT_EQ(reloaded.Lookup(11)->failures, 2u);
+
+    reloaded.Clear();
+    Netease::NegativeCache cleared(path, options, clock());
+    EXPECT_EQ(cleared.Size(), 0u);
+}
+
+TEST_F(NegativeCacheTest, Evict_KeepsAtMostMaxEntries) {
+    options.maxEntries = 100;
+    Netease::NegativeCache cache("", options, clock());
+    for (int i = 0; i < 250; ++i) {
+        now += 1;
+        cache.RecordNoLyric(i);
+    }
+    EXPECT_LE(cache.Size(), 100u);
+    EXPECT_TRUE(cache.ShouldSkip(249)) << "最近的记录应保留";
+}
+
+TEST(NegativeCacheApiTest, GetLyric_RepeatedMiss_SkipsNetwork) {
+    // 替身服务器：始终回答无歌词，并统计请求次数
+    const long long id = 900000090;
+    std::atomic<int> requests{0};
+    httplib::Server server;
+    server.Get("/api/song/lyric", [&](const httplib::Request&, httplib::Response& res) {
+        requests++;
+        res.set_content("{\"nolyric\":true,\"code\":200}", "application/json");
+    });
+    int port = server.bind_to_any_port("127.0.0.1");
+    ASSERT_GT(port, 0);
+    std::thread serverThread([&] { server.listen_after_bind(); });
+    server.wait_until_ready();
+
+    // 请求计数断言需要每次获取恰好一个请求：关闭对冲
+    Netease::Http::PolicyOptions policy;
+    policy.hedge = false;
+    Netease::Http::RequestPolicy::Default().SetOptions(policy);
+    Netease::API::SetApiBaseUrl("http://127.0.0.1:" + std::to_string(port));
+    Netease::API::ClearLyricCache(id);
+
+    // 第一次：真实请求，无歌词结果被记录
+    EXPECT_FALSE(Netease::API::GetLyric(id).has_value());
+    EXPECT_EQ(requests.load(), 1);
+
+    // 重复请求直接命中失败结果缓存
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_FALSE(Netease::API::GetLyric(id).has_value());
+    }
+    EXPECT_EQ(requests.load(), 1) << "100 次重复未命中不应发起网络请求";
+
+    // useCache=false 忽略该记录强制请求
+    EXPECT_FALSE(Netease::API::GetLyric(id, false).has_value());
+    EXPECT_EQ(requests.load(), 2);
+
+    Netease::API::ClearLyricCache(id);
+    Netease::API::SetApiBaseUrl("");
+    Netease::Http::RequestPolicy::Default().SetOptions(Netease::Http::PolicyOptions());
+    server.stop();
+    serverThread.join();
+}
+
+// ============================================================================
+// 17. 播放队列预取测试 (v0.1.4)
+// ============================================================================
+
+/**
+ * 本地替身服务器：提供 /api/song/detail 与 /api/song/lyric，记录请求，
+ * 可注入歌词接口延迟以模拟慢网络
+ */
+class PrefetcherTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        server.Get("/api/song/detail", [this](const httplib::Request& req, httplib::Response& res) {
+            long long id = std::stoll(req.get_param_value("id"));
+            detailHits++;
+            std::string body = "{\"songs\":[{\"name\":\"Song " + std::to_string(id) + "\",\"id\":" + std::to_string(id) +
+                ",\"artists\":[{\"name\":\"Artist\"}],\"album\":{\"name\":\"Album\",\"picUrl\":\"http://127.0.0.1/cover/" +
+                std::to_string(id) + ".jpg\"},\"duration\":180000}],\"code\":200}";
+            res.set_content(body, "application/json");
+        });
+        server.Get("/api/song/lyric", [this](const httplib::Request& req, httplib::Response& res) {
+            long long id = std::stoll(req.get_param_value("id"));
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                lyricRequests.push_back(id);
+            }
+            if (lyricDelayMs > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(lyricDelayMs.load()));
+            }
+            std::string body = "{\"lrc\":{\"version\":1,\"lyric\":\"[00:01.00]line " + std::to_string(id) +
+                "\\n[00:02.00]next\\n\"},\"code\":200}";
+            res.set_content(body, "application/json");
+        });
+
+        port = server.bind_to_any_port("127.0.0.1");
+        ASSERT_GT(port, 0);
+        serverThread = std::thread([this] { server.listen_after_bind(); });
+        server.wait_until_ready();
+
+        // 请求计数断言需要每首歌恰好一个请求：关闭对冲
+        Netease::Http::PolicyOptions policy;
+        policy.hedge = false;
+        Netease::Http::RequestPolicy::Default().SetOptions(policy);
+        Netease::Http::RequestPolicy::Default().Reset();
+
+        Netease::API::SetApiBaseUrl("http://127.0.0.1:" + std::to_string(port));
+        Netease::API::ClearAllCache();
+        for (long long id = 900000001; id <= 900000010; ++id) {
+            Netease::API::ClearLyricCache(id);
+        }
+    }
+
+    void TearDown() override {
+        server.stop();
+        if (serverThread.joinable()) serverThread.join();
+
+        Netease::API::SetApiBaseUrl("");
+        Netease::Http::RequestPolicy::Default().SetOptions(Netease::Http::PolicyOptions());
+        for (long long id = 900000001; id <= 900000010; ++id) {
+            Netease::API::ClearLyricCache(id);
+        }
+        Netease::API::ClearAllCache();
+    }
+
+    int LyricRequestCount(long long id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return (int)std::count(lyricRequests.begin(), lyricRequests.end(), id);
+    }
+
+    httplib::Server server;
+    std::thread serverThread;
+    int port = 0;
+
+    std::mutex mutex;
+    std::vector<long long> lyricRequests;
+    std::atomic<int> detailHits{0};
+    std::atomic<int> lyricDelayMs{0};
+};
+
+TEST_F(PrefetcherTest, Prefetch_WarmsMetadataLyricAndCover) {
+    const long long a = 900000001, b = 900000002, c = 900000003, d = 900000004;
+
+    Netease::Prefetcher prefetcher;     // depth = 3
+    std::mutex warmedMutex;
+    std::vector<std::pair<long long, std::string>> warmed;
+    prefetcher.SetCoverWarmer([&](long long songId, const std::string& url) {
+        std::lock_guard<std::mutex> lock(warmedMutex);
+        warmed.emplace_back(songId, url);
+    });
+
+    // 模拟 CDP 读到的队列：当前歌曲之后的 4 首
+    prefetcher.UpdateQueue({a, b, c, d});
+    ASSERT_TRUE(prefetcher.WaitIdle(10000));
+
+    EXPECT_EQ(prefetcher.GetStats().completed, 3u);
+    EXPECT_EQ(LyricRequestCount(d), 0) << "超出深度的歌曲不应预取";
+    ASSERT_EQ(warmed.size(), 3u);
+    EXPECT_EQ(warmed[0].first, a);
+    EXPECT_NE(warmed[0].second.find("/cover/900000001.jpg"), std::string::npos);
+
+    // 切歌到 b：元数据与歌词都应命中缓存，不再访问服务器
+    int detailBefore = detailHits.load();
+    auto meta = Netease::API::GetSongDetail(b);
+    auto lyric = Netease::API::GetLyric(b);
+
+    ASSERT_TRUE(meta.has_value());
+    EXPECT_EQ(meta->title, "Song 900000002");
+    ASSERT_TRUE(lyric.has_value());
+    EXPECT_TRUE(lyric->fromCache);
+    EXPECT_NE(lyric->lrc.find("line 900000002"), std::string::npos);
+    EXPECT_EQ(detailHits.load(), detailBefore);
+    EXPECT_EQ(LyricRequestCount(b), 1);
+
+    // 对照：未预取的 d 需要访问服务器
+    Netease::API::GetSongDetail(d);
+    Netease::API::GetLyric(d);
+    EXPECT_EQ(detailHits.load(), detailBefore + 1);
+    EXPECT_EQ(LyricRequestCount(d), 1);
+}
+
+TEST_F(PrefetcherTest, QueueReorder_CancelsStalePrefetches) {
+    const long long a = 900000001, b = 900000002, c = 900000003;
+    const long long x = 900000005, y = 900000006;
+    lyricDelayMs = 300;
+
+    Netease::Prefetcher prefetcher;
+    prefetcher.UpdateQueue({a, b, c});
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));   // a 正在请求歌词
+
+    // 用户调整了队列
+    prefetcher.UpdateQueue({x, y});
+    ASSERT_TRUE(prefetcher.WaitIdle(10000));
+
+    EXPECT_EQ(LyricRequestCount(b), 0) << "过期任务不应发起请求";
+    EXPECT_EQ(LyricRequestCount(c), 0);
+    EXPECT_EQ(LyricRequestCount(x), 1);
+    EXPECT_EQ(LyricRequestCount(y), 1);
+    EXPECT_TRUE(Netease::API::GetLocalLyric(x).has_value());
+    EXPECT_TRUE(Netease::API::GetLocalLyric(y).has_value());
+
+    auto stats = prefetcher.GetStats();
+    EXPECT_EQ(stats.generation, 2u);
+    EXPECT_GE(stats.cancelled, 3u) << "b/c 未开始即取消，a 在阶段之间放弃";
+    EXPECT_EQ(stats.completed, 2u);
+}
+
+TEST_F(PrefetcherTest, UnchangedQueue_NoNewGenerationAndNoRefetch) {
+    const long long a = 900000001, b = 900000002;
+
+    Netease::Prefetcher prefetcher;
+    prefetcher.UpdateQueue({a});
+    ASSERT_TRUE(prefetcher.WaitIdle(10000));
+
+    prefetcher.UpdateQueue({a});
+    EXPECT_EQ(prefetcher.GetStats().generation, 1u);
+
+    // 队列前移：a 已预取过，只处理 b
+    prefetcher.UpdateQueue({a, b});
+    ASSERT_TRUE(prefetcher.WaitIdle(10000));
+    EXPECT_EQ(LyricRequestCount(a), 1);
+    EXPECT_EQ(LyricRequestCount(b), 1);
+    EXPECT_EQ(prefetcher.GetStats().skipped, 1u);
+
+    // 深度为 0：暂停预取
+    prefetcher.SetDepth(0);
+    prefetcher.UpdateQueue({900000007});
+    ASSERT_TRUE(prefetcher.WaitIdle(1000));
+    EXPECT_EQ(LyricRequestCount(900000007), 0);
+}
+
+TEST_F(PrefetcherTest, Stop_JoinsWorkerAndAllowsRestart) {
+    const long long a = 900000001, b = 900000002;
+
+    // 驱动断开连接时停止预取线程，重新连接后同一实例继续工作
+    Netease::Prefetcher prefetcher;
+    prefetcher.UpdateQueue({a});
+    ASSERT_TRUE(prefetcher.WaitIdle(10000));
+    prefetcher.Stop();
+    prefetcher.Stop();      // 重复调用无副作用
+
+    prefetcher.UpdateQueue({a, b});
+    ASSERT_TRUE(prefetcher.WaitIdle(10000));
+    EXPECT_EQ(LyricRequestCount(a), 1) << "停止前已预取的歌曲不重复请求";
+    EXPECT_EQ(LyricRequestCount(b), 1);
+}
+
+// ============================================================================
+// 18. 压缩传输测试 (v0.1.4)
+// ============================================================================
+
+namespace {
+
+std::string ReadFixture(const std::string& name) {
+    std::ifstream file(fs::path(NETEASE_TEST_FIXTURE_DIR) / name, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+} // namespace
+
+TEST(InflateTest, Fixtures_MatchPlainText) {
+    std::string plain = ReadFixture("lyric_sample.json");
+    std::string gz = ReadFixture("lyric_sample.json.gz");
+    std::string zlib = ReadFixture("lyric_sample.json.zlib");
+    ASSERT_FALSE(plain.empty()) << "缺少测试数据: " << NETEASE_TEST_FIXTURE_DIR;
+    ASSERT_LT(gz.size(), plain.size());
+
+    std::string out;
+    ASSERT_TRUE(Netease::Inflater::Inflate(gz, Netease::Inflater::Format::Gzip, out));
+    EXPECT_EQ(out, plain);
+
+    out.clear();
+    ASSERT_TRUE(Netease::Inflater::Inflate(zlib, Netease::Inflater::Format::Zlib, out));
+    EXPECT_EQ(out, plain);
+
+    // Auto 按头部识别
+    out.clear();
+    ASSERT_TRUE(Netease::Inflater::Inflate(gz, Netease::Inflater::Format::Auto, out));
+    EXPECT_EQ(out, plain);
+}
+
+TEST(InflateTest, ByteByByteFeed_SameAsOneShot) {
+    std::string plain = ReadFixture("lyric_sample.json");
+    std::string gz = ReadFixture("lyric_sample.json.gz");
+    ASSERT_FALSE(gz.empty());
+
+    // 模拟网络逐字节到达：每个块头 / 符号都可能被切断
+    Netease::Inflater inflater(Netease::Inflater::Format::Gzip);
+    std::string out;
+    Netease::Inflater::Status status = Netease::Inflater::Status::NeedMore;
+    for (size_t i = 0; i < gz.size(); ++i) {
+        status = inflater.Feed(&gz[i], 1, out);
+        ASSERT_NE(status, Netease::Inflater::Status::Error) << "offset " << i;
+    }
+    EXPECT_EQ(status, Netease::Inflater::Status::Done);
+    EXPECT_EQ(out, plain);
+}
+
+TEST(InflateTest, CorruptOrTruncated_NeverReportsDone) {
+    std::string gz = ReadFixture("lyric_sample.json.gz");
+    ASSERT_GT(gz.size(), 64u);
+
+    // 截断：停在 NeedMore
+    Netease::Inflater truncated(Netease::Inflater::Format::Gzip);
+    std::string out;
+    EXPECT_EQ(truncated.Feed(gz.data(), gz.size() - 5, out), Netease::Inflater::Status::NeedMore);
+    EXPECT_FALSE(Netease::Inflater::Inflate(std::string_view(gz).substr(0, gz.size() / 2),
+                                            Netease::Inflater::Format::Gzip, out));
+
+    // 任意位置翻转一个字节：数据损坏或 CRC32 校验失败
+    for (size_t pos : { (size_t)3, (size_t)12, gz.size() / 2, gz.size() - 6, gz.size() - 2 }) {
+        std::string corrupt = gz;
+        corrupt[pos] ^= 0x5A;
+        out.clear();
+        EXPECT_FALSE(Netease::Inflater::Inflate(corrupt, Netease::Inflater::Format::Gzip, out)) << "pos " << pos;
+    }
+
+    // 不支持的格式
+    out.clear();
+    EXPECT_FALSE(Netease::Inflater::Inflate("not compressed", Netease::Inflater::Format::Zlib, out));
+}
+
+/**
+ * 本地替身服务器：按 Accept-Encoding 返回 gzip / zlib / 明文歌词
+ */
+class CompressedTransferTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        plain = ReadFixture("lyric_sample.json");
+        gz = ReadFixture("lyric_sample.json.gz");
+        zlib = ReadFixture("lyric_sample.json.zlib");
+        ASSERT_FALSE(plain.empty());
+
+        auto handler = [this](const httplib::Request& req, httplib::Response& res) {
+            std::string accept = req.get_header_value("Accept-Encoding");
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                lastAcceptEncoding = accept;
+            }
+            if (encoding == "gzip" && accept.find("gzip") != std::string::npos) {
+                res.set_header("Content-Encoding", "gzip");
+                res.set_content(gz, "application/json");
+            } else if (encoding == "deflate" && accept.find("deflate") != std::string::npos) {
+                res.set_header("Content-Encoding", "deflate");
+                res.set_content(zlib, "application/json");
+            } else {
+                res.set_content(plain, "application/json");
+            }
+        };
+        server.Get("/lyric.json", handler);
+        server.Get("/api/song/lyric", handler);
+
+        // 声明完整长度但只发送一半后断开连接
+        server.Get("/truncated.json", [this](const httplib::Request&, httplib::Response& res) {
+            const std::string& body = encoding == "gzip" ? gz : plain;
+            if (encoding == "gzip") res.set_header("Content-Encoding", "gzip");
+            res.set_content_provider(body.size(), "application/json",
+                [&body](size_t offset, size_t, httplib::DataSink& sink) {
+                    if (offset == 0) sink.write(body.data(), body.size() / 2);
+                    return false;
+                });
+        });
+        server.Get("/long-etag.json", [this](const httplib::Request&, httplib::Response& res) {
+            res.set_header("ETag", longEtag);
+            res.set_header("Last-Modified", "Mon, 01 Jan 2024 00:00:00 GMT");
+            res.set_content(plain, "application/json");
+        });
+
+        port = server.bind_to_any_port("127.0.0.1");
+        ASSERT_GT(port, 0);
+        serverThread = std::thread([this] { server.listen_after_bind(); });
+        server.wait_until_ready();
+
+        Netease::API::ClearLyricCache(SONG_ID);
+    }
+
+    void TearDown() override {
+        server.stop();
+        if (serverThread.joinable()) serverThread.join();
+        Netease::API::SetApiBaseUrl("");
+        Netease::API::ClearLyricCache(SONG_ID);
+    }
+
+    std::string Url(const std::string& path = "/lyric.json") const {
+        return "http://127.0.0.1:" + std::to_string(port) + path;
+    }
+
+    static constexpr long long SONG_ID = 900000020;
+
+    httplib::Server server;
+    std::thread serverThread;
+    int port = 0;
+
+    std::string plain, gz, zlib;
+    std::string encoding = "gzip";
+    std::string longEtag = "\"" + std::string(600, 'e') + "\"";
+    std::mutex mutex;
+    std::string lastAcceptEncoding;
+};
+
+TEST_F(CompressedTransferTest, Gzip_DecodedBodyMatchesAndFewerWireBytes) {
+    auto response = Netease::Http::Get(Url());
+    ASSERT_TRUE(response.has_value());
+    EXPECT_EQ(response->status, 200);
+    EXPECT_EQ(response->contentEncoding, "gzip");
+    EXPECT_EQ(response->body, plain);
+    EXPECT_EQ(response->wireBytes, gz.size());
+    EXPECT_LT(response->wireBytes, plain.size());
+    EXPECT_NE(lastAcceptEncoding.find("gzip"), std::string::npos);
+}
+
+TEST_F(CompressedTransferTest, Deflate_ZlibWrappedBody) {
+    encoding = "deflate";
+    auto response = Netease::Http::Get(Url());
+    ASSERT_TRUE(response.has_value());
+    EXPECT_EQ(response->contentEncoding, "deflate");
+    EXPECT_EQ(response->body, plain);
+    EXPECT_EQ(response->wireBytes, zlib.size());
+}
+
+TEST_F(CompressedTransferTest, AcceptCompressedOff_IdentityPath) {
+    Netease::Http::Options options;
+    options.acceptCompressed = false;
+    auto response = Netease::Http::Get(Url(), options);
+    ASSERT_TRUE(response.has_value());
+    EXPECT_TRUE(response->contentEncoding.empty());
+    EXPECT_EQ(response->body, plain);
+    EXPECT_EQ(response->wireBytes, plain.size());
+    EXPECT_EQ(lastAcceptEncoding.find("gzip"), std::string::npos);
+
+    // 超出正文上限
+    options.maxBodyBytes = 1024;
+    EXPECT_FALSE(Netease::Http::Get(Url(), options).has_value());
+}
+
+TEST_F(CompressedTransferTest, FetchLyricOnline_ThroughGzipEndpoint) {
+    Netease::API::SetApiBaseUrl("http://127.0.0.1:" + std::to_string(port));
+
+    encoding = "identity";
+    auto expected = Netease::API::FetchLyricOnline(SONG_ID, "", false);
+    ASSERT_TRUE(expected.has_value());
+
+    encoding = "gzip";
+    auto lyric = Netease::API::FetchLyricOnline(SONG_ID, "", false);
+    ASSERT_TRUE(lyric.has_value());
+    EXPECT_FALSE(lyric->fromCache);
+    EXPECT_EQ(lyric->lrc, expected->lrc);
+    EXPECT_EQ(lyric->tlyric, expected->tlyric);
+    EXPECT_FALSE(lyric->lrc.empty());
+}
+
+TEST_F(CompressedTransferTest, TruncatedBody_FailsInsteadOfReturningPartial) {
+    // 明文：按 Content-Length 核对
+    Netease::Http::Options options;
+    options.acceptCompressed = false;
+    encoding = "identity";
+    EXPECT_FALSE(Netease::Http::Get(Url("/truncated.json"), options).has_value());
+
+    // 压缩：流不完整
+    encoding = "gzip";
+    EXPECT_FALSE(Netease::Http::Get(Url("/truncated.json")).has_value());
+}
+
+TEST_F(CompressedTransferTest, LongValidators_ReadCompletely) {
+    auto response = Netease::Http::Get(Url("/long-etag.json"));
+    ASSERT_TRUE(response.has_value());
+    EXPECT_EQ(response->etag, longEtag);
+    EXPECT_EQ(response->lastModified, "Mon, 01 Jan 2024 00:00:00 GMT");
+    EXPECT_EQ(response->body, plain);
+}
+
+TEST_F(CompressedTransferTest, Inflate_ReusedOutputBuffer) {
+    // 解压耗时见 NeteaseLyricBench --only inflate
+    std::string out;
+    out.reserve(plain.size());
+    for (int i = 0; i < 3; ++i) {
+        out.clear();
+        ASSERT_TRUE(Netease::Inflater::Inflate(gz, Netease::Inflater::Format::Gzip, out));
+        EXPECT_EQ(out, plain);
+        out.clear();
+        ASSERT_TRUE(Netease::Inflater::Inflate(zlib, Netease::Inflater::Format::Auto, out));
+        EXPECT_EQ(out, plain);
+    }
+}
+
+// ============================================================================
+// 19. 条件刷新测试 (v0.1.4)
+// ============================================================================
+
+/**
+ * 本地替身服务器：歌词 / 元数据带 ETag 与 Last-Modified，验证器匹配时返回 304；
+ * 统计完整响应与 304 次数、同时在途的请求数
+ */
+class RevalidationTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        server.Get("/api/song/lyric", [this](const httplib::Request& req, httplib::Response& res) {
+            long long id = std::stoll(req.get_param_value("id"));
+            Track();
+            std::string etag, lastModified, body;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                int version = versions[id];
+                etag = "\"lrc-" + std::to_string(id) + "-v" + std::to_string(version) + "\"";
+                lastModified = "Mon, 0" + std::to_string(1 + version % 9) + " Jan 2024 00:00:00 GMT";
+                body = "{\"lrc\":{\"version\":" + std::to_string(version) + ",\"lyric\":\"[00:01.00]version " +
+                    std::to_string(version) + " of " + std::to_string(id) + "\\n\"},\"code\":200}";
+            }
+            if (!sendEtag) etag.clear();
+
+            bool fresh = (!etag.empty() && req.get_header_value("If-None-Match") == etag) ||
+                         (etag.empty() && req.get_header_value("If-Modified-Since") == lastModified);
+            if (!etag.empty()) res.set_header("ETag", etag);
+            res.set_header("Last-Modified", lastModified);
+            if (requestDelayMs > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(requestDelayMs.load()));
+            }
+            Untrack();
+
+            if (fresh) {
+                notModifiedCount++;
+                res.status = 304;
+                return;
+            }
+            fullCount++;
+            res.set_content(body, "application/json");
+        });
+        server.Get("/api/song/detail", [this](const httplib::Request& req, httplib::Response& res) {
+            long long id = std::stoll(req.get_param_value("id"));
+            std::string etag = "\"meta-" + std::to_string(id) + "\"";
+            res.set_header("ETag", etag);
+            if (req.get_header_value("If-None-Match") == etag) {
+                notModifiedCount++;
+                res.status = 304;
+                return;
+            }
+            fullCount++;
+            res.set_content("{\"songs\":[{\"name\":\"Song " + std::to_string(id) + "\",\"id\":" + std::to_string(id) +
+                ",\"artists\":[{\"name\":\"Artist\"}],\"album\":{\"name\":\"Album\",\"picUrl\":\"\"},\"duration\":1000}],\"code\":200}",
+                "application/json");
+        });
+
+        port = server.bind_to_any_port("127.0.0.1");
+        ASSERT_GT(port, 0);
+        serverThread = std::thread([this] { server.listen_after_bind(); });
+        server.wait_until_ready();
+
+        // 并发 / 请求计数断言需要每首歌恰好一个请求：关闭对冲
+        Netease::Http::PolicyOptions policy;
+        policy.hedge = false;
+        Netease::Http::RequestPolicy::Default().SetOptions(policy);
+        Netease::Http::RequestPolicy::Default().Reset();
+
+        Netease::API::SetApiBaseUrl("http://127.0.0.1:" + std::to_string(port));
+        Netease::API::ClearAllCache();
+        for (long long id = FIRST_ID; id < FIRST_ID + COUNT; ++id) {
+            Netease::API::ClearLyricCache(id);
+        }
+    }
+
+    void TearDown() override {
+        server.stop();
+        if (serverThread.joinable()) serverThread.join();
+
+        Netease::API::SetApiBaseUrl("");
+        Netease::API::SetCacheConfig(Netease::CacheConfig());
+        Netease::Http::RequestPolicy::Default().SetOptions(Netease::Http::PolicyOptions());
+        for (long long id = FIRST_ID; id < FIRST_ID + COUNT; ++id) {
+            Netease::API::ClearLyricCache(id);
+        }
+        Netease::API::ClearAllCache();
+    }
+
+    void Track() {
+        std::lock_guard<std::mutex> lock(mutex);
+        inFlight++;
+        peakInFlight = (std::max)(peakInFlight, inFlight);
+    }
+
+    void Untrack() {
+        std::lock_guard<std::mutex> lock(mutex);
+        inFlight--;
+    }
+
+    void Bump(long long id) {
+        std::lock_guard<std::mutex> lock(mutex);
+        versions[id]++;
+    }
+
+    static constexpr long long FIRST_ID = 900000030;
+    static constexpr int COUNT = 8;
+
+    httplib::Server server;
+    std::thread serverThread;
+    int port = 0;
+
+    std::mutex mutex;
+    std::map<long long, int> versions;
+    int inFlight = 0;
+    int peakInFlight = 0;
+    std::atomic<bool> sendEtag{true};
+    std::atomic<int> requestDelayMs{0};
+    std::atomic<int> fullCount{0};
+    std::atomic<int> notModifiedCount{0};
+};
+
+TEST_F(RevalidationTest, RefreshLyric_UnchangedIs304) {
+    const long long id = FIRST_ID;
+    ASSERT_TRUE(Netease::API::FetchLyricOnline(id).has_value());
+    EXPECT_EQ(fullCount.load(), 1);
+
+    EXPECT_EQ(Netease::API::RefreshLyric(id), Netease::RefreshStatus::NotModified);
+    EXPECT_EQ(fullCount.load(), 1);
+    EXPECT_EQ(notModifiedCount.load(), 1);
+
+    // 强制刷新走条件请求：304 返回本地缓存内容，但已由服务端确认，不算缓存命中
+    auto lyric = Netease::API::GetLyric(id, false);
+    ASSERT_TRUE(lyric.has_value());
+    EXPECT_FALSE(lyric->fromCache);
+    EXPECT_NE(lyric->lrc.find("version 0"), std::string::npos);
+    EXPECT_EQ(notModifiedCount.load(), 2);
+    EXPECT_EQ(fullCount.load(), 1);
+}
+
+TEST_F(RevalidationTest, RefreshLyric_ChangedContentReplacesCache) {
+    const long long id = FIRST_ID + 1;
+    ASSERT_TRUE(Netease::API::FetchLyricOnline(id).has_value());
+
+    Bump(id);
+    EXPECT_EQ(Netease::API::RefreshLyric(id), Netease::RefreshStatus::Updated);
+    auto local = Netease::API::GetLocalLyric(id);
+    ASSERT_TRUE(local.has_value());
+    EXPECT_NE(local->lrc.find("version 1"), std::string::npos);
+
+    // 新验证器已记录
+    EXPECT_EQ(Netease::API::RefreshLyric(id), Netease::RefreshStatus::NotModified);
+}
+
+TEST_F(RevalidationTest, RefreshLyric_LastModifiedOnlyAndNoCache) {
+    const long long id = FIRST_ID + 2;
+    sendEtag = false;
+
+    // 无本地缓存：完整下载
+    EXPECT_EQ(Netease::API::RefreshLyric(id), Netease::RefreshStatus::Updated);
+    EXPECT_EQ(Netease::API::RefreshLyric(id), Netease::RefreshStatus::NotModified);
+
+    // 手动写入缓存后旧验证器失效，不再发送条件请求
+    Netease::LyricData manual;
+    manual.lrc = "[00:01.00]manual\n";
+    ASSERT_TRUE(Netease::API::CacheLyric(id, manual));
+    int before = fullCount.load();
+    EXPECT_EQ(Netease::API::RefreshLyric(id), Netease::RefreshStatus::Updated);
+    EXPECT_EQ(fullCount.load(), before + 1);
+}
+
+TEST_F(RevalidationTest, RefreshSongDetail_304KeepsMetadata) {
+    const long long id = FIRST_ID + 3;
+    ASSERT_TRUE(Netease::API::GetSongDetail(id).has_value());
+    EXPECT_EQ(Netease::API::RefreshSongDetail(id), Netease::RefreshStatus::NotModified);
+
+    auto meta = Netease::API::GetSongDetail(id);
+    ASSERT_TRUE(meta.has_value());
+    EXPECT_EQ(meta->title, "Song 900000033");
+    EXPECT_EQ(fullCount.load(), 1);
+}
+
+TEST_F(RevalidationTest, StaleRefresh_RespectsConcurrencyLimit) {
+    for (long long id = FIRST_ID; id < FIRST_ID + COUNT; ++id) {
+        ASSERT_TRUE(Netease::API::FetchLyricOnline(id).has_value());
+    }
+    Bump(FIRST_ID + 5);
+
+    Netease::CacheConfig config;
+    config.revalidateAfterSec = 0;      // 全部视为过期
+    Netease::API::SetCacheConfig(config);
+    auto stale = Netease::API::GetStaleLyrics();
+    ASSERT_EQ(stale.size(), (size_t)COUNT);
+
+    requestDelayMs = 50;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        peakInFlight = 0;
+    }
+
+    Netease::CacheRefresher::Options options;
+    options.concurrency = 2;
+    Netease::CacheRefresher refresher(options);
+    ASSERT_TRUE(refresher.Start(stale));
+    EXPECT_FALSE(refresher.Start(stale)) << "上一轮进行中不应开始新一轮";
+    ASSERT_TRUE(refresher.Wait(10000));
+
+    auto stats = refresher.GetStats();
+    EXPECT_EQ(stats.scheduled, (uint64_t)COUNT);
+    EXPECT_EQ(stats.notModified, (uint64_t)COUNT - 1);
+    EXPECT_EQ(stats.updated, 1u);
+    EXPECT_LE(stats.peakInFlight, 2);
+    EXPECT_LE(peakInFlight, 2);
+
+    // 后台入口：使用 CacheConfig::refreshConcurrency
+    int before = notModifiedCount.load();
+    ASSERT_TRUE(Netease::API::RefreshStaleLyricsAsync());
+    for (int i = 0; i < 200 && notModifiedCount.load() < before + COUNT; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    EXPECT_EQ(notModifiedCount.load(), before + COUNT);
+    EXPECT_LE(peakInFlight, config.refreshConcurrency);
+}
+
+TEST_F(RevalidationTest, Shutdown_StopsBackgroundRefreshMidRound) {
+    for (long long id = FIRST_ID; id < FIRST_ID + COUNT; ++id) {
+        ASSERT_TRUE(Netease::API::FetchLyricOnline(id).has_value());
+    }
+
+    Netease::CacheConfig config;
+    config.revalidateAfterSec = 0;      // 全部视为过期
+    config.refreshConcurrency = 1;
+    Netease::API::SetCacheConfig(config);
+    requestDelayMs = 200;
+
+    int before = notModifiedCount.load();
+    ASSERT_TRUE(Netease::API::RefreshStaleLyricsAsync());
+    for (int i = 0; i < 100; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (inFlight > 0) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    // 等待在途请求结束后返回，剩余歌曲不再请求
+    Netease::API::Shutdown();
+    int afterShutdown = notModifiedCount.load() + fullCount.load();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_EQ(inFlight, 0);
+    }
+    EXPECT_LT(notModifiedCount.load() - before, COUNT);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    EXPECT_EQ(notModifiedCount.load() + fullCount.load(), afterShutdown) << "Shutdown 后不应再有刷新请求";
+
+    // 之后仍可再次开始刷新
+    requestDelayMs = 0;
+    ASSERT_TRUE(Netease::API::RefreshStaleLyricsAsync());
+    Netease::API::Shutdown();
+}
+
+TEST_F(RevalidationTest, RefreshLyric_RepeatedUnchanged_NoFullDownloads) {
+    // 完整下载与条件请求的耗时对比见 NeteaseLyricBench --only revalidate
+    const long long id = FIRST_ID + 7;
+    const int ITERATIONS = 20;
+    ASSERT_TRUE(Netease::API::FetchLyricOnline(id).has_value());
+    ASSERT_EQ(fullCount.load(), 1);
+
+    for (int i = 0; i < ITERATIONS; ++i) {
+        ASSERT_EQ(Netease::API::RefreshLyric(id), Netease::RefreshStatus::NotModified);
+    }
+    EXPECT_EQ(fullCount.load(), 1);
+    EXPECT_EQ(notModifiedCount.load(), ITERATIONS);
+
+    auto cached = Netease::API::GetLocalLyric(id);
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_NE(cached->lrc.find("version 0"), std::string::npos);
+}
+
+// ============================================================================
+// 20. 请求策略测试 (v0.1.4)
+// ============================================================================
+
+/**
+ * 故障注入替身服务器：按请求序号决定延迟与状态码
+ */
+class RequestPolicyTest : public ::testing::Test {
+protected:
+    struct Fault {
+        int delayMs = 0;
+        int status = 200;
+    };
+
+    void SetUp() override {
+        auto handler = [this](const httplib::Request&, httplib::Response& res) {
+            int index = hits++;
+            Fault fault;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (script) fault = script(index);
+            }
+            if (fault.delayMs > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(fault.delayMs));
+            }
+            res.status = fault.status;
+            if (fault.status == 200) {
+                res.set_content("{\"lrc\":{\"version\":1,\"lyric\":\"[00:01.00]policy\\n\"},\"code\":200}", "application/json");
+            }
+        };
+        server.Get("/data", handler);
+        server.Get("/api/song/lyric", handler);
+
+        port = server.bind_to_any_port("127.0.0.1");
+        ASSERT_GT(port, 0);
+        serverThread = std::thread([this] { server.listen_after_bind(); });
+        server.wait_until_ready();
+    }
+
+    void TearDown() override {
+        server.stop();
+        if (serverThread.joinable()) serverThread.join();
+        Netease::API::SetApiBaseUrl("");
+        Netease::API::ClearLyricCache(SONG_ID);
+        Netease::Http::RequestPolicy::Default().SetOptions(Netease::Http::PolicyOptions());
+        Netease::Http::RequestPolicy::Default().Reset();
+    }
+
+    void SetScript(std::function<Fault(int)> next) {
+        std::lock_guard<std::mutex> lock(mutex);
+        script = std::move(next);
+    }
+
+    std::string Url() const { return "http://127.0.0.1:" + std::to_string(port) + "/data"; }
+
+    static Netease::Http::PolicyOptions FastOptions() {
+        Netease::Http::PolicyOptions options;
+        options.backoffBaseMs = 10;
+        options.backoffMaxMs = 40;
+        options.hedgeMinSamples = 10;
+        return options;
+    }
+
+    static constexpr long long SONG_ID = 900000040;
+
+    httplib::Server server;
+    std::thread serverThread;
+    int port = 0;
+
+    std::mutex mutex;
+    std::function<Fault(int)> script;
+    std::atomic<int> hits{0};
+};
+
+TEST_F(RequestPolicyTest, Retry_TransientFailuresRecovered) {
+    SetScript([](int index) { return index < 2 ? Fault{ 0, 503 } : Fault{}; });
+
+    Netease::Http::RequestPolicy policy(FastOptions());
+    auto response = policy.Get(Url(), Netease::Http::Options());
+    ASSERT_TRUE(response.has_value());
+    EXPECT_EQ(response->status, 200);
+    EXPECT_EQ(hits.load(), 3);
+    EXPECT_EQ(policy.GetStats().retries, 2u);
+}
+
+TEST_F(RequestPolicyTest, ClientError_NotRetried) {
+    SetScript([](int) { return Fault{ 0, 404 }; });
+
+    Netease::Http::RequestPolicy policy(FastOptions());
+    auto response = policy.Get(Url(), Netease::Http::Options());
+    ASSERT_TRUE(response.has_value());
+    EXPECT_EQ(response->status, 404);
+    EXPECT_EQ(hits.load(), 1);
+    EXPECT_EQ(policy.GetBreakerState(Url()), Netease::Http::BreakerState::Closed);
+}
+
+TEST_F(RequestPolicyTest, Hedge_SlowPrimaryAnsweredByHedge) {
+    // 请求桩：首个请求阻塞到被取消为止，对冲请求立即成功
+    std::atomic<int> calls{0};
+    std::atomic<bool> primaryCancelled{false};
+    Netease::Http::PolicyOptions options = FastOptions();
+    options.hedgeDefaultDelayMs = 20;
+    Netease::Http::RequestPolicy policy(options, [&](const std::string&, const Netease::Http::Options& request)
+        -> std::optional<Netease::Http::Response> {
+        if (calls++ == 0) {
+            for (int waited = 0; waited < 10000 && !request.cancel->IsCancelled(); ++waited) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            primaryCancelled = request.cancel->IsCancelled();
+            return std::nullopt;
+        }
+        Netease::Http::Response response;
+        response.status = 200;
+        response.body = "hedge";
+        return response;
+    });
+
+    auto response = policy.Get(Url(), Netease::Http::Options());
+    ASSERT_TRUE(response.has_value());
+    EXPECT_EQ(response->body, "hedge");
+    EXPECT_TRUE(primaryCancelled.load()) << "对冲请求胜出后应中断首个请求";
+
+    auto stats = policy.GetStats();
+    EXPECT_EQ(stats.attempts, 2u);
+    EXPECT_EQ(stats.hedged, 1u);
+    EXPECT_EQ(stats.hedgeWins, 1u);
+    EXPECT_EQ(stats.retries, 0u);
+    EXPECT_EQ(policy.GetBreakerState(Url()), Netease::Http::BreakerState::Closed);
+}
+
+TEST_F(RequestPolicyTest, Hedge_BothAttemptsFailCountsOnce) {
+    // 首个请求慢且失败，对冲请求也失败：同一轮只计一次连续失败
+    std::atomic<int> calls{0};
+    Netease::Http::PolicyOptions options = FastOptions();
+    options.maxAttempts = 1;
+    options.hedgeDefaultDelayMs = 1;
+    options.hedgeMinDelayMs = 1;
+    options.breakerThreshold = 2;
+    Netease::Http::RequestPolicy policy(options, [&](const std::string&, const Netease::Http::Options&)
+        -> std::optional<Netease::Http::Response> {
+        if (calls++ % 2 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        Netease::Http::Response response;
+        response.status = 503;
+        return response;
+    });
+
+    auto response = policy.Get(Url(), Netease::Http::Options());
+    ASSERT_TRUE(response.has_value());
+    EXPECT_EQ(response->status, 503);
+    EXPECT_EQ(policy.GetStats().hedged, 1u);
+    EXPECT_EQ(policy.GetBreakerState(Url()), Netease::Http::BreakerState::Closed);
+
+    policy.Get(Url(), Netease::Http::Options());
+    EXPECT_EQ(policy.GetBreakerState(Url()), Netease::Http::BreakerState::Open);
+}
+
+TEST_F(RequestPolicyTest, Shutdown_CancelsAndJoinsHedges) {
+    // 首个请求先成功，落后的对冲请求阻塞到被取消：析构时必须中断并 join
+    std::atomic<int> calls{0};
+    std::atomic<bool> hedgeCancelled{false};
+    Netease::Http::PolicyOptions options = FastOptions();
+    options.hedgeDefaultDelayMs = 1;
+    options.hedgeMinDelayMs = 1;
+    auto policy = std::make_unique<Netease::Http::RequestPolicy>(options,
+        [&](const std::string&, const Netease::Http::Options& request) -> std::optional<Netease::Http::Response> {
+            if (calls++ == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(30));
+                Netease::Http::Response response;
+                response.status = 200;
+                return response;
+            }
+            for (int waited = 0; waited < 10000 && !request.cancel->IsCancelled(); ++waited) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            hedgeCancelled = request.cancel->IsCancelled();
+            return std::nullopt;
+        });
+
+    ASSERT_TRUE(policy->Get(Url(), Netease::Http::Options()).has_value());
+    policy.reset();
+    EXPECT_EQ(calls.load(), 2);
+    EXPECT_TRUE(hedgeCancelled.load());
+}
+
+TEST_F(RequestPolicyTest, CircuitBreaker_FailsFastAndRecovers) {
+    // 请求桩 + 手动时钟：按请求次数与熔断状态断言，不依赖真实等待
+    int64_t now = 1000000;
+    std::atomic<int> status{503};
+    std::atomic<int> calls{0};
+    Netease::Http::PolicyOptions options = FastOptions();
+    options.maxAttempts = 1;
+    options.hedge = false;
+    options.breakerThreshold = 3;
+    options.breakerCooldownMs = 300;
+    Netease::Http::RequestPolicy policy(options,
+        [&](const std::string&, const Netease::Http::Options&) -> std::optional<Netease::Http::Response> {
+            calls++;
+            Netease::Http::Response response;
+            response.status = status;
+            return response;
+        },
+        [&] { return now; });
+
+    for (int i = 0; i < 3; ++i) {
+        policy.Get(Url(), Netease::Http::Options());
+    }
+    EXPECT_EQ(policy.GetBreakerState(Url()), Netease::Http::BreakerState::Open);
+
+    // 熔断中：不发出请求，立即失败
+    EXPECT_FALSE(policy.Get(Url(), Netease::Http::Options()).has_value());
+    EXPECT_EQ(calls.load(), 3);
+    EXPECT_EQ(policy.GetStats().shortCircuited, 1u);
+
+    // 冷却结束：探测失败重新打开
+    now += 300;
+    policy.Get(Url(), Netease::Http::Options());
+    EXPECT_EQ(calls.load(), 4);
+    EXPECT_EQ(policy.GetBreakerState(Url()), Netease::Http::BreakerState::Open);
+
+    // 冷却未结束前仍然直接失败
+    status = 200;
+    now += 299;
+    EXPECT_FALSE(policy.Get(Url(), Netease::Http::Options()).has_value());
+    EXPECT_EQ(calls.load(), 4);
+
+    // 主机恢复：探测成功后关闭
+    now += 1;
+    auto response = policy.Get(Url(), Netease::Http::Options());
+    ASSERT_TRUE(response.has_value());
+    EXPECT_EQ(response->status, 200);
+    EXPECT_EQ(calls.load(), 5);
+    EXPECT_EQ(policy.GetBreakerState(Url()), Netease::Http::BreakerState::Closed);
+}
+
+TEST_F(RequestPolicyTest, FetchLyricOnline_RetriesThroughDefaultPolicy) {
+    SetScript([](int index) { return index == 0 ? Fault{ 0, 502 } : Fault{}; });
+    Netease::Http::RequestPolicy::Default().SetOptions(FastOptions());
+    Netease::Http::RequestPolicy::Default().Reset();
+    Netease::API::SetApiBaseUrl("http://127.0.0.1:" + std::to_string(port));
+
+    auto lyric = Netease::API::FetchLyricOnline(SONG_ID, "", false);
+    ASSERT_TRUE(lyric.has_value());
+    EXPECT_NE(lyric->lrc.find("policy"), std::string::npos);
+    EXPECT_EQ(hits.load(), 2);
+}
+
+TEST_F(RequestPolicyTest, FaultInjection_PolicyMasksTransientErrors) {
+    // 直连与策略的延迟分布对比见 NeteaseLyricBench --only policy
+    const int REQUESTS = 100;
+
+    // 2.5% 503
+    SetScript([](int index) { return index % 40 == 7 ? Fault{ 0, 503 } : Fault{}; });
+
+    int rawFailures = 0;
+    for (int i = 0; i < REQUESTS; ++i) {
+        auto response = Netease::Http::Get(Url());
+        if (!response || response->status != 200) rawFailures++;
+    }
+
+    hits = 0;
+    Netease::Http::RequestPolicy policy(FastOptions());
+    int policyFailures = 0;
+    for (int i = 0; i < REQUESTS; ++i) {
+        auto response = policy.Get(Url(), Netease::Http::Options());
+        if (!response || response->status != 200) policyFailures++;
+    }
+
+    EXPECT_GT(rawFailures, 0);
+    EXPECT_EQ(policyFailures, 0);
+    EXPECT_EQ(policy.GetBreakerState(Url()), Netease::Http::BreakerState::Closed);
+}
+
+// ============================================================================
+// 21. 缓存批量导入测试 (v0.1.4)
+// ============================================================================
+
+class CacheImportTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root = fs::temp_directory_path() / ("netease_import_test_" + std::to_string(GetCurrentProcessId()));
+        fs::remove_all(root);
+        fs::create_directories(root);
+        UsePack("pack");
+    }
+
+    void TearDown() override {
+        Netease::API::SetCacheConfig(Netease::CacheConfig());
+        std::error_code ec;
+        fs::remove_all(root, ec);
+    }
+
+    void UsePack(const std::string& name) {
+        Netease::CacheConfig config;
+        config.backend = Netease::CacheBackend::Pack;
+        config.packDir = (root / name).string();
+        config.packBackgroundCompaction = false;
+        Netease::API::SetCacheConfig(config);
+    }
+
+    // 模拟网易云 webdata/lyric 目录：count 首约 1.5KB 的 JSON 歌词
+    fs::path MakeSourceDir(const std::string& name, long long firstId, int count, const std::string& tag = "") {
+        fs::path dir = root / name;
+        fs::create_directories(dir);
+        for (int i = 0; i < count; ++i) {
+            Netease::LyricData data = MakeLyric(firstId + i, tag);
+            std::string json = "{\"lyric\":\"";
+            Netease::Json::AppendEscaped(json, data.lrc);
+            json += "\",\"translateLyric\":\"";
+            Netease::Json::AppendEscaped(json, data.tlyric);
+            json += "\"}";
+            std::ofstream(dir / std::to_string(firstId + i), std::ios::binary) << json;
+        }
+        return dir;
+    }
+
+    static Netease::LyricData MakeLyric(long long songId, const std::string& tag = "") {
+        Netease::LyricData data;
+        for (int line = 0; line < 30; ++line) {
+            data.lrc += "[00:" + std::to_string(10 + line) + ".00]line " + std::to_string(line) + " " + tag + " 歌词\n";
+        }
+        data.tlyric = "[00:10.00]translation " + std::to_string(songId);
+        return data;
+    }
+
+    fs::path root;
+};
+
+TEST_F(CacheImportTest, Fixtures_ValidatesAndNormalizes) {
+    Netease::ImportOptions options;
+    options.sourceDirs = { (fs::path(NETEASE_TEST_FIXTURE_DIR) / "lyric_cache").string() };
+    options.threads = 4;
+
+    auto report = Netease::API::ImportLyricCache(options);
+    EXPECT_EQ(report.filesScanned, 6u) << ".tmp 等非歌曲 ID 文件不应计入";
+    EXPECT_EQ(report.imported, 4u);
+    EXPECT_EQ(report.invalid, 2u) << "无时间标签 / 空文件";
+    EXPECT_EQ(report.failed, 0u);
+    EXPECT_GT(report.bytesRead, 0u);
+
+    auto json = Netease::API::GetLocalLyric(910000001);
+    ASSERT_TRUE(json.has_value());
+    EXPECT_NE(json->lrc.find("[00:15.80]"), std::string::npos);
+    EXPECT_NE(json->tlyric.find("second line"), std::string::npos);
+
+    auto roma = Netease::API::GetLocalLyric(910000002);
+    ASSERT_TRUE(roma.has_value());
+    EXPECT_EQ(roma->romalrc, "[00:01.00]haro waarudo");
+
+    auto bom = Netease::API::GetLocalLyric(910000003);
+    ASSERT_TRUE(bom.has_value());
+    EXPECT_EQ(bom->lrc, "[00:02.00]BOM prefixed cache file\n[00:04.00]second") << "BOM 去除后按 JSON 解析";
+
+    auto crlf = Netease::API::GetLocalLyric(910000004);
+    ASSERT_TRUE(crlf.has_value());
+    EXPECT_EQ(crlf->lrc, "[00:05.00]Plain text cache\n[00:07.50]with CRLF line endings\n");
+
+    EXPECT_FALSE(Netease::API::GetLocalLyric(910000005).has_value());
+}
+
+TEST_F(CacheImportTest, SecondRun_SkipsExistingUnlessOverwrite) {
+    Netease::ImportOptions options;
+    options.sourceDirs = { MakeSourceDir("src", 910100000, 50).string() };
+
+    EXPECT_EQ(Netease::API::ImportLyricCache(options).imported, 50u);
+
+    auto again = Netease::API::ImportLyricCache(options);
+    EXPECT_EQ(again.imported, 0u);
+    EXPECT_EQ(again.skipped, 50u);
+
+    options.overwrite = true;
+    EXPECT_EQ(Netease::API::ImportLyricCache(options).imported, 50u);
+}
+
+TEST_F(CacheImportTest, DuplicateAcrossDirs_FirstDirWins) {
+    Netease::ImportOptions options;
+    options.sourceDirs = {
+        MakeSourceDir("primary", 910200000, 20, "primary").string(),
+        MakeSourceDir("secondary", 910200010, 20, "secondary").string()
+    };
+
+    auto report = Netease::API::ImportLyricCache(options);
+    EXPECT_EQ(report.filesScanned, 40u);
+    EXPECT_EQ(report.imported, 30u);
+    EXPECT_EQ(report.skipped, 10u);
+
+    auto shared = Netease::API::GetLocalLyric(910200015);
+    ASSERT_TRUE(shared.has_value());
+    EXPECT_NE(shared->lrc.find("primary"), std::string::npos);
+    auto onlySecondary = Netease::API::GetLocalLyric(910200025);
+    ASSERT_TRUE(onlySecondary.has_value());
+    EXPECT_NE(onlySecondary->lrc.find("secondary"), std::string::npos);
+}
+
+TEST_F(CacheImportTest, FilesBackend_WritesSdkDirAndIndex) {
+    Netease::API::SetCacheConfig(Netease::CacheConfig());
+
+    Netease::ImportOptions options;
+    options.sourceDirs = { MakeSourceDir("src", 910300000, 10).string() };
+    options.overwrite = true;
+
+    EXPECT_EQ(Netease::API::ImportLyricCache(options).imported, 10u);
+    for (int i = 0; i < 10; ++i) {
+        auto lyric = Netease::API::GetLocalLyric(910300000 + i);
+        ASSERT_TRUE(lyric.has_value());
+        EXPECT_NE(lyric->tlyric.find(std::to_string(910300000 + i)), std::string::npos);
+        Netease::API::ClearLyricCache(910300000 + i);
+    }
+}
+
+TEST_F(CacheImportTest, BulkImport_MultipleBatchesAllReadable) {
+    // 跨多个写入批次；与逐首 CacheLyric 的吞吐量对比见 NeteaseLyricBench --only import
+    const int count = 1200;
+    fs::path source = MakeSourceDir("bulk", 910400000, count);
+
+    Netease::ImportOptions options;
+    options.sourceDirs = { source.string() };
+    options.batchSize = 500;
+    auto report = Netease::API::ImportLyricCache(options);
+
+    EXPECT_EQ(report.imported, (size_t)count);
+    EXPECT_EQ(report.invalid, 0u);
+    EXPECT_EQ(report.failed, 0u);
+    for (int i : { 0, 499, 500, 999, 1000, count - 1 }) {
+        auto lyric = Netease::API::GetLocalLyric(910400000 + i);
+        ASSERT_TRUE(lyric.has_value()) << i;
+        EXPECT_NE(lyric->tlyric.find(std::to_string(910400000 + i)), std::string::npos);
+    }
+}
+
+// ============================================================================
+// 22. 缓存容量预算测试 (v0.1.4)
+// ============================================================================
+
+class CacheBudgetTest : public ::testing::Test {
+protected:
+    static constexpr int64_t HOUR_MS = 3600LL * 1000;
+    static constexpr int64_t DAY_MS = 24 * HOUR_MS;
+
+    Netease::CacheBudget MakeBudget(size_t maxEntries, uint64_t maxBytes, int64_t halfLifeMs,
+                                    const std::string& persistPath = "") {
+        Netease::CacheBudget::Options options;
+        options.maxEntries = maxEntries;
+        options.maxBytes = maxBytes;
+        options.halfLifeMs = halfLifeMs;
+        return Netease::CacheBudget(persistPath, options, [this] { return now; });
+    }
+
+    // 按策略淘汰直到回到预算内（模拟后台分批淘汰）
+    static size_t Drain(Netease::CacheBudget& budget) {
+        size_t total = 0;
+        while (true) {
+            auto victims = budget.CollectVictims(64);
+            if (victims.empty()) return total;
+            for (long long songId : victims) budget.RecordEviction(songId);
+            total += victims.size();
+        }
+    }
+
+    // 轮询等待后台淘汰线程（超时只用于防止挂起）
+    template <typename Pred>
+    static bool WaitFor(Pred pred, int timeoutMs = 10000) {
+        for (int waited = 0; waited < timeoutMs; waited += 10) {
+            if (pred()) return true;
+            Sleep(10);
+        }
+        return pred();
+    }
+
+    int64_t now = 1700000000000LL;
+};
+
+TEST_F(CacheBudgetTest, EntryAndByteLimits_EvictToLowWatermark) {
+    auto budget = MakeBudget(100, 0, DAY_MS);
+    for (int i = 0; i < 150; ++i) {
+        now += 1000;
+        budget.RecordWrite(i, 1000);
+    }
+    EXPECT_TRUE(budget.IsOverBudget());
+    EXPECT_EQ(budget.CollectVictims(0).size(), 60u) << "淘汰到 90 条";
+    EXPECT_EQ(budget.CollectVictims(10).size(), 10u);
+
+    EXPECT_EQ(Drain(budget), 60u);
+    EXPECT_EQ(budget.GetStats().entries, 90u);
+    EXPECT_EQ(budget.GetStats().evictedBytes, 60000u);
+    EXPECT_FALSE(budget.Lookup(0).has_value()) << "同等频率下先淘汰最旧的";
+    EXPECT_TRUE(budget.Lookup(149).has_value());
+
+    auto bytes = MakeBudget(0, 10000, DAY_MS);
+    for (int i = 0; i < 30; ++i) bytes.RecordWrite(i, 500);
+    bytes.RecordWrite(5, 2000);     // 覆盖写入按新大小计
+    EXPECT_EQ(bytes.GetStats().bytes, 29u * 500 + 2000);
+    Drain(bytes);
+    EXPECT_LE(bytes.GetStats().bytes, 9000u);
+}
+
+TEST_F(CacheBudgetTest, HalfLife_TradesRecencyAgainstFrequency) {
+    // A 早期被播放 20 次，B 十天后只播放 1 次；预算只容得下一首
+    auto run = [&](int64_t halfLifeMs) {
+        auto budget = MakeBudget(1, 0, halfLifeMs);
+        now = 1700000000000LL;
+        budget.RecordWrite(1, 100);
+        for (int i = 0; i < 19; ++i) budget.RecordAccess(1);
+        now += 10 * DAY_MS;
+        budget.RecordWrite(2, 100);
+        auto victims = budget.CollectVictims(1);
+        return victims.empty() ? 0LL : victims[0];
+    };
+
+    EXPECT_EQ(run(DAY_MS), 1) << "短半衰期：接近 LRU，久未播放的先淘汰";
+    EXPECT_EQ(run(30 * DAY_MS), 2) << "长半衰期：接近 LFU，高频歌曲保留";
+    EXPECT_EQ(run(0), 1) << "半衰期为 0：纯 LRU";
+}
+
+TEST_F(CacheBudgetTest, SyntheticTrace_FlatSizeAndHotSetResident) {
+    // 90 天：每天 200 首只听一次的新歌 + 30 首常听歌曲（每天各播放数次）
+    const size_t maxEntries = 1000;
+    auto budget = MakeBudget(maxEntries, 2 * 1024 * 1024, 7 * DAY_MS);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> size(800, 3000);
+
+    long long nextId = 1000;
+    uint64_t peakBytes = 0;
+    size_t peakEntries = 0;
+    for (int day = 0; day < 90; ++day) {
+        for (int hour = 0; hour < 24; ++hour) {
+            now += HOUR_MS;
+            for (int i = 0; i < 8; ++i) budget.RecordWrite(nextId++, size(rng));
+            if (hour % 6 == 0) {
+                for (long long hot = 1; hot <= 30; ++hot) {
+                    if (!budget.RecordAccess(hot)) budget.RecordWrite(hot, 2000);
+                }
+            }
+            Drain(budget);
+            peakBytes = (std::max)(peakBytes, budget.GetStats().bytes);
+            peakEntries = (std::max)(peakEntries, (size_t)budget.GetStats().entries);
+        }
+    }
+
+    auto stats = budget.GetStats();
+    EXPECT_LE(peakEntries, maxEntries);
+    EXPECT_LE(peakBytes, 2u * 1024 * 1024);
+    EXPECT_GT(stats.evictedEntries, 15000u);
+    for (long long hot = 1; hot <= 30; ++hot) {
+        EXPECT_TRUE(budget.Lookup(hot).has_value()) << "常听歌曲被淘汰: " << hot;
+    }
+}
+
+TEST_F(CacheBudgetTest, Persist_SurvivesRestart) {
+    std::string path = (fs::temp_directory_path() / ("netease_budget_" + std::to_string(GetCurrentProcessId()) + ".txt")).string();
+    fs::remove(path);
+    {
+        auto budget = MakeBudget(100, 0, DAY_MS, path);
+        budget.RecordWrite(11, 1234);
+        budget.RecordWrite(12, 99);
+        budget.RecordAccess(11);
+        budget.Forget(12);
+        budget.Flush();
+    }
+
+    auto budget = MakeBudget(100, 0, DAY_MS, path);
+    auto entry = budget.Lookup(11);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->bytes, 1234u);
+    EXPECT_DOUBLE_EQ(entry->hits, 2.0);
+    EXPECT_FALSE(budget.Lookup(12).has_value());
+    EXPECT_EQ(budget.GetStats().bytes, 1234u);
+
+    budget.Clear();
+    EXPECT_FALSE(fs::exists(path));
+}
+
+TEST_F(CacheBudgetTest, ApiPackBackend_TrimKeepsHotSongs) {
+    fs::path root = fs::temp_directory_path() / ("netease_budget_pack_" + std::to_string(GetCurrentProcessId()));
+    fs::remove_all(root);
+
+    Netease::CacheConfig config;
+    config.backend = Netease::CacheBackend::Pack;
+    config.packDir = root.string();
+    config.packBackgroundCompaction = false;
+    config.maxCacheEntries = 20;
+    Netease::API::SetCacheConfig(config);
+    Netease::API::ClearAllCache();      // 之前测试遗留的跟踪条目
+
+    const long long baseId = 910500000;
+    Netease::LyricData data;
+    data.lrc = "[00:01.00]budget";
+    for (int hot = 0; hot < 5; ++hot) {
+        ASSERT_TRUE(Netease::API::CacheLyric(baseId + hot, data));
+    }
+    for (int i = 5; i < 60; ++i) {
+        ASSERT_TRUE(Netease::API::CacheLyric(baseId + i, data));
+        for (int hot = 0; hot < 5; ++hot) {
+            ASSERT_TRUE(Netease::API::GetLocalLyric(baseId + hot).has_value()) << "常听歌曲在第 " << i << " 首时丢失";
+        }
+    }
+    Netease::API::TrimCache();
+
+    auto usage = Netease::API::GetCacheUsage();
+    EXPECT_LE(usage.entries, 20u);
+    EXPECT_GT(usage.evictedEntries, 0u);
+    EXPECT_FALSE(Netease::API::GetLocalLyric(baseId + 5).has_value()) << "冷门歌曲应已从包文件删除";
+    EXPECT_TRUE(Netease::API::GetLocalLyric(baseId + 59).has_value());
+
+    Netease::API::SetCacheConfig(Netease::CacheConfig());
+    for (int i = 0; i < 60; ++i) Netease::API::ClearLyricCache(baseId + i);
+    std::error_code ec;
+    fs::remove_all(root, ec);
+}
+
+TEST_F(CacheBudgetTest, BackgroundEviction_DrainsOnOwnedWorker) {
+    // 批大小与耗时的关系见 NeteaseLyricBench --only budget
+    auto budget = MakeBudget(100, 0, DAY_MS);
+    auto options = budget.GetOptions();
+    options.evictionBatch = 16;
+    options.evictionPauseMs = 0;
+    budget.SetOptions(options);
+    for (int i = 0; i < 150; ++i) {
+        now += 1000;
+        budget.RecordWrite(i, 1000);
+    }
+
+    std::atomic<int> batches{0};
+    std::atomic<bool> drained{false};
+    budget.SetEvictor([&](size_t maxCount) {
+        auto victims = budget.CollectVictims(maxCount);
+        EXPECT_LE(victims.size(), 16u);
+        for (long long songId : victims) budget.RecordEviction(songId);
+        if (victims.empty()) drained = true;
+        batches++;
+        return victims.size();
+    });
+
+    budget.ScheduleEviction();
+    ASSERT_TRUE(WaitFor([&] { return drained.load(); }));
+    budget.Stop();
+
+    EXPECT_EQ(budget.GetStats().entries, 90u);
+    EXPECT_EQ(budget.GetStats().evictedEntries, 60u);
+    EXPECT_EQ(batches.load(), 5) << "4 批淘汰 + 1 次确认回到预算内";
+}
+
+TEST_F(CacheBudgetTest, BackgroundEviction_StopInterruptsPauseAndRestarts) {
+    auto budget = MakeBudget(100, 0, DAY_MS);
+    auto options = budget.GetOptions();
+    options.evictionBatch = 16;
+    options.evictionPauseMs = 3600 * 1000;     // Stop 必须打断批间暂停，否则测试挂起
+    budget.SetOptions(options);
+    for (int i = 0; i < 150; ++i) {
+        now += 1000;
+        budget.RecordWrite(i, 1000);
+    }
+
+    std::atomic<int> batches{0};
+    budget.SetEvictor([&](size_t maxCount) {
+        auto victims = budget.CollectVictims(maxCount);
+        for (long long songId : victims) budget.RecordEviction(songId);
+        batches++;
+        return victims.size();
+    });
+
+    budget.ScheduleEviction();
+    ASSERT_TRUE(WaitFor([&] { return batches.load() > 0; }));
+    budget.Stop();
+    EXPECT_EQ(batches.load(), 1);
+    EXPECT_EQ(budget.GetStats().entries, 134u) << "只完成了第一批";
+
+    // 停止后可以重新启动
+    options.evictionPauseMs = 0;
+    budget.SetOptions(options);
+    budget.ScheduleEviction();
+    ASSERT_TRUE(WaitFor([&] { return budget.GetStats().entries == 90; }));
+    budget.Stop();
+    EXPECT_FALSE(budget.IsOverBudget());
+}
+
+// ============================================================================
+// 23. 歌词合并（数值时间戳归并）测试 (v0.1.4)
+// ============================================================================
+
+namespace {
+
+// v0.1.3 实现（regex + map + set），用作结果对照
+std::string LegacyMergeLyrics(const std::string& lrc, const std::string& tlyric) {
+    auto parseLyric = [](const std::string& lyric) {
+        std::map<std::string, std::string> result;
+        std::istringstream iss(lyric);
+        std::string line;
+        std::regex timePattern("\\[(\\d{2}:\\d{2}\\.\\d{2})\\]");
+        while (std::getline(iss, line)) {
+            std::smatch match;
+            if (std::regex_search(line, match, timePattern)) {
+                size_t textStart = line.find(']') + 1;
+                result[match[1].str()] = textStart < line.length() ? line.substr(textStart) : "";
+            }
+        }
+        return result;
+    };
+
+    auto lrcMap = parseLyric(lrc);
+    auto tlyricMap = parseLyric(tlyric);
+    std::ostringstream oss;
+    std::set<std::string> allTimestamps;
+    for (const auto& [ts, _] : lrcMap) allTimestamps.insert(ts);
+    for (const auto& [ts, _] : tlyricMap) allTimestamps.insert(ts);
+    for (const auto& ts : allTimestamps) {
+        std::string original = lrcMap[ts];
+        std::string translation = tlyricMap[ts];
+        oss << "[" << ts << "]";
+        if (!original.empty() && !translation.empty()) oss << original << " / " << translation;
+        else if (!original.empty()) oss << original;
+        else oss << translation;
+        oss << "\n";
+    }
+    return oss.str();
+}
+
+std::string FormatTag(int ms, int digits) {
+    char buffer[32];
+    if (digits == 3) {
+        snprintf(buffer, sizeof(buffer), "[%02d:%02d.%03d]", ms / 60000, ms / 1000 % 60, ms % 1000);
+    } else {
+        snprintf(buffer, sizeof(buffer), "[%02d:%02d.%02d]", ms / 60000, ms / 1000 % 60, ms % 1000 / 10);
+    }
+    return buffer;
+}
+
+} // namespace
+
+TEST(MergeLyricsTest, ThreeDigitMilliseconds_MergedWithinTolerance) {
+    std::string result = Netease::API::MergeLyrics("[00:10.123]Hello\n[00:12.500]World", "[00:10.12]你好\n[00:12.50]世界");
+    EXPECT_EQ(result, "[00:10.123]Hello / 你好\n[00:12.500]World / 世界\n");
+}
+
+TEST(MergeLyricsTest, MultipleTimeTags_ExpandedInTimeOrder) {
+    std::string lrc = "[00:01.00][00:05.00]Chorus\n[00:03.00]Verse";
+    std::string tlyric = "[00:05.00]合唱\n[00:01.00]合唱\n[00:03.00]主歌";
+    EXPECT_EQ(Netease::API::MergeLyrics(lrc, tlyric),
+              "[00:01.00]Chorus / 合唱\n[00:03.00]Verse / 主歌\n[00:05.00]Chorus / 合唱\n");
+}
+
+TEST(MergeLyricsTest, ToleranceWindow_ControlsMatching) {
+    std::string lrc = "[00:10.00]Line";
+    std::string tlyric = "[00:10.05]行";
+    EXPECT_EQ(Netease::API::MergeLyrics(lrc, tlyric, 10), "[00:10.00]Line\n[00:10.05]行\n");
+    EXPECT_EQ(Netease::API::MergeLyrics(lrc, tlyric, 100), "[00:10.00]Line / 行\n");
+}
+
+TEST(MergeLyricsTest, MetadataCrlfAndEmptyLines) {
+    std::string lrc = "[ar:Artist]\r\n[ti:Title]\r\n[00:01.00]\r\n[00:02.00]Text\r\nno tag line\r\n";
+    std::string tlyric = "[by:someone]\n[00:01.00]译文\n";
+    EXPECT_EQ(Netease::API::MergeLyrics(lrc, tlyric), "[00:01.00]译文\n[00:02.00]Text\n");
+}
+
+TEST(MergeLyricsTest, LongLyrics_MatchesLegacyAndKeepsEveryLine) {
+    // 与 v0.1.3 regex 实现的耗时对比见 NeteaseLyricBench --only merge
+    // 长歌词：两轨各 3000 行，翻译使用两位精度、原文使用三位精度的一半行
+    std::string lrc;
+    std::string tlyric;
+    for (int i = 0; i < 3000; ++i) {
+        int ms = i * 1370;
+        lrc += FormatTag(ms, i % 2 ? 3 : 2) + "original line number " + std::to_string(i) + " with some words\n";
+        tlyric += FormatTag(ms, 2) + "翻译第 " + std::to_string(i) + " 行\n";
+    }
+
+    // 两位精度的行上两种实现结果一致
+    std::string evenLrc;
+    std::string evenTlyric;
+    for (int i = 0; i < 3000; i += 2) {
+        evenLrc += FormatTag(i * 1370, 2) + "line " + std::to_string(i) + "\n";
+        evenTlyric += FormatTag(i * 1370, 2) + "行 " + std::to_string(i) + "\n";
+    }
+    EXPECT_EQ(Netease::API::MergeLyrics(evenLrc, evenTlyric), LegacyMergeLyrics(evenLrc, evenTlyric));
+
+    std::string merged = Netease::API::MergeLyrics(lrc, tlyric);
+    EXPECT_EQ(std::count(merged.begin(), merged.end(), '\n'), 3000) << "三位毫秒的行不应被丢弃或拆开";
+}
+
+// ============================================================================
+// 24. 紧凑歌词时间轴测试 (v0.1.4)
+// ============================================================================
+
+extern "C" {
+    typedef struct Netease_LrcTimeline Netease_LrcTimeline;
+    Netease_LrcTimeline* Netease_LrcParse(const char* lrc, const char* tlyric, const char* romalrc, int toleranceMs);
+    void Netease_LrcFree(Netease_LrcTimeline* handle);
+    int Netease_LrcCount(const Netease_LrcTimeline* handle);
+    long long Netease_LrcTimeMs(const Netease_LrcTimeline* handle, int index);
+    const char* Netease_LrcText(const Netease_LrcTimeline* handle, int index);
+    const char* Netease_LrcTranslation(const Netease_LrcTimeline* handle, int index);
+    const char* Netease_LrcRomaji(const Netease_LrcTimeline* handle, int index);
+    int Netease_LrcFind(const Netease_LrcTimeline* handle, long long timeMs);
+}
+
+namespace {
+
+// v0.1.3 App 实现（stringstream + std::map<double, string>），用作结果对照
+std::map<double, std::string> LegacyParseLrcToMap(const std::string& lrc, double* outOffset = nullptr) {
+    std::map<double, std::string> result;
+    std::stringstream ss(lrc);
+    std::string line;
+    while (std::getline(ss, line)) {
+        if (line.empty()) continue;
+        if (outOffset && line.find("[offset:") != std::string::npos) {
+            size_t start = line.find(':') + 1;
+            size_t end = line.find(']');
+            if (end != std::string::npos) {
+                try { *outOffset = std::stod(line.substr(start, end - start)) / 1000.0; } catch (...) {}
+            }
+            continue;
+        }
+
+        std::vector<double> timestamps;
+        size_t lastBracketEnd = 0;
+        size_t pos = 0;
+        while (true) {
+            size_t bracketStart = line.find('[', pos);
+            size_t bracketEnd = line.find(']', pos);
+            if (bracketStart == std::string::npos || bracketEnd == std::string::npos || bracketEnd < bracketStart) break;
+            std::string tag = line.substr(bracketStart + 1, bracketEnd - bracketStart - 1);
+            size_t colon = tag.find(':');
+            size_t dot = tag.find_last_of(".:");
+            if (colon != std::string::npos) {
+                int m = std::atoi(tag.substr(0, colon).c_str());
+                if (dot != std::string::npos && dot > colon) {
+                    int sec = std::atoi(tag.substr(colon + 1, dot - colon - 1).c_str());
+                    timestamps.push_back(m * 60.0 + sec + std::atof(("0." + tag.substr(dot + 1)).c_str()));
+                } else {
+                    timestamps.push_back(m * 60.0 + std::atoi(tag.substr(colon + 1).c_str()));
+                }
+            }
+            lastBracketEnd = bracketEnd;
+            pos = bracketEnd + 1;
+            size_t nextBracket = line.find('[', pos);
+            if (nextBracket == std::string::npos || line.find_first_not_of(" \t", pos) != nextBracket) break;
+            pos = nextBracket;
+        }
+        if (timestamps.empty()) continue;
+
+        std::string text = line.substr(lastBracketEnd + 1);
+        text.erase(0, text.find_first_not_of(" \t\r\n"));
+        size_t last = text.find_last_not_of(" \t\r\n");
+        if (last != std::string::npos) text.erase(last + 1);
+        if (!text.empty()) {
+            for (double ts : timestamps) result[ts] = text;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(LrcTimelineTest, MultiTagLines_ShareOneSpan) {
+    auto timeline = Netease::API::ParseTimeline("[ti:Title]\n[00:30.00][00:10.00]Chorus\n[00:20.00]Verse\n");
+
+    ASSERT_EQ(timeline.Size(), 3u);
+    EXPECT_EQ(timeline.timesMs, (std::vector<int64_t>{ 10000, 20000, 30000 }));
+    EXPECT_EQ(timeline.Text(0), "Chorus");
+    EXPECT_EQ(timeline.Text(1), "Verse");
+    EXPECT_EQ(timeline.Text(2), "Chorus");
+    EXPECT_EQ(timeline.text[0], timeline.text[2]) << "同一行的多个标签应共享文本";
+    EXPECT_EQ(timeline.spans.size(), 2u);
+}
+
+TEST(LrcTimelineTest, TimeTagFormatsAndOffset) {
+    std::string lrc =
+        "[offset:+500]\r\n"
+        "[00:01]a\r\n"
+        "[00:02.5]b\r\n"
+        "[00:03.25]c\r\n"
+        "[00:04.125]d\r\n"
+        "[00:05:50]e\r\n"
+        "[1:02.00]  f  \r\n";
+    auto timeline = Netease::API::ParseTimeline(lrc);
+
+    EXPECT_EQ(timeline.offsetMs, 500);
+    EXPECT_EQ(timeline.timesMs, (std::vector<int64_t>{ 1500, 3000, 3750, 4625, 6000, 62500 }));
+    EXPECT_EQ(timeline.Text(5), "f") << "文本应去除首尾空白";
+
+    auto negative = Netease::API::ParseTimeline("[00:10.00]x\n[offset:-250]\n");
+    EXPECT_EQ(negative.timesMs, (std::vector<int64_t>{ 9750 })) << "[offset:] 可以出现在任意位置";
+}
+
+TEST(LrcTimelineTest, TranslationAndRomajiMatchedWithinTolerance) {
+    std::string lrc = "[00:10.000]Hello\n[00:12.000]World\n[00:14.000]\n[00:16.000]Alone\n";
+    std::string tlyric = "[00:10.05]你好\n[00:12.00]世界\n[00:16.90]太远\n";
+    std::string romalrc = "[00:10.00]haro\n[00:12.00] \n";
+    auto timeline = Netease::API::ParseTimeline(lrc, tlyric, romalrc, 300);
+
+    ASSERT_EQ(timeline.Size(), 4u);
+    EXPECT_EQ(timeline.Translation(0), "你好");
+    EXPECT_EQ(timeline.Translation(1), "世界");
+    EXPECT_EQ(timeline.translation[3], -1) << "超出容差不匹配";
+    EXPECT_EQ(timeline.Romaji(0), "haro");
+    EXPECT_EQ(timeline.romaji[1], -1) << "空白罗马音视为无";
+    EXPECT_EQ(timeline.Text(2), "") << "原文空行保留";
+    EXPECT_STREQ(timeline.SpanCStr(timeline.text[1]), "World");
+}
+
+TEST(LrcTimelineTest, FindLine_BinarySearch) {
+    auto timeline = Netease::API::ParseTimeline("[00:01.00]a\n[00:02.00]b\n[00:03.00]c\n");
+    EXPECT_EQ(timeline.FindLine(0), -1);
+    EXPECT_EQ(timeline.FindLine(1000), 0);
+    EXPECT_EQ(timeline.FindLine(2999), 1);
+    EXPECT_EQ(timeline.FindLine(100000), 2);
+    EXPECT_EQ(Netease::API::ParseTimeline("").FindLine(1000), -1);
+}
+
+TEST(LrcTimelineTest, CApi_MatchesCppTimeline) {
+    Netease_LrcTimeline* handle = Netease_LrcParse("[00:01.00][00:03.00]a\n[00:02.00]b\n", "[00:02.00]乙\n", nullptr, 300);
+    ASSERT_NE(handle, nullptr);
+
+    EXPECT_EQ(Netease_LrcCount(handle), 3);
+    EXPECT_EQ(Netease_LrcTimeMs(handle, 2), 3000);
+    EXPECT_EQ(Netease_LrcTimeMs(handle, 3), -1);
+    EXPECT_STREQ(Netease_LrcText(handle, 1), "b");
+    EXPECT_STREQ(Netease_LrcTranslation(handle, 1), "乙");
+    EXPECT_EQ(Netease_LrcTranslation(handle, 0), nullptr);
+    EXPECT_EQ(Netease_LrcRomaji(handle, 0), nullptr);
+    EXPECT_EQ(Netease_LrcFind(handle, 2500), 1);
+
+    Netease_LrcFree(handle);
+    EXPECT_EQ(Netease_LrcCount(nullptr), 0);
+}
+
+TEST(LrcTimelineTest, LongLyrics_MatchesLegacyMapParser) {
+    // 解析与 FindLine 的耗时见 NeteaseLyricBench --only timeline
+    // 长歌词：3000 行原文 + 3000 行翻译，每 10 行一个多标签副歌
+    std::string lrc = "[offset:120]\n";
+    std::string tlyric;
+    for (int i = 0; i < 3000; ++i) {
+        int ms = i * 1370;
+        if (i % 10 == 0) lrc += FormatTag(ms + 600000, 2);
+        lrc += FormatTag(ms, i % 2 ? 3 : 2) + "original line number " + std::to_string(i) + " with some words\n";
+        tlyric += FormatTag(ms, 2) + "翻译第 " + std::to_string(i) + " 行\n";
+    }
+
+    auto timeline = Netease::API::ParseTimeline(lrc, tlyric);
+    double offset = 0;
+    auto legacy = LegacyParseLrcToMap(lrc, &offset);
+    ASSERT_EQ(timeline.Size(), legacy.size());
+    size_t i = 0;
+    for (const auto& [time, text] : legacy) {
+        EXPECT_EQ(timeline.timesMs[i], std::llround((time + offset) * 1000)) << i;
+        EXPECT_EQ(timeline.Text(i), text) << i;
+        ++i;
+    }
+
+    // FindLine：每行起点及其前 1ms 落在正确的行上
+    EXPECT_EQ(timeline.FindLine(timeline.timesMs.front() - 1), -1);
+    for (size_t k = 1; k < timeline.Size(); k += 97) {
+        EXPECT_EQ(timeline.FindLine(timeline.timesMs[k]), (int)k);
+        EXPECT_EQ(timeline.FindLine(timeline.timesMs[k] - 1), (int)k - 1);
+    }
+}
+
+// ============================================================================
+// 25. 逐字歌词 (yrc) 测试 (v0.1.4)
+// ============================================================================
+
+namespace {
+
+/**
+ * 生成 yrc：每行 wordsPerLine 个字，字长 wordMs，行间留 gapMs 空白
+ */
+std::string MakeYrc(int lines, int wordsPerLine, int wordMs, int gapMs) {
+    std::string yrc = "{\"t\":0,\"c\":[{\"tx\":\"\xe4\xbd\x9c\xe8\xaf\x8d: \"},{\"tx\":\"someone\"}]}\n";
+    int64_t t = 1000;
+    for (int line = 0; line < lines; ++line) {
+        int duration = wordsPerLine * wordMs;
+        yrc += "[" + std::to_string(t) + "," + std::to_string(duration) + "]";
+        for (int w = 0; w < wordsPerLine; ++w) {
+            yrc += "(" + std::to_string(t + w * wordMs) + "," + std::to_string(wordMs) + ",0)w" + std::to_string(w) + " ";
+        }
+        yrc += "\n";
+        t += duration + gapMs;
+    }
+    return yrc;
+}
+
+} // namespace
+
+TEST(WordTimelineTest, Parse_FlatArraysAndContiguousLineText) {
+    std::string yrc =
+        "{\"t\":0,\"c\":[{\"tx\":\"composer\"}]}\r\n"
+        "[1000,900](1000,300,0)Hel(1300,300,0)lo (1600,300,0)(world)\r\n"
+        "[3000,500](3000,500,0)\xe4\xbd\xa0\xe5\xa5\xbd\r\n";
+    auto timeline = Netease::API::ParseWordTimeline(yrc);
+
+    ASSERT_EQ(timeline.LineCount(), 2u);
+    ASSERT_EQ(timeline.WordCount(), 4u);
+    EXPECT_EQ(timeline.lineStartMs, (std::vector<int64_t>{ 1000, 3000 }));
+    EXPECT_EQ(timeline.lineFirstWord, (std::vector<uint32_t>{ 0, 3, 4 }));
+    EXPECT_EQ(timeline.WordText(1), "lo ");
+    EXPECT_EQ(timeline.WordText(2), "(world)") << "不是字标签的括号保留为文本";
+    EXPECT_EQ(timeline.LineText(0), "Hello (world)");
+    EXPECT_EQ(timeline.LineText(1), "\xe4\xbd\xa0\xe5\xa5\xbd");
+    EXPECT_EQ(timeline.wordDurationMs[3], 500);
+}
+
+TEST(WordTimelineTest, Parse_RelativeWordTimesAndUnsortedLines) {
+    std::string yrc =
+        "[5000,400](0,200,0)b(200,200,0)c\n"
+        "[1000,400](1000,400,0)a\n";
+    auto timeline = Netease::API::ParseWordTimeline(yrc);
+
+    ASSERT_EQ(timeline.LineCount(), 2u);
+    EXPECT_EQ(timeline.lineStartMs, (std::vector<int64_t>{ 1000, 5000 }));
+    EXPECT_EQ(timeline.LineText(0), "a");
+    EXPECT_EQ(timeline.LineText(1), "bc");
+    EXPECT_EQ(timeline.wordStartMs, (std::vector<int64_t>{ 1000, 5000, 5200 }));
+}
+
+TEST(WordTimelineTest, Cursor_FillFractionsAndSeeks) {
+    auto timeline = Netease::API::ParseWordTimeline("[1000,900](1000,300,0)a(1300,300,0)b(1600,300,0)c\n[3000,600](3100,600,0)d\n");
+    Netease::WordCursor cursor(timeline);
+
+    EXPECT_EQ(cursor.Update(500).line, -1);
+    EXPECT_EQ(cursor.FillOf(0), 0.0f);
+
+    auto pos = cursor.Update(1450);
+    EXPECT_EQ(pos.line, 0);
+    EXPECT_EQ(pos.word, 1);
+    EXPECT_FLOAT_EQ(pos.wordFill, 0.5f);
+    EXPECT_EQ(cursor.FillOf(0), 1.0f);
+    EXPECT_EQ(cursor.FillOf(2), 0.0f);
+
+    // 行间空白：停在上一行最后一个字，已填满
+    pos = cursor.Update(2500);
+    EXPECT_EQ(pos.word, 2);
+    EXPECT_FLOAT_EQ(pos.wordFill, 1.0f);
+
+    // 新行已开始、第一个字尚未开始
+    pos = cursor.Update(3050);
+    EXPECT_EQ(pos.line, 1);
+    EXPECT_EQ(pos.word, -1);
+    EXPECT_EQ(cursor.FillOf(2), 1.0f);
+    EXPECT_EQ(cursor.FillOf(3), 0.0f);
+    EXPECT_EQ(cursor.SeekCount(), 0u) << "顺序播放不应触发二分查找";
+
+    // 回退
+    pos = cursor.Update(1000);
+    EXPECT_EQ(pos.line, 0);
+    EXPECT_EQ(pos.word, 0);
+    EXPECT_EQ(cursor.SeekCount(), 1u);
+
+    cursor.Reset();
+    EXPECT_EQ(cursor.Current().line, -1);
+}
+
+TEST(WordTimelineTest, Cursor_MatchesBinarySearchEverywhere) {
+    auto timeline = Netease::API::ParseWordTimeline(MakeYrc(50, 6, 230, 400));
+    Netease::WordCursor cursor(timeline);
+
+    auto reference = [&](int64_t ms) {
+        auto lineIt = std::upper_bound(timeline.lineStartMs.begin(), timeline.lineStartMs.end(), ms);
+        int line = (int)(lineIt - timeline.lineStartMs.begin()) - 1;
+        if (line < 0) return std::make_pair(-1, -1);
+        auto first = timeline.wordStartMs.begin() + timeline.LineWordBegin(line);
+        auto wordIt = std::upper_bound(first, timeline.wordStartMs.begin() + timeline.LineWordEnd(line), ms);
+        return std::make_pair(line, wordIt == first ? -1 : (int)(wordIt - timeline.wordStartMs.begin()) - 1);
+    };
+
+    std::mt19937 rng(39);
+    int64_t end = timeline.lineStartMs.back() + 3000;
+    int64_t t = 0;
+    for (int i = 0; i < 20000; ++i) {
+        // 大多数帧顺序前进，偶尔随机跳转
+        t = (i % 500 == 0) ? (int64_t)(rng() % end) : t + (int64_t)(rng() % 40);
+        auto pos = cursor.Update(t);
+        auto expected = reference(t);
+        ASSERT_EQ(pos.line, expected.first) << t;
+        ASSERT_EQ(pos.word, expected.second) << t;
+    }
+}
+
+TEST(WordTimelineTest, CacheRoundTrip_KeepsYrc) {
+    const long long songId = 930000039;
+    Netease::API::ClearLyricCache(songId);
+
+    Netease::LyricData data;
+    data.lrc = "[00:01.00]a\n";
+    data.yrc = "[1000,300](1000,300,0)a\n";
+    ASSERT_TRUE(Netease::API::CacheLyric(songId, data));
+
+    auto cached = Netease::API::GetLocalLyric(songId);
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ(cached->yrc, data.yrc);
+
+    // 无 yrc 字段的记录（网易云客户端缓存）；正文中的 "yrc" 不应被误当作键
+    data.lrc = "[00:01.00]yrc: not a key\n";
+    data.yrc.clear();
+    ASSERT_TRUE(Netease::API::CacheLyric(songId, data));
+    cached = Netease::API::GetLocalLyric(songId);
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_TRUE(cached->yrc.empty());
+
+    Netease::API::ClearLyricCache(songId);
+}
+
+TEST(WordTimelineTest, LongYrc_CursorMatchesBinarySearch) {
+    // 解析吞吐量与逐帧定位耗时见 NeteaseLyricBench --only words
+    std::string yrc = MakeYrc(2000, 10, 180, 300);
+    auto timeline = Netease::API::ParseWordTimeline(yrc);
+    ASSERT_EQ(timeline.LineCount(), 2000u);
+    ASSERT_EQ(timeline.WordCount(), 20000u);
+    int64_t end = timeline.lineStartMs.back() + 2000;
+
+    // 60 FPS 顺序播放：游标结果与每帧两次二分查找一致，且从不回退到二分查找
+    Netease::WordCursor cursor(timeline);
+    for (int64_t ms = 0; ms < end; ms += 16) {
+        const auto& position = cursor.Update(ms);
+        auto lineIt = std::upper_bound(timeline.lineStartMs.begin(), timeline.lineStartMs.end(), ms);
+        int line = (int)(lineIt - timeline.lineStartMs.begin()) - 1;
+        ASSERT_EQ(position.line, line) << ms;
+        if (line < 0) continue;
+        auto first = timeline.wordStartMs.begin() + timeline.LineWordBegin(line);
+        int started = (int)(std::upper_bound(first, timeline.wordStartMs.begin() + timeline.LineWordEnd(line), ms) - first);
+        ASSERT_EQ(position.word, started > 0 ? (int)timeline.LineWordBegin(line) + started - 1 : -1) << ms;
+    }
+    EXPECT_EQ(cursor.SeekCount(), 0u);
+}
+
+// ============================================================================
+// 26. 行级播放游标测试 (v0.1.4)
+// ============================================================================
+
+TEST(LineCursorTest, SequentialPlayback_EventsWithExactBoundaries) {
+    std::vector<int64_t> times = { 1000, 2000, 2000, 3500 };
+    Netease::LineCursor cursor(times);
+
+    std::vector<Netease::LineCursor::Event> events;
+    cursor.SetCallback([&](const Netease::LineCursor::Event& event) { events.push_back(event); });
+
+    EXPECT_EQ(cursor.Update(0), -1);
+    EXPECT_EQ(cursor.NextBoundaryMs(), 1000);
+    for (int64_t ms = 0; ms <= 5000; ms += 16) cursor.Update(ms);
+
+    ASSERT_EQ(events.size(), 3u) << "同一时刻的两行只触发一次";
+    EXPECT_EQ(events[0].previous, -1);
+    EXPECT_EQ(events[0].current, 0);
+    EXPECT_EQ(events[0].nextBoundaryMs, 2000);
+    EXPECT_EQ(events[1].current, 2);
+    EXPECT_EQ(events[1].nextBoundaryMs, 3500);
+    EXPECT_EQ(events[2].current, 3);
+    EXPECT_EQ(events[2].nextBoundaryMs, INT64_MAX);
+    for (const auto& event : events) EXPECT_FALSE(event.seek);
+    EXPECT_EQ(cursor.SeekCount(), 0u);
+}
+
+TEST(LineCursorTest, BackwardAndFarForwardJumps_DetectedAsSeeks) {
+    std::vector<int64_t> times;
+    for (int i = 0; i < 100; ++i) times.push_back(i * 1000);
+    Netease::LineCursor cursor(times);
+    cursor.SetSeekThresholdMs(2000);
+
+    EXPECT_EQ(cursor.Update(10500), 10);
+    EXPECT_FALSE(cursor.LastUpdateWasSeek()) << "首次定位不算跳转";
+
+    EXPECT_EQ(cursor.Update(11900), 11);
+    EXPECT_FALSE(cursor.LastUpdateWasSeek());
+
+    EXPECT_EQ(cursor.Update(5200), 5);
+    EXPECT_TRUE(cursor.LastUpdateWasSeek());
+
+    EXPECT_EQ(cursor.Update(80000), 80);
+    EXPECT_TRUE(cursor.LastUpdateWasSeek());
+    EXPECT_EQ(cursor.SeekCount(), 2u);
+
+    EXPECT_EQ(cursor.Update(-50), -1);
+    EXPECT_EQ(cursor.NextBoundaryMs(), 0);
+}
+
+TEST(LineCursorTest, Bind_ResetsOnlyWhenArrayChanges) {
+    std::vector<int64_t> first = { 0, 1000, 2000 };
+    std::vector<int64_t> second = { 500, 600 };
+    Netease::LineCursor cursor;
+    EXPECT_EQ(cursor.Update(100), -1) << "未绑定";
+
+    cursor.Bind(first);
+    EXPECT_EQ(cursor.Update(1500), 1);
+    cursor.Bind(first);
+    EXPECT_EQ(cursor.Current(), 1);
+
+    cursor.Bind(second);
+    EXPECT_EQ(cursor.Current(), -1);
+    EXPECT_EQ(cursor.Update(550), 0);
+    EXPECT_FALSE(cursor.LastUpdateWasSeek()) << "重新绑定后时间可以比上一首小";
+}
+
+TEST(LineCursorTest, RandomizedPlayback_MatchesBinarySearch) {
+    std::mt19937 rng(40);
+    std::vector<int64_t> times;
+    int64_t t = 0;
+    for (int i = 0; i < 500; ++i) {
+        t += rng() % 4000;      // 含 0：同一时刻多行
+        times.push_back(t);
+    }
+    Netease::LineCursor cursor(times);
+
+    int64_t now = -1000;
+    for (int i = 0; i < 50000; ++i) {
+        int r = (int)(rng() % 1000);
+        if (r == 0) now = (int64_t)(rng() % (t + 5000)) - 1000;    // 跳转
+        else if (r == 1) now -= rng() % 300;                       // 轻微回退
+        else now += rng() % 40;
+        int expected = (int)(std::upper_bound(times.begin(), times.end(), now) - times.begin()) - 1;
+        ASSERT_EQ(cursor.Update(now), expected) << now;
+        ASSERT_LE(now, cursor.NextBoundaryMs() - 1);
+    }
+}
+
+TEST(LineCursorTest, LongLyrics_OneEventPerLineWithoutSeeks) {
+    // 与 v0.1.3 逐帧线性扫描的耗时对比见 NeteaseLyricBench --only cursor
+    std::vector<int64_t> times;
+    for (int i = 0; i < 3000; ++i) times.push_back(i * 1370LL);
+    int64_t end = times.back() + 5000;
+
+    Netease::LineCursor cursor(times);
+    int events = 0;
+    cursor.SetCallback([&](const Netease::LineCursor::Event&) { events++; });
+    for (int64_t ms = 0; ms < end; ms += 16) {
+        ASSERT_EQ(cursor.Update(ms), (int)(ms / 1370 < 3000 ? ms / 1370 : 2999)) << ms;
+    }
+
+    EXPECT_EQ(events, 3000);
+    EXPECT_EQ(cursor.SeekCount(), 0u);
+}
+
 // ============================================================================
 // 主函数
 // ============================================================================
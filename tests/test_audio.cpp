@@ -0,0 +1,1619 @@
+/**
+ * test_audio.cpp - NeteaseMonitor 音频分析链路测试套件
+ *
+ * 使用 Google Test 框架
+ * 覆盖：FFT 计划、SIMD 频谱内核、无锁采集缓冲区、零分配分析路径、采集接入内核、多相降采样的正确性
+ * 耗时对比不在单元测试里断言，见 NeteaseAudioBench --micro
+ *
+ * 网易云音乐 Hook SDK v0.1.4
+ */
+
+#include "../src/App/FftHelper.h"
+#include "../src/App/SpectrumKernels.h"
+#include "../src/App/SpscRing.h"
+#include "../src/App/AnalysisContext.h"
+#include "../src/App/TripleBuffer.h"
+#include "../src/App/AnalysisThread.h"
+#include "../src/App/SampleSource.h"
+#include "../src/App/AudioIngest.h"
+#include "../src/App/Decimator.h"
+#include <gtest/gtest.h>
+#include <vector>
+#include <complex>
+#include <cmath>
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <cstdlib>
+#include <new>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+
+// ============================================================================
+// 测试辅助
+// ============================================================================
+
+namespace {
+
+/**
+ * v0.1.3 的递归实现（每层分配两个子数组），作为正确性对照
+ */
+void LegacyComputeFFT(std::vector<std::complex<double>>& a) {
+    size_t n = a.size();
+    if (n <= 1) return;
+
+    std::vector<std::complex<double>> a0(n / 2), a1(n / 2);
+    for (size_t i = 0; i * 2 < n; i++) {
+        a0[i] = a[i * 2];
+        a1[i] = a[i * 2 + 1];
+    }
+
+    LegacyComputeFFT(a0);
+    LegacyComputeFFT(a1);
+
+    double ang = 2 * M_PI / n;
+    std::complex<double> w(1), wn(cos(ang), sin(ang));
+    for (size_t i = 0; i * 2 < n; i++) {
+        a[i] = a0[i] + w * a1[i];
+        a[i + n / 2] = a0[i] - w * a1[i];
+        w *= wn;
+    }
+}
+
+std::vector<float> LegacyAnalyze(const std::vector<float>& samples) {
+    size_t n = samples.size();
+    if (n == 0 || (n & (n - 1)) != 0) return {};
+
+    std::vector<std::complex<double>> data(n);
+    for (size_t i = 0; i < n; i++) {
+        double window = 0.5 * (1.0 - cos(2.0 * M_PI * i / (n - 1)));
+        data[i] = std::complex<double>(samples[i] * window, 0.0);
+    }
+
+    LegacyComputeFFT(data);
+
+    std::vector<float> magnitudes(n / 2);
+    for (size_t i = 0; i < n / 2; i++) {
+        magnitudes[i] = (float)std::abs(data[i]) / (float)n;
+    }
+    return magnitudes;
+}
+
+/**
+ * 直接按定义计算的 DFT：X[k] = Σ x[t]·e^(-2πikt/N)
+ */
+std::vector<std::complex<double>> NaiveDft(const std::vector<std::complex<double>>& x) {
+    size_t n = x.size();
+    std::vector<std::complex<double>> out(n);
+    for (size_t k = 0; k < n; k++) {
+        std::complex<double> sum;
+        for (size_t t = 0; t < n; t++) {
+            double ang = -2.0 * M_PI * (double)((k * t) % n) / (double)n;
+            sum += x[t] * std::complex<double>(cos(ang), sin(ang));
+        }
+        out[k] = sum;
+    }
+    return out;
+}
+
+/**
+ * 模拟音乐：几个正弦分量 + 少量白噪声，幅度在 [-1, 1] 内
+ */
+std::vector<float> MakeSignal(size_t n, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> noise(-0.05f, 0.05f);
+    std::vector<float> samples(n);
+    for (size_t i = 0; i < n; i++) {
+        double t = (double)i / 48000.0;
+        samples[i] = (float)(0.5 * sin(2 * M_PI * 55.0 * t) + 0.25 * sin(2 * M_PI * 440.0 * t) +
+                             0.1 * sin(2 * M_PI * 3520.0 * t)) + noise(rng);
+    }
+    return samples;
+}
+
+/**
+ * 测试期间强制使用指定内核，析构时恢复自动选择
+ */
+class ScopedKernel {
+public:
+    explicit ScopedKernel(Netease::Spectrum::Kernel kernel) : m_Ok(Netease::Spectrum::SetKernel(kernel)) {}
+    ~ScopedKernel() { Netease::Spectrum::SetKernel(Netease::Spectrum::Kernel::Auto); }
+    bool Ok() const { return m_Ok; }
+
+private:
+    bool m_Ok;
+};
+
+const char* KernelName(Netease::Spectrum::Kernel kernel) {
+    switch (kernel) {
+        case Netease::Spectrum::Kernel::Scalar: return "Scalar";
+        case Netease::Spectrum::Kernel::SSE2: return "SSE2";
+        case Netease::Spectrum::Kernel::AVX2: return "AVX2";
+        case Netease::Spectrum::Kernel::NEON: return "NEON";
+        default: return "Auto";
+    }
+}
+
+const Netease::Spectrum::Kernel ALL_KERNELS[] = {
+    Netease::Spectrum::Kernel::Scalar,
+    Netease::Spectrum::Kernel::SSE2,
+    Netease::Spectrum::Kernel::AVX2,
+    Netease::Spectrum::Kernel::NEON,
+};
+
+} // namespace
+
+// ============================================================================
+// 1. FftPlan 测试 (v0.1.4)
+// ============================================================================
+
+TEST(FftPlanTest, InvalidSizes_ProduceEmptyPlan) {
+    EXPECT_FALSE(Netease::FftPlan().Valid());
+    EXPECT_FALSE(Netease::FftPlan(0).Valid());
+    EXPECT_FALSE(Netease::FftPlan(1).Valid());
+    EXPECT_FALSE(Netease::FftPlan(1000).Valid());
+    EXPECT_TRUE(Netease::FftPlan(2).Valid());
+    EXPECT_EQ(Netease::FftPlan(4096).Size(), 4096u);
+
+    EXPECT_TRUE(Netease::FftHelper::Analyze(std::vector<float>(1000, 0.5f)).empty());
+}
+
+TEST(FftPlanTest, Forward_MatchesNaiveDft) {
+    // 覆盖 log2(N) 为奇数（先做一级基 2）与偶数（纯基 4）两种情况
+    std::mt19937 rng(41);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (size_t n : { 2u, 4u, 8u, 16u, 32u, 64u, 128u, 256u, 512u }) {
+        std::vector<std::complex<double>> x(n);
+        for (auto& v : x) v = std::complex<double>(dist(rng), dist(rng));
+
+        auto expected = NaiveDft(x);
+        Netease::FftPlan plan(n);
+        plan.Forward(x.data());
+        for (size_t k = 0; k < n; k++) {
+            EXPECT_NEAR(x[k].real(), expected[k].real(), 1e-9) << "n=" << n << " k=" << k;
+            EXPECT_NEAR(x[k].imag(), expected[k].imag(), 1e-9) << "n=" << n << " k=" << k;
+        }
+    }
+}
+
+TEST(FftPlanTest, Analyze_MatchesLegacyRecursive) {
+    // 耗时对比见 NeteaseAudioBench --only fft
+    for (size_t n : { 1024u, 2048u, 4096u }) {
+        auto samples = MakeSignal(n, (uint32_t)n);
+        auto expected = LegacyAnalyze(samples);
+
+        Netease::FftPlan plan(n);
+        std::vector<std::complex<double>> work(n);
+        std::vector<float> magnitudes(n / 2);
+        plan.Analyze(samples.data(), work.data(), magnitudes.data());
+
+        ASSERT_EQ(magnitudes.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            EXPECT_NEAR(magnitudes[i], expected[i], 1e-6f) << "n=" << n << " bin=" << i;
+        }
+
+        // 包装函数（线程内缓存计划）结果一致，且切换尺寸后仍正确
+        auto wrapped = Netease::FftHelper::Analyze(samples);
+        ASSERT_EQ(wrapped.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            EXPECT_NEAR(wrapped[i], expected[i], 1e-6f) << "n=" << n << " bin=" << i;
+        }
+    }
+}
+
+TEST(FftPlanTest, Analyze_PureToneLandsInItsBin) {
+    // 48kHz / 1024 点，第 64 个频点 = 3000Hz
+    const size_t n = 1024;
+    std::vector<float> samples(n);
+    for (size_t i = 0; i < n; i++) samples[i] = (float)sin(2 * M_PI * 64.0 * i / n);
+
+    auto magnitudes = Netease::FftHelper::Analyze(samples);
+    size_t peak = 0;
+    for (size_t i = 1; i < magnitudes.size(); i++) {
+        if (magnitudes[i] > magnitudes[peak]) peak = i;
+    }
+    EXPECT_EQ(peak, 64u);
+    // Hann 窗相干增益 0.5，正弦幅度 1 → 单边 |X|/N ≈ 0.25
+    EXPECT_NEAR(magnitudes[64], 0.25f, 0.01f);
+}
+
+// ============================================================================
+// 2. RealFftPlan 测试 (v0.1.4)
+// ============================================================================
+
+TEST(RealFftPlanTest, InvalidSizes_ProduceEmptyPlan) {
+    EXPECT_FALSE(Netease::RealFftPlan(2).Valid());
+    EXPECT_FALSE(Netease::RealFftPlan(96).Valid());
+    EXPECT_TRUE(Netease::RealFftPlan(4).Valid());
+
+    // N <= 2 时 Hann 窗全为 0，包装函数仍返回 N/2 个 0
+    EXPECT_EQ(Netease::FftHelper::Analyze(std::vector<float>(2, 1.0f)), std::vector<float>(1, 0.0f));
+    EXPECT_TRUE(Netease::FftHelper::Analyze(std::vector<float>(1, 1.0f)).empty());
+}
+
+TEST(RealFftPlanTest, Forward_MatchesNaiveDftIncludingNyquist) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (size_t n : { 4u, 8u, 16u, 32u, 64u, 128u, 256u, 512u }) {
+        std::vector<double> x(n);
+        std::vector<std::complex<double>> complexInput(n);
+        for (size_t i = 0; i < n; i++) {
+            x[i] = dist(rng);
+            complexInput[i] = x[i];
+        }
+        auto expected = NaiveDft(complexInput);
+
+        Netease::RealFftPlan plan(n);
+        std::vector<std::complex<double>> work(n / 2);
+        std::vector<std::complex<double>> spectrum(n / 2 + 1);
+        plan.Forward(x.data(), work.data(), spectrum.data());
+        for (size_t k = 0; k <= n / 2; k++) {
+            EXPECT_NEAR(spectrum[k].real(), expected[k].real(), 1e-9) << "n=" << n << " k=" << k;
+            EXPECT_NEAR(spectrum[k].imag(), expected[k].imag(), 1e-9) << "n=" << n << " k=" << k;
+        }
+    }
+}
+
+// 耗时与工作区对比见 NeteaseAudioBench --only realfft
+TEST(RealFftPlanTest, Analyze_MatchesComplexPathAndLegacy) {
+    for (size_t n : { 4u, 64u, 1024u, 2048u, 4096u }) {
+        auto samples = MakeSignal(n, (uint32_t)n + 1);
+        auto legacy = LegacyAnalyze(samples);
+
+        Netease::FftPlan complexPlan(n);
+        std::vector<std::complex<double>> complexWork(n);
+        std::vector<float> complexMagnitudes(n / 2);
+        complexPlan.Analyze(samples.data(), complexWork.data(), complexMagnitudes.data());
+
+        Netease::RealFftPlan realPlan(n);
+        std::vector<std::complex<double>> realWork(n / 2);
+        std::vector<float> realMagnitudes(n / 2);
+        realPlan.Analyze(samples.data(), realWork.data(), realMagnitudes.data());
+
+        auto wrapped = Netease::FftHelper::Analyze(samples);
+        ASSERT_EQ(wrapped.size(), legacy.size());
+        for (size_t i = 0; i < n / 2; i++) {
+            EXPECT_NEAR(realMagnitudes[i], complexMagnitudes[i], 1e-6f) << "n=" << n << " bin=" << i;
+            EXPECT_NEAR(realMagnitudes[i], legacy[i], 1e-6f) << "n=" << n << " bin=" << i;
+            EXPECT_NEAR(wrapped[i], realMagnitudes[i], 1e-6f) << "n=" << n << " bin=" << i;
+        }
+    }
+}
+
+// ============================================================================
+// 3. 单精度 SIMD 频谱内核测试 (v0.1.4)
+// ============================================================================
+
+TEST(SpectrumKernelTest, SetKernel_AutoAndUnsupported) {
+    using Netease::Spectrum::Kernel;
+    EXPECT_TRUE(Netease::Spectrum::SetKernel(Kernel::Scalar));
+    EXPECT_EQ(Netease::Spectrum::GetKernel(), Kernel::Scalar);
+    EXPECT_TRUE(Netease::Spectrum::SetKernel(Kernel::Auto));
+    EXPECT_NE(Netease::Spectrum::GetKernel(), Kernel::Auto);
+
+    // 同一平台上 x86 与 NEON 内核不会同时可用；不可用时保持原内核
+    Kernel before = Netease::Spectrum::GetKernel();
+    bool sse2 = Netease::Spectrum::SetKernel(Kernel::SSE2);
+    bool neon = Netease::Spectrum::SetKernel(Kernel::NEON);
+    EXPECT_FALSE(sse2 && neon);
+    if (!sse2 && !neon) {
+        EXPECT_EQ(Netease::Spectrum::GetKernel(), before);
+    }
+    Netease::Spectrum::SetKernel(Kernel::Auto);
+}
+
+TEST(SpectrumKernelTest, SimdKernels_AgreeWithScalar) {
+    std::mt19937 rng(43);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+    // 覆盖不足一个向量宽度的级、以及后处理的标量尾部
+    for (size_t n : { 4u, 8u, 32u, 64u, 512u, 2048u }) {
+        std::vector<float> re(n), im(n), twRe(n), twIm(n);
+        for (size_t i = 0; i < n; i++) {
+            re[i] = dist(rng);
+            im[i] = dist(rng);
+            twRe[i] = (float)cos(0.37 * i);
+            twIm[i] = (float)-sin(0.37 * i);
+        }
+
+        std::vector<float> expectedMag(n, 0.0f);
+        Netease::Spectrum::SetKernel(Netease::Spectrum::Kernel::Scalar);
+        Netease::Spectrum::RealMagnitudes(re.data(), im.data(), n, twRe.data(), twIm.data(), 0.01f, expectedMag.data());
+
+        for (size_t half = 1; half < n; half *= 2) {
+            std::vector<float> expectedRe = re, expectedIm = im;
+            Netease::Spectrum::SetKernel(Netease::Spectrum::Kernel::Scalar);
+            Netease::Spectrum::ButterflyStage(expectedRe.data(), expectedIm.data(), n, half, twRe.data(), twIm.data());
+
+            for (auto kernel : ALL_KERNELS) {
+                ScopedKernel scoped(kernel);
+                if (!scoped.Ok()) continue;
+                std::vector<float> actualRe = re, actualIm = im;
+                Netease::Spectrum::ButterflyStage(actualRe.data(), actualIm.data(), n, half, twRe.data(), twIm.data());
+                for (size_t i = 0; i < n; i++) {
+                    ASSERT_NEAR(actualRe[i], expectedRe[i], 1e-5f) << KernelName(kernel) << " n=" << n << " half=" << half;
+                    ASSERT_NEAR(actualIm[i], expectedIm[i], 1e-5f) << KernelName(kernel) << " n=" << n << " half=" << half;
+                }
+            }
+        }
+
+        for (auto kernel : ALL_KERNELS) {
+            ScopedKernel scoped(kernel);
+            if (!scoped.Ok()) continue;
+            std::vector<float> actualMag(n, 0.0f);
+            Netease::Spectrum::RealMagnitudes(re.data(), im.data(), n, twRe.data(), twIm.data(), 0.01f, actualMag.data());
+            EXPECT_EQ(actualMag[0], 0.0f) << "out[0] 由调用方负责";
+            for (size_t k = 1; k < n; k++) {
+                ASSERT_NEAR(actualMag[k], expectedMag[k], 1e-6f) << KernelName(kernel) << " n=" << n << " k=" << k;
+            }
+        }
+    }
+}
+
+// 各内核与双精度路径的耗时对比见 NeteaseAudioBench --only spectrum
+TEST(SpectrumKernelTest, RealFftPlanF_MatchesDoublePrecisionOnEveryKernel) {
+    for (auto kernel : ALL_KERNELS) {
+        ScopedKernel scoped(kernel);
+        if (!scoped.Ok()) continue;
+        for (size_t n : { 4u, 8u, 16u, 64u, 1024u, 2048u, 4096u }) {
+            auto samples = MakeSignal(n, (uint32_t)n + 3);
+
+            Netease::RealFftPlan reference(n);
+            std::vector<std::complex<double>> work(n / 2);
+            std::vector<float> expected(n / 2);
+            reference.Analyze(samples.data(), work.data(), expected.data());
+
+            Netease::Spectrum::RealFftPlanF plan(n);
+            ASSERT_TRUE(plan.Valid());
+            std::vector<float> workRe(n / 2), workIm(n / 2), actual(n / 2);
+            plan.Analyze(samples.data(), workRe.data(), workIm.data(), actual.data());
+            for (size_t k = 0; k < n / 2; k++) {
+                // 峰值约 0.125，float 累积误差在 1e-7 量级
+                ASSERT_NEAR(actual[k], expected[k], 2e-6f) << KernelName(kernel) << " n=" << n << " bin=" << k;
+            }
+        }
+    }
+    EXPECT_FALSE(Netease::Spectrum::RealFftPlanF(2).Valid());
+    EXPECT_FALSE(Netease::Spectrum::RealFftPlanF(48).Valid());
+}
+
+// ============================================================================
+// 4. SpscRing / LatencyHistogram 测试 (v0.1.4)
+// ============================================================================
+
+TEST(SpscRingTest, CapacityAndZeroFilledSnapshots) {
+    Netease::SpscRing<float> ring(1000);
+    EXPECT_EQ(ring.Capacity(), 1024u);
+
+    std::vector<float> out(8, -1.0f);
+    EXPECT_EQ(ring.ReadLatest(out.data(), out.size()), 0u);
+    EXPECT_EQ(out, std::vector<float>(8, 0.0f));
+
+    const float data[] = { 1, 2, 3 };
+    ring.Write(data, 3);
+    EXPECT_EQ(ring.Written(), 3u);
+    EXPECT_EQ(ring.ReadLatest(out.data(), 5), 3u);
+    EXPECT_EQ(std::vector<float>(out.begin(), out.begin() + 5), (std::vector<float>{ 0, 0, 1, 2, 3 }));
+}
+
+TEST(SpscRingTest, WrapAroundAndOversizedWrites) {
+    Netease::SpscRing<uint32_t> ring(16);
+    std::vector<uint32_t> values(40);
+    for (uint32_t i = 0; i < 40; i++) values[i] = i;
+
+    // 逐块写过多圈，每次都能读回最新的连续序列
+    uint32_t written = 0;
+    for (size_t chunk : { 5u, 7u, 3u, 11u, 6u }) {
+        ring.Write(values.data() + written, chunk);
+        written += (uint32_t)chunk;
+        std::vector<uint32_t> out(10);
+        size_t got = ring.ReadLatest(out.data(), out.size());
+        ASSERT_EQ(got, (std::min)((size_t)written, out.size()));
+        for (size_t i = 0; i < got; i++) {
+            EXPECT_EQ(out[out.size() - got + i], written - got + i);
+        }
+    }
+
+    // 一次写入超过容量：只保留最后 16 个
+    ring.Write(values.data(), 40);
+    std::vector<uint32_t> out(20);
+    EXPECT_EQ(ring.ReadLatest(out.data(), out.size()), 16u);
+    for (size_t i = 0; i < 4; i++) EXPECT_EQ(out[i], 0u);
+    for (uint32_t i = 0; i < 16; i++) EXPECT_EQ(out[4 + i], 24 + i);
+}
+
+// 采集回调延迟对比（vs v0.1.3 deque + mutex）见 NeteaseAudioBench --only ring
+TEST(SpscRingTest, StressTest_ConcurrentSnapshotsAreContiguous) {
+    // 小容量 + 大快照：让生产者频繁追上读者，覆盖重读路径
+    for (size_t capacity : { 2048u, 16384u }) {
+        Netease::SpscRing<uint32_t> ring(capacity);
+        const uint32_t total = 4000000;
+        std::atomic<bool> done{false};
+
+        std::thread producer([&] {
+            std::mt19937 rng(44);
+            std::vector<uint32_t> chunk(1024);
+            uint32_t next = 0;
+            while (next < total) {
+                size_t count = (std::min)((size_t)(rng() % chunk.size()) + 1, (size_t)(total - next));
+                for (size_t i = 0; i < count; i++) chunk[i] = next + (uint32_t)i;
+                ring.Write(chunk.data(), count);
+                next += (uint32_t)count;
+            }
+            done = true;
+        });
+
+        std::vector<uint32_t> out(1024);
+        size_t snapshots = 0;
+        size_t broken = 0;
+        while (!done.load() || snapshots == 0) {
+            size_t got = ring.ReadLatest(out.data(), out.size());
+            size_t first = out.size() - got;
+            for (size_t i = first + 1; i < out.size(); i++) {
+                if (out[i] != out[i - 1] + 1) {
+                    broken++;
+                    break;
+                }
+            }
+            snapshots++;
+        }
+        producer.join();
+
+        EXPECT_EQ(broken, 0u) << "capacity=" << capacity;
+        EXPECT_EQ(ring.Written(), total);
+        ring.ReadLatest(out.data(), out.size());
+        EXPECT_EQ(out.back(), total - 1);
+    }
+}
+
+TEST(LatencyHistogramTest, BucketsAndPercentiles) {
+    using Netease::LatencyHistogram;
+    EXPECT_EQ(LatencyHistogram::BucketOf(0), 0);
+    EXPECT_EQ(LatencyHistogram::BucketOf(1), 1);
+    EXPECT_EQ(LatencyHistogram::BucketOf(1023), 10);
+    EXPECT_EQ(LatencyHistogram::BucketOf(1024), 11);
+    EXPECT_EQ(LatencyHistogram::BucketOf(UINT64_MAX), LatencyHistogram::BUCKETS - 1);
+
+    LatencyHistogram histogram;
+    for (int i = 0; i < 98; i++) histogram.Record(1500);     // 桶 11: [1024, 2048)
+    histogram.Record(40000);                                  // 桶 16
+    histogram.Record(900000);                                 // 桶 20
+
+    auto snapshot = histogram.Read();
+    EXPECT_EQ(snapshot.total, 100u);
+    EXPECT_EQ(snapshot.maxNs, 900000u);
+    EXPECT_DOUBLE_EQ(snapshot.MeanNs(), (98 * 1500.0 + 40000 + 900000) / 100);
+    EXPECT_EQ(snapshot.PercentileNs(0.5), 2047u);
+    EXPECT_EQ(snapshot.PercentileNs(0.99), 65535u);
+    EXPECT_EQ(snapshot.PercentileNs(1.0), 900000u);   // 不超过实际最大值
+
+    histogram.Reset();
+    EXPECT_EQ(histogram.Read().total, 0u);
+    EXPECT_EQ(histogram.Read().PercentileNs(0.99), 0u);
+}
+
+namespace {
+
+/**
+ * 与 AudioCapture::OnDataInternal 相同的写入方式：栈上分块混合 + 整块写入
+ */
+void RingOnData(Netease::SpscRing<float>& ring, const float* input, unsigned int frameCount) {
+    float mono[256];
+    for (unsigned int offset = 0; offset < frameCount; offset += 256) {
+        unsigned int frames = (std::min)(256u, frameCount - offset);
+        const float* frame = input + (size_t)offset * 2;
+        for (unsigned int i = 0; i < frames; i++) mono[i] = (frame[i * 2] + frame[i * 2 + 1]) / 2;
+        ring.Write(mono, frames);
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// 5. 零拷贝分析路径测试 (v0.1.4)
+// ============================================================================
+
+namespace {
+
+// 只统计当前线程、且处于计数区间内的分配（gtest 自身的分配不受影响）
+thread_local bool t_CountAllocations = false;
+thread_local size_t t_Allocations = 0;
+
+/**
+ * 计数区间：构造时开始，Count() 返回区间内的 operator new 次数
+ */
+class AllocationCounter {
+public:
+    AllocationCounter() {
+        t_Allocations = 0;
+        t_CountAllocations = true;
+    }
+    ~AllocationCounter() { t_CountAllocations = false; }
+    size_t Count() const { return t_Allocations; }
+};
+
+} // namespace
+
+// 替换全局 operator new/delete；GCC 会把内联后的 malloc/free 误报为不匹配
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t size) {
+    if (t_CountAllocations) t_Allocations++;
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+TEST(AnalysisContextTest, SpanApis_MatchVectorApis) {
+    auto samples = MakeSignal(1024, 45);
+    auto magnitudes = Netease::FftHelper::Analyze(samples);
+    auto bands = Netease::FftHelper::CalculateBands(magnitudes, 32);
+
+    Netease::AnalysisContext context(1024, 32);
+    EXPECT_EQ(context.FftSize(), 1024u);
+    EXPECT_EQ(context.BandCount(), 32u);
+    std::copy(samples.begin(), samples.end(), context.Samples().begin());
+    auto result = context.Process();
+
+    ASSERT_EQ(result.size(), bands.size());
+    EXPECT_TRUE(std::equal(result.begin(), result.end(), bands.begin()));
+    EXPECT_TRUE(std::equal(context.Magnitudes().begin(), context.Magnitudes().end(), magnitudes.begin()));
+
+    // 非 2 的幂 / 输出不足：拒绝且不写入
+    Netease::FftWorkspace workspace;
+    std::vector<float> out(512, -1.0f);
+    EXPECT_FALSE(Netease::FftHelper::Analyze(std::vector<float>(1000), out, workspace));
+    EXPECT_FALSE(Netease::FftHelper::Analyze(samples, std::span<float>(out.data(), 100), workspace));
+    EXPECT_EQ(out[0], -1.0f);
+
+    // 空幅值：频带清零
+    std::vector<float> zeroed(8, 1.0f);
+    Netease::FftHelper::CalculateBands(std::span<const float>(), zeroed);
+    EXPECT_EQ(zeroed, std::vector<float>(8, 0.0f));
+}
+
+TEST(AnalysisContextTest, AllocationCount_SteadyStateFrameIsZero) {
+    const unsigned int frames = 480;
+    std::vector<float> input(frames * 2);
+    for (size_t i = 0; i < input.size(); i++) input[i] = (float)sin(0.013 * i);
+
+    Netease::SpscRing<float> ring(16384);
+    Netease::AnalysisContext context(1024, 32);
+    std::vector<float> legacySink;
+
+    // 预热：首帧之后不应再有任何分配
+    RingOnData(ring, input.data(), frames);
+    ring.ReadLatest(context.Samples().data(), context.FftSize());
+    context.Process();
+
+    size_t zeroCopy = 0;
+    float sink = 0;
+    {
+        AllocationCounter counter;
+        for (int frame = 0; frame < 200; frame++) {
+            RingOnData(ring, input.data(), frames);
+            ring.ReadLatest(context.Samples().data(), context.FftSize());
+            sink += context.Process()[3];
+        }
+        zeroCopy = counter.Count();
+    }
+
+    // 对照：旧的按值返回接口每帧至少分配 3 次（采样 / 幅值 / 频带）
+    size_t legacy = 0;
+    {
+        AllocationCounter counter;
+        for (int frame = 0; frame < 200; frame++) {
+            RingOnData(ring, input.data(), frames);
+            std::vector<float> samples(1024);
+            ring.ReadLatest(samples.data(), samples.size());
+            auto magnitudes = Netease::FftHelper::Analyze(samples);
+            sink += Netease::FftHelper::CalculateBands(magnitudes, 32)[3];
+        }
+        legacy = counter.Count();
+    }
+
+    // 每帧耗时对比见 NeteaseAudioBench --only context
+    EXPECT_TRUE(std::isfinite(sink));
+    EXPECT_EQ(zeroCopy, 0u);
+    EXPECT_GE(legacy, 600u);
+}
+
+// ============================================================================
+// 6. 独立分析线程 / 三缓冲测试 (v0.1.4)
+// ============================================================================
+
+TEST(TripleBufferTest, PublishAndUpdate_ReaderSeesLatestOnly) {
+    Netease::TripleBuffer<int> buffer(0);
+    EXPECT_FALSE(buffer.Update());
+    EXPECT_EQ(buffer.Front(), 0);
+
+    buffer.Back() = 1;
+    buffer.Publish();
+    buffer.Back() = 2;
+    buffer.Publish();
+    EXPECT_TRUE(buffer.Update());
+    EXPECT_EQ(buffer.Front(), 2);   // 1 被覆盖
+    EXPECT_FALSE(buffer.Update());
+    EXPECT_EQ(buffer.Front(), 2);   // 无新帧时保持上一帧
+}
+
+TEST(TripleBufferTest, StressTest_ConcurrentFramesAreNeverTorn) {
+    // 每帧的所有元素都等于帧序号：读者看到混合值即说明读到了写了一半的帧
+    Netease::TripleBuffer<std::vector<uint32_t>> buffer(std::vector<uint32_t>(256, 0));
+    const uint32_t frames = 100000;
+    std::atomic<bool> done{false};
+
+    std::thread writer([&] {
+        for (uint32_t frame = 1; frame <= frames; frame++) {
+            auto& back = buffer.Back();
+            std::fill(back.begin(), back.end(), frame);
+            buffer.Publish();
+        }
+        done = true;
+    });
+
+    uint32_t last = 0;
+    size_t torn = 0, backwards = 0, updates = 0;
+    while (!done.load() || buffer.Update()) {
+        if (!buffer.Update()) continue;
+        updates++;
+        const auto& front = buffer.Front();
+        if (std::any_of(front.begin(), front.end(), [&](uint32_t v) { return v != front[0]; })) torn++;
+        if (front[0] <= last) backwards++;
+        last = front[0];
+    }
+    writer.join();
+    buffer.Update();
+
+    EXPECT_EQ(torn, 0u);
+    EXPECT_EQ(backwards, 0u);
+    EXPECT_EQ(buffer.Front()[0], frames);
+    EXPECT_GT(updates, 0u);
+}
+
+TEST(SpscRingTest, ReadEndingAt_AbsolutePositions) {
+    Netease::SpscRing<float> ring(16);
+    std::vector<float> data(40);
+    for (size_t i = 0; i < data.size(); i++) data[i] = (float)(i + 1);
+
+    std::vector<float> out(4);
+    EXPECT_FALSE(ring.ReadEndingAt(1, out.data(), out.size()));   // 尚未写入
+
+    ring.Write(data.data(), 10);
+    ASSERT_TRUE(ring.ReadEndingAt(2, out.data(), out.size()));    // 流开始之前补 0
+    EXPECT_EQ(out, std::vector<float>({0, 0, 1, 2}));
+    ASSERT_TRUE(ring.ReadEndingAt(10, out.data(), out.size()));
+    EXPECT_EQ(out, std::vector<float>({7, 8, 9, 10}));
+
+    ring.Write(data.data() + 10, 30);
+    ASSERT_TRUE(ring.ReadEndingAt(40, out.data(), out.size()));
+    EXPECT_EQ(out, std::vector<float>({37, 38, 39, 40}));
+    ASSERT_TRUE(ring.ReadEndingAt(28, out.data(), out.size()));   // 仍在最近一圈内
+    EXPECT_EQ(out, std::vector<float>({25, 26, 27, 28}));
+    EXPECT_FALSE(ring.ReadEndingAt(20, out.data(), out.size()));  // 已被覆盖
+    EXPECT_FALSE(ring.ReadEndingAt(41, out.data(), out.size()));  // 超过写指针
+}
+
+TEST(AnalysisThreadTest, Pump_FixedHopIndependentOfWriteChunks) {
+    Netease::AnalysisConfig config;
+    config.fftSize = 1024;
+    config.hopSize = 512;
+    config.bandCount = 32;
+    config.maxCatchUpHops = 1000;
+
+    auto signal = MakeSignal(48000, 47);
+    Netease::SpscRing<float> ring(16384);
+    Netease::AnalysisThread analysis(ring, config);
+    EXPECT_EQ(analysis.Latest().bands, std::vector<float>(32, 0.0f));
+
+    // 随机大小的写入块（模拟不规则的音频回调），每次写入后抽取
+    std::mt19937 rng(48);
+    std::uniform_int_distribution<size_t> chunk(1, 1500);
+    size_t written = 0;
+    while (written < signal.size()) {
+        size_t count = (std::min)(chunk(rng), signal.size() - written);
+        ring.Write(signal.data() + written, count);
+        written += count;
+        analysis.Pump();
+    }
+
+    // 帧数只由样本数决定
+    EXPECT_EQ(analysis.FramesPublished(), signal.size() / config.hopSize);
+    EXPECT_EQ(analysis.HopsSkipped(), 0u);
+
+    // 最新帧与对同一窗口直接分析的结果一致
+    const Netease::SpectrumFrame& frame = analysis.Latest();
+    uint64_t end = (signal.size() / config.hopSize) * config.hopSize;
+    EXPECT_EQ(frame.endSample, end);
+    EXPECT_EQ(frame.sequence, analysis.FramesPublished());
+
+    Netease::AnalysisContext context(config.fftSize, config.bandCount);
+    std::copy(signal.begin() + (end - config.fftSize), signal.begin() + end, context.Samples().begin());
+    auto bands = context.Process();
+    EXPECT_TRUE(std::equal(bands.begin(), bands.end(), frame.bands.begin()));
+
+    double sumSquares = 0;
+    for (size_t i = end - config.fftSize; i < end; i++) sumSquares += (double)signal[i] * signal[i];
+    EXPECT_NEAR(frame.rms, std::sqrt(sumSquares / config.fftSize), 1e-5);
+    EXPECT_GT(frame.energy, 0.0f);
+}
+
+TEST(AnalysisThreadTest, Pump_SkipsOldHopsWhenFarBehind) {
+    Netease::AnalysisConfig config;
+    config.hopSize = 512;
+    config.maxCatchUpHops = 4;
+
+    auto signal = MakeSignal(512 * 20, 49);
+    Netease::SpscRing<float> ring(16384);
+    Netease::AnalysisThread analysis(ring, config);
+    ring.Write(signal.data(), signal.size());
+
+    // 一次积压 20 个步长：只算最新的 4 个
+    EXPECT_EQ(analysis.Pump(), 4u);
+    EXPECT_EQ(analysis.HopsSkipped(), 16u);
+    EXPECT_EQ(analysis.Latest().endSample, signal.size());
+    EXPECT_EQ(analysis.Pump(), 0u);
+}
+
+// 渲染线程每帧开销对比（帧内分析 vs 读取结果）见 NeteaseAudioBench --only thread
+TEST(AnalysisThreadTest, StartStop_PublishesWhileProducerRuns) {
+    Netease::AnalysisConfig config;
+    config.hopSize = 256;
+    config.maxCatchUpHops = 1u << 20;
+
+    Netease::SpscRing<float> ring(1u << 16);
+    Netease::AnalysisThread analysis(ring, config);
+    auto signal = MakeSignal(480, 50);
+
+    EXPECT_TRUE(analysis.Start());
+    EXPECT_TRUE(analysis.IsRunning());
+
+    // 生产者按 10ms 回调节奏写入 100 块（共 48000 样本）
+    std::thread producer([&] {
+        for (int block = 0; block < 100; block++) {
+            ring.Write(signal.data(), signal.size());
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    uint64_t lastSequence = 0;
+    bool monotonic = true;
+    const uint64_t hops = 48000 / 256;
+    while (analysis.FramesPublished() + analysis.HopsSkipped() < hops) {
+        const auto& frame = analysis.Latest();
+        if (frame.sequence < lastSequence) monotonic = false;
+        lastSequence = frame.sequence;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    producer.join();
+    analysis.Stop();
+    EXPECT_FALSE(analysis.IsRunning());
+
+    EXPECT_TRUE(monotonic);
+    EXPECT_EQ(analysis.FramesPublished() + analysis.HopsSkipped(), hops);
+    const auto& frame = analysis.Latest();
+    EXPECT_EQ(frame.sequence, analysis.FramesPublished());
+    EXPECT_EQ(frame.endSample, hops * 256);
+    analysis.Stop();   // 重复 Stop 无副作用
+}
+
+// ============================================================================
+// 7. 频带映射表测试 (v0.1.4)
+// ============================================================================
+
+TEST(BandMapTest, Layout_LogAndMelSpacing) {
+    using Netease::Spectrum::BandMap;
+    EXPECT_FALSE(BandMap(2, 32).Valid());
+    EXPECT_FALSE(BandMap(1024, 0).Valid());
+
+    BandMap map(1024, 32);
+    ASSERT_TRUE(map.Valid());
+    EXPECT_EQ(map.BandCount(), 32u);
+    EXPECT_NEAR(map.LowerHz(0), 30.0f, 1e-3);
+    EXPECT_NEAR(map.UpperHz(31), 16000.0f, 0.1);
+
+    // 对数间距：相邻中心频率之比恒定
+    double ratio = map.CenterHz(1) / map.CenterHz(0);
+    for (size_t b = 1; b < map.BandCount(); b++) {
+        EXPECT_NEAR(map.CenterHz(b) / map.CenterHz(b - 1), ratio, 1e-4);
+    }
+
+    // 感知分辨率：1kHz 以下的频带数（旧的等宽分组只有 1 个：每组 16 桶 = 750Hz）
+    size_t below1k = 0;
+    for (size_t b = 0; b < map.BandCount(); b++) below1k += map.CenterHz(b) < 1000.0f;
+    EXPECT_GE(below1k, 16u);
+
+    // Mel：中心在 Mel 刻度上等距
+    Netease::Spectrum::BandLayout mel;
+    mel.scale = Netease::Spectrum::BandScale::Mel;
+    mel.minHz = 0.0f;
+    BandMap melMap(2048, 40, mel);
+    auto toMel = [](double hz) { return 2595.0 * log10(1.0 + hz / 700.0); };
+    double melStep = toMel(melMap.CenterHz(1)) - toMel(melMap.CenterHz(0));
+    for (size_t b = 1; b < melMap.BandCount(); b++) {
+        EXPECT_NEAR(toMel(melMap.CenterHz(b)) - toMel(melMap.CenterHz(b - 1)), melStep, 1e-2);
+    }
+
+    // 上沿截断到最后一个频率桶以内
+    Netease::Spectrum::BandLayout low;
+    low.sampleRate = 22050;
+    BandMap lowMap(512, 16, low);
+    EXPECT_LE(lowMap.UpperHz(15), 22050.0f / 2);
+}
+
+// 映射表 vs 每帧建表 / v0.1.3 线性分组的耗时对比见 NeteaseAudioBench --only bandmap
+TEST(BandMapTest, Apply_ReferenceBandEnergies) {
+    const size_t fftSize = 1024;
+    const double binHz = 48000.0 / fftSize;
+    Netease::Spectrum::BandMap map(fftSize, 32);
+    std::vector<float> bands(32);
+
+    // 全 1 幅值：归一化后每个频带恰好输出其增益（倾斜补偿 × 整体增益）
+    std::vector<float> ones(fftSize / 2, 1.0f);
+    map.Apply(ones.data(), bands.data());
+    for (size_t b = 0; b < map.BandCount(); b++) {
+        double expected = pow(10.0, 3.0 * log2(map.CenterHz(b) / 1000.0) / 20.0);
+        EXPECT_NEAR(map.Gain(b), expected, expected * 1e-5);
+        EXPECT_NEAR(bands[b], map.Gain(b), map.Gain(b) * 1e-5) << "band " << b;
+    }
+
+    // 分数桶：明显窄于两个频率桶的频带走插值，对线性斜坡 m[k] = k 精确取到中心位置
+    std::vector<float> ramp(fftSize / 2);
+    for (size_t k = 0; k < ramp.size(); k++) ramp[k] = (float)k;
+    map.Apply(ramp.data(), bands.data());
+    size_t narrow = 0;
+    for (size_t b = 0; b < map.BandCount(); b++) {
+        if ((map.UpperHz(b) - map.LowerHz(b)) / binHz >= 1.2) continue;
+        narrow++;
+        double position = (std::max)(1.0, map.CenterHz(b) / binHz);
+        EXPECT_NEAR(bands[b] / map.Gain(b), position, 1e-4 * position) << "band " << b;
+    }
+    EXPECT_GT(narrow, 0u);
+
+    // 纯音：能量落在中心频率最接近的频带（只检查宽于 4 个桶、能被 1024 点分辨的频带）
+    Netease::AnalysisContext context(fftSize, 32);
+    size_t checked = 0;
+    for (size_t b = 0; b < map.BandCount(); b++) {
+        if ((map.UpperHz(b) - map.LowerHz(b)) / binHz < 4.0) continue;
+        checked++;
+        auto samples = context.Samples();
+        for (size_t i = 0; i < samples.size(); i++) {
+            samples[i] = (float)(0.5 * sin(2 * M_PI * map.CenterHz(b) * i / 48000.0));
+        }
+        auto result = context.Process();
+        size_t peak = 0;
+        for (size_t i = 1; i < result.size(); i++) {
+            if (result[i] / map.Gain(i) > result[peak] / map.Gain(peak)) peak = i;
+        }
+        EXPECT_EQ(peak, b) << "tone " << map.CenterHz(b) << "Hz";
+    }
+    EXPECT_GE(checked, 8u);
+}
+
+TEST(BandMapTest, SimdKernels_AgreeWithScalar) {
+    std::mt19937 rng(52);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    for (size_t fftSize : { (size_t)256, (size_t)1024, (size_t)4096 }) {
+        for (int bandCount : { 8, 32, 64 }) {
+            Netease::Spectrum::BandMap map(fftSize, bandCount);
+            std::vector<float> magnitudes(fftSize / 2);
+            for (auto& m : magnitudes) m = dist(rng);
+
+            std::vector<float> expected(bandCount);
+            {
+                ScopedKernel scalar(Netease::Spectrum::Kernel::Scalar);
+                map.Apply(magnitudes.data(), expected.data());
+            }
+            for (auto kernel : ALL_KERNELS) {
+                ScopedKernel scoped(kernel);
+                if (!scoped.Ok()) continue;
+                std::vector<float> actual(bandCount, -1.0f);
+                map.Apply(magnitudes.data(), actual.data());
+                for (int b = 0; b < bandCount; b++) {
+                    EXPECT_NEAR(actual[b], expected[b], 1e-5f * (std::max)(1.0f, expected[b]))
+                        << KernelName(kernel) << " N=" << fftSize << " bands=" << bandCount << " b=" << b;
+                }
+            }
+        }
+    }
+}
+
+TEST(BandMapTest, CalculateBands_UsesMapAndRejectsMismatch) {
+    auto magnitudes = Netease::FftHelper::Analyze(MakeSignal(1024, 53));
+    Netease::Spectrum::BandMap map(1024, 32);
+
+    std::vector<float> viaMap(32), expected(32);
+    map.Apply(magnitudes.data(), expected.data());
+    Netease::FftHelper::CalculateBands(magnitudes, viaMap, map);
+    EXPECT_EQ(viaMap, expected);
+
+    // 默认重载：48kHz 对数映射
+    EXPECT_EQ(Netease::FftHelper::CalculateBands(magnitudes, 32), expected);
+
+    // 幅值不足 / 频带数不符：清零
+    std::vector<float> out(32, 1.0f);
+    Netease::FftHelper::CalculateBands(std::span<const float>(magnitudes.data(), 100), out, map);
+    EXPECT_EQ(out, std::vector<float>(32, 0.0f));
+    std::vector<float> wrong(16, 1.0f);
+    Netease::FftHelper::CalculateBands(magnitudes, wrong, map);
+    EXPECT_EQ(wrong, std::vector<float>(16, 0.0f));
+}
+
+// ============================================================================
+// 8. 采样来源测试 (v0.1.4)
+// ============================================================================
+
+namespace {
+
+/**
+ * 写一个最小 WAV 文件（小端）；extensible 时使用 WAVE_FORMAT_EXTENSIBLE 头
+ */
+void WriteWav(const std::string& path, uint16_t tag, uint16_t bits, uint16_t channels, uint32_t rate,
+              const std::vector<uint8_t>& data, bool extensible = false) {
+    auto u16 = [](std::vector<uint8_t>& out, uint16_t v) { out.push_back(v & 0xFF); out.push_back(v >> 8); };
+    auto u32 = [&](std::vector<uint8_t>& out, uint32_t v) { u16(out, v & 0xFFFF); u16(out, v >> 16); };
+
+    std::vector<uint8_t> fmt;
+    u16(fmt, extensible ? 0xFFFE : tag);
+    u16(fmt, channels);
+    u32(fmt, rate);
+    u32(fmt, rate * channels * bits / 8);
+    u16(fmt, (uint16_t)(channels * bits / 8));
+    u16(fmt, bits);
+    if (extensible) {
+        u16(fmt, 22);
+        u16(fmt, bits);
+        u32(fmt, 0x3);
+        u16(fmt, tag);   // SubFormat GUID 前 2 字节
+        const uint8_t guidTail[14] = { 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 };
+        fmt.insert(fmt.end(), guidTail, guidTail + 14);
+    }
+
+    std::vector<uint8_t> file = { 'R', 'I', 'F', 'F' };
+    u32(file, (uint32_t)(4 + 8 + fmt.size() + 8 + 4 + 8 + data.size()));
+    file.insert(file.end(), { 'W', 'A', 'V', 'E' });
+    // 一个需要跳过的奇数长度块（带填充字节）
+    file.insert(file.end(), { 'L', 'I', 'S', 'T' });
+    u32(file, 3);
+    file.insert(file.end(), { 'a', 'b', 'c', 0 });
+    file.insert(file.end(), { 'f', 'm', 't', ' ' });
+    u32(file, (uint32_t)fmt.size());
+    file.insert(file.end(), fmt.begin(), fmt.end());
+    file.insert(file.end(), { 'd', 'a', 't', 'a' });
+    u32(file, (uint32_t)data.size());
+    file.insert(file.end(), data.begin(), data.end());
+
+    std::ofstream out(path, std::ios::binary);
+    out.write((const char*)file.data(), (std::streamsize)file.size());
+}
+
+std::string TempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+// 小端编码 value ∈ [-1, 1)
+std::vector<uint8_t> Encode(const std::vector<float>& values, Netease::SampleFormat format) {
+    std::vector<uint8_t> out;
+    for (float v : values) {
+        switch (format) {
+            case Netease::SampleFormat::S16: {
+                int16_t s = (int16_t)std::lround(v * 32768.0f);
+                out.push_back(s & 0xFF);
+                out.push_back((s >> 8) & 0xFF);
+                break;
+            }
+            case Netease::SampleFormat::S24: {
+                int32_t s = (int32_t)std::lround(v * 8388608.0f);
+                for (int b = 0; b < 3; b++) out.push_back((s >> (8 * b)) & 0xFF);
+                break;
+            }
+            case Netease::SampleFormat::S32: {
+                int32_t s = (int32_t)std::llround((double)v * 2147483648.0);
+                for (int b = 0; b < 4; b++) out.push_back((s >> (8 * b)) & 0xFF);
+                break;
+            }
+            case Netease::SampleFormat::F32: {
+                uint8_t bytes[4];
+                std::memcpy(bytes, &v, 4);
+                out.insert(out.end(), bytes, bytes + 4);
+                break;
+            }
+        }
+    }
+    return out;
+}
+
+std::vector<float> ReadAll(Netease::SampleSource& source, size_t block) {
+    std::vector<float> all;
+    std::vector<float> buffer(block * source.Format().channels);
+    for (;;) {
+        size_t frames = source.Read(buffer.data(), block);
+        if (frames == 0) break;
+        all.insert(all.end(), buffer.begin(), buffer.begin() + frames * source.Format().channels);
+    }
+    return all;
+}
+
+} // namespace
+
+TEST(SampleSourceTest, Synthetic_DeterministicBoundedAndFinite) {
+    Netease::SyntheticConfig config;
+    config.seconds = 1.5;
+    config.channels = 2;
+    Netease::SyntheticSource a(config), b(config);
+
+    auto first = ReadAll(a, 480);
+    auto second = ReadAll(b, 333);   // 不同块大小，结果相同
+    ASSERT_EQ(first.size(), (size_t)(1.5 * 48000) * 2);
+    EXPECT_EQ(first, second);
+
+    float peak = 0;
+    double sumSquares = 0;
+    for (float v : first) {
+        peak = (std::max)(peak, std::fabs(v));
+        sumSquares += (double)v * v;
+    }
+    EXPECT_LE(peak, 1.0f);
+    EXPECT_GT(std::sqrt(sumSquares / first.size()), 0.1);
+    EXPECT_NE(first[0], first[1]);   // 左右声道不完全相同
+
+    // 低音 55Hz 的能量应落在频带的低频端
+    Netease::AnalysisContext context(4096, 32);
+    for (size_t i = 0; i < 4096; i++) context.Samples()[i] = first[2 * (8192 + i)];
+    auto bands = context.Process();
+    size_t peakBand = std::max_element(bands.begin(), bands.end()) - bands.begin();
+    EXPECT_LT(peakBand, 16u);
+}
+
+TEST(SampleSourceTest, Wav_DecodesEveryEncoding) {
+    std::vector<float> values;
+    for (int i = 0; i < 200; i++) values.push_back((float)sin(0.1 * i) * 0.9f);
+
+    struct Case { Netease::SampleFormat format; uint16_t tag; uint16_t bits; bool extensible; float tolerance; };
+    const Case cases[] = {
+        { Netease::SampleFormat::S16, 1, 16, false, 1.0f / 32768 },
+        { Netease::SampleFormat::S24, 1, 24, false, 1.0f / 8388608 },
+        { Netease::SampleFormat::S32, 1, 32, true, 1e-7f },
+        { Netease::SampleFormat::F32, 3, 32, false, 0.0f },
+        { Netease::SampleFormat::F32, 3, 32, true, 0.0f },
+    };
+    for (const Case& c : cases) {
+        std::string path = TempPath("netease_audio_test.wav");
+        WriteWav(path, c.tag, c.bits, 2, 44100, Encode(values, c.format), c.extensible);
+
+        std::string error;
+        auto source = Netease::FileSource::OpenWav(path, &error);
+        ASSERT_TRUE(source) << error;
+        EXPECT_EQ(source->Encoding(), c.format);
+        EXPECT_EQ(source->Format().sampleRate, 44100);
+        EXPECT_EQ(source->Format().channels, 2);
+        EXPECT_EQ(source->TotalFrames(), 100u);
+
+        auto decoded = ReadAll(*source, 64);
+        ASSERT_EQ(decoded.size(), values.size());
+        for (size_t i = 0; i < values.size(); i++) {
+            EXPECT_NEAR(decoded[i], values[i], c.tolerance + 1e-7f) << "bits " << c.bits << " i=" << i;
+        }
+        source.reset();
+        std::filesystem::remove(path);
+    }
+}
+
+TEST(SampleSourceTest, RawAndLoopAndErrors) {
+    std::vector<float> values = { 0.5f, -0.5f, 0.25f, -0.25f, 0.125f, -0.125f };
+    std::string path = TempPath("netease_audio_test.raw");
+    {
+        auto bytes = Encode(values, Netease::SampleFormat::S16);
+        std::ofstream out(path, std::ios::binary);
+        out.write((const char*)bytes.data(), (std::streamsize)bytes.size());
+    }
+
+    Netease::RawFormat format;
+    format.channels = 2;
+    format.format = Netease::SampleFormat::S16;
+    auto source = Netease::FileSource::OpenRaw(path, format);
+    ASSERT_TRUE(source);
+    EXPECT_EQ(source->TotalFrames(), 3u);
+
+    // 循环：读 7 帧得到 3 + 3 + 1
+    source->SetLoop(true);
+    std::vector<float> out(14);
+    size_t got = 0;
+    while (got < 7) got += source->Read(out.data() + got * 2, 7 - got);
+    for (size_t i = 0; i < out.size(); i++) EXPECT_EQ(out[i], values[i % values.size()]);
+    source.reset();
+
+    std::string error;
+    EXPECT_FALSE(Netease::FileSource::OpenWav(path, &error));   // 不是 RIFF
+    EXPECT_FALSE(error.empty());
+    EXPECT_FALSE(Netease::FileSource::OpenWav(TempPath("netease_audio_missing.wav")));
+    format.channels = 0;
+    EXPECT_FALSE(Netease::FileSource::OpenRaw(path, format));
+
+    // 8 位 PCM 不支持
+    WriteWav(path, 1, 8, 1, 8000, std::vector<uint8_t>(16, 128));
+    EXPECT_FALSE(Netease::FileSource::OpenWav(path, &error));
+    EXPECT_NE(error.find("8 bit"), std::string::npos) << error;
+
+    // fmt 块长度损坏：过大（不应按其分配）/ 过小 / 超出文件末尾，都只返回错误
+    for (uint32_t fmtSize : { 0xFFFFFFF0u, 8u, 40u }) {
+        const uint8_t header[] = {
+            'R', 'I', 'F', 'F', 0x24, 0, 0, 0, 'W', 'A', 'V', 'E',
+            'f', 'm', 't', ' ', (uint8_t)fmtSize, (uint8_t)(fmtSize >> 8), (uint8_t)(fmtSize >> 16),
+            (uint8_t)(fmtSize >> 24), 1, 0, 2, 0,
+        };
+        {
+            std::ofstream out(path, std::ios::binary);
+            out.write((const char*)header, sizeof(header));
+        }
+        error.clear();
+        EXPECT_FALSE(Netease::FileSource::OpenWav(path, &error)) << "fmtSize=" << fmtSize;
+        EXPECT_NE(error.find("fmt"), std::string::npos) << error;
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(SampleSourceTest, WriteMono_AveragesChannels) {
+    std::vector<float> interleaved;
+    for (int i = 0; i < 1000; i++) {
+        for (int c = 0; c < 6; c++) interleaved.push_back((float)(i + c));
+    }
+    Netease::SpscRing<float> ring(2048);
+    Netease::WriteMono(ring, interleaved.data(), 1000, 6);
+    ASSERT_EQ(ring.Written(), 1000u);
+
+    std::vector<float> mono(1000);
+    ring.ReadLatest(mono.data(), mono.size());
+    for (int i = 0; i < 1000; i++) EXPECT_FLOAT_EQ(mono[i], (float)i + 2.5f);
+
+    // 单声道直接写入
+    Netease::WriteMono(ring, mono.data(), 10, 1);
+    EXPECT_EQ(ring.Written(), 1010u);
+}
+
+// 只校验帧数与零分配；吞吐量与各阶段耗时由 NeteaseAudioBench 默认模式报告
+TEST(SampleSourceTest, HeadlessPipeline_FixedFrameCountAndNoSteadyStateAllocations) {
+    Netease::SyntheticConfig config;
+    config.seconds = 10;
+    Netease::SyntheticSource source(config);
+
+    Netease::AnalysisConfig analysisConfig;
+    analysisConfig.maxCatchUpHops = 1000;
+    Netease::SpscRing<float> ring(16384);
+    Netease::AnalysisThread analysis(ring, analysisConfig);
+    std::vector<float> block(480 * 2);
+
+    // 预热一块，之后整条流水线不应再分配
+    size_t frames = source.Read(block.data(), 480);
+    Netease::WriteMono(ring, block.data(), frames, 2);
+    analysis.Pump();
+
+    uint64_t fed = frames;
+    size_t allocations = 0;
+    {
+        AllocationCounter counter;
+        while ((frames = source.Read(block.data(), 480)) > 0) {
+            Netease::WriteMono(ring, block.data(), frames, 2);
+            if (analysis.Pump() > 0) analysis.Latest();
+            fed += frames;
+        }
+        allocations = counter.Count();
+    }
+
+    EXPECT_EQ(fed, 480000u);
+    EXPECT_EQ(analysis.FramesPublished(), 480000u / 512);
+    EXPECT_EQ(analysis.HopsSkipped(), 0u);
+    EXPECT_EQ(allocations, 0u);
+}
+
+// ============================================================================
+// 9. 采集接入内核测试 (v0.1.4)
+// ============================================================================
+
+namespace {
+
+class ScopedIngestKernel {
+public:
+    explicit ScopedIngestKernel(Netease::Ingest::Kernel kernel) : m_Ok(Netease::Ingest::SetKernel(kernel)) {}
+    ~ScopedIngestKernel() { Netease::Ingest::SetKernel(Netease::Ingest::Kernel::Auto); }
+    bool Ok() const { return m_Ok; }
+
+private:
+    bool m_Ok;
+};
+
+const Netease::Ingest::Kernel ALL_INGEST_KERNELS[] = {
+    Netease::Ingest::Kernel::Scalar,
+    Netease::Ingest::Kernel::SSE2,
+    Netease::Ingest::Kernel::AVX2,
+    Netease::Ingest::Kernel::NEON,
+};
+
+const char* IngestKernelName(Netease::Ingest::Kernel kernel) {
+    switch (kernel) {
+        case Netease::Ingest::Kernel::Scalar: return "Scalar";
+        case Netease::Ingest::Kernel::SSE2: return "SSE2";
+        case Netease::Ingest::Kernel::AVX2: return "AVX2";
+        case Netease::Ingest::Kernel::NEON: return "NEON";
+        default: return "Auto";
+    }
+}
+
+const Netease::SampleFormat ALL_FORMATS[] = {
+    Netease::SampleFormat::S16,
+    Netease::SampleFormat::S24,
+    Netease::SampleFormat::S32,
+    Netease::SampleFormat::F32,
+};
+
+std::vector<float> RandomSamples(size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-0.99f, 0.99f);
+    std::vector<float> values(count);
+    for (auto& v : values) v = dist(rng);
+    return values;
+}
+
+/**
+ * v0.1.4 之前的写入路径：逐帧逐声道累加（只支持 f32）
+ */
+void LegacyDownmix(const float* interleaved, size_t frames, int channels, float* mono) {
+    const float scale = 1.0f / (float)channels;
+    for (size_t i = 0; i < frames; i++) {
+        float sample = 0;
+        for (int c = 0; c < channels; c++) sample += interleaved[i * channels + c];
+        mono[i] = sample * scale;
+    }
+}
+
+} // namespace
+
+// 各格式 / 声道数的接入吞吐量见 NeteaseAudioBench --only ingest
+TEST(AudioIngestTest, Decode_EveryKernelMatchesScalar) {
+    // 覆盖不足一个向量宽度的长度与 s24 的标量尾部
+    for (size_t count : { 1u, 7u, 8u, 17u, 64u, 1003u }) {
+        auto values = RandomSamples(count, 61 + (uint32_t)count);
+        for (auto format : ALL_FORMATS) {
+            auto encoded = Encode(values, format);
+            std::vector<float> expected(count);
+            {
+                ScopedIngestKernel scoped(Netease::Ingest::Kernel::Scalar);
+                Netease::Ingest::Decode(encoded.data(), format, count, expected.data());
+            }
+            for (size_t i = 0; i < count; i++) {
+                ASSERT_NEAR(expected[i], values[i], 1e-4f) << "format=" << (int)format << " i=" << i;
+            }
+
+            for (auto kernel : ALL_INGEST_KERNELS) {
+                ScopedIngestKernel scoped(kernel);
+                if (!scoped.Ok()) continue;
+                std::vector<float> actual(count);
+                Netease::Ingest::Decode(encoded.data(), format, count, actual.data());
+                for (size_t i = 0; i < count; i++) {
+                    ASSERT_EQ(actual[i], expected[i]) << IngestKernelName(kernel) << " format=" << (int)format
+                                                      << " count=" << count << " i=" << i;
+                }
+            }
+        }
+    }
+
+    // 满量程边界
+    const uint8_t s16[] = { 0x00, 0x80, 0xFF, 0x7F };
+    float out[2];
+    Netease::Ingest::Decode(s16, Netease::SampleFormat::S16, 2, out);
+    EXPECT_EQ(out[0], -1.0f);
+    EXPECT_NEAR(out[1], 1.0f, 1e-4f);
+}
+
+TEST(AudioIngestTest, DownmixAndDeinterleave_EveryKernelMatchesScalar) {
+    for (int channels : { 1, 2, 3, 6, 8 }) {
+        for (size_t frames : { 1u, 3u, 4u, 9u, 16u, 257u }) {
+            auto interleaved = RandomSamples(frames * channels, 71 + channels * 1000 + (uint32_t)frames);
+
+            std::vector<float> expected(frames);
+            LegacyDownmix(interleaved.data(), frames, channels, expected.data());
+
+            for (auto kernel : ALL_INGEST_KERNELS) {
+                ScopedIngestKernel scoped(kernel);
+                if (!scoped.Ok()) continue;
+
+                std::vector<float> mono(frames);
+                Netease::Ingest::Downmix(interleaved.data(), channels, frames, mono.data());
+                for (size_t i = 0; i < frames; i++) {
+                    // 求和顺序不同，允许舍入误差
+                    ASSERT_NEAR(mono[i], expected[i], 1e-6f) << IngestKernelName(kernel) << " channels=" << channels
+                                                             << " frames=" << frames << " i=" << i;
+                }
+
+                std::vector<std::vector<float>> planeData(channels, std::vector<float>(frames));
+                std::vector<float*> planes(channels);
+                for (int c = 0; c < channels; c++) planes[c] = planeData[c].data();
+                Netease::Ingest::Deinterleave(interleaved.data(), channels, frames, planes.data());
+                for (size_t i = 0; i < frames; i++) {
+                    for (int c = 0; c < channels; c++) {
+                        ASSERT_EQ(planeData[c][i], interleaved[i * channels + c]) << IngestKernelName(kernel)
+                            << " channels=" << channels << " frames=" << frames << " i=" << i << " c=" << c;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(AudioIngestTest, WriteMono_DecodesDeviceFormats) {
+    // 6 声道 × 1000 帧，跨越多个中转块
+    const int channels = 6;
+    const size_t frames = 1000;
+    auto values = RandomSamples(frames * channels, 81);
+    std::vector<float> expected(frames);
+    LegacyDownmix(values.data(), frames, channels, expected.data());
+
+    for (auto format : ALL_FORMATS) {
+        auto encoded = Encode(values, format);
+        Netease::SpscRing<float> ring(2048);
+        Netease::WriteMono(ring, encoded.data(), format, channels, frames);
+        ASSERT_EQ(ring.Written(), frames);
+
+        std::vector<float> mono(frames);
+        ring.ReadLatest(mono.data(), mono.size());
+        for (size_t i = 0; i < frames; i++) {
+            ASSERT_NEAR(mono[i], expected[i], 1e-4f) << "format=" << (int)format << " i=" << i;
+        }
+    }
+
+    // 声道数越界时忽略
+    Netease::SpscRing<float> ring(64);
+    Netease::WriteMono(ring, values.data(), Netease::SampleFormat::F32, 0, 4);
+    Netease::WriteMono(ring, values.data(), Netease::SampleFormat::F32, Netease::Ingest::MAX_CHANNELS + 1, 4);
+    EXPECT_EQ(ring.Written(), 0u);
+}
+
+TEST(AudioIngestTest, WriteStereo_SplitsFrontChannels) {
+    const size_t frames = 700;
+    for (int channels : { 1, 2, 8 }) {
+        std::vector<float> interleaved(frames * channels);
+        for (size_t i = 0; i < frames; i++) {
+            for (int c = 0; c < channels; c++) interleaved[i * channels + c] = (float)i * 0.001f + (float)c;
+        }
+        Netease::SpscRing<float> left(1024), right(1024);
+        Netease::WriteStereo(left, right, interleaved.data(), Netease::SampleFormat::F32, channels, frames);
+        ASSERT_EQ(left.Written(), frames);
+        ASSERT_EQ(right.Written(), frames);
+
+        std::vector<float> l(frames), r(frames);
+        left.ReadLatest(l.data(), frames);
+        right.ReadLatest(r.data(), frames);
+        for (size_t i = 0; i < frames; i++) {
+            ASSERT_EQ(l[i], interleaved[i * channels]) << "channels=" << channels << " i=" << i;
+            ASSERT_EQ(r[i], interleaved[i * channels + (channels > 1 ? 1 : 0)]) << "channels=" << channels << " i=" << i;
+        }
+    }
+}
+
+// ============================================================================
+// 10. 多相降采样测试 (v0.1.4)
+// ============================================================================
+
+namespace {
+
+std::vector<float> Tone(size_t n, double hz, double amplitude = 1.0) {
+    std::vector<float> out(n);
+    for (size_t i = 0; i < n; i++) out[i] = (float)(amplitude * std::sin(2.0 * M_PI * hz * (double)i / 48000.0));
+    return out;
+}
+
+// 去掉开头的滤波器暂态后的均方根
+double SteadyRms(const std::vector<float>& x, size_t skip) {
+    double sum = 0;
+    for (size_t i = skip; i < x.size(); i++) sum += (double)x[i] * x[i];
+    return std::sqrt(sum / (double)(x.size() - skip));
+}
+
+/**
+ * 以 10ms 块写入并逐块 Pump，返回最后一帧频带
+ */
+std::vector<float> RunAnalysis(const std::vector<float>& signal, size_t fftSize, int decimation, float maxHz) {
+    Netease::AnalysisConfig config;
+    config.fftSize = fftSize;
+    config.hopSize = 512;
+    config.decimation = decimation;
+    config.maxHz = maxHz;
+    config.maxCatchUpHops = 1u << 20;
+    Netease::SpscRing<float> ring(1u << 16);
+    Netease::AnalysisThread analysis(ring, config);
+
+    for (size_t offset = 0; offset + 480 <= signal.size(); offset += 480) {
+        ring.Write(signal.data() + offset, 480);
+        analysis.Pump();
+    }
+    return analysis.Latest().bands;
+}
+
+} // namespace
+
+TEST(DecimatorTest, Response_PassbandStopbandAndChunking) {
+    for (int factor : { 2, 4 }) {
+        Netease::Decimator reference(factor);
+        EXPECT_EQ(reference.Factor(), factor);
+        EXPECT_EQ(reference.TapCount() % Netease::Spectrum::BandMap::PAD, 0u);
+        const double outNyquist = 24000.0 / factor;
+        const size_t n = 48000;
+        const size_t skip = reference.TapCount();
+
+        // 通带：±0.1dB 以内
+        for (double ratio : { 0.05, 0.3, 0.6 }) {
+            Netease::Decimator decimator(factor);
+            auto in = Tone(n, ratio * outNyquist);
+            std::vector<float> out(decimator.MaxOutput(n));
+            out.resize(decimator.Process(in.data(), n, out.data()));
+            EXPECT_EQ(out.size(), n / factor);
+            double gain = SteadyRms(out, skip) / SteadyRms(in, skip);
+            EXPECT_NEAR(20 * std::log10(gain), 0.0, 0.1) << "x" << factor << " f=" << ratio * outNyquist;
+        }
+
+        // 阻带：会折叠回通带的频率至少衰减 70dB
+        for (double ratio : { 1.2, 1.5, 1.9 }) {
+            double hz = ratio * outNyquist;
+            if (hz >= 24000.0) continue;
+            Netease::Decimator decimator(factor);
+            auto in = Tone(n, hz);
+            std::vector<float> out(decimator.MaxOutput(n));
+            out.resize(decimator.Process(in.data(), n, out.data()));
+            double gain = SteadyRms(out, skip) / SteadyRms(in, skip);
+            EXPECT_LT(20 * std::log10(gain), -70.0) << "x" << factor << " f=" << hz;
+        }
+
+        // 任意分块与一次处理结果完全一致
+        auto signal = MakeSignal(10007, 100 + factor);
+        std::vector<float> whole(reference.MaxOutput(signal.size()));
+        whole.resize(reference.Process(signal.data(), signal.size(), whole.data()));
+
+        Netease::Decimator chunked(factor);
+        std::mt19937 rng(7);
+        std::vector<float> pieces, buffer(chunked.MaxOutput(700));
+        for (size_t offset = 0; offset < signal.size();) {
+            size_t take = (std::min)((size_t)(rng() % 700), signal.size() - offset);
+            size_t produced = chunked.Process(signal.data() + offset, take, buffer.data());
+            pieces.insert(pieces.end(), buffer.begin(), buffer.begin() + produced);
+            offset += take;
+        }
+        ASSERT_EQ(pieces.size(), whole.size());
+        for (size_t i = 0; i < whole.size(); i++) ASSERT_EQ(pieces[i], whole[i]) << "x" << factor << " i=" << i;
+
+        // Reset 后与新实例一致
+        chunked.Reset();
+        std::vector<float> again(chunked.MaxOutput(signal.size()));
+        again.resize(chunked.Process(signal.data(), signal.size(), again.data()));
+        EXPECT_EQ(again, whole);
+    }
+
+    // 倍数 1 直通
+    Netease::Decimator passthrough(1);
+    float in[3] = { 0.1f, 0.2f, 0.3f }, out[4] = {};
+    EXPECT_EQ(passthrough.Process(in, 3, out), 3u);
+    EXPECT_EQ(out[2], 0.3f);
+}
+
+TEST(AnalysisThreadTest, Decimation_SameFrameRateAndNoAliasing) {
+    // 15kHz 高于 ×2 后的 Nyquist (12kHz)，不滤波会折叠到 9kHz
+    auto signal = Tone(48000 * 2, 15000.0, 0.5);
+    float fullRatePeak = 0;
+    for (int decimation : { 1, 2, 4 }) {
+        Netease::AnalysisConfig config;
+        config.decimation = decimation;
+        config.maxCatchUpHops = 1u << 20;
+        Netease::SpscRing<float> ring(1u << 16);
+        Netease::AnalysisThread analysis(ring, config);
+
+        for (size_t offset = 0; offset < signal.size(); offset += 480) {
+            ring.Write(signal.data() + offset, 480);
+            analysis.Pump();
+        }
+
+        // 步长按采集样本计：帧率与是否降采样无关
+        EXPECT_EQ(analysis.FramesPublished(), signal.size() / 512) << "x" << decimation;
+        EXPECT_EQ(analysis.HopsSkipped(), 0u);
+        const auto& frame = analysis.Latest();
+        EXPECT_EQ(frame.endSample, signal.size() / 512 * 512);
+
+        float peak = *std::max_element(frame.bands.begin(), frame.bands.end());
+        if (decimation == 1) {
+            fullRatePeak = peak;
+            EXPECT_GT(peak, 1e-3f);
+        } else {
+            // 降采样后的频带里不应出现折叠回来的 15kHz（至少低 60dB）
+            EXPECT_LT(peak, fullRatePeak * 1e-3f) << "x" << decimation;
+        }
+    }
+}
+
+// 每帧耗时对比（×4 + FFT 1024 vs 全速率 FFT 4096 等）见 NeteaseAudioBench --only decimate
+TEST(DecimatorTest, BandAccuracy_LowFrequencyContrastWithoutAliasing) {
+    // 共同的频带布局：30Hz ~ 4kHz（×4 后的平坦通带之内）
+    const float maxHz = 4000.0f;
+    const int bandCount = 32;
+    Netease::Spectrum::BandLayout layout;
+    layout.maxHz = maxHz;
+    Netease::Spectrum::BandMap centers(16384, bandCount, layout);
+
+    // 在 100 ~ 400Hz 每隔一个频带的中心放一个单音，相邻频带留空；再加强的高频成分检验混叠
+    std::vector<float> signal(48000 * 3, 0.0f);
+    std::vector<int> toneBands, gapBands;
+    for (int b = 0; b < bandCount; b++) {
+        float hz = centers.CenterHz(b);
+        if (hz < 100.0f || hz > 400.0f) continue;
+        if (toneBands.size() == gapBands.size()) {
+            toneBands.push_back(b);
+            auto tone = Tone(signal.size(), hz, 0.05);
+            for (size_t i = 0; i < signal.size(); i++) signal[i] += tone[i];
+        } else {
+            gapBands.push_back(b);
+        }
+    }
+    auto tonesOnly = signal;
+    for (double hz : { 7500.0, 15000.0, 19000.0 }) {
+        auto tone = Tone(signal.size(), hz, 0.3);
+        for (size_t i = 0; i < signal.size(); i++) signal[i] += tone[i];
+    }
+    ASSERT_GE(gapBands.size(), 3u);
+
+    struct Case { size_t fft; int decimation; double contrastDb = 0, errorDb = 0; };
+    Case cases[] = { { 1024, 1 }, { 1024, 4 } };
+    for (auto& c : cases) {
+        auto bands = RunAnalysis(signal, c.fft, c.decimation, maxHz);
+        auto clean = RunAnalysis(tonesOnly, c.fft, c.decimation, maxHz);
+
+        // 分辨率：单音频带与空频带的平均幅值之比
+        double tone = 0, gap = 0;
+        for (int b : toneBands) tone += bands[b];
+        for (int b : gapBands) gap += bands[b];
+        c.contrastDb = 20 * std::log10((tone / toneBands.size()) / (gap / gapBands.size() + 1e-12));
+
+        // 混叠：加入通带外强成分前后频带的最大变化（相对单音频带）
+        double worst = 0;
+        for (int b = 0; b < bandCount; b++) worst = (std::max)(worst, (double)std::fabs(bands[b] - clean[b]));
+        c.errorDb = 20 * std::log10(worst / (tone / toneBands.size()) + 1e-12);
+    }
+
+    const Case& full1024 = cases[0];
+    const Case& x4fft1024 = cases[1];
+    // ×4 + FFT 1024 与全速率 FFT 4096 的频率桶相同：低频对比度明显好于全速率 1024
+    EXPECT_GT(x4fft1024.contrastDb, full1024.contrastDb + 6.0);
+    EXPECT_LT(x4fft1024.errorDb, -60.0);
+}
+
+// ============================================================================
+// 主函数
+// ============================================================================
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+
+    std::cout << "===========================================" << std::endl;
+    std::cout << "NeteaseMonitor 音频分析测试套件" << std::endl;
+    std::cout << "===========================================" << std::endl;
+    std::cout << std::endl;
+
+    int result = RUN_ALL_TESTS();
+
+    std::cout << std::endl;
+    std::cout << "===========================================" << std::endl;
+    std::cout << "测试完成" << std::endl;
+    std::cout << "===========================================" << std::endl;
+
+    return result;
+}